@@ -1,13 +1,13 @@
 ﻿#include "DebugText.h"
+#include "SpriteBatch.h"
 #include "TextureManager.h"
+#include <algorithm>
+
+using namespace DirectX;
 
 DebugText::DebugText() {}
 
-DebugText::~DebugText() {
-	for (int i = 0; i < _countof(spriteDatas_); i++) {
-		delete spriteDatas_[i];
-	}
-}
+DebugText::~DebugText() {}
 
 DebugText* DebugText::GetInstance() {
 	static DebugText instance;
@@ -18,11 +18,13 @@ void DebugText::Initialize() {
 
 	// デバッグテキスト用テクスチャ読み込み
 	textureHandle_ = TextureManager::Load("debugfont.png");
-	// 全てのスプライトデータについて
-	for (int i = 0; i < _countof(spriteDatas_); i++) {
-		// スプライトを生成する
-		spriteDatas_[i] = Sprite::Create(textureHandle_, {0, 0});
-	}
+	const D3D12_RESOURCE_DESC& resDesc =
+	  TextureManager::GetInstance()->GetResoureDesc(textureHandle_);
+	textureWidth_ = static_cast<float>(resDesc.Width);
+	textureHeight_ = static_cast<float>(resDesc.Height);
+
+	runs_.reserve(64);
+	vertices_.reserve(1024 * 4);
 }
 
 // 1文字列追加
@@ -37,7 +39,7 @@ void DebugText::Printf(const char* fmt, ...) {
 	va_list args;
 	va_start(args, fmt);
 	int w = vsnprintf(buffer, kBufferSize - 1, fmt, args);
-	NPrint(w, buffer);
+	NPrint((std::min)(w, kBufferSize - 2), buffer);
 	va_end(args);
 }
 
@@ -51,28 +53,73 @@ void DebugText::ConsolePrintf(const char* fmt, ...) {
 
 // まとめて描画
 void DebugText::DrawAll(ID3D12GraphicsCommandList* cmdList) {
-	// 全ての文字のスプライトについて
-	for (int i = 0; i < spriteIndex_; i++) {
-		// スプライト描画
-		spriteDatas_[i]->Draw();
+	vertices_.clear();
+
+	for (size_t i = 0; i < runs_.size(); i++) {
+		GlyphRun& run = runs_[i];
+		size_t firstVertex = vertices_.size();
+
+		// 前フレームの同じ位置の文字列と同じなら頂点を使い回す
+		if (i < cachedRuns_.size()) {
+			const GlyphRun& cached = cachedRuns_[i];
+			if (
+			  cached.x == run.x && cached.y == run.y && cached.scale == run.scale &&
+			  cached.text == run.text) {
+				auto begin = cachedVertices_.begin() + cached.firstVertex;
+				vertices_.insert(vertices_.end(), begin, begin + cached.vertexCount);
+			} else {
+				GenerateGlyphs(run);
+			}
+		} else {
+			GenerateGlyphs(run);
+		}
+
+		run.firstVertex = firstVertex;
+		run.vertexCount = vertices_.size() - firstVertex;
+	}
+
+	// 全ての文字を1つのテクスチャの四角形としてまとめて追加
+	if (!vertices_.empty()) {
+		SpriteBatch::GetInstance()->DrawQuads(
+		  textureHandle_, vertices_.data(), vertices_.size() / 4);
 	}
 
-	spriteIndex_ = 0;
+	// 次のフレームと比べるために残す
+	std::swap(runs_, cachedRuns_);
+	std::swap(vertices_, cachedVertices_);
+	runs_.clear();
+	charCount_ = 0;
 }
 
 void DebugText::NPrint(int len, const char* text) {
-	// 全ての文字について
-	for (int i = 0; i < len; i++) {
-		// 最大文字数超過
-		if (spriteIndex_ >= kMaxCharCount) {
-			break;
-		}
+	// 最大文字数超過
+	len = (std::min)(len, kMaxCharCount - charCount_);
+	if (len <= 0) {
+		return;
+	}
+
+	GlyphRun run;
+	run.text.assign(text, len);
+	run.x = posX_;
+	run.y = posY_;
+	run.scale = scale_;
+	run.firstVertex = 0;
+	run.vertexCount = 0;
+	runs_.push_back(std::move(run));
+	charCount_ += len;
+}
+
+void DebugText::GenerateGlyphs(const GlyphRun& run) {
+	glyphs_.Clear();
 
+	XMFLOAT2 size = {kFontWidth * run.scale, kFontHeight * run.scale};
+	XMFLOAT4 color = {1, 1, 1, 1};
+	for (size_t i = 0; i < run.text.size(); i++) {
 		// 1文字取り出す(※ASCIIコードでしか成り立たない)
-		const unsigned char& character = text[i];
+		const unsigned char& character = run.text[i];
 
 		int fontIndex = character - 32;
-		if (character >= 0x7f) {
+		if (character < 32 || character >= 0x7f) {
 			fontIndex = 0;
 		}
 
@@ -80,15 +127,15 @@ void DebugText::NPrint(int len, const char* text) {
 		int fontIndexX = fontIndex % kFontLineCount;
 
 		// 座標計算
-		spriteDatas_[spriteIndex_]->SetPosition(
-		  {this->posX_ + kFontWidth * this->scale_ * i, this->posY_});
-		spriteDatas_[spriteIndex_]->SetTextureRect(
-		  {(float)fontIndexX * kFontWidth, (float)fontIndexY * kFontHeight},
-		  {(float)kFontWidth, (float)kFontHeight});
-		spriteDatas_[spriteIndex_]->SetSize(
-		  {kFontWidth * this->scale_, kFontHeight * this->scale_});
-
-		// 文字を１つ進める
-		spriteIndex_++;
+		float left = (float)fontIndexX * kFontWidth / textureWidth_;
+		float top = (float)fontIndexY * kFontHeight / textureHeight_;
+		glyphs_.Add(
+		  {run.x + size.x * i, run.y}, size, 0.0f, {0.0f, 0.0f},
+		  {left, top, left + kFontWidth / textureWidth_, top + kFontHeight / textureHeight_},
+		  color);
 	}
-}
\ No newline at end of file
+
+	size_t first = vertices_.size();
+	vertices_.resize(first + glyphs_.GetCount() * 4);
+	SpriteQuadKernel::Generate(glyphs_.GetSprites(), glyphs_.GetCount(), vertices_.data() + first);
+}
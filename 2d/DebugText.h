@@ -1,20 +1,24 @@
 ﻿#pragma once
 
-#include "Sprite.h"
+#include "SpriteQuadKernel.h"
 #include <Windows.h>
+#include <d3d12.h>
 #include <string>
+#include <vector>
 
 /// <summary>
 /// デバッグ用文字表示
+/// 文字列を文字ごとの四角形にしてSpriteBatchへまとめて追加する（1回の描画コマンドで描ける）。
+/// 前フレームと同じ順番、内容、座標、倍率の文字列は頂点を作り直さずに使い回す
 /// </summary>
 class DebugText {
   public:
 	// デバッグテキスト用のテクスチャ番号を指定
-	static const int kMaxCharCount = 256; // 最大文字数
-	static const int kFontWidth = 9;      // フォント画像内1文字分の横幅
-	static const int kFontHeight = 18;    // フォント画像内1文字分の縦幅
-	static const int kFontLineCount = 14; // フォント画像内1行分の文字数
-	static const int kBufferSize = 256;   // 書式付き文字列展開用バッファサイズ
+	static const int kMaxCharCount = 16384; // 最大文字数（1回の描画コマンドで描ける数）
+	static const int kFontWidth = 9;        // フォント画像内1文字分の横幅
+	static const int kFontHeight = 18;      // フォント画像内1文字分の縦幅
+	static const int kFontLineCount = 14;   // フォント画像内1行分の文字数
+	static const int kBufferSize = 1024;    // 書式付き文字列展開用バッファサイズ
 
 	/// <summary>
 	/// シングルトンインスタンスの取得
@@ -49,7 +53,7 @@ class DebugText {
 	void ConsolePrintf(const char* fmt, ...);
 
 	/// <summary>
-	/// 描画フラッシュ
+	/// 描画フラッシュ（Sprite::PreDraw～PostDrawの間で呼ぶ）
 	/// </summary>
 	/// <param name="cmdList">描画コマンドリスト</param>
 	void DrawAll(ID3D12GraphicsCommandList* cmdList);
@@ -71,12 +75,33 @@ class DebugText {
 	void SetScale(float scale) { scale_ = scale; }
 
   private:
+	// 同じ座標、倍率で続けて表示する文字列
+	struct GlyphRun {
+		std::string text;
+		float x;
+		float y;
+		float scale;
+		// 頂点配列内の範囲
+		size_t firstVertex;
+		size_t vertexCount;
+	};
+
 	// テクスチャハンドル
 	uint32_t textureHandle_ = 0;
-	// スプライトデータの配列
-	Sprite* spriteDatas_[kMaxCharCount] = {};
-	// スプライトデータ配列の添え字番号
-	int spriteIndex_ = 0;
+	// フォント画像の幅、高さ
+	float textureWidth_ = 1.0f;
+	float textureHeight_ = 1.0f;
+	// このフレームに追加された文字列
+	std::vector<GlyphRun> runs_;
+	// このフレームに追加された文字数
+	int charCount_ = 0;
+	// 前フレームに描画した文字列と頂点
+	std::vector<GlyphRun> cachedRuns_;
+	std::vector<SpriteQuadKernel::Vertex> cachedVertices_;
+	// このフレームの頂点
+	std::vector<SpriteQuadKernel::Vertex> vertices_;
+	// 頂点生成用の文字の配列
+	SpriteQuadKernel::SpriteArrays glyphs_;
 
 	float posX_ = 0.0f;
 	float posY_ = 0.0f;
@@ -89,4 +114,10 @@ class DebugText {
 	DebugText(const DebugText&) = delete;
 	DebugText& operator=(const DebugText&) = delete;
 	void NPrint(int len, const char* text);
+
+	/// <summary>
+	/// 文字列の頂点を生成してvertices_の末尾に追加
+	/// </summary>
+	/// <param name="run">文字列</param>
+	void GenerateGlyphs(const GlyphRun& run);
 };
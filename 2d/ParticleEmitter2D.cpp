@@ -0,0 +1,146 @@
+﻿#include "ParticleEmitter2D.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace {
+
+// 4要素の読み込み、書き込み（アライメント不要）
+inline XMVECTOR Load4(const float* source) {
+	return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(source));
+}
+inline void Store4(float* destination, FXMVECTOR value) {
+	XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(destination), value);
+}
+
+} // namespace
+
+ParticleEmitter2D::ParticleEmitter2D(const Desc& desc) : desc_(desc) {
+	assert(desc.seed != 0);
+	randomState_ = desc.seed;
+
+	// 4個ずつ処理するので端数の分も確保しておく（端数の要素は描画しない）
+	capacity_ = (desc.maxParticles + 3) / 4 * 4;
+	for (std::vector<float>* array :
+	     {&positionX_, &positionY_, &velocityX_, &velocityY_, &life_, &inverseLifetime_}) {
+		array->assign(capacity_, 0.0f);
+	}
+	size_.assign(capacity_, desc.startSize);
+	color_.assign(capacity_, desc.startColor);
+
+	// 回転なし、中心がアンカーポイント、UVは全て同じ
+	zero_.assign(capacity_, 0.0f);
+	half_.assign(capacity_, 0.5f);
+	uvLeft_.assign(capacity_, desc.uvRect.x);
+	uvTop_.assign(capacity_, desc.uvRect.y);
+	uvRight_.assign(capacity_, desc.uvRect.z);
+	uvBottom_.assign(capacity_, desc.uvRect.w);
+}
+
+void ParticleEmitter2D::Update(float deltaTime) {
+	// 積分（端数の要素もまとめて処理する）
+	XMVECTOR dt = XMVectorReplicate(deltaTime);
+	XMVECTOR accelerationX = XMVectorReplicate(desc_.acceleration.x * deltaTime);
+	XMVECTOR accelerationY = XMVectorReplicate(desc_.acceleration.y * deltaTime);
+	for (uint32_t i = 0; i < count_; i += 4) {
+		XMVECTOR velocityX = XMVectorAdd(Load4(&velocityX_[i]), accelerationX);
+		XMVECTOR velocityY = XMVectorAdd(Load4(&velocityY_[i]), accelerationY);
+		Store4(&velocityX_[i], velocityX);
+		Store4(&velocityY_[i], velocityY);
+		Store4(&positionX_[i], XMVectorMultiplyAdd(velocityX, dt, Load4(&positionX_[i])));
+		Store4(&positionY_[i], XMVectorMultiplyAdd(velocityY, dt, Load4(&positionY_[i])));
+		Store4(&life_[i], XMVectorSubtract(Load4(&life_[i]), dt));
+	}
+
+	// 寿命の尽きたものを末尾と入れ替えて詰める
+	for (uint32_t i = 0; i < count_;) {
+		if (0.0f < life_[i]) {
+			i++;
+			continue;
+		}
+		uint32_t last = --count_;
+		positionX_[i] = positionX_[last];
+		positionY_[i] = positionY_[last];
+		velocityX_[i] = velocityX_[last];
+		velocityY_[i] = velocityY_[last];
+		life_[i] = life_[last];
+		inverseLifetime_[i] = inverseLifetime_[last];
+	}
+
+	// 発生
+	emissionAccumulator_ += desc_.emissionRate * deltaTime;
+	uint32_t emitCount = static_cast<uint32_t>(emissionAccumulator_);
+	emissionAccumulator_ -= static_cast<float>(emitCount);
+	Burst(emitCount);
+}
+
+void ParticleEmitter2D::Burst(uint32_t count) {
+	count = (std::min)(count, desc_.maxParticles - count_);
+	for (uint32_t i = 0; i < count; i++) {
+		Spawn();
+	}
+}
+
+SpriteQuadKernel::Sprites ParticleEmitter2D::BuildSprites() {
+	// 経過の割合 t = 1 - 残り寿命 / 寿命 で大きさと色を補間
+	XMVECTOR one = XMVectorSplatOne();
+	XMVECTOR startSize = XMVectorReplicate(desc_.startSize);
+	XMVECTOR sizeRange = XMVectorReplicate(desc_.endSize - desc_.startSize);
+	XMVECTOR startColor = XMLoadFloat4(&desc_.startColor);
+	XMVECTOR endColor = XMLoadFloat4(&desc_.endColor);
+	for (uint32_t i = 0; i < count_; i += 4) {
+		XMVECTOR t = XMVectorSubtract(
+		  one, XMVectorMultiply(Load4(&life_[i]), Load4(&inverseLifetime_[i])));
+		t = XMVectorSaturate(t);
+		Store4(&size_[i], XMVectorMultiplyAdd(t, sizeRange, startSize));
+
+		XMFLOAT4 ratio;
+		XMStoreFloat4(&ratio, t);
+		XMStoreFloat4(&color_[i + 0], XMVectorLerp(startColor, endColor, ratio.x));
+		XMStoreFloat4(&color_[i + 1], XMVectorLerp(startColor, endColor, ratio.y));
+		XMStoreFloat4(&color_[i + 2], XMVectorLerp(startColor, endColor, ratio.z));
+		XMStoreFloat4(&color_[i + 3], XMVectorLerp(startColor, endColor, ratio.w));
+	}
+
+	SpriteQuadKernel::Sprites sprites;
+	sprites.positionX = positionX_.data();
+	sprites.positionY = positionY_.data();
+	sprites.sizeX = size_.data();
+	sprites.sizeY = size_.data();
+	sprites.rotation = zero_.data();
+	sprites.anchorX = half_.data();
+	sprites.anchorY = half_.data();
+	sprites.uvLeft = uvLeft_.data();
+	sprites.uvTop = uvTop_.data();
+	sprites.uvRight = uvRight_.data();
+	sprites.uvBottom = uvBottom_.data();
+	sprites.color = color_.data();
+	return sprites;
+}
+
+float ParticleEmitter2D::NextRandom() {
+	randomState_ ^= randomState_ << 13;
+	randomState_ ^= randomState_ >> 17;
+	randomState_ ^= randomState_ << 5;
+	// 上位24bitを使う
+	return static_cast<float>(randomState_ >> 8) * (1.0f / 16777216.0f);
+}
+
+void ParticleEmitter2D::Spawn() {
+	assert(count_ < desc_.maxParticles);
+
+	float angle = desc_.direction + desc_.spread * (NextRandom() * 2.0f - 1.0f);
+	float speed = desc_.speedMin + (desc_.speedMax - desc_.speedMin) * NextRandom();
+	float lifetime = desc_.lifeMin + (desc_.lifeMax - desc_.lifeMin) * NextRandom();
+	lifetime = (std::max)(lifetime, 1e-4f);
+
+	uint32_t i = count_++;
+	positionX_[i] = desc_.position.x;
+	positionY_[i] = desc_.position.y;
+	velocityX_[i] = std::cos(angle) * speed;
+	velocityY_[i] = std::sin(angle) * speed;
+	life_[i] = lifetime;
+	inverseLifetime_[i] = 1.0f / lifetime;
+}
@@ -0,0 +1,145 @@
+﻿#pragma once
+
+#include "SpriteQuadKernel.h"
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 2Dパーティクルの発生源
+/// パーティクルは要素ごとの配列（座標、速度、寿命）で持ち、4個ずつSIMDで積分する。
+/// 寿命の尽きたものは末尾と入れ替えて詰める。乱数は発生源ごとの種から決まり、
+/// 同じ経過時間の列を与えれば結果は毎回同じになる（描画には依存しない）
+/// </summary>
+class ParticleEmitter2D {
+  public: // サブクラス
+	/// <summary>
+	/// 発生源の設定
+	/// </summary>
+	struct Desc {
+		// 最大数
+		uint32_t maxParticles = 1024;
+		// 1秒あたりの発生数
+		float emissionRate = 100.0f;
+		// 発生位置
+		DirectX::XMFLOAT2 position = {0, 0};
+		// 発射方向（ラジアン、スクリーン座標で右が0、下が正）と左右の広がり
+		float direction = -DirectX::XM_PIDIV2;
+		float spread = DirectX::XM_PI / 6.0f;
+		// 初速の範囲
+		float speedMin = 50.0f;
+		float speedMax = 100.0f;
+		// 寿命の範囲（秒）
+		float lifeMin = 1.0f;
+		float lifeMax = 2.0f;
+		// 加速度
+		DirectX::XMFLOAT2 acceleration = {0, 0};
+		// 発生時と消滅時の色（寿命に応じて補間）
+		DirectX::XMFLOAT4 startColor = {1, 1, 1, 1};
+		DirectX::XMFLOAT4 endColor = {1, 1, 1, 0};
+		// 発生時と消滅時の大きさ（寿命に応じて補間）
+		float startSize = 16.0f;
+		float endSize = 16.0f;
+		// テクスチャハンドルとUV範囲（左、上、右、下）
+		uint32_t textureHandle = 0;
+		DirectX::XMFLOAT4 uvRect = {0, 0, 1, 1};
+		// 乱数の種（0以外）
+		uint32_t seed = 1;
+	};
+
+  public: // メンバ関数
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="desc">発生源の設定</param>
+	explicit ParticleEmitter2D(const Desc& desc);
+
+	/// <summary>
+	/// 更新（積分、消滅、発生の順）
+	/// </summary>
+	/// <param name="deltaTime">経過時間（秒）</param>
+	void Update(float deltaTime);
+
+	/// <summary>
+	/// まとめて発生させる
+	/// </summary>
+	/// <param name="count">数（空きがなければ減らす）</param>
+	void Burst(uint32_t count);
+
+	/// <summary>
+	/// 全て消す
+	/// </summary>
+	void Clear() { count_ = 0; }
+
+	/// <summary>
+	/// 発生位置の設定
+	/// </summary>
+	/// <param name="position">発生位置</param>
+	void SetPosition(const DirectX::XMFLOAT2& position) { desc_.position = position; }
+
+	/// <summary>
+	/// 1秒あたりの発生数の設定
+	/// </summary>
+	/// <param name="emissionRate">発生数（0なら止める）</param>
+	void SetEmissionRate(float emissionRate) { desc_.emissionRate = emissionRate; }
+
+	/// <summary>
+	/// 設定の取得
+	/// </summary>
+	/// <returns>設定</returns>
+	const Desc& GetDesc() const { return desc_; }
+
+	/// <summary>
+	/// 生きているパーティクル数の取得
+	/// </summary>
+	/// <returns>数</returns>
+	uint32_t GetCount() const { return count_; }
+
+	/// <summary>
+	/// 描画用の配列の取得（寿命から色と大きさを求める）
+	/// </summary>
+	/// <returns>SpriteQuadKernelに渡す配列（GetCount個、次の更新まで有効）</returns>
+	SpriteQuadKernel::Sprites BuildSprites();
+
+  private: // メンバ関数
+	/// <summary>
+	/// 0以上1未満の乱数
+	/// </summary>
+	float NextRandom();
+
+	/// <summary>
+	/// 末尾に1個発生させる（空きがあること）
+	/// </summary>
+	void Spawn();
+
+  private: // メンバ変数
+	// 設定
+	Desc desc_;
+	// 生きている数
+	uint32_t count_ = 0;
+	// 配列の長さ（最大数を4の倍数に切り上げ）
+	uint32_t capacity_ = 0;
+	// 乱数の状態（xorshift32）
+	uint32_t randomState_ = 1;
+	// 発生数の端数
+	float emissionAccumulator_ = 0.0f;
+
+	// パーティクルの状態
+	std::vector<float> positionX_;
+	std::vector<float> positionY_;
+	std::vector<float> velocityX_;
+	std::vector<float> velocityY_;
+	// 残り寿命と、寿命の逆数
+	std::vector<float> life_;
+	std::vector<float> inverseLifetime_;
+
+	// 描画用（大きさと色は寿命から求め、それ以外は全て同じ値）
+	std::vector<float> size_;
+	std::vector<DirectX::XMFLOAT4> color_;
+	std::vector<float> zero_;
+	std::vector<float> half_;
+	std::vector<float> uvLeft_;
+	std::vector<float> uvTop_;
+	std::vector<float> uvRight_;
+	std::vector<float> uvBottom_;
+};
@@ -0,0 +1,45 @@
+﻿#include "ParticleSystem2D.h"
+#include "SpriteBatch.h"
+#include <algorithm>
+#include <cassert>
+
+ParticleEmitter2D* ParticleSystem2D::CreateEmitter(const ParticleEmitter2D::Desc& desc) {
+	emitters_.push_back(std::make_unique<ParticleEmitter2D>(desc));
+	return emitters_.back().get();
+}
+
+void ParticleSystem2D::RemoveEmitter(ParticleEmitter2D* emitter) {
+	auto it = std::find_if(
+	  emitters_.begin(), emitters_.end(),
+	  [emitter](const std::unique_ptr<ParticleEmitter2D>& e) { return e.get() == emitter; });
+	assert(it != emitters_.end());
+	emitters_.erase(it);
+}
+
+void ParticleSystem2D::Update(float deltaTime) {
+	for (const std::unique_ptr<ParticleEmitter2D>& emitter : emitters_) {
+		emitter->Update(deltaTime);
+	}
+}
+
+void ParticleSystem2D::Draw() {
+	SpriteBatch* spriteBatch = SpriteBatch::GetInstance();
+	assert(spriteBatch->IsBegun());
+
+	for (const std::unique_ptr<ParticleEmitter2D>& emitter : emitters_) {
+		if (emitter->GetCount() == 0) {
+			continue;
+		}
+		// 頂点はSpriteBatchがSpriteQuadKernelでまとめて生成する
+		spriteBatch->DrawSprites(
+		  emitter->GetDesc().textureHandle, emitter->BuildSprites(), emitter->GetCount());
+	}
+}
+
+uint32_t ParticleSystem2D::GetParticleCount() const {
+	uint32_t count = 0;
+	for (const std::unique_ptr<ParticleEmitter2D>& emitter : emitters_) {
+		count += emitter->GetCount();
+	}
+	return count;
+}
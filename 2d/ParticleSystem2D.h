@@ -0,0 +1,47 @@
+﻿#pragma once
+
+#include "ParticleEmitter2D.h"
+#include <memory>
+#include <vector>
+
+/// <summary>
+/// 2Dパーティクルの管理
+/// 発生源ごとの全パーティクルをSpriteBatchへ1回の追加でまとめて渡す。
+/// 描画はSprite::PreDraw～PostDrawの間で行う
+/// </summary>
+class ParticleSystem2D {
+  public: // メンバ関数
+	/// <summary>
+	/// 発生源の生成
+	/// </summary>
+	/// <param name="desc">発生源の設定</param>
+	/// <returns>生成した発生源（このクラスが所有する）</returns>
+	ParticleEmitter2D* CreateEmitter(const ParticleEmitter2D::Desc& desc);
+
+	/// <summary>
+	/// 発生源の削除
+	/// </summary>
+	/// <param name="emitter">CreateEmitterで生成した発生源</param>
+	void RemoveEmitter(ParticleEmitter2D* emitter);
+
+	/// <summary>
+	/// 全ての発生源の更新
+	/// </summary>
+	/// <param name="deltaTime">経過時間（秒）</param>
+	void Update(float deltaTime);
+
+	/// <summary>
+	/// 描画（SpriteBatchに追加する）
+	/// </summary>
+	void Draw();
+
+	/// <summary>
+	/// 生きているパーティクル数の合計の取得
+	/// </summary>
+	/// <returns>数</returns>
+	uint32_t GetParticleCount() const;
+
+  private: // メンバ変数
+	// 発生源
+	std::vector<std::unique_ptr<ParticleEmitter2D>> emitters_;
+};
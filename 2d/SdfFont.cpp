@@ -0,0 +1,323 @@
+﻿#include "SdfFont.h"
+#include "DistanceTransform.h"
+#include "RectPacker.h"
+#include "SpriteBatch.h"
+#include "TextureManager.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace {
+
+// 距離変換前の文字の被覆率
+struct GlyphBitmap {
+	std::vector<uint8_t> coverage;
+	uint32_t width = 0;
+	uint32_t height = 0;
+};
+
+// 倍数に切り上げ
+uint32_t AlignUp(uint32_t value, uint32_t alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+SdfFont::~SdfFont() {
+	if (textureHandle_ != UINT32_MAX) {
+		TextureManager::Unload(textureHandle_);
+	}
+}
+
+bool SdfFont::Initialize(const std::wstring& faceName, int weight) {
+	assert(textureHandle_ == UINT32_MAX);
+
+	// 高さを指定してフォントを生成（負の値は内部レディングを除いた文字の高さ）
+	HDC dc = CreateCompatibleDC(nullptr);
+	HFONT font = CreateFontW(
+	  -kRasterSize, 0, 0, 0, weight, FALSE, FALSE, FALSE, DEFAULT_CHARSET, OUT_TT_PRECIS,
+	  CLIP_DEFAULT_PRECIS, ANTIALIASED_QUALITY, DEFAULT_PITCH | FF_DONTCARE, faceName.c_str());
+	if (dc == nullptr || font == nullptr) {
+		if (dc) {
+			DeleteDC(dc);
+		}
+		return false;
+	}
+	HGDIOBJ oldFont = SelectObject(dc, font);
+
+	// 行の情報
+	TEXTMETRICW textMetric{};
+	GetTextMetricsW(dc, &textMetric);
+	lineHeight_ = float(textMetric.tmHeight + textMetric.tmExternalLeading) / kRasterSize;
+	ascent_ = float(textMetric.tmAscent) / kRasterSize;
+
+	// 距離を記録する範囲の余白（輪郭を取る解像度）
+	const uint32_t padding = kSpread * kDownsample;
+
+	// 文字ごとに被覆率を取得（GDIは並列に使わない）
+	const MAT2 identity = {{0, 1}, {0, 0}, {0, 0}, {0, 1}};
+	std::vector<GlyphBitmap> bitmaps(glyphs_.size());
+	for (size_t i = 0; i < glyphs_.size(); i++) {
+		UINT character = UINT(kFirstChar + i);
+		GLYPHMETRICS metrics{};
+		DWORD size =
+		  GetGlyphOutlineW(dc, character, GGO_GRAY8_BITMAP, &metrics, 0, nullptr, &identity);
+		if (size == GDI_ERROR) {
+			continue;
+		}
+		glyphs_[i].advance = float(metrics.gmCellIncX) / kRasterSize;
+		if (size == 0) {
+			// 空白など形のない文字
+			continue;
+		}
+
+		std::vector<uint8_t> buffer(size);
+		GetGlyphOutlineW(
+		  dc, character, GGO_GRAY8_BITMAP, &metrics, size, buffer.data(), &identity);
+
+		// 余白を付け、縮小率の倍数に揃えて0～255に広げる（GDIは0～64、行は4バイト境界）
+		GlyphBitmap& bitmap = bitmaps[i];
+		bitmap.width = AlignUp(metrics.gmBlackBoxX + padding * 2, kDownsample);
+		bitmap.height = AlignUp(metrics.gmBlackBoxY + padding * 2, kDownsample);
+		bitmap.coverage.assign(size_t(bitmap.width) * bitmap.height, 0);
+		uint32_t pitch = (metrics.gmBlackBoxX + 3) & ~3u;
+		for (uint32_t y = 0; y < metrics.gmBlackBoxY; y++) {
+			for (uint32_t x = 0; x < metrics.gmBlackBoxX; x++) {
+				uint32_t value = buffer[size_t(y) * pitch + x];
+				bitmap.coverage[size_t(y + padding) * bitmap.width + x + padding] =
+				  uint8_t((std::min)(value * 255 / 64, 255u));
+			}
+		}
+
+		// ベースライン上のペン位置から余白込みの左上まで
+		glyphs_[i].offset = {
+		  float(metrics.gmptGlyphOrigin.x - int(padding)) / kRasterSize,
+		  float(-metrics.gmptGlyphOrigin.y - int(padding)) / kRasterSize};
+		glyphs_[i].size = {float(bitmap.width) / kRasterSize, float(bitmap.height) / kRasterSize};
+	}
+
+	// カーニング
+	DWORD pairCount = GetKerningPairsW(dc, 0, nullptr);
+	if (pairCount > 0) {
+		std::vector<KERNINGPAIR> pairs(pairCount);
+		GetKerningPairsW(dc, pairCount, pairs.data());
+		for (const KERNINGPAIR& pair : pairs) {
+			if (
+			  kFirstChar <= pair.wFirst && pair.wFirst <= kLastChar && kFirstChar <= pair.wSecond &&
+			  pair.wSecond <= kLastChar && pair.iKernAmount != 0) {
+				kerning_[uint32_t(pair.wFirst) << 8 | pair.wSecond] =
+				  float(pair.iKernAmount) / kRasterSize;
+			}
+		}
+	}
+
+	SelectObject(dc, oldFont);
+	DeleteObject(font);
+	DeleteDC(dc);
+
+	// 文字ごとに距離変換し、平均を取りながら縮小して0～255に収める（0.5が輪郭）
+	std::vector<std::vector<uint8_t>> fields(glyphs_.size());
+	ThreadPool::GetInstance()->ParallelFor(static_cast<uint32_t>(bitmaps.size()), [&](uint32_t i) {
+		const GlyphBitmap& bitmap = bitmaps[i];
+		if (bitmap.coverage.empty()) {
+			return;
+		}
+		std::vector<float> distances(bitmap.coverage.size());
+		DistanceTransform::ComputeSigned(
+		  bitmap.coverage.data(), bitmap.width, bitmap.height, 128, distances.data());
+
+		uint32_t width = bitmap.width / kDownsample;
+		uint32_t height = bitmap.height / kDownsample;
+		fields[i].resize(size_t(width) * height);
+		for (uint32_t y = 0; y < height; y++) {
+			for (uint32_t x = 0; x < width; x++) {
+				float sum = 0.0f;
+				for (uint32_t sy = 0; sy < kDownsample; sy++) {
+					for (uint32_t sx = 0; sx < kDownsample; sx++) {
+						sum += distances
+						  [size_t(y * kDownsample + sy) * bitmap.width + x * kDownsample + sx];
+					}
+				}
+				// アトラスのピクセル単位の距離
+				float distance = sum / (kDownsample * kDownsample * kDownsample);
+				float value = 0.5f - distance / (2.0f * kSpread);
+				value = (std::min)((std::max)(value, 0.0f), 1.0f);
+				fields[i][size_t(y) * width + x] = uint8_t(value * 255.0f + 0.5f);
+			}
+		}
+	});
+
+	// アトラスに詰め込む（隣の文字が混ざらないように1ピクセル空ける）
+	std::vector<size_t> packedGlyphs;
+	std::vector<RectPacker::Size> sizes;
+	for (size_t i = 0; i < glyphs_.size(); i++) {
+		if (!fields[i].empty()) {
+			packedGlyphs.push_back(i);
+			sizes.push_back(
+			  {bitmaps[i].width / kDownsample + 1, bitmaps[i].height / kDownsample + 1});
+		}
+	}
+	std::vector<RectPacker::Rect> rects;
+	RectPacker::Size atlasSize;
+	if (!RectPacker::PackMinimum(TextureManager::kMaxAtlasSize, sizes, rects, atlasSize)) {
+		return false;
+	}
+
+	std::vector<uint8_t> pixels(size_t(atlasSize.width) * atlasSize.height, 0);
+	for (size_t n = 0; n < packedGlyphs.size(); n++) {
+		size_t i = packedGlyphs[n];
+		const RectPacker::Rect& rect = rects[n];
+		uint32_t width = rect.width - 1;
+		uint32_t height = rect.height - 1;
+		for (uint32_t y = 0; y < height; y++) {
+			std::copy_n(
+			  &fields[i][size_t(y) * width], width,
+			  &pixels[size_t(rect.y + y) * atlasSize.width + rect.x]);
+		}
+		glyphs_[i].uvRect = {
+		  float(rect.x) / atlasSize.width, float(rect.y) / atlasSize.height,
+		  float(rect.x + width) / atlasSize.width, float(rect.y + height) / atlasSize.height};
+	}
+
+	// フォント名と太さごとに1枚
+	char name[256];
+	WideCharToMultiByte(CP_UTF8, 0, faceName.c_str(), -1, name, sizeof(name), nullptr, nullptr);
+	textureHandle_ = TextureManager::CreateFromPixels(
+	  std::string("SdfFont/") + name + "/" + std::to_string(weight), DXGI_FORMAT_R8_UNORM,
+	  atlasSize.width, atlasSize.height, pixels.data(), atlasSize.width);
+
+	return true;
+}
+
+XMFLOAT2 SdfFont::Layout(
+  const std::string& text, const XMFLOAT2& position, float fontSize, float maxWidth,
+  const XMFLOAT4& color, std::vector<SpriteQuadKernel::Vertex>* vertices) {
+	// 折り返し幅を文字の高さ単位に直す
+	float wrapWidth = maxWidth > 0.0f ? maxWidth / fontSize : 0.0f;
+
+	// 行に分ける（単語の途中では折り返さず、1単語で幅を超えるときだけ文字で折り返す）
+	std::vector<std::pair<size_t, size_t>> lines;
+	size_t lineStart = 0;
+	size_t lastSpace = std::string::npos;
+	float penX = 0.0f;
+	for (size_t i = 0; i < text.size(); i++) {
+		unsigned char character = text[i];
+		if (character == '\n') {
+			lines.emplace_back(lineStart, i);
+			lineStart = i + 1;
+			lastSpace = std::string::npos;
+			penX = 0.0f;
+			continue;
+		}
+
+		float advance = GetGlyph(character).advance;
+		if (i > lineStart) {
+			advance += GetKerning(text[i - 1], character);
+		}
+		if (0.0f < wrapWidth && character != ' ' && i > lineStart && wrapWidth < penX + advance) {
+			if (lastSpace != std::string::npos) {
+				// 最後の空白で折り返す（空白は行に含めない）
+				lines.emplace_back(lineStart, lastSpace);
+				lineStart = lastSpace + 1;
+			} else {
+				lines.emplace_back(lineStart, i);
+				lineStart = i;
+			}
+			lastSpace = std::string::npos;
+			penX = MeasureRange(text, lineStart, i);
+			advance = GetGlyph(character).advance;
+			if (i > lineStart) {
+				advance += GetKerning(text[i - 1], character);
+			}
+		}
+
+		if (character == ' ') {
+			lastSpace = i;
+		}
+		penX += advance;
+	}
+	lines.emplace_back(lineStart, text.size());
+
+	// 行ごとに文字の四角形を並べる
+	glyphSprites_.Clear();
+	float width = 0.0f;
+	for (size_t line = 0; line < lines.size(); line++) {
+		float baseline = ascent_ + lineHeight_ * line;
+		penX = 0.0f;
+		for (size_t i = lines[line].first; i < lines[line].second; i++) {
+			unsigned char character = text[i];
+			if (i > lines[line].first) {
+				penX += GetKerning(text[i - 1], character);
+			}
+
+			const Glyph& glyph = GetGlyph(character);
+			if (vertices && glyph.size.x > 0.0f) {
+				glyphSprites_.Add(
+				  {position.x + (penX + glyph.offset.x) * fontSize,
+				   position.y + (baseline + glyph.offset.y) * fontSize},
+				  {glyph.size.x * fontSize, glyph.size.y * fontSize}, 0.0f, {0.0f, 0.0f},
+				  glyph.uvRect, color);
+			}
+			penX += glyph.advance;
+		}
+		width = (std::max)(width, penX);
+	}
+
+	// 頂点生成
+	if (vertices && glyphSprites_.GetCount() > 0) {
+		size_t first = vertices->size();
+		vertices->resize(first + glyphSprites_.GetCount() * 4);
+		SpriteQuadKernel::Generate(
+		  glyphSprites_.GetSprites(), glyphSprites_.GetCount(), vertices->data() + first);
+	}
+
+	return {width * fontSize, lineHeight_ * lines.size() * fontSize};
+}
+
+void SdfFont::Draw(
+  const std::string& text, const XMFLOAT2& position, float fontSize, const XMFLOAT4& color,
+  float maxWidth) {
+	assert(textureHandle_ != UINT32_MAX);
+
+	vertices_.clear();
+	Layout(text, position, fontSize, maxWidth, color, &vertices_);
+	if (vertices_.empty()) {
+		return;
+	}
+
+	// 距離場用のシェーダでまとめて追加し、元のシェーダに戻す
+	SpriteBatch* spriteBatch = SpriteBatch::GetInstance();
+	SpriteBatch::Shader shader = spriteBatch->GetShader();
+	spriteBatch->SetShader(SpriteBatch::Shader::kDistanceField);
+	spriteBatch->DrawQuads(textureHandle_, vertices_.data(), vertices_.size() / 4);
+	spriteBatch->SetShader(shader);
+}
+
+const SdfFont::Glyph& SdfFont::GetGlyph(unsigned char character) const {
+	if (character < kFirstChar || kLastChar < character) {
+		character = '?';
+	}
+	return glyphs_[character - kFirstChar];
+}
+
+float SdfFont::GetKerning(unsigned char first, unsigned char second) const {
+	if (kerning_.empty()) {
+		return 0.0f;
+	}
+	auto it = kerning_.find(uint32_t(first) << 8 | second);
+	return it != kerning_.end() ? it->second : 0.0f;
+}
+
+float SdfFont::MeasureRange(const std::string& text, size_t begin, size_t end) const {
+	float width = 0.0f;
+	for (size_t i = begin; i < end; i++) {
+		if (i > begin) {
+			width += GetKerning(text[i - 1], text[i]);
+		}
+		width += GetGlyph(text[i]).advance;
+	}
+	return width;
+}
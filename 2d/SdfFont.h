@@ -0,0 +1,127 @@
+﻿#pragma once
+
+#include "SpriteQuadKernel.h"
+#include <DirectXMath.h>
+#include <Windows.h>
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// 符号付き距離場（SDF）フォント
+/// 起動時にGDIで文字を大きく描いて距離変換し、縮小してアトラスにまとめる。
+/// どの大きさで描いても輪郭がにじまない。カーニングと幅による折り返しに対応する（ASCIIのみ）
+/// </summary>
+class SdfFont {
+  public: // 定数
+	// 輪郭を取るときの文字の高さ（ピクセル）
+	static const int kRasterSize = 128;
+	// アトラスへの縮小率
+	static const int kDownsample = 4;
+	// 距離を記録する範囲（アトラスのピクセル。輪郭の内外それぞれ）
+	static const int kSpread = 4;
+	// 収録する文字の範囲
+	static const unsigned char kFirstChar = 32;
+	static const unsigned char kLastChar = 126;
+
+  public: // サブクラス
+	/// <summary>
+	/// 文字の情報（大きさは文字の高さを1とした単位）
+	/// </summary>
+	struct Glyph {
+		// アトラス内のUV範囲（左、上、右、下）
+		DirectX::XMFLOAT4 uvRect = {0, 0, 0, 0};
+		// ペン位置（ベースライン上）から四角形の左上まで
+		DirectX::XMFLOAT2 offset = {0, 0};
+		// 四角形の幅、高さ（0なら描かない）
+		DirectX::XMFLOAT2 size = {0, 0};
+		// 次の文字までの送り幅
+		float advance = 0.0f;
+	};
+
+  public: // メンバ関数
+	/// <summary>
+	/// デストラクタ
+	/// </summary>
+	~SdfFont();
+
+	/// <summary>
+	/// 初期化（アトラスを生成する。文字の距離変換はスレッドプールで並列に行う）
+	/// </summary>
+	/// <param name="faceName">フォント名</param>
+	/// <param name="weight">太さ（FW_NORMAL、FW_BOLDなど）</param>
+	/// <returns>成否</returns>
+	bool Initialize(const std::wstring& faceName, int weight = FW_NORMAL);
+
+	/// <summary>
+	/// 文字列を四角形に並べる
+	/// </summary>
+	/// <param name="text">文字列（'\n'で改行）</param>
+	/// <param name="position">左上の座標</param>
+	/// <param name="fontSize">文字の高さ（ピクセル）</param>
+	/// <param name="maxWidth">折り返す幅（0以下なら折り返さない）</param>
+	/// <param name="color">色</param>
+	/// <param name="vertices">頂点の追加先（nullptrなら大きさを測るだけ）</param>
+	/// <returns>並べた範囲の幅、高さ</returns>
+	DirectX::XMFLOAT2 Layout(
+	  const std::string& text, const DirectX::XMFLOAT2& position, float fontSize, float maxWidth,
+	  const DirectX::XMFLOAT4& color, std::vector<SpriteQuadKernel::Vertex>* vertices);
+
+	/// <summary>
+	/// 描画（Sprite::PreDraw～PostDrawの間で呼ぶ）
+	/// </summary>
+	/// <param name="text">文字列（'\n'で改行）</param>
+	/// <param name="position">左上の座標</param>
+	/// <param name="fontSize">文字の高さ（ピクセル）</param>
+	/// <param name="color">色</param>
+	/// <param name="maxWidth">折り返す幅（0以下なら折り返さない）</param>
+	void Draw(
+	  const std::string& text, const DirectX::XMFLOAT2& position, float fontSize,
+	  const DirectX::XMFLOAT4& color = {1, 1, 1, 1}, float maxWidth = 0.0f);
+
+	/// <summary>
+	/// 行の高さの取得
+	/// </summary>
+	/// <param name="fontSize">文字の高さ（ピクセル）</param>
+	/// <returns>行の高さ（ピクセル）</returns>
+	float GetLineHeight(float fontSize) const { return lineHeight_ * fontSize; }
+
+	/// <summary>
+	/// アトラスのテクスチャハンドルの取得
+	/// </summary>
+	/// <returns>テクスチャハンドル</returns>
+	uint32_t GetTextureHandle() const { return textureHandle_; }
+
+  private: // メンバ関数
+	/// <summary>
+	/// 文字の情報の取得（収録していない文字は'?'）
+	/// </summary>
+	const Glyph& GetGlyph(unsigned char character) const;
+
+	/// <summary>
+	/// 2文字の間のカーニングの取得
+	/// </summary>
+	float GetKerning(unsigned char first, unsigned char second) const;
+
+	/// <summary>
+	/// 範囲の文字列の送り幅の合計
+	/// </summary>
+	float MeasureRange(const std::string& text, size_t begin, size_t end) const;
+
+  private: // メンバ変数
+	// アトラスのテクスチャハンドル
+	uint32_t textureHandle_ = UINT32_MAX;
+	// 文字の情報
+	std::array<Glyph, kLastChar - kFirstChar + 1> glyphs_{};
+	// 2文字の組（前の文字 << 8 | 後の文字）からカーニングへの索引
+	std::unordered_map<uint32_t, float> kerning_;
+	// 行の高さ
+	float lineHeight_ = 1.0f;
+	// 行の上端からベースラインまで
+	float ascent_ = 1.0f;
+	// 頂点生成用の文字の配列
+	SpriteQuadKernel::SpriteArrays glyphSprites_;
+	// 描画用の頂点
+	std::vector<SpriteQuadKernel::Vertex> vertices_;
+};
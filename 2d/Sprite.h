@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include "TextureManager.h"
 #include <DirectXMath.h>
 #include <Windows.h>
 #include <d3d12.h>
@@ -8,6 +9,8 @@
 
 /// <summary>
 /// スプライト
+/// 描画はSpriteBatchに四角形として追加され、PostDrawでまとめて描かれる。
+/// 設定関数は値を保持するだけで、頂点は描画時にまとめて生成される
 /// </summary>
 class Sprite {
   public:
@@ -22,23 +25,6 @@ class Sprite {
 		kCountOfBlendMode, //!< ブレンドモード数。指定はしない
 	};
 
-  public: // サブクラス
-	/// <summary>
-	/// 頂点データ構造体
-	/// </summary>
-	struct VertexPosUv {
-		DirectX::XMFLOAT3 pos; // xyz座標
-		DirectX::XMFLOAT2 uv;  // uv座標
-	};
-
-	/// <summary>
-	/// 定数バッファ用データ構造体
-	/// </summary>
-	struct ConstBufferData {
-		DirectX::XMFLOAT4 color; // 色 (RGBA)
-		DirectX::XMMATRIX mat;   // ３Ｄ変換行列
-	};
-
   public: // 静的メンバ関数
 	/// <summary>
 	/// 静的初期化
@@ -51,14 +37,14 @@ class Sprite {
 	  const std::wstring& directoryPath = L"Resources/");
 
 	/// <summary>
-	/// 描画前処理
+	/// 描画前処理（SpriteBatchへの追加を開始する）
 	/// </summary>
 	/// <param name="cmdList">描画コマンドリスト</param>
 	static void
 	  PreDraw(ID3D12GraphicsCommandList* cmdList, BlendMode blendMode = BlendMode::kNormal);
 
 	/// <summary>
-	/// 描画後処理
+	/// 描画後処理（追加したスプライトをまとめて描画する）
 	/// </summary>
 	static void PostDraw();
 
@@ -76,23 +62,20 @@ class Sprite {
 	  uint32_t textureHandle, DirectX::XMFLOAT2 position, DirectX::XMFLOAT4 color = {1, 1, 1, 1},
 	  DirectX::XMFLOAT2 anchorpoint = {0.0f, 0.0f}, bool isFlipX = false, bool isFlipY = false);
 
-  private: // 静的メンバ変数
-	// 頂点数
-	static const int kVertNum = 4;
-	// デバイス
-	static ID3D12Device* sDevice_;
-	// デスクリプタサイズ
-	static UINT sDescriptorHandleIncrementSize_;
-	// コマンドリスト
-	static ID3D12GraphicsCommandList* sCommandList_;
-	// ルートシグネチャ
-	static Microsoft::WRL::ComPtr<ID3D12RootSignature> sRootSignature_;
-	// パイプラインステートオブジェクト
-	static std::array<
-	  Microsoft::WRL::ComPtr<ID3D12PipelineState>, size_t(BlendMode::kCountOfBlendMode)>
-	  sPipelineStates_;
-	// 射影行列
-	static DirectX::XMMATRIX sMatProjection_;
+	/// <summary>
+	/// アトラス内の画像からスプライト生成
+	/// </summary>
+	/// <param name="region">アトラス内の画像の範囲</param>
+	/// <param name="position">座標</param>
+	/// <param name="color">色</param>
+	/// <param name="anchorpoint">アンカーポイント</param>
+	/// <param name="isFlipX">左右反転</param>
+	/// <param name="isFlipY">上下反転</param>
+	/// <returns>生成されたスプライト</returns>
+	static Sprite* Create(
+	  const TextureManager::AtlasRegion& region, DirectX::XMFLOAT2 position,
+	  DirectX::XMFLOAT4 color = {1, 1, 1, 1}, DirectX::XMFLOAT2 anchorpoint = {0.0f, 0.0f},
+	  bool isFlipX = false, bool isFlipY = false);
 
   public: // メンバ関数
 	/// <summary>
@@ -176,6 +159,14 @@ class Sprite {
 
 	bool GetIsFlipY() { return isFlipY_; }
 
+	/// <summary>
+	/// レイヤーの設定（小さいほど奥。同じレイヤーは描画した順）
+	/// </summary>
+	/// <param name="layer">レイヤー</param>
+	void SetLayer(int16_t layer) { layer_ = layer; }
+
+	int16_t GetLayer() { return layer_; }
+
 	/// <summary>
 	/// テクスチャ範囲設定
 	/// </summary>
@@ -184,21 +175,23 @@ class Sprite {
 	void SetTextureRect(const DirectX::XMFLOAT2& texBase, const DirectX::XMFLOAT2& texSize);
 
 	/// <summary>
-	/// 描画
+	/// アトラス内の画像の設定（テクスチャと範囲を差し替える。サイズは変えない）
+	/// </summary>
+	/// <param name="region">アトラス内の画像の範囲</param>
+	void SetAtlasRegion(const TextureManager::AtlasRegion& region);
+
+	/// <summary>
+	/// 描画（SpriteBatchに追加する）
 	/// </summary>
 	void Draw();
 
+  private: // メンバ関数
+	/// <summary>
+	/// テクスチャのリソース設定と読み込み世代を読み直す
+	/// </summary>
+	void UpdateResourceDesc();
+
   private: // メンバ変数
-	// 頂点バッファ
-	Microsoft::WRL::ComPtr<ID3D12Resource> vertBuff_;
-	// 定数バッファ
-	Microsoft::WRL::ComPtr<ID3D12Resource> constBuff_;
-	// 頂点バッファマップ
-	VertexPosUv* vertMap_ = nullptr;
-	// 定数バッファマップ
-	ConstBufferData* constMap_ = nullptr;
-	// 頂点バッファビュー
-	D3D12_VERTEX_BUFFER_VIEW vbView_{};
 	// テクスチャ番号
 	UINT textureHandle_ = 0;
 	// Z軸回りの回転角
@@ -209,24 +202,27 @@ class Sprite {
 	DirectX::XMFLOAT2 size_ = {100.0f, 100.0f};
 	// アンカーポイント
 	DirectX::XMFLOAT2 anchorPoint_ = {0, 0};
-	// ワールド行列
-	DirectX::XMMATRIX matWorld_{};
 	// 色
 	DirectX::XMFLOAT4 color_ = {1, 1, 1, 1};
 	// 左右反転
 	bool isFlipX_ = false;
 	// 上下反転
 	bool isFlipY_ = false;
+	// レイヤー
+	int16_t layer_ = 0;
 	// テクスチャ始点
 	DirectX::XMFLOAT2 texBase_ = {0, 0};
 	// テクスチャ幅、高さ
 	DirectX::XMFLOAT2 texSize_ = {100.0f, 100.0f};
 	// リソース設定
 	D3D12_RESOURCE_DESC resourceDesc_;
-
-  private: // メンバ関数
-	/// <summary>
-	/// 頂点データ転送
-	/// </summary>
-	void TransferVertices();
+	// リソース設定を読んだときのテクスチャの読み込み世代
+	uint32_t textureGeneration_ = 0;
+	// サイズ、テクスチャ範囲をテクスチャの大きさに合わせるか（設定するまで）
+	bool isSizeFromTexture_ = false;
+	bool isTexRectFromTexture_ = false;
+	// UV範囲（左、上、右、下）
+	DirectX::XMFLOAT4 uvRect_ = {0, 0, 1, 1};
+	// UV範囲の再計算が必要か（テクスチャかテクスチャ範囲を変えたら立てる）
+	bool isUvRectDirty_ = true;
 };
@@ -0,0 +1,515 @@
+﻿#include "SpriteBatch.h"
+#include "DirectXCommon.h"
+#include "ResourceUploader.h"
+#include "TextureManager.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <d3dcompiler.h>
+#include <d3dx12.h>
+
+#pragma comment(lib, "d3dcompiler.lib")
+
+using namespace DirectX;
+using namespace Microsoft::WRL;
+
+SpriteBatch* SpriteBatch::GetInstance() {
+	static SpriteBatch instance;
+	return &instance;
+}
+
+SpriteBatch::~SpriteBatch() {
+	// GPUが使い終わってからヒープに返す
+	GpuMemoryAllocator::GetInstance()->Release(indexBuff_, indexAllocation_);
+}
+
+void SpriteBatch::Initialize(
+  ID3D12Device* device, int window_width, int window_height, const std::wstring& directoryPath) {
+	// nullptrチェック
+	assert(device);
+
+	device_ = device;
+
+	// パイプライン初期化
+	InitializeGraphicsPipeline(directoryPath);
+
+	// インデックスバッファ生成
+	CreateIndexBuffer();
+
+	// 射影行列計算
+	matProjection_ = XMMatrixOrthographicOffCenterLH(
+	  0.0f, (float)window_width, (float)window_height, 0.0f, 0.0f, 1.0f);
+
+	quads_.reserve(1024);
+	vertices_.reserve(1024 * 4);
+}
+
+void SpriteBatch::Begin(
+  ID3D12GraphicsCommandList* commandList, Sprite::BlendMode blendMode, SortMode sortMode) {
+	// BeginとEndがペアで呼ばれていなければエラー
+	assert(commandList_ == nullptr);
+	assert(commandList);
+
+	commandList_ = commandList;
+	sortMode_ = sortMode;
+	SetBlendMode(blendMode);
+	shader_ = Shader::kTexture;
+	layer_ = 0;
+	quads_.clear();
+	vertices_.clear();
+	sprites_.Clear();
+}
+
+void SpriteBatch::SetBlendMode(Sprite::BlendMode blendMode) {
+	// ブレンドモード設定が間違ってる
+	assert(
+	  0 <= size_t(blendMode) && size_t(blendMode) < size_t(Sprite::BlendMode::kCountOfBlendMode));
+
+	blendMode_ = blendMode;
+}
+
+void SpriteBatch::SetShader(Shader shader) {
+	assert(size_t(shader) < size_t(Shader::kCountOfShader));
+
+	shader_ = shader;
+}
+
+void SpriteBatch::Draw(uint32_t textureHandle, const Vertex (&vertices)[4]) {
+	assert(commandList_);
+
+	// 先に追加されたスプライトの頂点を並びどおりに揃える
+	FlushSprites();
+
+	quads_.push_back({textureHandle, blendMode_, shader_, layer_});
+	vertices_.insert(vertices_.end(), std::begin(vertices), std::end(vertices));
+}
+
+void SpriteBatch::DrawQuads(uint32_t textureHandle, const Vertex* vertices, size_t quadCount) {
+	assert(commandList_);
+
+	FlushSprites();
+
+	quads_.resize(quads_.size() + quadCount, {textureHandle, blendMode_, shader_, layer_});
+	vertices_.insert(vertices_.end(), vertices, vertices + quadCount * 4);
+}
+
+void SpriteBatch::DrawSprite(
+  uint32_t textureHandle, const XMFLOAT2& position, const XMFLOAT2& size, float rotation,
+  const XMFLOAT2& anchorPoint, const XMFLOAT4& uvRect, const XMFLOAT4& color) {
+	assert(commandList_);
+
+	// 頂点の生成はFlushSpritesでまとめて行う
+	quads_.push_back({textureHandle, blendMode_, shader_, layer_});
+	sprites_.Add(position, size, rotation, anchorPoint, uvRect, color);
+}
+
+void SpriteBatch::DrawSprites(
+  uint32_t textureHandle, const SpriteQuadKernel::Sprites& sprites, size_t count) {
+	assert(commandList_);
+
+	FlushSprites();
+
+	quads_.resize(quads_.size() + count, {textureHandle, blendMode_, shader_, layer_});
+	size_t first = vertices_.size();
+	vertices_.resize(first + count * 4);
+	SpriteQuadKernel::Generate(sprites, count, vertices_.data() + first);
+}
+
+void SpriteBatch::End() {
+	assert(commandList_);
+
+	FlushSprites();
+
+	ID3D12GraphicsCommandList* commandList = commandList_;
+	commandList_ = nullptr;
+	drawCallCount_ = 0;
+	vertexWriteCount_ = static_cast<uint32_t>(vertices_.size());
+	if (quads_.empty()) {
+		return;
+	}
+
+	// 描く順番（並べ替えるならキーの基数ソートで。同じキーは追加順のまま）
+	uint32_t quadCount = static_cast<uint32_t>(quads_.size());
+	const uint32_t* order = nullptr;
+	if (sortMode_ != SortMode::kSubmission) {
+		sortKeys_.resize(quadCount);
+		for (uint32_t i = 0; i < quadCount; i++) {
+			sortKeys_[i] = MakeSortKey(quads_[i]);
+		}
+		radixSort_.Sort(sortKeys_.data(), quadCount);
+		// 全て同じキーなら追加順のまま
+		if (radixSort_.GetPassCount() > 0) {
+			order = radixSort_.GetOrder();
+		}
+	}
+	auto quadAt = [this, order](uint32_t i) -> const Quad& { return quads_[order ? order[i] : i]; };
+
+	// 全頂点を現在のフレームのアップロード領域へ書き込む
+	DirectXCommon* dxCommon = DirectXCommon::GetInstance();
+	size_t quadSize = sizeof(Vertex) * 4;
+	LinearAllocator::Allocation vertices = dxCommon->AllocateUpload(quadSize * quadCount);
+	assert(vertices.cpuAddress);
+	if (order == nullptr) {
+		memcpy(vertices.cpuAddress, vertices_.data(), quadSize * quadCount);
+	} else {
+		uint8_t* dst = static_cast<uint8_t*>(vertices.cpuAddress);
+		for (uint32_t i = 0; i < quadCount; i++) {
+			memcpy(dst, &vertices_[size_t(order[i]) * 4], quadSize);
+			dst += quadSize;
+		}
+	}
+
+	// 射影行列
+	LinearAllocator::Allocation constants = dxCommon->AllocateUpload(sizeof(XMMATRIX));
+	assert(constants.cpuAddress);
+	memcpy(constants.cpuAddress, &matProjection_, sizeof(XMMATRIX));
+
+	// 頂点バッファビュー
+	D3D12_VERTEX_BUFFER_VIEW vbView{};
+	vbView.BufferLocation = vertices.gpuAddress;
+	vbView.SizeInBytes = static_cast<UINT>(quadSize * quadCount);
+	vbView.StrideInBytes = sizeof(Vertex);
+
+	// 共通の設定
+	commandList->SetGraphicsRootSignature(rootSignature_.Get());
+	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	commandList->IASetVertexBuffers(0, 1, &vbView);
+	commandList->IASetIndexBuffer(&ibView_);
+	commandList->SetGraphicsRootConstantBufferView(0, constants.gpuAddress);
+
+	// デスクリプタヒープは描画ごとではなくここで1回だけセットする
+	TextureManager* textureManager = TextureManager::GetInstance();
+	textureManager->SetDescriptorHeap(commandList);
+	if (textureManager->IsBindless()) {
+		textureManager->SetGraphicsRootTextureTable(commandList, 2);
+	}
+
+	// テクスチャ、ブレンドモード、シェーダが同じ連続した範囲ごとに描画
+	ID3D12PipelineState* currentPipelineState = nullptr;
+	uint32_t first = 0;
+	while (first < quadCount) {
+		const Quad& head = quadAt(first);
+		uint32_t count = 1;
+		while (first + count < quadCount && count < kMaxQuadsPerDraw) {
+			const Quad& quad = quadAt(first + count);
+			if (
+			  quad.textureHandle != head.textureHandle || quad.blendMode != head.blendMode ||
+			  quad.shader != head.shader) {
+				break;
+			}
+			count++;
+		}
+
+		ID3D12PipelineState* pipelineState =
+		  pipelineStates_[size_t(head.shader)][size_t(head.blendMode)].Get();
+		if (pipelineState != currentPipelineState) {
+			commandList->SetPipelineState(pipelineState);
+			currentPipelineState = pipelineState;
+		}
+		textureManager->SetGraphicsRootTexture(commandList, 1, head.textureHandle);
+		commandList->DrawIndexedInstanced(count * 6, 1, 0, first * 4, 0);
+		drawCallCount_++;
+		RequestMip(head.textureHandle, order, first, count);
+
+		first += count;
+	}
+
+	quads_.clear();
+	vertices_.clear();
+}
+
+void SpriteBatch::FlushSprites() {
+	size_t count = sprites_.GetCount();
+	if (count == 0) {
+		return;
+	}
+
+	// 未生成のスプライトはquads_の末尾に並んでいる
+	size_t first = vertices_.size();
+	assert(first + count * 4 == quads_.size() * 4);
+	vertices_.resize(first + count * 4);
+	SpriteQuadKernel::Generate(sprites_.GetSprites(), count, vertices_.data() + first);
+	sprites_.Clear();
+}
+
+void SpriteBatch::RequestMip(
+  uint32_t textureHandle, const uint32_t* order, uint32_t first, uint32_t count) {
+	TextureManager* textureManager = TextureManager::GetInstance();
+	D3D12_RESOURCE_DESC desc = textureManager->GetResoureDesc(textureHandle);
+	float width = static_cast<float>(desc.Width);
+	float height = static_cast<float>(desc.Height);
+
+	// 四角形の辺（左下→右下、左下→左上）ごとの、テクセルあたりのピクセル数の2乗の最大
+	float maxScaleSq = 0.0f;
+	for (uint32_t i = first; i < first + count; i++) {
+		const Vertex* quad = &vertices_[size_t(order ? order[i] : i) * 4];
+		for (uint32_t corner = 1; corner <= 2; corner++) {
+			float dx = quad[corner].pos.x - quad[0].pos.x;
+			float dy = quad[corner].pos.y - quad[0].pos.y;
+			float du = (quad[corner].uv.x - quad[0].uv.x) * width;
+			float dv = (quad[corner].uv.y - quad[0].uv.y) * height;
+			float texelsSq = du * du + dv * dv;
+			if (texelsSq > 0.0f) {
+				maxScaleSq = (std::max)(maxScaleSq, (dx * dx + dy * dy) / texelsSq);
+			}
+		}
+	}
+
+	// テクスチャ全体を貼ったときの画面上の大きさに換算
+	textureManager->RequestMip(
+	  textureHandle, std::sqrt(maxScaleSq) * (std::max)(width, height));
+}
+
+uint64_t SpriteBatch::MakeSortKey(const Quad& quad) const {
+	// レイヤーは符号なしにずらして上位16bitへ
+	uint64_t layer = uint64_t(uint16_t(quad.layer + 0x8000)) << 48;
+	uint64_t state = uint64_t(quad.shader) << 44 | uint64_t(quad.blendMode) << 40 |
+	                 uint64_t(quad.textureHandle);
+
+	switch (sortMode_) {
+	case SortMode::kLayer:
+		return layer;
+	case SortMode::kTexture:
+		return state;
+	case SortMode::kLayerTexture:
+		return layer | state;
+	default:
+		return 0;
+	}
+}
+
+void SpriteBatch::InitializeGraphicsPipeline(const std::wstring& directoryPath) {
+	HRESULT result = S_FALSE;
+	TextureManager* textureManager = TextureManager::GetInstance();
+	bool bindless = textureManager->IsBindless();
+	ComPtr<ID3DBlob> vsBlob;    // 頂点シェーダオブジェクト
+	ComPtr<ID3DBlob> errorBlob; // エラーオブジェクト
+
+	// 頂点シェーダの読み込みとコンパイル
+	std::wstring vsFile = directoryPath + L"/shaders/SpriteVS.hlsl";
+	result = D3DCompileFromFile(
+	  vsFile.c_str(), // シェーダファイル名
+	  nullptr,
+	  D3D_COMPILE_STANDARD_FILE_INCLUDE, // インクルード可能にする
+	  "main", "vs_5_0", // エントリーポイント名、シェーダーモデル指定
+	  D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION, // デバッグ用設定
+	  0, &vsBlob, &errorBlob);
+	if (FAILED(result)) {
+		// errorBlobからエラー内容をstring型にコピー
+		std::string errstr;
+		errstr.resize(errorBlob->GetBufferSize());
+
+		std::copy_n(
+		  (char*)errorBlob->GetBufferPointer(), errorBlob->GetBufferSize(), errstr.begin());
+		errstr += "\n";
+		// エラー内容を出力ウィンドウに表示
+		OutputDebugStringA(errstr.c_str());
+		exit(1);
+	}
+
+	// ピクセルシェーダの読み込みとコンパイル（種類ごと）
+	const wchar_t* psFileNames[] = {L"/shaders/SpritePS.hlsl", L"/shaders/SpriteSdfPS.hlsl"};
+	static_assert(_countof(psFileNames) == size_t(Shader::kCountOfShader), "shader file");
+	std::array<ComPtr<ID3DBlob>, size_t(Shader::kCountOfShader)> psBlobs;
+	for (size_t i = 0; i < psBlobs.size(); i++) {
+		std::wstring psFile = directoryPath + psFileNames[i];
+		result = D3DCompileFromFile(
+		  psFile.c_str(), // シェーダファイル名
+		  textureManager->GetShaderMacros(),
+		  D3D_COMPILE_STANDARD_FILE_INCLUDE, // インクルード可能にする
+		  "main", bindless ? "ps_5_1" : "ps_5_0", // テクスチャ配列の動的参照は5.1から
+		  D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION, // デバッグ用設定
+		  0, &psBlobs[i], &errorBlob);
+		if (FAILED(result)) {
+			// errorBlobからエラー内容をstring型にコピー
+			std::string errstr;
+			errstr.resize(errorBlob->GetBufferSize());
+
+			std::copy_n(
+			  (char*)errorBlob->GetBufferPointer(), errorBlob->GetBufferSize(), errstr.begin());
+			errstr += "\n";
+			// エラー内容を出力ウィンドウに表示
+			OutputDebugStringA(errstr.c_str());
+
+			exit(1);
+		}
+	}
+
+	// 頂点レイアウト
+	D3D12_INPUT_ELEMENT_DESC inputLayout[] = {
+	  {// xy座標(1行で書いたほうが見やすい)
+	   "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	   D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	  {// uv座標(1行で書いたほうが見やすい)
+	   "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,    0, D3D12_APPEND_ALIGNED_ELEMENT,
+	   D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	  {// 色(1行で書いたほうが見やすい)
+	   "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	   D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	};
+
+	// グラフィックスパイプラインの流れを設定
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC gpipeline{};
+	gpipeline.VS = CD3DX12_SHADER_BYTECODE(vsBlob.Get());
+
+	// サンプルマスク
+	gpipeline.SampleMask = D3D12_DEFAULT_SAMPLE_MASK; // 標準設定
+	// ラスタライザステート
+	gpipeline.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
+	gpipeline.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+	// デプスステンシルステート
+	gpipeline.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
+	gpipeline.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_ALWAYS; // 常に上書きルール
+
+	// 深度バッファのフォーマット
+	gpipeline.DSVFormat = DXGI_FORMAT_D32_FLOAT;
+
+	// 頂点レイアウトの設定
+	gpipeline.InputLayout.pInputElementDescs = inputLayout;
+	gpipeline.InputLayout.NumElements = _countof(inputLayout);
+
+	// 図形の形状設定（三角形）
+	gpipeline.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+
+	gpipeline.NumRenderTargets = 1;                            // 描画対象は1つ
+	gpipeline.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB; // 0～255指定のRGBA
+	gpipeline.SampleDesc.Count = 1; // 1ピクセルにつき1回サンプリング
+
+	// デスクリプタレンジ
+	CD3DX12_DESCRIPTOR_RANGE descRangeSRV;
+	descRangeSRV.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0); // t0 レジスタ
+
+	// バインドレス時はt0から全テクスチャ
+	CD3DX12_DESCRIPTOR_RANGE descRangeTextures;
+	descRangeTextures.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, UINT_MAX, 0);
+
+	// ルートパラメータ
+	CD3DX12_ROOT_PARAMETER rootparams[3] = {};
+	rootparams[0].InitAsConstantBufferView(0, 0, D3D12_SHADER_VISIBILITY_VERTEX);
+	if (bindless) {
+		// テクスチャ番号（b1 レジスタ）
+		rootparams[1].InitAsConstants(1, 1, 0, D3D12_SHADER_VISIBILITY_PIXEL);
+	} else {
+		rootparams[1].InitAsDescriptorTable(1, &descRangeSRV, D3D12_SHADER_VISIBILITY_ALL);
+	}
+	rootparams[2].InitAsDescriptorTable(1, &descRangeTextures, D3D12_SHADER_VISIBILITY_PIXEL);
+
+	// スタティックサンプラー
+	CD3DX12_STATIC_SAMPLER_DESC samplerDesc =
+	  CD3DX12_STATIC_SAMPLER_DESC(0, D3D12_FILTER_MIN_MAG_MIP_LINEAR); // s0 レジスタ
+	samplerDesc.AddressU = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+	samplerDesc.AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+	samplerDesc.AddressW = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+
+	// ルートシグネチャの設定
+	CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc;
+	rootSignatureDesc.Init_1_0(
+	  bindless ? _countof(rootparams) : _countof(rootparams) - 1, rootparams, 1, &samplerDesc,
+	  D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+
+	ComPtr<ID3DBlob> rootSigBlob;
+	// バージョン自動判定のシリアライズ
+	result = D3DX12SerializeVersionedRootSignature(
+	  &rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1_0, &rootSigBlob, &errorBlob);
+	assert(SUCCEEDED(result));
+	// ルートシグネチャの生成
+	result = device_->CreateRootSignature(
+	  0, rootSigBlob->GetBufferPointer(), rootSigBlob->GetBufferSize(),
+	  IID_PPV_ARGS(&rootSignature_));
+	assert(SUCCEEDED(result));
+
+	gpipeline.pRootSignature = rootSignature_.Get();
+
+	// シェーダの種類ごとに、ブレンドモードごとのパイプラインを生成
+	for (size_t shader = 0; shader < psBlobs.size(); shader++) {
+		gpipeline.PS = CD3DX12_SHADER_BYTECODE(psBlobs[shader].Get());
+		auto& pipelineStates = pipelineStates_[shader];
+
+		// レンダーターゲットのブレンド設定。ブレンドなし
+		D3D12_RENDER_TARGET_BLEND_DESC blenddesc{};
+		blenddesc.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL; // RBGA全てのチャンネルを描画
+		blenddesc.BlendEnable = false;
+		gpipeline.BlendState.RenderTarget[0] = blenddesc;
+
+		// グラフィックスパイプラインの生成
+		result = device_->CreateGraphicsPipelineState(
+		  &gpipeline, IID_PPV_ARGS(&pipelineStates[size_t(Sprite::BlendMode::kNone)]));
+		assert(SUCCEEDED(result));
+
+		// 通常αブレンド
+		blenddesc.BlendEnable = true;
+		blenddesc.BlendOp = D3D12_BLEND_OP_ADD;
+		blenddesc.SrcBlend = D3D12_BLEND_SRC_ALPHA;
+		blenddesc.DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+
+		blenddesc.BlendOpAlpha = D3D12_BLEND_OP_ADD;
+		blenddesc.SrcBlendAlpha = D3D12_BLEND_ONE;
+		blenddesc.DestBlendAlpha = D3D12_BLEND_ZERO;
+		gpipeline.BlendState.RenderTarget[0] = blenddesc;
+		result = device_->CreateGraphicsPipelineState(
+		  &gpipeline, IID_PPV_ARGS(&pipelineStates[size_t(Sprite::BlendMode::kNormal)]));
+		assert(SUCCEEDED(result));
+
+		// 加算
+		blenddesc.BlendOp = D3D12_BLEND_OP_ADD;
+		blenddesc.SrcBlend = D3D12_BLEND_SRC_ALPHA;
+		blenddesc.DestBlend = D3D12_BLEND_ONE;
+		gpipeline.BlendState.RenderTarget[0] = blenddesc;
+		result = device_->CreateGraphicsPipelineState(
+		  &gpipeline, IID_PPV_ARGS(&pipelineStates[size_t(Sprite::BlendMode::kAdd)]));
+		assert(SUCCEEDED(result));
+
+		// 減算
+		blenddesc.BlendOp = D3D12_BLEND_OP_REV_SUBTRACT;
+		blenddesc.SrcBlend = D3D12_BLEND_SRC_ALPHA;
+		blenddesc.DestBlend = D3D12_BLEND_ONE;
+		gpipeline.BlendState.RenderTarget[0] = blenddesc;
+		result = device_->CreateGraphicsPipelineState(
+		  &gpipeline, IID_PPV_ARGS(&pipelineStates[size_t(Sprite::BlendMode::kSubtract)]));
+		assert(SUCCEEDED(result));
+
+		// 乗算
+		blenddesc.BlendOp = D3D12_BLEND_OP_ADD;
+		blenddesc.SrcBlend = D3D12_BLEND_ZERO;
+		blenddesc.DestBlend = D3D12_BLEND_SRC_COLOR;
+		gpipeline.BlendState.RenderTarget[0] = blenddesc;
+		result = device_->CreateGraphicsPipelineState(
+		  &gpipeline, IID_PPV_ARGS(&pipelineStates[size_t(Sprite::BlendMode::kMultily)]));
+		assert(SUCCEEDED(result));
+
+		// スクリーン
+		blenddesc.BlendOp = D3D12_BLEND_OP_ADD;
+		blenddesc.SrcBlend = D3D12_BLEND_INV_DEST_COLOR;
+		blenddesc.DestBlend = D3D12_BLEND_ONE;
+		gpipeline.BlendState.RenderTarget[0] = blenddesc;
+		result = device_->CreateGraphicsPipelineState(
+		  &gpipeline, IID_PPV_ARGS(&pipelineStates[size_t(Sprite::BlendMode::kScreen)]));
+		assert(SUCCEEDED(result));
+	}
+}
+
+void SpriteBatch::CreateIndexBuffer() {
+	// 四角形ごとに左下、左上、右下 / 右下、左上、右上の2枚の三角形
+	std::vector<uint16_t> indices(kMaxQuadsPerDraw * 6);
+	for (uint32_t i = 0; i < kMaxQuadsPerDraw; i++) {
+		uint16_t base = static_cast<uint16_t>(i * 4);
+		indices[i * 6 + 0] = base + 0;
+		indices[i * 6 + 1] = base + 1;
+		indices[i * 6 + 2] = base + 2;
+		indices[i * 6 + 3] = base + 2;
+		indices[i * 6 + 4] = base + 1;
+		indices[i * 6 + 5] = base + 3;
+	}
+
+	// DEFAULTヒープに生成し、コピーキューで転送する
+	UINT sizeIB = static_cast<UINT>(sizeof(uint16_t) * indices.size());
+	HRESULT result = ResourceUploader::GetInstance()->UploadBuffer(
+	  indices.data(), sizeIB, indexBuff_, indexAllocation_);
+	assert(SUCCEEDED(result));
+
+	// インデックスバッファビューの作成
+	ibView_.BufferLocation = indexBuff_->GetGPUVirtualAddress();
+	ibView_.Format = DXGI_FORMAT_R16_UINT;
+	ibView_.SizeInBytes = sizeIB;
+}
@@ -0,0 +1,250 @@
+﻿#pragma once
+
+#include "GpuMemoryAllocator.h"
+#include "RadixSort.h"
+#include "Sprite.h"
+#include "SpriteQuadKernel.h"
+#include <DirectXMath.h>
+#include <array>
+#include <d3d12.h>
+#include <string>
+#include <vector>
+#include <wrl.h>
+
+/// <summary>
+/// スプライトのまとめ描画
+/// Begin～Endの間に追加された四角形をフレームごとのアップロード領域の1つの頂点バッファに詰め、
+/// テクスチャとブレンドモードが同じ連続した範囲を1回の描画コマンドで描く
+/// </summary>
+class SpriteBatch {
+  public: // 定数
+	// 1回の描画コマンドで描ける四角形の最大数（16bitインデックスの範囲）
+	static const uint32_t kMaxQuadsPerDraw = 65536 / 4;
+
+  public: // サブクラス
+	// 頂点データ構造体（座標は変換済みのスクリーン座標）
+	using Vertex = SpriteQuadKernel::Vertex;
+
+	/// <summary>
+	/// ピクセルシェーダの種類
+	/// </summary>
+	enum class Shader {
+		kTexture,       //!< テクスチャの色。デフォルト
+		kDistanceField, //!< 符号付き距離場の赤チャンネルを輪郭として描く（SdfFont用）
+
+		kCountOfShader, //!< 種類数。指定はしない
+	};
+
+	/// <summary>
+	/// 並べ替え方法
+	/// </summary>
+	enum class SortMode {
+		kSubmission,   //!< 追加順に描く。連続して同じテクスチャのものだけまとまる
+		kLayer,        //!< レイヤー順。同じレイヤーは追加順。デフォルト
+		kTexture,      //!< シェーダ、ブレンドモード、テクスチャ順に並べ替えてまとめる（重なりの順は崩れる）
+		kLayerTexture, //!< レイヤー順、同じレイヤーの中はkTextureと同じ順
+	};
+
+  public: // メンバ関数
+	/// <summary>
+	/// シングルトンインスタンスの取得
+	/// </summary>
+	/// <returns>シングルトンインスタンス</returns>
+	static SpriteBatch* GetInstance();
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="device">デバイス</param>
+	/// <param name="window_width">画面幅</param>
+	/// <param name="window_height">画面高さ</param>
+	/// <param name="directoryPath">シェーダーのあるディレクトリ</param>
+	void Initialize(
+	  ID3D12Device* device, int window_width, int window_height,
+	  const std::wstring& directoryPath);
+
+	/// <summary>
+	/// 追加の開始
+	/// </summary>
+	/// <param name="commandList">描画コマンドリスト</param>
+	/// <param name="blendMode">ブレンドモード</param>
+	/// <param name="sortMode">並べ替え方法</param>
+	void Begin(
+	  ID3D12GraphicsCommandList* commandList,
+	  Sprite::BlendMode blendMode = Sprite::BlendMode::kNormal,
+	  SortMode sortMode = SortMode::kLayer);
+
+	/// <summary>
+	/// 以降に追加する四角形のブレンドモードの設定
+	/// </summary>
+	/// <param name="blendMode">ブレンドモード</param>
+	void SetBlendMode(Sprite::BlendMode blendMode);
+
+	/// <summary>
+	/// 以降に追加する四角形のピクセルシェーダの設定（Beginでデフォルトに戻る）
+	/// </summary>
+	/// <param name="shader">ピクセルシェーダの種類</param>
+	void SetShader(Shader shader);
+
+	Shader GetShader() const { return shader_; }
+
+	/// <summary>
+	/// 以降に追加する四角形のレイヤーの設定（小さいほど奥。Beginで0に戻る）
+	/// </summary>
+	/// <param name="layer">レイヤー</param>
+	void SetLayer(int16_t layer) { layer_ = layer; }
+
+	int16_t GetLayer() const { return layer_; }
+
+	/// <summary>
+	/// 四角形の追加
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	/// <param name="vertices">頂点（左下、左上、右下、右上の順）</param>
+	void Draw(uint32_t textureHandle, const Vertex (&vertices)[4]);
+
+	/// <summary>
+	/// 同じテクスチャの四角形をまとめて追加
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	/// <param name="vertices">頂点（四角形ごとに左下、左上、右下、右上の順）</param>
+	/// <param name="quadCount">四角形の数</param>
+	void DrawQuads(uint32_t textureHandle, const Vertex* vertices, size_t quadCount);
+
+	/// <summary>
+	/// スプライトの追加（頂点はまとめてSpriteQuadKernelで生成する）
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	/// <param name="position">座標</param>
+	/// <param name="size">幅、高さ（負なら反転）</param>
+	/// <param name="rotation">Z軸回りの回転角</param>
+	/// <param name="anchorPoint">アンカーポイント</param>
+	/// <param name="uvRect">UV範囲（左、上、右、下）</param>
+	/// <param name="color">色</param>
+	void DrawSprite(
+	  uint32_t textureHandle, const DirectX::XMFLOAT2& position, const DirectX::XMFLOAT2& size,
+	  float rotation, const DirectX::XMFLOAT2& anchorPoint, const DirectX::XMFLOAT4& uvRect,
+	  const DirectX::XMFLOAT4& color);
+
+	/// <summary>
+	/// 同じテクスチャのスプライトをまとめて追加
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	/// <param name="sprites">スプライトの配列</param>
+	/// <param name="count">スプライト数</param>
+	void DrawSprites(
+	  uint32_t textureHandle, const SpriteQuadKernel::Sprites& sprites, size_t count);
+
+	/// <summary>
+	/// 追加した四角形を描画して終了
+	/// </summary>
+	void End();
+
+	/// <summary>
+	/// 追加中か
+	/// </summary>
+	/// <returns>Begin～Endの間ならtrue</returns>
+	bool IsBegun() const { return commandList_ != nullptr; }
+
+	/// <summary>
+	/// 直前のEndで発行した描画コマンド数の取得
+	/// </summary>
+	/// <returns>描画コマンド数</returns>
+	uint32_t GetDrawCallCount() const { return drawCallCount_; }
+
+	/// <summary>
+	/// 直前のBegin～Endで書き込んだ頂点数の取得
+	/// </summary>
+	/// <returns>頂点数（四角形ごとに4）</returns>
+	uint32_t GetVertexWriteCount() const { return vertexWriteCount_; }
+
+  private: // サブクラス
+	// 四角形の描画設定
+	struct Quad {
+		uint32_t textureHandle;
+		Sprite::BlendMode blendMode;
+		Shader shader;
+		int16_t layer;
+	};
+
+  private: // メンバ関数
+	SpriteBatch() = default;
+	~SpriteBatch();
+	SpriteBatch(const SpriteBatch&) = delete;
+	SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+	/// <summary>
+	/// グラフィックスパイプラインの生成
+	/// </summary>
+	void InitializeGraphicsPipeline(const std::wstring& directoryPath);
+
+	/// <summary>
+	/// 全ての四角形で共有するインデックスバッファの生成
+	/// </summary>
+	void CreateIndexBuffer();
+
+	/// <summary>
+	/// 追加済みのスプライトの頂点を生成
+	/// </summary>
+	void FlushSprites();
+
+	/// <summary>
+	/// 描画する範囲のテクスチャに、表示している大きさに見合ったミップを要求する
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	/// <param name="order">描く順番（nullptrなら追加順）</param>
+	/// <param name="first">範囲の先頭</param>
+	/// <param name="count">範囲の四角形の数</param>
+	void RequestMip(uint32_t textureHandle, const uint32_t* order, uint32_t first, uint32_t count);
+
+	/// <summary>
+	/// 並べ替え方法に応じた四角形の並べ替えキー
+	/// </summary>
+	/// <param name="quad">四角形</param>
+	/// <returns>キー（上位からレイヤー、シェーダ、ブレンドモード、テクスチャ）</returns>
+	uint64_t MakeSortKey(const Quad& quad) const;
+
+  private: // メンバ変数
+	// デバイス
+	ID3D12Device* device_ = nullptr;
+	// ルートシグネチャ
+	Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature_;
+	// パイプラインステートオブジェクト（シェーダ、ブレンドモードごと）
+	std::array<
+	  std::array<
+	    Microsoft::WRL::ComPtr<ID3D12PipelineState>,
+	    size_t(Sprite::BlendMode::kCountOfBlendMode)>,
+	  size_t(Shader::kCountOfShader)>
+	  pipelineStates_;
+	// インデックスバッファ
+	Microsoft::WRL::ComPtr<ID3D12Resource> indexBuff_;
+	GpuMemoryAllocator::Allocation indexAllocation_;
+	// インデックスバッファビュー
+	D3D12_INDEX_BUFFER_VIEW ibView_{};
+	// 射影行列
+	DirectX::XMMATRIX matProjection_{};
+	// 追加先のコマンドリスト
+	ID3D12GraphicsCommandList* commandList_ = nullptr;
+	// 現在のブレンドモード
+	Sprite::BlendMode blendMode_ = Sprite::BlendMode::kNormal;
+	// 現在のピクセルシェーダ
+	Shader shader_ = Shader::kTexture;
+	// 現在のレイヤー
+	int16_t layer_ = 0;
+	// 並べ替え方法
+	SortMode sortMode_ = SortMode::kLayer;
+	// 並べ替えキー
+	std::vector<uint64_t> sortKeys_;
+	// 並べ替え
+	RadixSort radixSort_;
+	// 追加された四角形
+	std::vector<Quad> quads_;
+	// 追加された四角形の頂点（四角形ごとに4頂点）
+	std::vector<Vertex> vertices_;
+	// 頂点が未生成のスプライト（quads_の末尾に対応する）
+	SpriteQuadKernel::SpriteArrays sprites_;
+	// 直前のEndで発行した描画コマンド数
+	uint32_t drawCallCount_ = 0;
+	// 直前のBegin～Endで書き込んだ頂点数
+	uint32_t vertexWriteCount_ = 0;
+};
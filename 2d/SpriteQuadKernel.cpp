@@ -0,0 +1,169 @@
+﻿#include "SpriteQuadKernel.h"
+#include <cmath>
+
+using namespace DirectX;
+
+namespace {
+
+// 左下、左上、右下、右上
+enum { LB, LT, RB, RT };
+
+// 4要素の読み込み（アライメント不要）
+inline XMVECTOR Load4(const float* source) {
+	return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(source));
+}
+
+// 4枚分の同じ角の頂点を書き込む（x, y, u, v を行にしてからスプライトごとの列に並べ替える）
+inline void StoreCorner(
+  FXMVECTOR x, FXMVECTOR y, FXMVECTOR u, GXMVECTOR v, const XMFLOAT4* color, int corner,
+  SpriteQuadKernel::Vertex* vertices) {
+	XMMATRIX rows = XMMatrixTranspose(XMMATRIX(x, y, u, v));
+	for (int i = 0; i < 4; i++) {
+		SpriteQuadKernel::Vertex& vertex = vertices[i * 4 + corner];
+		XMStoreFloat3(&vertex.pos, XMVectorSelect(g_XMZero, rows.r[i], g_XMSelect1100));
+		XMStoreFloat2(&vertex.uv, XMVectorSwizzle<2, 3, 2, 3>(rows.r[i]));
+		vertex.color = color[i];
+	}
+}
+
+} // namespace
+
+void SpriteQuadKernel::SpriteArrays::Add(
+  const XMFLOAT2& position, const XMFLOAT2& size, float rotation, const XMFLOAT2& anchorPoint,
+  const XMFLOAT4& uvRect, const XMFLOAT4& color) {
+	positionX_.push_back(position.x);
+	positionY_.push_back(position.y);
+	sizeX_.push_back(size.x);
+	sizeY_.push_back(size.y);
+	rotation_.push_back(rotation);
+	anchorX_.push_back(anchorPoint.x);
+	anchorY_.push_back(anchorPoint.y);
+	uvLeft_.push_back(uvRect.x);
+	uvTop_.push_back(uvRect.y);
+	uvRight_.push_back(uvRect.z);
+	uvBottom_.push_back(uvRect.w);
+	color_.push_back(color);
+}
+
+void SpriteQuadKernel::SpriteArrays::Clear() {
+	positionX_.clear();
+	positionY_.clear();
+	sizeX_.clear();
+	sizeY_.clear();
+	rotation_.clear();
+	anchorX_.clear();
+	anchorY_.clear();
+	uvLeft_.clear();
+	uvTop_.clear();
+	uvRight_.clear();
+	uvBottom_.clear();
+	color_.clear();
+}
+
+SpriteQuadKernel::Sprites SpriteQuadKernel::SpriteArrays::GetSprites() const {
+	Sprites sprites;
+	sprites.positionX = positionX_.data();
+	sprites.positionY = positionY_.data();
+	sprites.sizeX = sizeX_.data();
+	sprites.sizeY = sizeY_.data();
+	sprites.rotation = rotation_.data();
+	sprites.anchorX = anchorX_.data();
+	sprites.anchorY = anchorY_.data();
+	sprites.uvLeft = uvLeft_.data();
+	sprites.uvTop = uvTop_.data();
+	sprites.uvRight = uvRight_.data();
+	sprites.uvBottom = uvBottom_.data();
+	sprites.color = color_.data();
+	return sprites;
+}
+
+void SpriteQuadKernel::Generate(const Sprites& sprites, size_t count, Vertex* vertices) {
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4, vertices += 16) {
+		// 回転前の四辺（アンカーポイントを原点にする）
+		XMVECTOR sizeX = Load4(sprites.sizeX + i);
+		XMVECTOR sizeY = Load4(sprites.sizeY + i);
+		XMVECTOR left = XMVectorNegate(XMVectorMultiply(Load4(sprites.anchorX + i), sizeX));
+		XMVECTOR right = XMVectorAdd(left, sizeX);
+		XMVECTOR top = XMVectorNegate(XMVectorMultiply(Load4(sprites.anchorY + i), sizeY));
+		XMVECTOR bottom = XMVectorAdd(top, sizeY);
+
+		// 四辺ごとの回転成分
+		XMVECTOR sinRotation, cosRotation;
+		XMVectorSinCos(&sinRotation, &cosRotation, Load4(sprites.rotation + i));
+		XMVECTOR positionX = Load4(sprites.positionX + i);
+		XMVECTOR positionY = Load4(sprites.positionY + i);
+		XMVECTOR leftX = XMVectorMultiplyAdd(left, cosRotation, positionX);
+		XMVECTOR leftY = XMVectorMultiplyAdd(left, sinRotation, positionY);
+		XMVECTOR rightX = XMVectorMultiplyAdd(right, cosRotation, positionX);
+		XMVECTOR rightY = XMVectorMultiplyAdd(right, sinRotation, positionY);
+		XMVECTOR topX = XMVectorMultiply(top, sinRotation);
+		XMVECTOR topY = XMVectorMultiply(top, cosRotation);
+		XMVECTOR bottomX = XMVectorMultiply(bottom, sinRotation);
+		XMVECTOR bottomY = XMVectorMultiply(bottom, cosRotation);
+
+		// x' = x * cos - y * sin, y' = x * sin + y * cos
+		XMVECTOR uvLeft = Load4(sprites.uvLeft + i);
+		XMVECTOR uvTop = Load4(sprites.uvTop + i);
+		XMVECTOR uvRight = Load4(sprites.uvRight + i);
+		XMVECTOR uvBottom = Load4(sprites.uvBottom + i);
+		const XMFLOAT4* color = sprites.color + i;
+		StoreCorner(
+		  XMVectorSubtract(leftX, bottomX), XMVectorAdd(leftY, bottomY), uvLeft, uvBottom, color,
+		  LB, vertices);
+		StoreCorner(
+		  XMVectorSubtract(leftX, topX), XMVectorAdd(leftY, topY), uvLeft, uvTop, color, LT,
+		  vertices);
+		StoreCorner(
+		  XMVectorSubtract(rightX, bottomX), XMVectorAdd(rightY, bottomY), uvRight, uvBottom,
+		  color, RB, vertices);
+		StoreCorner(
+		  XMVectorSubtract(rightX, topX), XMVectorAdd(rightY, topY), uvRight, uvTop, color, RT,
+		  vertices);
+	}
+
+	// 端数
+	if (i < count) {
+		Sprites rest = sprites;
+		rest.positionX += i;
+		rest.positionY += i;
+		rest.sizeX += i;
+		rest.sizeY += i;
+		rest.rotation += i;
+		rest.anchorX += i;
+		rest.anchorY += i;
+		rest.uvLeft += i;
+		rest.uvTop += i;
+		rest.uvRight += i;
+		rest.uvBottom += i;
+		rest.color += i;
+		GenerateReference(rest, count - i, vertices);
+	}
+}
+
+void SpriteQuadKernel::GenerateReference(const Sprites& sprites, size_t count, Vertex* vertices) {
+	for (size_t i = 0; i < count; i++, vertices += 4) {
+		// 回転前の四辺（アンカーポイントを原点にする）
+		float left = -sprites.anchorX[i] * sprites.sizeX[i];
+		float right = left + sprites.sizeX[i];
+		float top = -sprites.anchorY[i] * sprites.sizeY[i];
+		float bottom = top + sprites.sizeY[i];
+
+		float sinRotation = std::sin(sprites.rotation[i]);
+		float cosRotation = std::cos(sprites.rotation[i]);
+		const float x[4] = {left, left, right, right};
+		const float y[4] = {bottom, top, bottom, top};
+		const float u[4] = {sprites.uvLeft[i], sprites.uvLeft[i], sprites.uvRight[i],
+		                    sprites.uvRight[i]};
+		const float v[4] = {sprites.uvBottom[i], sprites.uvTop[i], sprites.uvBottom[i],
+		                    sprites.uvTop[i]};
+		for (int corner = 0; corner < 4; corner++) {
+			Vertex& vertex = vertices[corner];
+			vertex.pos = {
+			  x[corner] * cosRotation - y[corner] * sinRotation + sprites.positionX[i],
+			  x[corner] * sinRotation + y[corner] * cosRotation + sprites.positionY[i], 0.0f};
+			vertex.uv = {u[corner], v[corner]};
+			vertex.color = sprites.color[i];
+		}
+	}
+}
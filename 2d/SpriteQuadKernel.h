@@ -0,0 +1,108 @@
+﻿#pragma once
+
+#include <DirectXMath.h>
+#include <cstddef>
+#include <vector>
+
+/// <summary>
+/// スプライトの頂点生成
+/// 座標、大きさ、回転、アンカーポイント、UV範囲の配列から、変換済みの四隅の頂点をまとめて書き出す。
+/// SIMD（DirectXMathのSSE）で4枚ずつ処理し、端数はスカラーで処理する
+/// </summary>
+class SpriteQuadKernel {
+  public: // サブクラス
+	/// <summary>
+	/// 頂点データ構造体（座標は変換済みのスクリーン座標）
+	/// </summary>
+	struct Vertex {
+		DirectX::XMFLOAT3 pos;   // xyz座標
+		DirectX::XMFLOAT2 uv;    // uv座標
+		DirectX::XMFLOAT4 color; // 色 (RGBA)
+	};
+
+	/// <summary>
+	/// スプライトの配列（要素ごとに別の配列、いずれもcount個）
+	/// </summary>
+	struct Sprites {
+		const float* positionX; // 座標
+		const float* positionY;
+		const float* sizeX; // 幅、高さ（負なら反転）
+		const float* sizeY;
+		const float* rotation; // Z軸回りの回転角
+		const float* anchorX;  // アンカーポイント
+		const float* anchorY;
+		const float* uvLeft; // UV範囲
+		const float* uvTop;
+		const float* uvRight;
+		const float* uvBottom;
+		const DirectX::XMFLOAT4* color; // 色
+	};
+
+	/// <summary>
+	/// スプライトの配列の保持
+	/// </summary>
+	class SpriteArrays {
+	  public:
+		/// <summary>
+		/// 追加
+		/// </summary>
+		/// <param name="position">座標</param>
+		/// <param name="size">幅、高さ（負なら反転）</param>
+		/// <param name="rotation">Z軸回りの回転角</param>
+		/// <param name="anchorPoint">アンカーポイント</param>
+		/// <param name="uvRect">UV範囲（左、上、右、下）</param>
+		/// <param name="color">色</param>
+		void Add(
+		  const DirectX::XMFLOAT2& position, const DirectX::XMFLOAT2& size, float rotation,
+		  const DirectX::XMFLOAT2& anchorPoint, const DirectX::XMFLOAT4& uvRect,
+		  const DirectX::XMFLOAT4& color);
+
+		/// <summary>
+		/// 全て削除
+		/// </summary>
+		void Clear();
+
+		/// <summary>
+		/// 数の取得
+		/// </summary>
+		/// <returns>スプライト数</returns>
+		size_t GetCount() const { return color_.size(); }
+
+		/// <summary>
+		/// 配列の取得
+		/// </summary>
+		/// <returns>配列（次に追加するまで有効）</returns>
+		Sprites GetSprites() const;
+
+	  private:
+		std::vector<float> positionX_;
+		std::vector<float> positionY_;
+		std::vector<float> sizeX_;
+		std::vector<float> sizeY_;
+		std::vector<float> rotation_;
+		std::vector<float> anchorX_;
+		std::vector<float> anchorY_;
+		std::vector<float> uvLeft_;
+		std::vector<float> uvTop_;
+		std::vector<float> uvRight_;
+		std::vector<float> uvBottom_;
+		std::vector<DirectX::XMFLOAT4> color_;
+	};
+
+  public: // 静的メンバ関数
+	/// <summary>
+	/// 頂点生成（スプライトごとに左下、左上、右下、右上の4頂点）
+	/// </summary>
+	/// <param name="sprites">スプライトの配列</param>
+	/// <param name="count">スプライト数</param>
+	/// <param name="vertices">書き込み先（count * 4 頂点）</param>
+	static void Generate(const Sprites& sprites, size_t count, Vertex* vertices);
+
+	/// <summary>
+	/// 頂点生成（1枚ずつ計算する、検証用の基準）
+	/// </summary>
+	/// <param name="sprites">スプライトの配列</param>
+	/// <param name="count">スプライト数</param>
+	/// <param name="vertices">書き込み先（count * 4 頂点）</param>
+	static void GenerateReference(const Sprites& sprites, size_t count, Vertex* vertices);
+};
@@ -0,0 +1,173 @@
+﻿#include "UiElement.h"
+#include "SdfFont.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace DirectX;
+
+UiElement* UiElement::CreateChild() {
+	children_.emplace_back(new UiElement());
+	UiElement* child = children_.back().get();
+	child->parent_ = this;
+	return child;
+}
+
+void UiElement::RemoveChild(UiElement* child) {
+	auto it = std::find_if(
+	  children_.begin(), children_.end(),
+	  [child](const std::unique_ptr<UiElement>& element) { return element.get() == child; });
+	assert(it != children_.end());
+	children_.erase(it);
+}
+
+void UiElement::Draw() {
+	// 根から呼ぶ
+	assert(parent_ == nullptr);
+
+	rebuildCount_ = 0;
+	if (!isVisible_) {
+		return;
+	}
+
+	SpriteBatch* spriteBatch = SpriteBatch::GetInstance();
+	SpriteBatch::Shader shader = spriteBatch->GetShader();
+	Submit({0, 0}, spriteBatch, rebuildCount_);
+	spriteBatch->SetShader(shader);
+}
+
+void UiElement::SetPosition(const XMFLOAT2& position) {
+	// 頂点の作り直しが必要かは描画時にアンカー位置を比べて決める
+	position_ = position;
+}
+
+void UiElement::SetSize(const XMFLOAT2& size) {
+	size_ = size;
+	isGeometryDirty_ = true;
+}
+
+void UiElement::SetAnchorPoint(const XMFLOAT2& anchorPoint) {
+	anchorPoint_ = anchorPoint;
+	isGeometryDirty_ = true;
+}
+
+void UiElement::SetColor(const XMFLOAT4& color) {
+	color_ = color;
+	isGeometryDirty_ = true;
+}
+
+void UiElement::SetVisible(bool isVisible) {
+	// 非表示の間に親が動いても、表示したときにアンカー位置を比べて作り直す
+	isVisible_ = isVisible;
+}
+
+void UiElement::SetImage(uint32_t textureHandle, const XMFLOAT4& uvRect) {
+	textureHandle_ = textureHandle;
+	uvRect_ = uvRect;
+	isUvRectFromPixels_ = false;
+	isGeometryDirty_ = true;
+}
+
+void UiElement::SetImage(const TextureManager::AtlasRegion& region) {
+	textureHandle_ = region.textureHandle;
+	texBase_ = region.texBase;
+	texSize_ = region.texSize;
+	isUvRectFromPixels_ = true;
+	UpdateUvRect();
+	isGeometryDirty_ = true;
+}
+
+void UiElement::ClearImage() {
+	textureHandle_ = UINT32_MAX;
+	isUvRectFromPixels_ = false;
+	isGeometryDirty_ = true;
+}
+
+void UiElement::SetText(SdfFont* font, const std::string& text, float fontSize, float maxWidth) {
+	// 毎フレーム同じ文字列を設定し直しても作り直さない
+	if (font == font_ && text == text_ && fontSize == fontSize_ && maxWidth == maxWidth_) {
+		return;
+	}
+	font_ = font;
+	text_ = text;
+	fontSize_ = fontSize;
+	maxWidth_ = maxWidth;
+	isGeometryDirty_ = true;
+}
+
+void UiElement::Submit(
+  const XMFLOAT2& parentOrigin, SpriteBatch* spriteBatch, uint32_t& rebuildCount) {
+	// アトラス内の画像は、非同期読み込みが完了したら本来の大きさでUVを求め直す
+	if (
+	  isUvRectFromPixels_ &&
+	  TextureManager::GetInstance()->GetLoadGeneration(textureHandle_) != textureGeneration_) {
+		UpdateUvRect();
+		isGeometryDirty_ = true;
+	}
+
+	// 親が動いたら頂点（スクリーン座標）を作り直す
+	XMFLOAT2 origin = {parentOrigin.x + position_.x, parentOrigin.y + position_.y};
+	bool isMoved = origin.x != origin_.x || origin.y != origin_.y;
+	if (isMoved || isGeometryDirty_) {
+		origin_ = origin;
+		BuildGeometry();
+		isGeometryDirty_ = false;
+		rebuildCount++;
+	}
+
+	// 自身の頂点を範囲ごとに追加（連結し直さないので、変更の手間は変わった要素の分だけ）
+	for (const Run& run : runs_) {
+		spriteBatch->SetShader(run.shader);
+		spriteBatch->DrawQuads(
+		  run.textureHandle, &vertices_[size_t(run.firstQuad) * 4], run.quadCount);
+	}
+
+	for (const std::unique_ptr<UiElement>& child : children_) {
+		if (child->isVisible_) {
+			child->Submit(origin_, spriteBatch, rebuildCount);
+		}
+	}
+}
+
+void UiElement::UpdateUvRect() {
+	// ピクセル単位の範囲をUVに換算
+	TextureManager* textureManager = TextureManager::GetInstance();
+	textureGeneration_ = textureManager->GetLoadGeneration(textureHandle_);
+	const D3D12_RESOURCE_DESC resDesc = textureManager->GetResoureDesc(textureHandle_);
+	float width = static_cast<float>(resDesc.Width);
+	float height = static_cast<float>(resDesc.Height);
+	uvRect_ = {
+	  texBase_.x / width, texBase_.y / height, (texBase_.x + texSize_.x) / width,
+	  (texBase_.y + texSize_.y) / height};
+}
+
+void UiElement::BuildGeometry() {
+	vertices_.clear();
+	runs_.clear();
+
+	// 要素の左上
+	XMFLOAT2 topLeft = {
+	  origin_.x - anchorPoint_.x * size_.x, origin_.y - anchorPoint_.y * size_.y};
+
+	// 画像（左下、左上、右下、右上）
+	if (textureHandle_ != UINT32_MAX) {
+		float right = topLeft.x + size_.x;
+		float bottom = topLeft.y + size_.y;
+		vertices_.push_back({{topLeft.x, bottom, 0.0f}, {uvRect_.x, uvRect_.w}, color_});
+		vertices_.push_back({{topLeft.x, topLeft.y, 0.0f}, {uvRect_.x, uvRect_.y}, color_});
+		vertices_.push_back({{right, bottom, 0.0f}, {uvRect_.z, uvRect_.w}, color_});
+		vertices_.push_back({{right, topLeft.y, 0.0f}, {uvRect_.z, uvRect_.y}, color_});
+		runs_.push_back({textureHandle_, SpriteBatch::Shader::kTexture, 0, 1});
+	}
+
+	// 文字列
+	if (font_ && !text_.empty()) {
+		uint32_t firstQuad = static_cast<uint32_t>(vertices_.size() / 4);
+		font_->Layout(text_, topLeft, fontSize_, maxWidth_, color_, &vertices_);
+		uint32_t quadCount = static_cast<uint32_t>(vertices_.size() / 4) - firstQuad;
+		if (quadCount > 0) {
+			runs_.push_back(
+			  {font_->GetTextureHandle(), SpriteBatch::Shader::kDistanceField, firstQuad,
+			   quadCount});
+		}
+	}
+}
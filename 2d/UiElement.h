@@ -0,0 +1,184 @@
+﻿#pragma once
+
+#include "SpriteBatch.h"
+#include "TextureManager.h"
+#include <DirectXMath.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+class SdfFont;
+
+/// <summary>
+/// 保持型UIの要素
+/// 親からの相対座標で木構造を作り、画像と文字列の頂点を要素ごとに保持する。
+/// 変更のあった要素だけ頂点を作り直し、描画では木をたどって各要素の頂点をSpriteBatchに追加する
+/// （同じテクスチャが続けばSpriteBatchが1回の描画コマンドにまとめる）
+/// </summary>
+class UiElement {
+  public: // サブクラス
+	/// <summary>
+	/// 同じテクスチャとシェーダで続けて描く四角形の範囲
+	/// </summary>
+	struct Run {
+		uint32_t textureHandle;
+		SpriteBatch::Shader shader;
+		uint32_t firstQuad;
+		uint32_t quadCount;
+	};
+
+  public: // メンバ関数
+	/// <summary>
+	/// 子要素の生成
+	/// </summary>
+	/// <returns>生成した子要素（この要素が所有する）</returns>
+	UiElement* CreateChild();
+
+	/// <summary>
+	/// 子要素の削除
+	/// </summary>
+	/// <param name="child">子要素</param>
+	void RemoveChild(UiElement* child);
+
+	/// <summary>
+	/// 描画（根の要素で、Sprite::PreDraw～PostDrawの間に呼ぶ）
+	/// 変更のあった要素の頂点を作り直しながら、表示している要素の頂点をSpriteBatchに追加する
+	/// </summary>
+	void Draw();
+
+	/// <summary>
+	/// 座標の設定（親のアンカー位置からの相対座標）
+	/// </summary>
+	/// <param name="position">座標</param>
+	void SetPosition(const DirectX::XMFLOAT2& position);
+
+	const DirectX::XMFLOAT2& GetPosition() const { return position_; }
+
+	/// <summary>
+	/// 大きさの設定
+	/// </summary>
+	/// <param name="size">幅、高さ</param>
+	void SetSize(const DirectX::XMFLOAT2& size);
+
+	const DirectX::XMFLOAT2& GetSize() const { return size_; }
+
+	/// <summary>
+	/// アンカーポイントの設定
+	/// </summary>
+	/// <param name="anchorPoint">アンカーポイント</param>
+	void SetAnchorPoint(const DirectX::XMFLOAT2& anchorPoint);
+
+	const DirectX::XMFLOAT2& GetAnchorPoint() const { return anchorPoint_; }
+
+	/// <summary>
+	/// 色の設定
+	/// </summary>
+	/// <param name="color">色</param>
+	void SetColor(const DirectX::XMFLOAT4& color);
+
+	const DirectX::XMFLOAT4& GetColor() const { return color_; }
+
+	/// <summary>
+	/// 表示するかの設定（非表示なら子要素も描かない）
+	/// </summary>
+	/// <param name="isVisible">表示するか</param>
+	void SetVisible(bool isVisible);
+
+	bool IsVisible() const { return isVisible_; }
+
+	/// <summary>
+	/// 画像の設定
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	/// <param name="uvRect">UV範囲（左、上、右、下）</param>
+	void SetImage(uint32_t textureHandle, const DirectX::XMFLOAT4& uvRect = {0, 0, 1, 1});
+
+	/// <summary>
+	/// アトラス内の画像の設定（非同期読み込み中なら完了したときにUVを求め直す）
+	/// </summary>
+	/// <param name="region">アトラス内の画像の範囲</param>
+	void SetImage(const TextureManager::AtlasRegion& region);
+
+	/// <summary>
+	/// 画像をなくす
+	/// </summary>
+	void ClearImage();
+
+	/// <summary>
+	/// 文字列の設定（要素の左上から並べる）
+	/// </summary>
+	/// <param name="font">フォント（要素より長く有効なもの。nullptrなら文字列なし）</param>
+	/// <param name="text">文字列</param>
+	/// <param name="fontSize">文字の高さ（ピクセル）</param>
+	/// <param name="maxWidth">折り返す幅（0以下なら折り返さない）</param>
+	void SetText(SdfFont* font, const std::string& text, float fontSize, float maxWidth = 0.0f);
+
+	const std::string& GetText() const { return text_; }
+
+	/// <summary>
+	/// 直前のDrawで頂点を作り直した要素数の取得（根の要素で呼ぶ）
+	/// </summary>
+	/// <returns>要素数</returns>
+	uint32_t GetRebuildCount() const { return rebuildCount_; }
+
+  private: // メンバ関数
+	/// <summary>
+	/// 部分木の頂点をSpriteBatchに追加（変更のあった要素は作り直す）
+	/// </summary>
+	/// <param name="parentOrigin">親のアンカー位置（スクリーン座標）</param>
+	/// <param name="spriteBatch">追加先</param>
+	/// <param name="rebuildCount">頂点を作り直した要素数の加算先</param>
+	void Submit(
+	  const DirectX::XMFLOAT2& parentOrigin, SpriteBatch* spriteBatch, uint32_t& rebuildCount);
+
+	/// <summary>
+	/// アトラス内の画像の範囲をUVに換算
+	/// </summary>
+	void UpdateUvRect();
+
+	/// <summary>
+	/// 自身の画像と文字列の頂点を作る
+	/// </summary>
+	void BuildGeometry();
+
+  private: // メンバ変数
+	// 親要素
+	UiElement* parent_ = nullptr;
+	// 子要素
+	std::vector<std::unique_ptr<UiElement>> children_;
+	// 親からの相対座標
+	DirectX::XMFLOAT2 position_ = {0, 0};
+	// 幅、高さ
+	DirectX::XMFLOAT2 size_ = {0, 0};
+	// アンカーポイント
+	DirectX::XMFLOAT2 anchorPoint_ = {0, 0};
+	// 色
+	DirectX::XMFLOAT4 color_ = {1, 1, 1, 1};
+	// 表示するか
+	bool isVisible_ = true;
+	// 画像のテクスチャハンドル
+	uint32_t textureHandle_ = UINT32_MAX;
+	// 画像のUV範囲
+	DirectX::XMFLOAT4 uvRect_ = {0, 0, 1, 1};
+	// アトラス内の画像の範囲（ピクセル）。UVはテクスチャの大きさから求める
+	bool isUvRectFromPixels_ = false;
+	DirectX::XMFLOAT2 texBase_ = {0, 0};
+	DirectX::XMFLOAT2 texSize_ = {0, 0};
+	// UVを求めたときのテクスチャの読み込み世代
+	uint32_t textureGeneration_ = 0;
+	// 文字列
+	SdfFont* font_ = nullptr;
+	std::string text_;
+	float fontSize_ = 16.0f;
+	float maxWidth_ = 0.0f;
+
+	// 頂点を作ったときのアンカー位置（スクリーン座標）
+	DirectX::XMFLOAT2 origin_ = {0, 0};
+	// 自身の頂点の作り直しが必要か
+	bool isGeometryDirty_ = true;
+	// 自身の頂点と範囲
+	std::vector<SpriteBatch::Vertex> vertices_;
+	std::vector<Run> runs_;
+	// 直前のDrawで頂点を作り直した要素数
+	uint32_t rebuildCount_ = 0;
+};
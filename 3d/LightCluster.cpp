@@ -0,0 +1,197 @@
+﻿#include "LightCluster.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+using namespace DirectX;
+
+float LightCluster::ComputeRange(const XMFLOAT3& atten, float intensity) {
+	// x + y * d + z * d * d = intensity / cutoff となる距離
+	float limit = intensity / kAttenuationCutoff - atten.x;
+	if (limit <= 0.0f) {
+		return 0.0f;
+	}
+	if (atten.z > 0.0f) {
+		return (-atten.y + std::sqrt(atten.y * atten.y + 4.0f * atten.z * limit)) /
+		       (2.0f * atten.z);
+	}
+	if (atten.y > 0.0f) {
+		return limit / atten.y;
+	}
+	return FLT_MAX;
+}
+
+XMFLOAT2 LightCluster::ComputeSliceParams(float nearZ, float farZ) {
+	float logRatio = std::log(farZ / nearZ);
+	float scale = static_cast<float>(kCountZ) / logRatio;
+	return {scale, -std::log(nearZ) * scale};
+}
+
+void LightCluster::Build(
+  const XMMATRIX& matView, float fovAngleY, float aspectRatio, float nearZ, float farZ,
+  const XMFLOAT4* spheres, const uint32_t* lightIds, uint32_t count, ThreadPool* pool) {
+	tanHalfFovY_ = std::tan(fovAngleY * 0.5f);
+	tanHalfFovX_ = tanHalfFovY_ * aspectRatio;
+	for (uint32_t z = 0; z <= kCountZ; z++) {
+		sliceDepths_[z] = nearZ * std::pow(farZ / nearZ, static_cast<float>(z) / kCountZ);
+	}
+
+	// 境界球の中心をビュー空間へ（4個ずつ、行を列に入れ替えてまとめて変換）
+	viewSpheres_.resize((count + 3) / 4 * 4);
+	XMFLOAT4X4 m;
+	XMStoreFloat4x4(&m, matView);
+	for (uint32_t i = 0; i < count; i += 4) {
+		XMMATRIX rows;
+		for (uint32_t lane = 0; lane < 4; lane++) {
+			rows.r[lane] = i + lane < count ? XMLoadFloat4(&spheres[i + lane]) : XMVectorZero();
+		}
+		XMMATRIX columns = XMMatrixTranspose(rows);
+		XMVECTOR x = columns.r[0];
+		XMVECTOR y = columns.r[1];
+		XMVECTOR z = columns.r[2];
+		XMVECTOR viewX = XMVectorMultiplyAdd(
+		  z, XMVectorReplicate(m._31),
+		  XMVectorMultiplyAdd(
+		    y, XMVectorReplicate(m._21),
+		    XMVectorMultiplyAdd(x, XMVectorReplicate(m._11), XMVectorReplicate(m._41))));
+		XMVECTOR viewY = XMVectorMultiplyAdd(
+		  z, XMVectorReplicate(m._32),
+		  XMVectorMultiplyAdd(
+		    y, XMVectorReplicate(m._22),
+		    XMVectorMultiplyAdd(x, XMVectorReplicate(m._12), XMVectorReplicate(m._42))));
+		XMVECTOR viewZ = XMVectorMultiplyAdd(
+		  z, XMVectorReplicate(m._33),
+		  XMVectorMultiplyAdd(
+		    y, XMVectorReplicate(m._23),
+		    XMVectorMultiplyAdd(x, XMVectorReplicate(m._13), XMVectorReplicate(m._43))));
+		XMMATRIX viewRows = XMMatrixTranspose(XMMATRIX(viewX, viewY, viewZ, columns.r[3]));
+		for (uint32_t lane = 0; lane < 4; lane++) {
+			XMStoreFloat4(&viewSpheres_[i + lane], viewRows.r[lane]);
+		}
+	}
+	viewSpheres_.resize(count);
+	lightIds_.assign(lightIds, lightIds + count);
+
+	// ライトごとに重なる区切りの範囲（視錐台の外は空の範囲にする）
+	XMFLOAT2 sliceParams = ComputeSliceParams(nearZ, farZ);
+	auto sliceOf = [&sliceParams](float depth) {
+		float slice = std::floor(std::log(depth) * sliceParams.x + sliceParams.y);
+		return static_cast<uint32_t>((std::min)((std::max)(slice, 0.0f), kCountZ - 1.0f));
+	};
+	firstSlice_.resize(count);
+	lastSlice_.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		const XMFLOAT4& sphere = viewSpheres_[i];
+		float front = sphere.z - sphere.w;
+		float back = sphere.z + sphere.w;
+		if (back < nearZ || farZ < front) {
+			firstSlice_[i] = 1;
+			lastSlice_[i] = 0;
+			continue;
+		}
+		firstSlice_[i] = front <= nearZ ? 0 : sliceOf(front);
+		lastSlice_[i] = farZ <= back ? kCountZ - 1 : sliceOf(back);
+	}
+
+	// 区切りごとに構築（区切り同士は独立）
+	ranges_.resize(kClusterCount);
+	if (pool) {
+		pool->ParallelFor(kCountZ, [this](uint32_t z) { BuildSlice(z); });
+	} else {
+		for (uint32_t z = 0; z < kCountZ; z++) {
+			BuildSlice(z);
+		}
+	}
+
+	// 区切りの順に連結する
+	indices_.clear();
+	for (uint32_t z = 0; z < kCountZ; z++) {
+		uint32_t base = static_cast<uint32_t>(indices_.size());
+		Range* ranges = &ranges_[GetClusterIndex(0, 0, z)];
+		for (uint32_t i = 0; i < kCountX * kCountY; i++) {
+			ranges[i].offset += base;
+		}
+		indices_.insert(indices_.end(), slices_[z].indices.begin(), slices_[z].indices.end());
+	}
+}
+
+void LightCluster::BuildSlice(uint32_t z) {
+	Slice& slice = slices_[z];
+
+	// この区切りに重なるライトを集める
+	slice.centerX.clear();
+	slice.centerY.clear();
+	slice.centerZ.clear();
+	slice.radiusSq.clear();
+	slice.lightIds.clear();
+	for (uint32_t i = 0; i < viewSpheres_.size(); i++) {
+		if (firstSlice_[i] <= z && z <= lastSlice_[i]) {
+			const XMFLOAT4& sphere = viewSpheres_[i];
+			slice.centerX.push_back(sphere.x);
+			slice.centerY.push_back(sphere.y);
+			slice.centerZ.push_back(sphere.z);
+			slice.radiusSq.push_back(sphere.w * sphere.w);
+			slice.lightIds.push_back(lightIds_[i]);
+		}
+	}
+	uint32_t lightCount = static_cast<uint32_t>(slice.lightIds.size());
+	// 4の倍数まで、どのクラスタにも重ならないライトで埋める
+	uint32_t paddedCount = (lightCount + 3) / 4 * 4;
+	slice.centerX.resize(paddedCount, 0.0f);
+	slice.centerY.resize(paddedCount, 0.0f);
+	slice.centerZ.resize(paddedCount, 0.0f);
+	slice.radiusSq.resize(paddedCount, -1.0f);
+
+	slice.indices.clear();
+	Range* ranges = &ranges_[GetClusterIndex(0, 0, z)];
+	float nearDepth = sliceDepths_[z];
+	float farDepth = sliceDepths_[z + 1];
+	XMVECTOR zero = XMVectorZero();
+	XMVECTOR minZ = XMVectorReplicate(nearDepth);
+	XMVECTOR maxZ = XMVectorReplicate(farDepth);
+
+	for (uint32_t y = 0; y < kCountY; y++) {
+		// タイルの上下端の傾き（正規化デバイス座標 × tan(半視野角)）
+		float bottom = (-1.0f + 2.0f * y / kCountY) * tanHalfFovY_;
+		float top = (-1.0f + 2.0f * (y + 1) / kCountY) * tanHalfFovY_;
+		// 奥行きの範囲でのビュー空間の範囲（傾きの符号で手前と奥のどちらが外側か決まる）
+		XMVECTOR minY = XMVectorReplicate(bottom * (bottom < 0.0f ? farDepth : nearDepth));
+		XMVECTOR maxY = XMVectorReplicate(top * (top > 0.0f ? farDepth : nearDepth));
+
+		for (uint32_t x = 0; x < kCountX; x++) {
+			float left = (-1.0f + 2.0f * x / kCountX) * tanHalfFovX_;
+			float right = (-1.0f + 2.0f * (x + 1) / kCountX) * tanHalfFovX_;
+			XMVECTOR minX = XMVectorReplicate(left * (left < 0.0f ? farDepth : nearDepth));
+			XMVECTOR maxX = XMVectorReplicate(right * (right > 0.0f ? farDepth : nearDepth));
+
+			Range& range = ranges[y * kCountX + x];
+			range.offset = static_cast<uint32_t>(slice.indices.size());
+
+			// 境界球とクラスタの箱の最短距離の2乗を4個ずつ求める
+			for (uint32_t i = 0; i < paddedCount; i += 4) {
+				XMVECTOR cx = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&slice.centerX[i]));
+				XMVECTOR cy = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&slice.centerY[i]));
+				XMVECTOR cz = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&slice.centerZ[i]));
+				XMVECTOR r2 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&slice.radiusSq[i]));
+				XMVECTOR dx = XMVectorMax(
+				  XMVectorMax(XMVectorSubtract(minX, cx), XMVectorSubtract(cx, maxX)), zero);
+				XMVECTOR dy = XMVectorMax(
+				  XMVectorMax(XMVectorSubtract(minY, cy), XMVectorSubtract(cy, maxY)), zero);
+				XMVECTOR dz = XMVectorMax(
+				  XMVectorMax(XMVectorSubtract(minZ, cz), XMVectorSubtract(cz, maxZ)), zero);
+				XMVECTOR distanceSq = XMVectorMultiplyAdd(
+				  dz, dz, XMVectorMultiplyAdd(dy, dy, XMVectorMultiply(dx, dx)));
+
+				uint32_t hits[4];
+				XMStoreInt4(hits, XMVectorLessOrEqual(distanceSq, r2));
+				for (uint32_t lane = 0; lane < 4; lane++) {
+					if (hits[lane]) {
+						slice.indices.push_back(slice.lightIds[i + lane]);
+					}
+				}
+			}
+			range.count = static_cast<uint32_t>(slice.indices.size()) - range.offset;
+		}
+	}
+}
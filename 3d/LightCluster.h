@@ -0,0 +1,125 @@
+﻿#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+/// <summary>
+/// ライトのクラスタ分割
+/// 視錐台を画面の縦横と、奥行き方向に対数で区切った格子（クラスタ）に分け、
+/// ビュー空間の境界球が重なるライトの番号をクラスタごとに並べる。
+/// 奥行きの区切りごとにスレッドを分け、ライト4個ずつSIMDで判定する（結果はスレッド数によらない）
+/// </summary>
+class LightCluster {
+  public: // 定数
+	// 分割数
+	static const uint32_t kCountX = 16;
+	static const uint32_t kCountY = 9;
+	static const uint32_t kCountZ = 24;
+	static const uint32_t kClusterCount = kCountX * kCountY * kCountZ;
+	// 影響範囲とみなす明るさの下限（これより暗くなる距離で打ち切る）
+	static constexpr float kAttenuationCutoff = 1.0f / 256.0f;
+
+  public: // サブクラス
+	/// <summary>
+	/// クラスタのライト番号の範囲
+	/// </summary>
+	struct Range {
+		uint32_t offset; // GetIndices内の先頭
+		uint32_t count;  // 数
+	};
+
+  public: // 静的メンバ関数
+	/// <summary>
+	/// 距離減衰から影響範囲の半径を求める
+	/// </summary>
+	/// <param name="atten">距離減衰係数（1 / (x + y * d + z * d * d)）</param>
+	/// <param name="intensity">明るさ（色の最大成分）</param>
+	/// <returns>半径（減衰しなければ無限大）</returns>
+	static float ComputeRange(const DirectX::XMFLOAT3& atten, float intensity);
+
+	/// <summary>
+	/// ビュー空間の奥行きからクラスタの区切り番号を求める係数（区切り = log(z) * scale + bias）
+	/// </summary>
+	/// <param name="nearZ">深度限界（手前側）</param>
+	/// <param name="farZ">深度限界（奥側）</param>
+	/// <returns>x:scale y:bias</returns>
+	static DirectX::XMFLOAT2 ComputeSliceParams(float nearZ, float farZ);
+
+	/// <summary>
+	/// クラスタ番号の計算
+	/// </summary>
+	/// <returns>(z * kCountY + y) * kCountX + x</returns>
+	static uint32_t GetClusterIndex(uint32_t x, uint32_t y, uint32_t z) {
+		return (z * kCountY + y) * kCountX + x;
+	}
+
+  public: // メンバ関数
+	/// <summary>
+	/// 構築
+	/// </summary>
+	/// <param name="matView">ビュー行列</param>
+	/// <param name="fovAngleY">垂直方向視野角</param>
+	/// <param name="aspectRatio">アスペクト比</param>
+	/// <param name="nearZ">深度限界（手前側）</param>
+	/// <param name="farZ">深度限界（奥側）</param>
+	/// <param name="spheres">ライトのワールド座標の境界球（xyz:中心 w:半径）</param>
+	/// <param name="lightIds">クラスタに並べるライトの番号（境界球ごと）</param>
+	/// <param name="count">ライト数</param>
+	/// <param name="pool">区切りを分けるスレッドプール（nullptrなら呼び出し元だけで行う）</param>
+	void Build(
+	  const DirectX::XMMATRIX& matView, float fovAngleY, float aspectRatio, float nearZ,
+	  float farZ, const DirectX::XMFLOAT4* spheres, const uint32_t* lightIds, uint32_t count,
+	  ThreadPool* pool = nullptr);
+
+	/// <summary>
+	/// クラスタごとの範囲の取得
+	/// </summary>
+	/// <returns>kClusterCount個</returns>
+	const std::vector<Range>& GetRanges() const { return ranges_; }
+
+	/// <summary>
+	/// 全クラスタのライト番号の取得
+	/// </summary>
+	/// <returns>クラスタ番号順に連結したもの</returns>
+	const std::vector<uint32_t>& GetIndices() const { return indices_; }
+
+  private: // サブクラス
+	// 奥行きの区切りごとの作業領域
+	struct Slice {
+		// 区切りに重なるライト（ビュー空間、4の倍数に埋める）
+		std::vector<float> centerX;
+		std::vector<float> centerY;
+		std::vector<float> centerZ;
+		std::vector<float> radiusSq;
+		std::vector<uint32_t> lightIds;
+		// 区切り内で並べたライト番号
+		std::vector<uint32_t> indices;
+	};
+
+  private: // メンバ関数
+	/// <summary>
+	/// 1つの区切りの構築
+	/// </summary>
+	void BuildSlice(uint32_t z);
+
+  private: // メンバ変数
+	// 視野の傾き（tan(半視野角)）
+	float tanHalfFovX_ = 1.0f;
+	float tanHalfFovY_ = 1.0f;
+	// 区切りの境界の奥行き（kCountZ + 1個）
+	float sliceDepths_[kCountZ + 1] = {};
+	// ビュー空間のライト
+	std::vector<DirectX::XMFLOAT4> viewSpheres_;
+	std::vector<uint32_t> lightIds_;
+	// ライトごとの区切りの範囲
+	std::vector<uint32_t> firstSlice_;
+	std::vector<uint32_t> lastSlice_;
+	// 区切りごとの作業領域
+	Slice slices_[kCountZ];
+	// 結果
+	std::vector<Range> ranges_;
+	std::vector<uint32_t> indices_;
+};
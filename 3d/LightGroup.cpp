@@ -1,6 +1,9 @@
 ﻿#include "LightGroup.h"
 #include "DirectXCommon.h"
+#include "ThreadPool.h"
+#include <algorithm>
 #include <assert.h>
+#include <cstring>
 
 using namespace DirectX;
 
@@ -17,106 +20,315 @@ LightGroup* LightGroup::Create() {
 void LightGroup::Initialize() {
 
 	DefaultLightSetting();
+	spotShadowIndices_.fill(-1);
 
-	// ヒーププロパティ
-	CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-	// リソース設定
-	CD3DX12_RESOURCE_DESC resourceDesc =
-	  CD3DX12_RESOURCE_DESC::Buffer((sizeof(ConstBufferData) + 0xff) & ~0xff);
-
-	HRESULT result;
 	// 定数バッファの生成
-	result = DirectXCommon::GetInstance()->GetDevice()->CreateCommittedResource(
-	  &heapProps, // アップロード可能
-	  D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
-	  IID_PPV_ARGS(&constBuff_));
-	assert(SUCCEEDED(result));
-
-	// 定数バッファとのデータリンク
-	result = constBuff_->Map(0, nullptr, (void**)&constMap_);
-	assert(SUCCEEDED(result));
+	constBuffer_.Create();
+	// 点光源とスポットライトの構造化バッファの生成
+	pointLightBuffer_.Create();
+	spotLightBuffer_.Create();
 
 	// 定数バッファへデータ転送
 	TransferConstBuffer();
 }
 
 void LightGroup::Update() {
-	// 値の更新があった時だけ定数バッファに転送する
+	// 値の更新があった時だけ、変えたライトだけを転送する
 	if (dirty_) {
-		TransferConstBuffer();
+		TransferDirtyLights();
 		dirty_ = false;
 	}
 }
 
+void LightGroup::UpdateClusters(const ViewProjection& viewProjection) {
+	DirectXCommon* dxCommon = DirectXCommon::GetInstance();
+	uint64_t frameNumber = dxCommon->GetFrameNumber();
+
+	// 値の更新があれば転送する（境界球も作り直される）
+	Update();
+
+	bool viewChanged =
+	  memcmp(&clusterView_, &viewProjection.matView, sizeof(XMMATRIX)) != 0 ||
+	  memcmp(&clusterProjection_, &viewProjection.matProjection, sizeof(XMMATRIX)) != 0;
+	if (frameNumber == clusterFrameNumber_ && !viewChanged && !clustersDirty_) {
+		return;
+	}
+
+	// 視点かライトが変わったときだけクラスタを作り直す
+	if (viewChanged || clustersDirty_) {
+		cluster_.Build(
+		  viewProjection.matView, viewProjection.fovAngleY, viewProjection.aspectRatio,
+		  viewProjection.nearZ, viewProjection.farZ, lightSpheres_.data(), lightIds_.data(),
+		  static_cast<uint32_t>(lightIds_.size()), ThreadPool::GetInstance());
+		clusterView_ = viewProjection.matView;
+		clusterProjection_ = viewProjection.matProjection;
+		clustersDirty_ = false;
+
+		// 奥行きの区切りの係数は深度限界が変わったときだけ転送する
+		XMFLOAT2 sliceParams =
+		  LightCluster::ComputeSliceParams(viewProjection.nearZ, viewProjection.farZ);
+		const XMFLOAT2& current = constBuffer_.GetData().clusterSliceParams;
+		if (sliceParams.x != current.x || sliceParams.y != current.y) {
+			constBuffer_.Edit(current) = sliceParams;
+		}
+	}
+
+	// クラスタの範囲とライト番号を現在のフレームのアップロード領域へ書き込む
+	const std::vector<LightCluster::Range>& ranges = cluster_.GetRanges();
+	const std::vector<uint32_t>& indices = cluster_.GetIndices();
+	size_t rangesSize = sizeof(LightCluster::Range) * ranges.size();
+	LinearAllocator::Allocation rangesAllocation = dxCommon->AllocateUpload(rangesSize);
+	assert(rangesAllocation.cpuAddress);
+	memcpy(rangesAllocation.cpuAddress, ranges.data(), rangesSize);
+	// 空でも有効なアドレスが要るので最低1要素分確保する
+	size_t indicesSize = sizeof(uint32_t) * indices.size();
+	LinearAllocator::Allocation indicesAllocation =
+	  dxCommon->AllocateUpload((std::max)(indicesSize, sizeof(uint32_t)));
+	assert(indicesAllocation.cpuAddress);
+	if (!indices.empty()) {
+		memcpy(indicesAllocation.cpuAddress, indices.data(), indicesSize);
+	}
+	clusterRangesAddress_ = rangesAllocation.gpuAddress;
+	lightIndicesAddress_ = indicesAllocation.gpuAddress;
+	// オブジェクトごとに選ばない描画で使う空のライト一覧
+	LinearAllocator::Allocation emptyAllocation =
+	  dxCommon->AllocateUpload(sizeof(LightSelector::LightSet));
+	assert(emptyAllocation.cpuAddress);
+	memset(emptyAllocation.cpuAddress, 0, sizeof(LightSelector::LightSet));
+	emptyObjectLightsAddress_ = emptyAllocation.gpuAddress;
+	clusterFrameNumber_ = frameNumber;
+	bindingVersion_++;
+
+	// 並列記録で共有するので、構造化バッファもここで現在のフレームへ転送しておく
+	constBuffer_.GetGPUVirtualAddress();
+	pointLightBuffer_.GetGPUVirtualAddress();
+	spotLightBuffer_.GetGPUVirtualAddress();
+}
+
 void LightGroup::Draw(ID3D12GraphicsCommandList* cmdList, UINT rootParameterIndex) {
+	// UpdateClustersで現在のフレームのクラスタを作っておくこと
+	assert(clusterFrameNumber_ == DirectXCommon::GetInstance()->GetFrameNumber());
+
 	// 定数バッファビューをセット
 	cmdList->SetGraphicsRootConstantBufferView(
-	  rootParameterIndex, constBuff_->GetGPUVirtualAddress());
+	  rootParameterIndex, constBuffer_.GetGPUVirtualAddress());
+	// 点光源、スポットライト、クラスタの範囲、ライト番号のシェーダリソースビューをセット
+	cmdList->SetGraphicsRootShaderResourceView(
+	  rootParameterIndex + 1, pointLightBuffer_.GetGPUVirtualAddress());
+	cmdList->SetGraphicsRootShaderResourceView(
+	  rootParameterIndex + 2, spotLightBuffer_.GetGPUVirtualAddress());
+	cmdList->SetGraphicsRootShaderResourceView(rootParameterIndex + 3, clusterRangesAddress_);
+	cmdList->SetGraphicsRootShaderResourceView(rootParameterIndex + 4, lightIndicesAddress_);
+}
+
+void LightGroup::SelectObjectLights(
+  const XMFLOAT4* spheres, uint32_t count, D3D12_GPU_VIRTUAL_ADDRESS* addresses) {
+	// UpdateClustersで現在のフレームのライトを転送しておくこと
+	DirectXCommon* dxCommon = DirectXCommon::GetInstance();
+	assert(clusterFrameNumber_ == dxCommon->GetFrameNumber());
+
+	if (lightSelection_ != LightSelection::kObject || count == 0) {
+		for (uint32_t i = 0; i < count; i++) {
+			addresses[i] = emptyObjectLightsAddress_;
+		}
+		return;
+	}
+
+	// 作業領域で選んでから、現在のフレームのアップロード領域へまとめて写す
+	objectLightSets_.resize(count);
+	selector_.Select(spheres, count, objectLightSets_.data(), ThreadPool::GetInstance());
+	size_t size = sizeof(LightSelector::LightSet) * count;
+	LinearAllocator::Allocation allocation = dxCommon->AllocateUpload(size);
+	assert(allocation.cpuAddress);
+	memcpy(allocation.cpuAddress, objectLightSets_.data(), size);
+	for (uint32_t i = 0; i < count; i++) {
+		addresses[i] = allocation.gpuAddress + sizeof(LightSelector::LightSet) * i;
+	}
+}
+
+D3D12_GPU_VIRTUAL_ADDRESS LightGroup::SelectObjectLights(const XMFLOAT4& sphere) {
+	D3D12_GPU_VIRTUAL_ADDRESS address = 0;
+	SelectObjectLights(&sphere, 1, &address);
+	return address;
 }
 
 void LightGroup::TransferConstBuffer() {
-	// 環境光
-	constMap_->ambientColor = ambientColor_;
+	// 全てを未転送にして転送する
+	constantsDirty_ = true;
+	dirLightsDirty_.set();
+	pointLightsDirty_.set();
+	spotLightsDirty_.set();
+	circleShadowsDirty_.set();
+	TransferDirtyLights();
+	dirty_ = false;
+}
+
+void LightGroup::TransferDirtyLights() {
+	// 書き換えた範囲だけが、描画時にそれぞれのフレームの領域へ転送される
+	const ConstBufferData& constData = constBuffer_.GetData();
+	// 環境光と点光源とスポットライトの選び方
+	if (constantsDirty_) {
+		constBuffer_.Edit(constData.ambientColor) = ambientColor_;
+		constBuffer_.Edit(constData.objectLightSelection) =
+		  lightSelection_ == LightSelection::kObject ? 1 : 0;
+		constantsDirty_ = false;
+	}
 	// 平行光源
 	for (int i = 0; i < kDirLightNum; i++) {
+		if (!dirLightsDirty_[i]) {
+			continue;
+		}
+		DirectionalLight::ConstBufferData& dirLight = constBuffer_.Edit(constData.dirLights[i]);
 		// ライトが有効なら設定を転送
 		if (dirLights_[i].IsActive()) {
-			constMap_->dirLights[i].active = 1;
-			constMap_->dirLights[i].lightv = -dirLights_[i].GetLightDir();
-			constMap_->dirLights[i].lightcolor = dirLights_[i].GetLightColor();
+			dirLight.active = 1;
+			dirLight.lightv = -dirLights_[i].GetLightDir();
+			dirLight.lightcolor = dirLights_[i].GetLightColor();
 		}
 		// ライトが無効ならライト色を0に
 		else {
-			constMap_->dirLights[i].active = 0;
+			dirLight.active = 0;
 		}
 	}
+	dirLightsDirty_.reset();
+
+	// シャドウマップの番号が変わったスポットライトも転送する
+	if (shadowSpotLightsDirty_) {
+		RebuildShadowSpotLights();
+	}
+
+	// 点光源とスポットライトを変えたら境界球も作り直す
+	bool spheresDirty = pointLightsDirty_.any() || spotLightsDirty_.any();
+
 	// 点光源
-	for (int i = 0; i < kPointLightNum; i++) {
+	const std::array<PointLight::ConstBufferData, kPointLightNum>& pointData =
+	  pointLightBuffer_.GetData();
+	for (int i = 0; pointLightsDirty_.any() && i < kPointLightNum; i++) {
+		if (!pointLightsDirty_[i]) {
+			continue;
+		}
+		PointLight::ConstBufferData& pointLight = pointLightBuffer_.Edit(pointData[i]);
 		// ライトが有効なら設定を転送
 		if (pointLights_[i].IsActive()) {
-			constMap_->pointLights[i].active = 1;
-			constMap_->pointLights[i].lightpos = pointLights_[i].GetLightPos();
-			constMap_->pointLights[i].lightcolor = pointLights_[i].GetLightColor();
-			constMap_->pointLights[i].lightatten = pointLights_[i].GetLightAtten();
+			pointLight.active = 1;
+			pointLight.lightpos = pointLights_[i].GetLightPos();
+			pointLight.lightcolor = pointLights_[i].GetLightColor();
+			pointLight.lightatten = pointLights_[i].GetLightAtten();
 		}
 		// ライトが無効ならライト色を0に
 		else {
-			constMap_->pointLights[i].active = 0;
+			pointLight.active = 0;
 		}
+		pointLightsDirty_.reset(i);
 	}
 	// スポットライト
-	for (int i = 0; i < kSpotLightNum; i++) {
+	const std::array<SpotLight::ConstBufferData, kSpotLightNum>& spotData =
+	  spotLightBuffer_.GetData();
+	for (int i = 0; spotLightsDirty_.any() && i < kSpotLightNum; i++) {
+		if (!spotLightsDirty_[i]) {
+			continue;
+		}
+		SpotLight::ConstBufferData& spotLight = spotLightBuffer_.Edit(spotData[i]);
 		// ライトが有効なら設定を転送
 		if (spotLights_[i].IsActive()) {
-			constMap_->spotLights[i].active = 1;
-			constMap_->spotLights[i].lightv = -spotLights_[i].GetLightDir();
-			constMap_->spotLights[i].lightpos = spotLights_[i].GetLightPos();
-			constMap_->spotLights[i].lightcolor = spotLights_[i].GetLightColor();
-			constMap_->spotLights[i].lightatten = spotLights_[i].GetLightAtten();
-			constMap_->spotLights[i].lightfactoranglecos = spotLights_[i].GetLightFactorAngleCos();
+			spotLight.active = 1;
+			spotLight.lightv = -spotLights_[i].GetLightDir();
+			spotLight.lightpos = spotLights_[i].GetLightPos();
+			spotLight.lightcolor = spotLights_[i].GetLightColor();
+			spotLight.lightatten = spotLights_[i].GetLightAtten();
+			spotLight.lightfactoranglecos = spotLights_[i].GetLightFactorAngleCos();
 		}
 		// ライトが無効ならライト色を0に
 		else {
-			constMap_->spotLights[i].active = 0;
+			spotLight.active = 0;
 		}
+		spotLight.shadowIndex = spotShadowIndices_[i];
+		spotLightsDirty_.reset(i);
 	}
 	// 丸影
 	for (int i = 0; i < kCircleShadowNum; i++) {
+		if (!circleShadowsDirty_[i]) {
+			continue;
+		}
+		CircleShadow::ConstBufferData& circleShadow =
+		  constBuffer_.Edit(constData.circleShadows[i]);
 		// 有効なら設定を転送
 		if (circleShadows_[i].IsActive()) {
-			constMap_->circleShadows[i].active = 1;
-			constMap_->circleShadows[i].dir = -circleShadows_[i].GetDir();
-			constMap_->circleShadows[i].casterPos = circleShadows_[i].GetCasterPos();
-			constMap_->circleShadows[i].distanceCasterLight =
-			  circleShadows_[i].GetDistanceCasterLight();
-			constMap_->circleShadows[i].atten = circleShadows_[i].GetAtten();
-			constMap_->circleShadows[i].factorAngleCos = circleShadows_[i].GetFactorAngleCos();
+			circleShadow.active = 1;
+			circleShadow.dir = -circleShadows_[i].GetDir();
+			circleShadow.casterPos = circleShadows_[i].GetCasterPos();
+			circleShadow.distanceCasterLight = circleShadows_[i].GetDistanceCasterLight();
+			circleShadow.atten = circleShadows_[i].GetAtten();
+			circleShadow.factorAngleCos = circleShadows_[i].GetFactorAngleCos();
 		}
 		// 無効なら色を0に
 		else {
-			constMap_->circleShadows[i].active = 0;
+			circleShadow.active = 0;
+		}
+	}
+	circleShadowsDirty_.reset();
+
+	if (spheresDirty) {
+		RebuildLightSpheres();
+	}
+}
+
+void LightGroup::RebuildLightSpheres() {
+	// 有効な点光源とスポットライトの境界球（距離減衰で十分暗くなるところまで）
+	lightSpheres_.clear();
+	lightIds_.clear();
+	lightAttens_.clear();
+	lightIntensities_.clear();
+	auto addSphere = [this](const XMFLOAT3& pos, const XMFLOAT3& color, const XMFLOAT3& atten,
+	                        uint32_t id) {
+		float intensity = (std::max)((std::max)(color.x, color.y), color.z);
+		float range = LightCluster::ComputeRange(atten, intensity);
+		lightSpheres_.push_back({pos.x, pos.y, pos.z, range});
+		lightIds_.push_back(id);
+		lightAttens_.push_back(atten);
+		lightIntensities_.push_back(intensity);
+	};
+	for (int i = 0; i < kPointLightNum; i++) {
+		if (pointLights_[i].IsActive()) {
+			addSphere(
+			  pointLights_[i].GetLightPos(), pointLights_[i].GetLightColor(),
+			  pointLights_[i].GetLightAtten(), i);
+		}
+	}
+	for (int i = 0; i < kSpotLightNum; i++) {
+		// 角度減衰は考えず、点光源と同じ球で囲む
+		if (spotLights_[i].IsActive()) {
+			addSphere(
+			  spotLights_[i].GetLightPos(), spotLights_[i].GetLightColor(),
+			  spotLights_[i].GetLightAtten(), kPointLightNum + i);
+		}
+	}
+	clustersDirty_ = true;
+
+	// オブジェクトごとのライト選択にも同じライトを渡す
+	selector_.SetLights(
+	  lightSpheres_.data(), lightAttens_.data(), lightIntensities_.data(), lightIds_.data(),
+	  static_cast<uint32_t>(lightIds_.size()));
+}
+
+void LightGroup::RebuildShadowSpotLights() {
+	// 有効で影を落とすものを番号順に上限まで
+	shadowSpotLights_.clear();
+	for (int i = 0; i < kSpotLightNum; i++) {
+		int shadowIndex = -1;
+		if (
+		  spotLights_[i].IsActive() && spotLights_[i].IsCastShadow() &&
+		  shadowSpotLights_.size() < kShadowSpotLightNum) {
+			shadowIndex = static_cast<int>(shadowSpotLights_.size());
+			shadowSpotLights_.push_back(i);
+		}
+		// 番号が変わったものだけ転送し直す
+		if (spotShadowIndices_[i] != shadowIndex) {
+			spotShadowIndices_[i] = shadowIndex;
+			spotLightsDirty_.set(i);
 		}
 	}
+	shadowSpotLightsDirty_ = false;
 }
 
 void LightGroup::DefaultLightSetting() {
@@ -131,10 +343,20 @@ void LightGroup::DefaultLightSetting() {
 	dirLights_[2].SetActive(true);
 	dirLights_[2].SetLightColor({1.0f, 1.0f, 1.0f});
 	dirLights_[2].SetLightDir({-0.5f, +0.1f, -0.2f, 0});
+
+	dirLightsDirty_.set();
+	dirty_ = true;
+}
+
+void LightGroup::SetLightSelection(LightSelection lightSelection) {
+	lightSelection_ = lightSelection;
+	constantsDirty_ = true;
+	dirty_ = true;
 }
 
 void LightGroup::SetAmbientColor(const XMFLOAT3& color) {
 	ambientColor_ = color;
+	constantsDirty_ = true;
 	dirty_ = true;
 }
 
@@ -142,12 +364,15 @@ void LightGroup::SetDirLightActive(int index, bool active) {
 	assert(0 <= index && index < kDirLightNum);
 
 	dirLights_[index].SetActive(active);
+	dirLightsDirty_.set(index);
+	dirty_ = true;
 }
 
 void LightGroup::SetDirLightDir(int index, const XMVECTOR& lightdir) {
 	assert(0 <= index && index < kDirLightNum);
 
 	dirLights_[index].SetLightDir(lightdir);
+	dirLightsDirty_.set(index);
 	dirty_ = true;
 }
 
@@ -155,19 +380,35 @@ void LightGroup::SetDirLightColor(int index, const XMFLOAT3& lightcolor) {
 	assert(0 <= index && index < kDirLightNum);
 
 	dirLights_[index].SetLightColor(lightcolor);
+	dirLightsDirty_.set(index);
 	dirty_ = true;
 }
 
+bool LightGroup::IsDirLightActive(int index) {
+	assert(0 <= index && index < kDirLightNum);
+
+	return dirLights_[index].IsActive();
+}
+
+XMVECTOR LightGroup::GetDirLightDir(int index) {
+	assert(0 <= index && index < kDirLightNum);
+
+	return dirLights_[index].GetLightDir();
+}
+
 void LightGroup::SetPointLightActive(int index, bool active) {
 	assert(0 <= index && index < kPointLightNum);
 
 	pointLights_[index].SetActive(active);
+	pointLightsDirty_.set(index);
+	dirty_ = true;
 }
 
 void LightGroup::SetPointLightPos(int index, const XMFLOAT3& lightpos) {
 	assert(0 <= index && index < kPointLightNum);
 
 	pointLights_[index].SetLightPos(lightpos);
+	pointLightsDirty_.set(index);
 	dirty_ = true;
 }
 
@@ -175,6 +416,7 @@ void LightGroup::SetPointLightColor(int index, const XMFLOAT3& lightcolor) {
 	assert(0 <= index && index < kPointLightNum);
 
 	pointLights_[index].SetLightColor(lightcolor);
+	pointLightsDirty_.set(index);
 	dirty_ = true;
 }
 
@@ -182,6 +424,7 @@ void LightGroup::SetPointLightAtten(int index, const XMFLOAT3& lightAtten) {
 	assert(0 <= index && index < kPointLightNum);
 
 	pointLights_[index].SetLightAtten(lightAtten);
+	pointLightsDirty_.set(index);
 	dirty_ = true;
 }
 
@@ -189,12 +432,16 @@ void LightGroup::SetSpotLightActive(int index, bool active) {
 	assert(0 <= index && index < kSpotLightNum);
 
 	spotLights_[index].SetActive(active);
+	spotLightsDirty_.set(index);
+	shadowSpotLightsDirty_ = true;
+	dirty_ = true;
 }
 
 void LightGroup::SetSpotLightDir(int index, const XMVECTOR& lightdir) {
 	assert(0 <= index && index < kSpotLightNum);
 
 	spotLights_[index].SetLightDir(lightdir);
+	spotLightsDirty_.set(index);
 	dirty_ = true;
 }
 
@@ -202,6 +449,7 @@ void LightGroup::SetSpotLightPos(int index, const XMFLOAT3& lightpos) {
 	assert(0 <= index && index < kSpotLightNum);
 
 	spotLights_[index].SetLightPos(lightpos);
+	spotLightsDirty_.set(index);
 	dirty_ = true;
 }
 
@@ -209,6 +457,7 @@ void LightGroup::SetSpotLightColor(int index, const XMFLOAT3& lightcolor) {
 	assert(0 <= index && index < kSpotLightNum);
 
 	spotLights_[index].SetLightColor(lightcolor);
+	spotLightsDirty_.set(index);
 	dirty_ = true;
 }
 
@@ -216,6 +465,7 @@ void LightGroup::SetSpotLightAtten(int index, const XMFLOAT3& lightAtten) {
 	assert(0 <= index && index < kSpotLightNum);
 
 	spotLights_[index].SetLightAtten(lightAtten);
+	spotLightsDirty_.set(index);
 	dirty_ = true;
 }
 
@@ -223,19 +473,47 @@ void LightGroup::SetSpotLightFactorAngle(int index, const XMFLOAT2& lightFactorA
 	assert(0 <= index && index < kSpotLightNum);
 
 	spotLights_[index].SetLightFactorAngle(lightFactorAngle);
+	spotLightsDirty_.set(index);
 	dirty_ = true;
 }
 
+void LightGroup::SetSpotLightCastShadow(int index, bool castShadow) {
+	assert(0 <= index && index < kSpotLightNum);
+
+	spotLights_[index].SetCastShadow(castShadow);
+	shadowSpotLightsDirty_ = true;
+	dirty_ = true;
+}
+
+LightGroup::ShadowSpotLight LightGroup::GetShadowSpotLight(int shadowIndex) {
+	assert(0 <= shadowIndex && shadowIndex < GetShadowSpotLightCount());
+
+	SpotLight& spotLight = spotLights_[shadowSpotLights_[shadowIndex]];
+	const XMFLOAT3& color = spotLight.GetLightColor();
+	float intensity = (std::max)((std::max)(color.x, color.y), color.z);
+
+	ShadowSpotLight shadowSpotLight;
+	shadowSpotLight.position = spotLight.GetLightPos();
+	XMStoreFloat3(&shadowSpotLight.direction, spotLight.GetLightDir());
+	shadowSpotLight.outerAngleCos = spotLight.GetLightFactorAngleCos().y;
+	// クラスタと同じく、距離減衰で十分暗くなるところまで
+	shadowSpotLight.range = LightCluster::ComputeRange(spotLight.GetLightAtten(), intensity);
+	return shadowSpotLight;
+}
+
 void LightGroup::SetCircleShadowActive(int index, bool active) {
 	assert(0 <= index && index < kCircleShadowNum);
 
 	circleShadows_[index].SetActive(active);
+	circleShadowsDirty_.set(index);
+	dirty_ = true;
 }
 
 void LightGroup::SetCircleShadowCasterPos(int index, const XMFLOAT3& casterPos) {
 	assert(0 <= index && index < kCircleShadowNum);
 
 	circleShadows_[index].SetCasterPos(casterPos);
+	circleShadowsDirty_.set(index);
 	dirty_ = true;
 }
 
@@ -243,6 +521,7 @@ void LightGroup::SetCircleShadowDir(int index, const XMVECTOR& lightdir) {
 	assert(0 <= index && index < kCircleShadowNum);
 
 	circleShadows_[index].SetDir(lightdir);
+	circleShadowsDirty_.set(index);
 	dirty_ = true;
 }
 
@@ -250,6 +529,7 @@ void LightGroup::SetCircleShadowDistanceCasterLight(int index, float distanceCas
 	assert(0 <= index && index < kCircleShadowNum);
 
 	circleShadows_[index].SetDistanceCasterLight(distanceCasterLight);
+	circleShadowsDirty_.set(index);
 	dirty_ = true;
 }
 
@@ -257,6 +537,7 @@ void LightGroup::SetCircleShadowAtten(int index, const XMFLOAT3& lightAtten) {
 	assert(0 <= index && index < kCircleShadowNum);
 
 	circleShadows_[index].SetAtten(lightAtten);
+	circleShadowsDirty_.set(index);
 	dirty_ = true;
 }
 
@@ -264,5 +545,6 @@ void LightGroup::SetCircleShadowFactorAngle(int index, const XMFLOAT2& lightFact
 	assert(0 <= index && index < kCircleShadowNum);
 
 	circleShadows_[index].SetFactorAngle(lightFactorAngle);
+	circleShadowsDirty_.set(index);
 	dirty_ = true;
 }
@@ -6,13 +6,23 @@
 #include <DirectXMath.h>
 #include <d3dx12.h>
 
+#include "FrameUploadBuffer.h"
 #include "DirectionalLight.h"
 #include "PointLight.h"
 #include "SpotLight.h"
 #include "CircleShadow.h"
+#include "LightCluster.h"
+#include "LightSelector.h"
+#include "ViewProjection.h"
+#include <array>
+#include <bitset>
+#include <vector>
 
 /// <summary>
 /// ライト
+/// 点光源とスポットライトは構造化バッファに置き、LightClusterで分けたクラスタごとの番号の一覧から
+/// ピクセルの属するクラスタに重なるものだけをシェーダで計算する。
+/// kObjectに切り替えると、LightSelectorでオブジェクトごとに選んだ上位のライトだけを計算する
 /// </summary>
 class LightGroup
 {
@@ -30,13 +40,38 @@ public: // 定数
 	// 平行光源の数
 	static const int kDirLightNum = 3;
 	// 点光源の数
-	static const int kPointLightNum = 3;
+	static const int kPointLightNum = 1024;
 	// スポットライトの数
-	static const int kSpotLightNum = 3;
+	static const int kSpotLightNum = 1024;
 	// 丸影の数
 	static const int kCircleShadowNum = 1;
+	// 影を落とすスポットライトの最大数（シャドウマップのタイル数）
+	static const int kShadowSpotLightNum = 8;
+	// Drawで使うルートパラメータの数（定数バッファ、点光源、スポットライト、クラスタの範囲、ライト番号）
+	static const UINT kRootParameterCount = 5;
 
 public: // サブクラス
+	/// <summary>
+	/// 点光源とスポットライトの選び方
+	/// </summary>
+	enum class LightSelection {
+		kCluster, //!< ピクセルの属するクラスタに重なるもの。デフォルト
+		kObject,  //!< オブジェクトごとに明るさと距離減衰で選んだ上位LightSelector::kMaxLights個
+	};
+
+	/// <summary>
+	/// 影を落とすスポットライト（シャドウマップの描画用）
+	/// </summary>
+	struct ShadowSpotLight {
+		// ライト座標
+		XMFLOAT3 position;
+		// 光線方向（単位ベクトル）
+		XMFLOAT3 direction;
+		// 減衰終了角度のコサイン
+		float outerAngleCos;
+		// 影響範囲の半径
+		float range;
+	};
 
 	// 定数バッファ用データ構造体
 	struct ConstBufferData
@@ -44,12 +79,13 @@ public: // サブクラス
 		// 環境光の色
 		XMFLOAT3 ambientColor;
 		float pad1;
+		// クラスタの奥行きの区切りを求める係数（区切り = log(z) * x + y）
+		XMFLOAT2 clusterSliceParams;
+		// 1ならクラスタでなくオブジェクトごとに選んだライトを使う
+		uint32_t objectLightSelection;
+		float pad2;
 		// 平行光源用
 		DirectionalLight::ConstBufferData dirLights[kDirLightNum];
-		// 点光源用
-		PointLight::ConstBufferData pointLights[kPointLightNum];
-		// スポットライト用
-		SpotLight::ConstBufferData spotLights[kSpotLightNum];
 		// 丸影用
 		CircleShadow::ConstBufferData circleShadows[kCircleShadowNum];
 	};
@@ -68,20 +104,73 @@ public: // メンバ関数
 	void Initialize();
 
 	/// <summary>
-	/// 更新
+	/// 更新（値を変えたライトだけを転送する）
 	/// </summary>
 	void Update();
 	
 	/// <summary>
-	/// 描画
+	/// クラスタの更新（描画の前にメインスレッドで呼ぶ。同じフレームで視点もライトも変わらなければ何もしない）
+	/// </summary>
+	/// <param name="viewProjection">ビュープロジェクション</param>
+	void UpdateClusters(const ViewProjection& viewProjection);
+
+	/// <summary>
+	/// 描画（rootParameterIndexから順にkRootParameterCount個のルートパラメータをセットする）
 	/// </summary>
 	void Draw(ID3D12GraphicsCommandList* cmdList, UINT rootParameterIndex);
 
 	/// <summary>
-	/// 定数バッファ転送
+	/// Drawでセットする内容の番号を取得（UpdateClustersでアドレスが変わるたびに増える）
+	/// </summary>
+	/// <returns>番号（0はまだ一度もセットできない）</returns>
+	uint64_t GetBindingVersion() const { return bindingVersion_; }
+
+	/// <summary>
+	/// オブジェクトごとのライト選択（UpdateClustersの後にメインスレッドで呼ぶ）
+	/// kClusterのときは選ばずに空の一覧を返す
+	/// </summary>
+	/// <param name="spheres">オブジェクトのワールド座標の境界球（xyz:中心 w:半径）</param>
+	/// <param name="count">オブジェクト数</param>
+	/// <param name="addresses">選んだライトの一覧のGPUアドレス（オブジェクトごと）</param>
+	void SelectObjectLights(
+	  const XMFLOAT4* spheres, uint32_t count, D3D12_GPU_VIRTUAL_ADDRESS* addresses);
+
+	/// <summary>
+	/// 1つのオブジェクトのライト選択（UpdateClustersの後にメインスレッドで呼ぶ）
+	/// </summary>
+	/// <param name="sphere">オブジェクトのワールド座標の境界球（xyz:中心 w:半径）</param>
+	/// <returns>選んだライトの一覧のGPUアドレス</returns>
+	D3D12_GPU_VIRTUAL_ADDRESS SelectObjectLights(const XMFLOAT4& sphere);
+
+	/// <summary>
+	/// 現在のフレームの空のライト一覧のGPUアドレスを取得（オブジェクトごとに選ばない描画用）
+	/// </summary>
+	/// <returns>GPUアドレス</returns>
+	D3D12_GPU_VIRTUAL_ADDRESS GetEmptyObjectLightsAddress() const {
+		return emptyObjectLightsAddress_;
+	}
+
+	/// <summary>
+	/// 定数バッファ転送（全てのライトを転送する）
 	/// </summary>
 	void TransferConstBuffer();
 
+	/// <summary>
+	/// 現在のフレームの定数バッファアドレスを取得
+	/// </summary>
+	/// <returns>GPUアドレス</returns>
+	D3D12_GPU_VIRTUAL_ADDRESS GetGPUVirtualAddress() const {
+		return constBuffer_.GetGPUVirtualAddress();
+	}
+
+	/// <summary>
+	/// 点光源とスポットライトの選び方をセット
+	/// </summary>
+	/// <param name="lightSelection">選び方</param>
+	void SetLightSelection(LightSelection lightSelection);
+
+	LightSelection GetLightSelection() const { return lightSelection_; }
+
 	/// <summary>
 	/// 標準のライト設定
 	/// </summary>
@@ -114,6 +203,20 @@ public: // メンバ関数
 	/// <param name="lightcolor">ライト色</param>
 	void SetDirLightColor(int index, const XMFLOAT3& lightcolor);
 
+	/// <summary>
+	/// 平行光源の有効チェック
+	/// </summary>
+	/// <param name="index">ライト番号</param>
+	/// <returns>有効フラグ</returns>
+	bool IsDirLightActive(int index);
+
+	/// <summary>
+	/// 平行光源のライト方向を取得
+	/// </summary>
+	/// <param name="index">ライト番号</param>
+	/// <returns>ライト方向</returns>
+	XMVECTOR GetDirLightDir(int index);
+
 	/// <summary>
 	/// 点光源の有効フラグをセット
 	/// </summary>
@@ -184,6 +287,26 @@ public: // メンバ関数
 	/// <param name="lightFactorAngle">x:減衰開始角度 y:減衰終了角度</param>
 	void SetSpotLightFactorAngle(int index, const XMFLOAT2& lightFactorAngle);
 
+	/// <summary>
+	/// スポットライトが影を落とすかをセット（有効なものから番号順にkShadowSpotLightNum個まで）
+	/// </summary>
+	/// <param name="index">ライト番号</param>
+	/// <param name="castShadow">影を落とすならtrue</param>
+	void SetSpotLightCastShadow(int index, bool castShadow);
+
+	/// <summary>
+	/// 影を落とすスポットライトの数を取得（Updateの後）
+	/// </summary>
+	/// <returns>数</returns>
+	int GetShadowSpotLightCount() const { return static_cast<int>(shadowSpotLights_.size()); }
+
+	/// <summary>
+	/// 影を落とすスポットライトを取得（Updateの後）
+	/// </summary>
+	/// <param name="shadowIndex">シャドウマップの番号</param>
+	/// <returns>影を落とすスポットライト</returns>
+	ShadowSpotLight GetShadowSpotLight(int shadowIndex);
+
 	/// <summary>
 	/// 丸影の有効フラグをセット
 	/// </summary>
@@ -226,11 +349,29 @@ public: // メンバ関数
 	/// <param name="lightFactorAngle">x:減衰開始角度 y:減衰終了角度</param>
 	void SetCircleShadowFactorAngle(int index, const XMFLOAT2& lightFactorAngle);
 
+private: // メンバ関数
+	/// <summary>
+	/// 値を変えたものだけを転送
+	/// </summary>
+	void TransferDirtyLights();
+
+	/// <summary>
+	/// 有効な点光源とスポットライトの境界球を作り直す
+	/// </summary>
+	void RebuildLightSpheres();
+
+	/// <summary>
+	/// 影を落とすスポットライトにシャドウマップの番号を振り直す
+	/// </summary>
+	void RebuildShadowSpotLights();
+
 private: // メンバ変数
-	// 定数バッファ
-	ComPtr<ID3D12Resource> constBuff_;
-	// 定数バッファのマップ
-	ConstBufferData* constMap_ = nullptr;
+	// 定数バッファ（フレームごとに切り替え）
+	FrameUploadBuffer<ConstBufferData> constBuffer_;
+	// 点光源の構造化バッファ（フレームごとに切り替え）
+	FrameUploadBuffer<std::array<PointLight::ConstBufferData, kPointLightNum>> pointLightBuffer_;
+	// スポットライトの構造化バッファ（フレームごとに切り替え）
+	FrameUploadBuffer<std::array<SpotLight::ConstBufferData, kSpotLightNum>> spotLightBuffer_;
 
 	// 環境光の色
 	XMFLOAT3 ambientColor_ = { 1,1,1 };
@@ -249,5 +390,47 @@ private: // メンバ変数
 
 	// ダーティフラグ
 	bool dirty_ = false;
+	// 値を変えて未転送のもの（環境光と選び方、ライトごと）
+	bool constantsDirty_ = false;
+	std::bitset<kDirLightNum> dirLightsDirty_;
+	std::bitset<kPointLightNum> pointLightsDirty_;
+	std::bitset<kSpotLightNum> spotLightsDirty_;
+	std::bitset<kCircleShadowNum> circleShadowsDirty_;
+	// 影を落とすスポットライトを振り直すか
+	bool shadowSpotLightsDirty_ = false;
+
+	// 影を落とすスポットライトの番号（シャドウマップの番号順）
+	std::vector<int> shadowSpotLights_;
+	// スポットライトごとのシャドウマップの番号（-1なら影なし）
+	std::array<int, kSpotLightNum> spotShadowIndices_;
+
+	// クラスタ分割
+	LightCluster cluster_;
+	// 有効な点光源とスポットライトの境界球と番号（スポットライトはkPointLightNumから）
+	std::vector<XMFLOAT4> lightSpheres_;
+	std::vector<uint32_t> lightIds_;
+	// 有効な点光源とスポットライトの距離減衰係数と明るさ（境界球と同じ順）
+	std::vector<XMFLOAT3> lightAttens_;
+	std::vector<float> lightIntensities_;
+	// 境界球を変えてからクラスタを作り直していないか
+	bool clustersDirty_ = true;
+	// クラスタを作ったときの行列とフレーム番号
+	XMMATRIX clusterView_{};
+	XMMATRIX clusterProjection_{};
+	uint64_t clusterFrameNumber_ = UINT64_MAX;
+	// 現在のフレームのクラスタの範囲とライト番号のGPUアドレス
+	D3D12_GPU_VIRTUAL_ADDRESS clusterRangesAddress_ = 0;
+	D3D12_GPU_VIRTUAL_ADDRESS lightIndicesAddress_ = 0;
+	// Drawでセットする内容の番号
+	uint64_t bindingVersion_ = 0;
+
+	// 点光源とスポットライトの選び方
+	LightSelection lightSelection_ = LightSelection::kCluster;
+	// オブジェクトごとのライト選択
+	LightSelector selector_;
+	// 選んだライトの一覧（アップロード領域へ写す前の作業領域）
+	std::vector<LightSelector::LightSet> objectLightSets_;
+	// 現在のフレームの空のライト一覧のGPUアドレス
+	D3D12_GPU_VIRTUAL_ADDRESS emptyObjectLightsAddress_ = 0;
 };
 
@@ -0,0 +1,128 @@
+﻿#include "LightSelector.h"
+#include "ThreadPool.h"
+#include <algorithm>
+
+using namespace DirectX;
+
+namespace {
+
+// 1つのタスクで選ぶオブジェクト数
+const uint32_t kObjectsPerTask = 256;
+
+// 4個並んだ値の読み込み
+XMVECTOR Load4(const std::vector<float>& values, uint32_t index) {
+	return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&values[index]));
+}
+
+} // namespace
+
+void LightSelector::SetLights(
+  const XMFLOAT4* spheres, const XMFLOAT3* attens, const float* intensities,
+  const uint32_t* lightIds, uint32_t count) {
+	lightCount_ = count;
+
+	// 4の倍数まで、どのオブジェクトにも選ばれない明るさ0のライトで埋める
+	uint32_t paddedCount = (count + 3) / 4 * 4;
+	positionX_.assign(paddedCount, 0.0f);
+	positionY_.assign(paddedCount, 0.0f);
+	positionZ_.assign(paddedCount, 0.0f);
+	range_.assign(paddedCount, 0.0f);
+	attenX_.assign(paddedCount, 1.0f);
+	attenY_.assign(paddedCount, 0.0f);
+	attenZ_.assign(paddedCount, 0.0f);
+	intensity_.assign(paddedCount, 0.0f);
+	lightIds_.assign(lightIds, lightIds + count);
+	for (uint32_t i = 0; i < count; i++) {
+		positionX_[i] = spheres[i].x;
+		positionY_[i] = spheres[i].y;
+		positionZ_[i] = spheres[i].z;
+		range_[i] = spheres[i].w;
+		attenX_[i] = attens[i].x;
+		attenY_[i] = attens[i].y;
+		attenZ_[i] = attens[i].z;
+		intensity_[i] = intensities[i];
+	}
+}
+
+void LightSelector::Select(const XMFLOAT4& sphere, LightSet& lightSet) const {
+	// 点数の高い順に並べた上位（同じ点数なら先のライトを残す）
+	float scores[kMaxLights];
+	lightSet.count = 0;
+	lightSet.pad[0] = lightSet.pad[1] = lightSet.pad[2] = 0;
+	// 選ばれる点数の下限（埋まるまでは0より大きければ選ぶ）
+	float threshold = 0.0f;
+
+	XMVECTOR centerX = XMVectorReplicate(sphere.x);
+	XMVECTOR centerY = XMVectorReplicate(sphere.y);
+	XMVECTOR centerZ = XMVectorReplicate(sphere.z);
+	XMVECTOR radius = XMVectorReplicate(sphere.w);
+	XMVECTOR zero = XMVectorZero();
+
+	uint32_t paddedCount = static_cast<uint32_t>(intensity_.size());
+	for (uint32_t i = 0; i < paddedCount; i += 4) {
+		// 境界球の表面からライトまでの距離（中にあれば0）
+		XMVECTOR dx = XMVectorSubtract(Load4(positionX_, i), centerX);
+		XMVECTOR dy = XMVectorSubtract(Load4(positionY_, i), centerY);
+		XMVECTOR dz = XMVectorSubtract(Load4(positionZ_, i), centerZ);
+		XMVECTOR distanceSq =
+		  XMVectorMultiplyAdd(dz, dz, XMVectorMultiplyAdd(dy, dy, XMVectorMultiply(dx, dx)));
+		XMVECTOR distance = XMVectorMax(XMVectorSubtract(XMVectorSqrt(distanceSq), radius), zero);
+
+		// 点数は最も近いところでの明るさ（影響範囲の外なら0）
+		XMVECTOR denominator = XMVectorMultiplyAdd(
+		  distance, XMVectorMultiplyAdd(distance, Load4(attenZ_, i), Load4(attenY_, i)),
+		  Load4(attenX_, i));
+		XMVECTOR score = XMVectorDivide(Load4(intensity_, i), denominator);
+		score = XMVectorSelect(zero, score, XMVectorLess(distance, Load4(range_, i)));
+
+		// 4個とも下限以下なら何もしない
+		if (XMVector4LessOrEqual(score, XMVectorReplicate(threshold))) {
+			continue;
+		}
+
+		XMFLOAT4 laneScores;
+		XMStoreFloat4(&laneScores, score);
+		const float* lanes = &laneScores.x;
+		for (uint32_t lane = 0; lane < 4; lane++) {
+			float laneScore = lanes[lane];
+			if (laneScore <= threshold) {
+				continue;
+			}
+			// 挿入位置より後ろをずらす（埋まっていれば最下位は押し出される）
+			uint32_t position = (std::min)(lightSet.count, kMaxLights - 1);
+			while (position > 0 && scores[position - 1] < laneScore) {
+				scores[position] = scores[position - 1];
+				lightSet.indices[position] = lightSet.indices[position - 1];
+				position--;
+			}
+			scores[position] = laneScore;
+			lightSet.indices[position] = lightIds_[i + lane];
+			if (lightSet.count < kMaxLights) {
+				lightSet.count++;
+			}
+			if (lightSet.count == kMaxLights) {
+				threshold = scores[kMaxLights - 1];
+			}
+		}
+	}
+}
+
+void LightSelector::Select(
+  const XMFLOAT4* spheres, uint32_t count, LightSet* lightSets, ThreadPool* pool) const {
+	// オブジェクト同士は独立なので、まとまりごとに分ける
+	uint32_t taskCount = (count + kObjectsPerTask - 1) / kObjectsPerTask;
+	auto selectTask = [this, spheres, count, lightSets](uint32_t task) {
+		uint32_t begin = task * kObjectsPerTask;
+		uint32_t end = (std::min)(begin + kObjectsPerTask, count);
+		for (uint32_t i = begin; i < end; i++) {
+			Select(spheres[i], lightSets[i]);
+		}
+	};
+	if (pool && taskCount > 1) {
+		pool->ParallelFor(taskCount, selectTask);
+	} else {
+		for (uint32_t task = 0; task < taskCount; task++) {
+			selectTask(task);
+		}
+	}
+}
@@ -0,0 +1,79 @@
+﻿#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+/// <summary>
+/// オブジェクトごとのライト選択
+/// 全ての点光源とスポットライトをオブジェクトの境界球に対して明るさと距離減衰で採点し、
+/// 上位kMaxLights個の番号を選ぶ。ライト4個ずつSIMDで採点する（結果はスレッド数によらない）
+/// </summary>
+class LightSelector {
+  public: // 定数
+	// 1つのオブジェクトに選ぶライトの最大数
+	static const uint32_t kMaxLights = 8;
+
+  public: // サブクラス
+	/// <summary>
+	/// 選んだライト（構造化バッファの要素。シェーダのObjectLightsと合わせる）
+	/// </summary>
+	struct LightSet {
+		uint32_t count;               // 数
+		uint32_t indices[kMaxLights]; // ライト番号（点数の高い順）
+		uint32_t pad[3];
+	};
+
+  public: // メンバ関数
+	/// <summary>
+	/// ライトの設定
+	/// </summary>
+	/// <param name="spheres">ライトの境界球（xyz:中心 w:影響範囲の半径）</param>
+	/// <param name="attens">距離減衰係数（1 / (x + y * d + z * d * d)）</param>
+	/// <param name="intensities">明るさ（色の最大成分）</param>
+	/// <param name="lightIds">選んだときに返す番号（ライトごと）</param>
+	/// <param name="count">ライト数</param>
+	void SetLights(
+	  const DirectX::XMFLOAT4* spheres, const DirectX::XMFLOAT3* attens, const float* intensities,
+	  const uint32_t* lightIds, uint32_t count);
+
+	/// <summary>
+	/// 1つのオブジェクトのライト選択
+	/// </summary>
+	/// <param name="sphere">オブジェクトのワールド座標の境界球（xyz:中心 w:半径）</param>
+	/// <param name="lightSet">選んだライト</param>
+	void Select(const DirectX::XMFLOAT4& sphere, LightSet& lightSet) const;
+
+	/// <summary>
+	/// 複数のオブジェクトのライト選択
+	/// </summary>
+	/// <param name="spheres">オブジェクトのワールド座標の境界球</param>
+	/// <param name="count">オブジェクト数</param>
+	/// <param name="lightSets">選んだライト（オブジェクトごと）</param>
+	/// <param name="pool">分けて選ぶスレッドプール（nullptrなら呼び出し元だけで行う）</param>
+	void Select(
+	  const DirectX::XMFLOAT4* spheres, uint32_t count, LightSet* lightSets,
+	  ThreadPool* pool = nullptr) const;
+
+	/// <summary>
+	/// ライト数の取得
+	/// </summary>
+	/// <returns>SetLightsで設定した数</returns>
+	uint32_t GetLightCount() const { return lightCount_; }
+
+  private: // メンバ変数
+	// ライト数
+	uint32_t lightCount_ = 0;
+	// ライト（4の倍数に埋める。埋めた分は明るさ0）
+	std::vector<float> positionX_;
+	std::vector<float> positionY_;
+	std::vector<float> positionZ_;
+	std::vector<float> range_;
+	std::vector<float> attenX_;
+	std::vector<float> attenY_;
+	std::vector<float> attenZ_;
+	std::vector<float> intensity_;
+	std::vector<uint32_t> lightIds_;
+};
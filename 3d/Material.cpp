@@ -15,29 +15,15 @@ Material* Material::Create() {
 	return instance;
 }
 
-void Material::Initialize() {
-	// 定数バッファの生成
-	CreateConstantBuffer();
+Material::~Material() {
+	if (textureLoaded_) {
+		TextureManager::Unload(textureHandle_);
+	}
 }
 
-void Material::CreateConstantBuffer() {
-	HRESULT result;
-
-	// ヒーププロパティ
-	CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-	// リソース設定
-	CD3DX12_RESOURCE_DESC resourceDesc =
-	  CD3DX12_RESOURCE_DESC::Buffer((sizeof(ConstBufferData) + 0xff) & ~0xff);
-
-	// 定数バッファの生成
-	result = DirectXCommon::GetInstance()->GetDevice()->CreateCommittedResource(
-	  &heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
-	  IID_PPV_ARGS(&constBuff_));
-	assert(SUCCEEDED(result));
-
-	// 定数バッファとのデータリンク
-	result = constBuff_->Map(0, nullptr, (void**)&constMap_);
-	assert(SUCCEEDED(result));
+void Material::Initialize() {
+	// 定数バッファへ初期値を反映（領域は描画時にフレームごとに確保される）
+	Update();
 }
 
 void Material::LoadTexture(const std::string& directoryPath) {
@@ -55,16 +41,21 @@ void Material::LoadTexture(const std::string& directoryPath) {
 	// ファイルパスを結合
 	string filepath = directoryPath + textureFilename_;
 
-	// テクスチャ読み込み
+	// テクスチャ読み込み（読み込み済みなら先に解放）
+	if (textureLoaded_) {
+		TextureManager::Unload(textureHandle_);
+	}
 	textureHandle_ = TextureManager::Load(filepath);
+	textureLoaded_ = true;
 }
 
 void Material::Update() {
-	// 定数バッファへデータ転送
-	constMap_->ambient = ambient_;
-	constMap_->diffuse = diffuse_;
-	constMap_->specular = specular_;
-	constMap_->alpha = alpha_;
+	// 定数バッファへデータ転送（描画時に現在のフレームの領域へ転送される）
+	ConstBufferData& constData = constBuffer_.Edit();
+	constData.ambient = ambient_;
+	constData.diffuse = diffuse_;
+	constData.specular = specular_;
+	constData.alpha = alpha_;
 }
 
 void Material::SetGraphicsCommand(
@@ -72,12 +63,12 @@ void Material::SetGraphicsCommand(
   UINT rooParameterIndexTexture) {
 
 	// SRVをセット
-	TextureManager::GetInstance()->SetGraphicsRootDescriptorTable(
+	TextureManager::GetInstance()->SetGraphicsRootTexture(
 	  commandList, rooParameterIndexTexture, textureHandle_);
 
 	// マテリアルの定数バッファをセット
 	commandList->SetGraphicsRootConstantBufferView(
-	  rooParameterIndexMaterial, constBuff_->GetGPUVirtualAddress());
+	  rooParameterIndexMaterial, constBuffer_.GetGPUVirtualAddress());
 }
 
 void Material::SetGraphicsCommand(
@@ -85,10 +76,10 @@ void Material::SetGraphicsCommand(
   UINT rooParameterIndexTexture, uint32_t textureHandle) {
 
 	// SRVをセット
-	TextureManager::GetInstance()->SetGraphicsRootDescriptorTable(
+	TextureManager::GetInstance()->SetGraphicsRootTexture(
 	  commandList, rooParameterIndexTexture, textureHandle);
 
 	// マテリアルの定数バッファをセット
 	commandList->SetGraphicsRootConstantBufferView(
-	  rooParameterIndexMaterial, constBuff_->GetGPUVirtualAddress());
+	  rooParameterIndexMaterial, constBuffer_.GetGPUVirtualAddress());
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include "FrameConstantBuffer.h"
 #include <DirectXMath.h>
 #include <d3d12.h>
 #include <d3dx12.h>
@@ -47,10 +48,17 @@ class Material {
 
   public:
 	/// <summary>
-	/// 定数バッファの取得
+	/// デストラクタ（読み込んだテクスチャを解放する）
 	/// </summary>
-	/// <returns></returns>
-	ID3D12Resource* GetConstantBuffer() { return constBuff_.Get(); }
+	~Material();
+
+	/// <summary>
+	/// 現在のフレームの定数バッファアドレスを取得
+	/// </summary>
+	/// <returns>GPUアドレス</returns>
+	D3D12_GPU_VIRTUAL_ADDRESS GetGPUVirtualAddress() const {
+		return constBuffer_.GetGPUVirtualAddress();
+	}
 
 	/// テクスチャ読み込み
 	/// </summary>
@@ -87,12 +95,12 @@ class Material {
 	uint32_t GetTextureHadle() { return textureHandle_; }
 
   private:
-	// 定数バッファ
-	ComPtr<ID3D12Resource> constBuff_;
-	// 定数バッファのマップ
-	ConstBufferData* constMap_ = nullptr;
+	// 定数バッファ（フレームごとのアップロード領域に書き込む）
+	FrameConstantBuffer<ConstBufferData> constBuffer_;
 	// テクスチャハンドル
 	uint32_t textureHandle_ = 0;
+	// テクスチャを読み込んだか
+	bool textureLoaded_ = false;
 
   private:
 	// コンストラクタ
@@ -107,9 +115,4 @@ class Material {
 	/// 初期化
 	/// </summary>
 	void Initialize();
-
-	/// <summary>
-	/// 定数バッファの生成
-	/// </summary>
-	void CreateConstantBuffer();
 };
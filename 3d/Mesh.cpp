@@ -1,5 +1,6 @@
 ﻿#include "DirectXCommon.h"
 #include "Mesh.h"
+#include "ResourceUploader.h"
 #include <cassert>
 #include <d3dcompiler.h>
 
@@ -7,6 +8,13 @@
 
 using namespace DirectX;
 
+Mesh::~Mesh() {
+	// GPUが使い終わってからヒープに返す
+	GpuMemoryAllocator* allocator = GpuMemoryAllocator::GetInstance();
+	allocator->Release(vertBuff_, vertAllocation_);
+	allocator->Release(indexBuff_, indexAllocation_);
+}
+
 void Mesh::SetName(const std::string& name_) { this->name_ = name_; }
 
 void Mesh::AddVertex(const VertexPosNormalUv& vertex) { vertices_.emplace_back(vertex); }
@@ -41,25 +49,16 @@ void Mesh::SetMaterial(Material* material) { this->material_ = material; }
 void Mesh::CreateBuffers() {
 	HRESULT result;
 
-	UINT sizeVB = static_cast<UINT>(sizeof(VertexPosNormalUv) * vertices_.size());
+	// DEFAULTヒープに生成し、コピーキューで転送する（次のPostDrawでまとめて提出）
+	ResourceUploader* uploader = ResourceUploader::GetInstance();
 
-	// ヒーププロパティ
-	CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-	// リソース設定
-	CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(sizeVB);
+	UINT sizeVB = static_cast<UINT>(sizeof(VertexPosNormalUv) * vertices_.size());
 
 	// 頂点バッファ生成
-	result = DirectXCommon::GetInstance()->GetDevice()->CreateCommittedResource(
-	  &heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
-	  IID_PPV_ARGS(&vertBuff_));
-	assert(SUCCEEDED(result));
-
-	// 頂点バッファへのデータ転送
-	VertexPosNormalUv* vertMap = nullptr;
-	result = vertBuff_->Map(0, nullptr, (void**)&vertMap);
-	if (SUCCEEDED(result)) {
-		std::copy(vertices_.begin(), vertices_.end(), vertMap);
-		vertBuff_->Unmap(0, nullptr);
+	result = uploader->UploadBuffer(vertices_.data(), sizeVB, vertBuff_, vertAllocation_);
+	if (FAILED(result)) {
+		assert(0);
+		return;
 	}
 
 	// 頂点バッファビューの作成
@@ -67,31 +66,15 @@ void Mesh::CreateBuffers() {
 	vbView_.SizeInBytes = sizeVB;
 	vbView_.StrideInBytes = sizeof(vertices_[0]);
 
-	if (FAILED(result)) {
-		assert(0);
-		return;
-	}
-
 	UINT sizeIB = static_cast<UINT>(sizeof(unsigned short) * indices_.size());
-	// リソース設定
-	resourceDesc.Width = sizeIB;
+
 	// インデックスバッファ生成
-	result = DirectXCommon::GetInstance()->GetDevice()->CreateCommittedResource(
-	  &heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
-	  IID_PPV_ARGS(&indexBuff_));
+	result = uploader->UploadBuffer(indices_.data(), sizeIB, indexBuff_, indexAllocation_);
 	if (FAILED(result)) {
 		assert(0);
 		return;
 	}
 
-	// インデックスバッファへのデータ転送
-	unsigned short* indexMap = nullptr;
-	result = indexBuff_->Map(0, nullptr, (void**)&indexMap);
-	if (SUCCEEDED(result)) {
-		std::copy(indices_.begin(), indices_.end(), indexMap);
-		indexBuff_->Unmap(0, nullptr);
-	}
-
 	// インデックスバッファビューの作成
 	ibView_.BufferLocation = indexBuff_->GetGPUVirtualAddress();
 	ibView_.Format = DXGI_FORMAT_R16_UINT;
@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include "GpuMemoryAllocator.h"
 #include "Material.h"
 #include <DirectXMath.h>
 #include <Windows.h>
@@ -31,6 +32,11 @@ class Mesh {
 	};
 
   public: // メンバ関数
+	/// <summary>
+	/// デストラクタ
+	/// </summary>
+	~Mesh();
+
 	/// <summary>
 	/// 名前を取得
 	/// </summary>
@@ -140,8 +146,12 @@ class Mesh {
 	std::string name_;
 	// 頂点バッファ
 	ComPtr<ID3D12Resource> vertBuff_;
+	// 頂点バッファのヒープ内の領域
+	GpuMemoryAllocator::Allocation vertAllocation_;
 	// インデックスバッファ
 	ComPtr<ID3D12Resource> indexBuff_;
+	// インデックスバッファのヒープ内の領域
+	GpuMemoryAllocator::Allocation indexAllocation_;
 	// 頂点バッファビュー
 	D3D12_VERTEX_BUFFER_VIEW vbView_ = {};
 	// インデックスバッファビュー
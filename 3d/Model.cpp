@@ -1,7 +1,10 @@
 ﻿#include "DirectXCommon.h"
 #include "Model.h"
+#include "ShadowMap.h"
+#include "WinApp.h"
 #include <algorithm>
 #include <cassert>
+#include <cfloat>
 #include <d3dcompiler.h>
 #include <fstream>
 #include <sstream>
@@ -20,6 +23,7 @@ UINT Model::sDescriptorHandleIncrementSize_ = 0;
 ID3D12GraphicsCommandList* Model::sCommandList_ = nullptr;
 ComPtr<ID3D12RootSignature> Model::sRootSignature_;
 ComPtr<ID3D12PipelineState> Model::sPipelineState_;
+uint64_t Model::sLightBindingVersion_ = 0;
 std::unique_ptr<LightGroup> Model::lightGroup;
 
 void Model::StaticInitialize() {
@@ -29,10 +33,15 @@ void Model::StaticInitialize() {
 		
 	// ライト生成
 	lightGroup.reset(LightGroup::Create());
+
+	// シャドウマップ生成（描かないフレームも影なしとしてセットする）
+	ShadowMap::GetInstance()->Initialize();
 }
 
 void Model::InitializeGraphicsPipeline() {
 	HRESULT result = S_FALSE;
+	TextureManager* textureManager = TextureManager::GetInstance();
+	bool bindless = textureManager->IsBindless();
 	ComPtr<ID3DBlob> vsBlob;    // 頂点シェーダオブジェクト
 	ComPtr<ID3DBlob> psBlob;    // ピクセルシェーダオブジェクト
 	ComPtr<ID3DBlob> errorBlob; // エラーオブジェクト
@@ -61,9 +70,9 @@ void Model::InitializeGraphicsPipeline() {
 	// ピクセルシェーダの読み込みとコンパイル
 	result = D3DCompileFromFile(
 	  L"Resources/shaders/ObjPS.hlsl", // シェーダファイル名
-	  nullptr,
+	  textureManager->GetShaderMacros(),
 	  D3D_COMPILE_STANDARD_FILE_INCLUDE, // インクルード可能にする
-	  "main", "ps_5_0", // エントリーポイント名、シェーダーモデル指定
+	  "main", "ps_5_1", // ライトの構造化バッファをレジスタ空間1に置くので5.1
 	  D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION, // デバッグ用設定
 	  0, &psBlob, &errorBlob);
 	if (FAILED(result)) {
@@ -138,22 +147,53 @@ void Model::InitializeGraphicsPipeline() {
 	// デスクリプタレンジ
 	CD3DX12_DESCRIPTOR_RANGE descRangeSRV;
 	descRangeSRV.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0); // t0 レジスタ
-
-	// ルートパラメータ
-	CD3DX12_ROOT_PARAMETER rootparams[5];
+	// バインドレス時はt0から全テクスチャ
+	CD3DX12_DESCRIPTOR_RANGE descRangeTextures;
+	descRangeTextures.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, UINT_MAX, 0);
+	// シャドウマップ（t5 レジスタ、レジスタ空間1）
+	CD3DX12_DESCRIPTOR_RANGE descRangeShadowMap;
+	descRangeShadowMap.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 5, 1);
+
+	// ルートパラメータ（ライトはkLightから続けてLightGroupがセットする）
+	static_assert(
+	  UINT(RoomParameter::kObjectLights) - UINT(RoomParameter::kLight) ==
+	    LightGroup::kRootParameterCount,
+	  "light root parameters");
+	CD3DX12_ROOT_PARAMETER rootparams[13];
 	rootparams[0].InitAsConstantBufferView(0, 0, D3D12_SHADER_VISIBILITY_ALL);
 	rootparams[1].InitAsConstantBufferView(1, 0, D3D12_SHADER_VISIBILITY_ALL);
 	rootparams[2].InitAsConstantBufferView(2, 0, D3D12_SHADER_VISIBILITY_ALL);
-	rootparams[3].InitAsDescriptorTable(1, &descRangeSRV, D3D12_SHADER_VISIBILITY_ALL);
+	if (bindless) {
+		// テクスチャ番号（b4 レジスタ）
+		rootparams[3].InitAsConstants(1, 4, 0, D3D12_SHADER_VISIBILITY_PIXEL);
+	} else {
+		rootparams[3].InitAsDescriptorTable(1, &descRangeSRV, D3D12_SHADER_VISIBILITY_ALL);
+	}
 	rootparams[4].InitAsConstantBufferView(3, 0, D3D12_SHADER_VISIBILITY_ALL);
-
-	// スタティックサンプラー
-	CD3DX12_STATIC_SAMPLER_DESC samplerDesc = CD3DX12_STATIC_SAMPLER_DESC(0);
+	// 点光源、スポットライト、クラスタの範囲、ライト番号（t0～t3、レジスタ空間1）
+	for (UINT i = 0; i < 4; i++) {
+		rootparams[5 + i].InitAsShaderResourceView(i, 1, D3D12_SHADER_VISIBILITY_PIXEL);
+	}
+	// オブジェクトごとに選んだライト（t4、レジスタ空間1）
+	rootparams[9].InitAsShaderResourceView(4, 1, D3D12_SHADER_VISIBILITY_PIXEL);
+	// シャドウマップの変換行列（b5 レジスタ）とシャドウマップ
+	rootparams[10].InitAsConstantBufferView(5, 0, D3D12_SHADER_VISIBILITY_PIXEL);
+	rootparams[11].InitAsDescriptorTable(1, &descRangeShadowMap, D3D12_SHADER_VISIBILITY_PIXEL);
+	rootparams[12].InitAsDescriptorTable(1, &descRangeTextures, D3D12_SHADER_VISIBILITY_PIXEL);
+
+	// スタティックサンプラー（s1はシャドウマップの比較用。範囲外は影なし）
+	CD3DX12_STATIC_SAMPLER_DESC samplerDescs[2];
+	samplerDescs[0] = CD3DX12_STATIC_SAMPLER_DESC(0);
+	samplerDescs[1] = CD3DX12_STATIC_SAMPLER_DESC(
+	  1, D3D12_FILTER_COMPARISON_MIN_MAG_LINEAR_MIP_POINT, D3D12_TEXTURE_ADDRESS_MODE_BORDER,
+	  D3D12_TEXTURE_ADDRESS_MODE_BORDER, D3D12_TEXTURE_ADDRESS_MODE_BORDER, 0.0f, 16,
+	  D3D12_COMPARISON_FUNC_LESS_EQUAL, D3D12_STATIC_BORDER_COLOR_OPAQUE_WHITE);
 
 	// ルートシグネチャの設定
 	CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc;
 	rootSignatureDesc.Init_1_0(
-	  _countof(rootparams), rootparams, 1, &samplerDesc,
+	  bindless ? _countof(rootparams) : _countof(rootparams) - 1, rootparams,
+	  _countof(samplerDescs), samplerDescs,
 	  D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
 	ComPtr<ID3DBlob> rootSigBlob;
@@ -196,18 +236,41 @@ void Model::PreDraw(ID3D12GraphicsCommandList* commandList) {
 
 	// コマンドリストをセット
 	sCommandList_ = commandList;
+	// ライトは最初の描画でセットする
+	sLightBindingVersion_ = 0;
+
+	// パイプライン関連の設定
+	SetPipelineState(commandList);
+}
 
+void Model::SetLightParameters(ID3D12GraphicsCommandList* commandList) {
+	// 描画ごとではなくパスごとに1回だけセットする
+	lightGroup->Draw(commandList, static_cast<UINT>(RoomParameter::kLight));
+	ShadowMap::GetInstance()->SetGraphicsRootParameters(
+	  commandList, static_cast<UINT>(RoomParameter::kShadow),
+	  static_cast<UINT>(RoomParameter::kShadowMap));
+}
+
+void Model::PostDraw() {
+	// コマンドリストを解除
+	sCommandList_ = nullptr;
+}
+
+void Model::SetPipelineState(ID3D12GraphicsCommandList* commandList) {
 	// パイプラインステートの設定
 	commandList->SetPipelineState(sPipelineState_.Get());
 	// ルートシグネチャの設定
 	commandList->SetGraphicsRootSignature(sRootSignature_.Get());
 	// プリミティブ形状を設定
 	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-}
 
-void Model::PostDraw() {
-	// コマンドリストを解除
-	sCommandList_ = nullptr;
+	// デスクリプタヒープは描画ごとではなくここで1回だけセットする
+	TextureManager* textureManager = TextureManager::GetInstance();
+	textureManager->SetDescriptorHeap(commandList);
+	if (textureManager->IsBindless()) {
+		textureManager->SetGraphicsRootTextureTable(
+		  commandList, static_cast<UINT>(RoomParameter::kTextureTable));
+	}
 }
 
 Model::~Model() {
@@ -226,6 +289,16 @@ void Model::Initialize(const std::string& modelname, bool smoothing) {
 	// モデル読み込み
 	LoadModel(modelname, smoothing);
 
+	// 境界球の半径（テクスチャのミップの選択に使う）
+	boundingRadius_ = 0.0f;
+	for (auto& m : meshes_) {
+		for (const Mesh::VertexPosNormalUv& vertex : m->GetVertices()) {
+			float length = DirectX::XMVectorGetX(
+			  DirectX::XMVector3Length(DirectX::XMLoadFloat3(&vertex.pos)));
+			boundingRadius_ = (std::max)(boundingRadius_, length);
+		}
+	}
+
 	// メッシュのマテリアルチェック
 	for (auto& m : meshes_) {
 		// マテリアルの割り当てがない
@@ -564,47 +637,131 @@ void Model::LoadTextures() {
 
 void Model::Draw(
   const WorldTransform& worldTransform, const ViewProjection& viewProjection) {
+	Draw(worldTransform, viewProjection, UINT32_MAX);
+}
 
-	// ライトの描画
-	lightGroup->Draw(sCommandList_, static_cast<UINT>(RoomParameter::kLight));
-
-	// CBVをセット（ワールド行列）
-	sCommandList_->SetGraphicsRootConstantBufferView(
-	  static_cast<UINT>(RoomParameter::kWorldTransform),
-	  worldTransform.constBuff_->GetGPUVirtualAddress());
-
-	// CBVをセット（ビュープロジェクション行列）
-	sCommandList_->SetGraphicsRootConstantBufferView(
-	  static_cast<UINT>(RoomParameter::kViewProjection),
-	  viewProjection.constBuff_->GetGPUVirtualAddress());
-
-	// 全メッシュを描画
-	for (auto& mesh : meshes_) {
-		mesh->Draw(sCommandList_, (UINT)RoomParameter::kMaterial, (UINT)RoomParameter::kTexture);
+void Model::PrepareDraw(const ViewProjection& viewProjection) {
+	// ライトのクラスタを作り、ライトのバッファも現在のフレームの領域へ転送される
+	lightGroup->UpdateClusters(viewProjection);
+	// アドレス取得時に現在のフレームの領域へ転送される
+	for (auto& m : materials_) {
+		m.second->GetGPUVirtualAddress();
 	}
 }
 
 void Model::Draw(
   const WorldTransform& worldTransform, const ViewProjection& viewProjection,
   uint32_t textureHadle) {
+	// ライトのクラスタは視点ごとに作る（同じフレームの同じ視点なら作り直さない）
+	lightGroup->UpdateClusters(viewProjection);
+	// ライトのアドレスが変わったときだけセットし直す
+	if (sLightBindingVersion_ != lightGroup->GetBindingVersion()) {
+		SetLightParameters(sCommandList_);
+		sLightBindingVersion_ = lightGroup->GetBindingVersion();
+	}
+	// オブジェクトごとのライトはメインスレッドで選ぶ
+	D3D12_GPU_VIRTUAL_ADDRESS objectLights =
+	  lightGroup->SelectObjectLights(GetWorldBoundingSphere(worldTransform));
+	Draw(sCommandList_, worldTransform, viewProjection, textureHadle, objectLights);
+}
+
+void Model::Draw(
+  ID3D12GraphicsCommandList* commandList, const WorldTransform& worldTransform,
+  const ViewProjection& viewProjection) {
+	Draw(
+	  commandList, worldTransform, viewProjection, UINT32_MAX,
+	  lightGroup->GetEmptyObjectLightsAddress());
+}
+
+void Model::Draw(
+  ID3D12GraphicsCommandList* commandList, const WorldTransform& worldTransform,
+  const ViewProjection& viewProjection, uint32_t textureHadle) {
+	Draw(
+	  commandList, worldTransform, viewProjection, textureHadle,
+	  lightGroup->GetEmptyObjectLightsAddress());
+}
 
-	// ライトの描画
-	lightGroup->Draw(sCommandList_, static_cast<UINT>(RoomParameter::kLight));
+void Model::Draw(
+  ID3D12GraphicsCommandList* commandList, const WorldTransform& worldTransform,
+  const ViewProjection& viewProjection, uint32_t textureHadle,
+  D3D12_GPU_VIRTUAL_ADDRESS objectLights) {
+
+	// オブジェクトごとに選んだライト（共有するライトはパスの最初にセット済み）
+	commandList->SetGraphicsRootShaderResourceView(
+	  static_cast<UINT>(RoomParameter::kObjectLights), objectLights);
 
 	// CBVをセット（ワールド行列）
-	sCommandList_->SetGraphicsRootConstantBufferView(
+	commandList->SetGraphicsRootConstantBufferView(
 	  static_cast<UINT>(RoomParameter::kWorldTransform),
-	  worldTransform.constBuff_->GetGPUVirtualAddress());
+	  worldTransform.GetGPUVirtualAddress());
 
 	// CBVをセット（ビュープロジェクション行列）
-	sCommandList_->SetGraphicsRootConstantBufferView(
+	commandList->SetGraphicsRootConstantBufferView(
 	  static_cast<UINT>(RoomParameter::kViewProjection),
-	  viewProjection.constBuff_->GetGPUVirtualAddress());
+	  viewProjection.GetGPUVirtualAddress());
 
 	// 全メッシュを描画
 	for (auto& mesh : meshes_) {
-		mesh->Draw(
-		  sCommandList_, (UINT)RoomParameter::kMaterial, (UINT)RoomParameter::kTexture,
-		  textureHadle);
+		if (textureHadle == UINT32_MAX) {
+			mesh->Draw(commandList, (UINT)RoomParameter::kMaterial, (UINT)RoomParameter::kTexture);
+		} else {
+			mesh->Draw(
+			  commandList, (UINT)RoomParameter::kMaterial, (UINT)RoomParameter::kTexture,
+			  textureHadle);
+		}
+	}
+
+	// テクスチャのミップの要求
+	RequestTextureMips(worldTransform, viewProjection, textureHadle);
+}
+
+void Model::DrawDepth(ID3D12GraphicsCommandList* commandList) {
+	// マテリアルとテクスチャは使わない
+	for (auto& mesh : meshes_) {
+		commandList->IASetVertexBuffers(0, 1, &mesh->GetVBView());
+		commandList->IASetIndexBuffer(&mesh->GetIBView());
+		commandList->DrawIndexedInstanced(
+		  static_cast<UINT>(mesh->GetIndices().size()), 1, 0, 0, 0);
+	}
+}
+
+DirectX::XMFLOAT4 Model::GetWorldBoundingSphere(const WorldTransform& worldTransform) const {
+	using namespace DirectX;
+
+	const XMMATRIX& matWorld = worldTransform.matWorld_;
+	float scale = (std::max)(
+	  {XMVectorGetX(XMVector3Length(matWorld.r[0])), XMVectorGetX(XMVector3Length(matWorld.r[1])),
+	   XMVectorGetX(XMVector3Length(matWorld.r[2]))});
+	XMFLOAT4 sphere;
+	XMStoreFloat4(&sphere, matWorld.r[3]);
+	sphere.w = boundingRadius_ * scale;
+	return sphere;
+}
+
+void Model::RequestTextureMips(
+  const WorldTransform& worldTransform, const ViewProjection& viewProjection,
+  uint32_t textureHadle) {
+	using namespace DirectX;
+
+	// 境界球をワールド座標へ
+	XMFLOAT4 sphere = GetWorldBoundingSphere(worldTransform);
+	float radius = sphere.w;
+	float viewZ = XMVectorGetZ(XMVector3TransformCoord(
+	  XMVectorSet(sphere.x, sphere.y, sphere.z, 1.0f), viewProjection.matView));
+
+	// 画面上の直径（ピクセル）。カメラが球の中なら最も詳細なミップ
+	float screenSize = FLT_MAX;
+	if (viewZ > radius) {
+		float projScaleY = XMVectorGetY(viewProjection.matProjection.r[1]);
+		screenSize = radius * projScaleY * WinApp::kWindowHeight / viewZ;
+	}
+
+	TextureManager* textureManager = TextureManager::GetInstance();
+	if (textureHadle != UINT32_MAX) {
+		textureManager->RequestMip(textureHadle, screenSize);
+		return;
+	}
+	for (auto& mesh : meshes_) {
+		textureManager->RequestMip(mesh->GetMaterial()->GetTextureHadle(), screenSize);
 	}
 }
@@ -30,8 +30,16 @@ class Model {
 		kWorldTransform, // ワールド変換行列
 		kViewProjection, // ビュープロジェクション変換行列
 		kMaterial,       // マテリアル
-		kTexture,        // テクスチャ
+		kTexture,        // テクスチャ（バインドレス時はテクスチャ番号のルート定数）
 		kLight,          // ライト
+		kPointLights,    // 点光源（構造化バッファ）
+		kSpotLights,     // スポットライト（構造化バッファ）
+		kClusterRanges,  // クラスタごとのライト番号の範囲
+		kLightIndices,   // クラスタごとのライト番号
+		kObjectLights,   // オブジェクトごとに選んだライト（描画ごと）
+		kShadow,         // シャドウマップの変換行列
+		kShadowMap,      // シャドウマップ
+		kTextureTable,   // 全テクスチャのテーブル（バインドレス時のみ）
 	};
 
   private:
@@ -47,6 +55,8 @@ class Model {
 	static Microsoft::WRL::ComPtr<ID3D12RootSignature> sRootSignature_;
 	// パイプラインステートオブジェクト
 	static Microsoft::WRL::ComPtr<ID3D12PipelineState> sPipelineState_;
+	// sCommandList_にセット済みのライトの番号（LightGroup::GetBindingVersion）
+	static uint64_t sLightBindingVersion_;
 	// ライト
 	static std::unique_ptr<LightGroup> lightGroup;
 
@@ -86,6 +96,24 @@ class Model {
 	/// </summary>
 	static void PostDraw();
 
+	/// <summary>
+	/// ライトの取得
+	/// </summary>
+	/// <returns>全モデルで共有するライト</returns>
+	static LightGroup* GetLightGroup() { return lightGroup.get(); }
+
+	/// <summary>
+	/// パイプライン関連の設定をコマンドリストに積む
+	/// </summary>
+	/// <param name="commandList">描画コマンドリスト</param>
+	static void SetPipelineState(ID3D12GraphicsCommandList* commandList);
+
+	/// <summary>
+	/// ライトと影のルートパラメータをコマンドリストに積む（パスごとに1回。UpdateClustersの後）
+	/// </summary>
+	/// <param name="commandList">描画コマンドリスト</param>
+	static void SetLightParameters(ID3D12GraphicsCommandList* commandList);
+
   public: // メンバ関数
 	/// <summary>
 	/// デストラクタ
@@ -117,6 +145,68 @@ class Model {
 	  const WorldTransform& worldTransform, const ViewProjection& viewProjection,
 	  uint32_t textureHadle);
 
+	/// <summary>
+	/// コマンドリスト指定の描画（並列記録用。選んだライトなし）
+	/// SetPipelineStateとSetLightParametersを積んだコマンドリストに使う
+	/// </summary>
+	/// <param name="commandList">描画コマンドリスト</param>
+	/// <param name="worldTransform">ワールドトランスフォーム</param>
+	/// <param name="viewProjection">ビュープロジェクション</param>
+	void Draw(
+	  ID3D12GraphicsCommandList* commandList, const WorldTransform& worldTransform,
+	  const ViewProjection& viewProjection);
+
+	/// <summary>
+	/// コマンドリスト指定の描画（テクスチャ差し替え、並列記録用。選んだライトなし）
+	/// </summary>
+	/// <param name="commandList">描画コマンドリスト</param>
+	/// <param name="worldTransform">ワールドトランスフォーム</param>
+	/// <param name="viewProjection">ビュープロジェクション</param>
+	/// <param name="textureHadle">テクスチャハンドル</param>
+	void Draw(
+	  ID3D12GraphicsCommandList* commandList, const WorldTransform& worldTransform,
+	  const ViewProjection& viewProjection, uint32_t textureHadle);
+
+	/// <summary>
+	/// コマンドリスト指定の描画（選んだライトを指定、並列記録用）
+	/// </summary>
+	/// <param name="commandList">描画コマンドリスト</param>
+	/// <param name="worldTransform">ワールドトランスフォーム</param>
+	/// <param name="viewProjection">ビュープロジェクション</param>
+	/// <param name="textureHadle">テクスチャハンドル（UINT32_MAXなら差し替えない）</param>
+	/// <param name="objectLights">LightGroup::SelectObjectLightsで選んだライトの一覧</param>
+	void Draw(
+	  ID3D12GraphicsCommandList* commandList, const WorldTransform& worldTransform,
+	  const ViewProjection& viewProjection, uint32_t textureHadle,
+	  D3D12_GPU_VIRTUAL_ADDRESS objectLights);
+
+	/// <summary>
+	/// 共有する定数バッファ（マテリアル、ライト）を現在のフレームへ転送し、ライトのクラスタを作る
+	/// 並列記録の前にメインスレッドで呼ぶ
+	/// </summary>
+	/// <param name="viewProjection">ビュープロジェクション</param>
+	void PrepareDraw(const ViewProjection& viewProjection);
+
+	/// <summary>
+	/// 深度のみの描画（頂点とインデックスだけを積む。シャドウマップ用）
+	/// 変換行列などのルートパラメータは呼び出し側でセットしておく
+	/// </summary>
+	/// <param name="commandList">描画コマンドリスト</param>
+	void DrawDepth(ID3D12GraphicsCommandList* commandList);
+
+	/// <summary>
+	/// 境界球の半径を取得
+	/// </summary>
+	/// <returns>モデル座標系での半径（原点中心）</returns>
+	float GetBoundingRadius() const { return boundingRadius_; }
+
+	/// <summary>
+	/// ワールド座標の境界球を取得（拡大は最も大きい軸で見積もる）
+	/// </summary>
+	/// <param name="worldTransform">ワールドトランスフォーム</param>
+	/// <returns>xyz:中心 w:半径</returns>
+	DirectX::XMFLOAT4 GetWorldBoundingSphere(const WorldTransform& worldTransform) const;
+
 	/// <summary>
 	/// メッシュコンテナを取得
 	/// </summary>
@@ -132,6 +222,8 @@ class Model {
 	std::unordered_map<std::string, Material*> materials_;
 	// デフォルトマテリアル
 	Material* defaultMaterial_ = nullptr;
+	// 境界球の半径
+	float boundingRadius_ = 0.0f;
 
   private: // メンバ関数
 	/// <summary>
@@ -155,4 +247,14 @@ class Model {
 	/// テクスチャ読み込み
 	/// </summary>
 	void LoadTextures();
+
+	/// <summary>
+	/// 画面上の大きさに見合ったテクスチャのミップを要求する
+	/// </summary>
+	/// <param name="worldTransform">ワールドトランスフォーム</param>
+	/// <param name="viewProjection">ビュープロジェクション</param>
+	/// <param name="textureHadle">差し替えるテクスチャハンドル（なければマテリアルのテクスチャ）</param>
+	void RequestTextureMips(
+	  const WorldTransform& worldTransform, const ViewProjection& viewProjection,
+	  uint32_t textureHadle = UINT32_MAX);
 };
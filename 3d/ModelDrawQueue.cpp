@@ -0,0 +1,57 @@
+﻿#include "ModelDrawQueue.h"
+#include "ShadowMap.h"
+#include <cassert>
+
+void ModelDrawQueue::Push(Model* model, const WorldTransform& worldTransform) {
+	Push(model, worldTransform, kNoTextureOverride);
+}
+
+void ModelDrawQueue::Push(
+  Model* model, const WorldTransform& worldTransform, uint32_t textureHandle) {
+	assert(model);
+
+	DrawItem item;
+	item.model = model;
+	item.worldTransform = &worldTransform;
+	item.textureHandle = textureHandle;
+	items_.push_back(item);
+}
+
+void ModelDrawQueue::Prepare() {
+	assert(viewProjection_);
+
+	// 定数バッファの転送はスレッドセーフではないので、記録前にまとめて済ませておく
+	viewProjection_->GetGPUVirtualAddress();
+	Model::GetLightGroup()->UpdateClusters(*viewProjection_);
+	ShadowMap::GetInstance()->GetGPUVirtualAddress();
+	for (const DrawItem& item : items_) {
+		item.model->PrepareDraw(*viewProjection_);
+		item.worldTransform->GetGPUVirtualAddress();
+	}
+
+	// オブジェクトごとのライトもまとめて選んでおく
+	spheres_.resize(items_.size());
+	objectLights_.resize(items_.size());
+	for (size_t i = 0; i < items_.size(); i++) {
+		spheres_[i] = items_[i].model->GetWorldBoundingSphere(*items_[i].worldTransform);
+	}
+	Model::GetLightGroup()->SelectObjectLights(
+	  spheres_.data(), static_cast<uint32_t>(spheres_.size()), objectLights_.data());
+}
+
+void ModelDrawQueue::BeginRecord(ID3D12GraphicsCommandList* commandList) {
+	// コマンドリストごとにパイプラインとライトを設定し直す（ライトは描画ごとにはセットしない）
+	Model::SetPipelineState(commandList);
+	Model::SetLightParameters(commandList);
+}
+
+void ModelDrawQueue::Record(ID3D12GraphicsCommandList* commandList, const RecordRange& range) {
+	assert(viewProjection_);
+
+	for (uint32_t i = range.begin; i < range.end; i++) {
+		const DrawItem& item = items_[i];
+		item.model->Draw(
+		  commandList, *item.worldTransform, *viewProjection_, item.textureHandle,
+		  objectLights_[i]);
+	}
+}
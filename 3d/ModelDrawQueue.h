@@ -0,0 +1,70 @@
+﻿#pragma once
+
+#include "Model.h"
+#include "ParallelCommandRecorder.h"
+#include "ViewProjection.h"
+#include "WorldTransform.h"
+#include <vector>
+
+/// <summary>
+/// モデル描画キュー（並列記録用）
+/// </summary>
+class ModelDrawQueue : public ICommandRecorder<ID3D12GraphicsCommandList> {
+  public: // 定数
+	// テクスチャ差し替えなし
+	static const uint32_t kNoTextureOverride = UINT32_MAX;
+
+  public: // サブクラス
+	// 描画要素
+	struct DrawItem {
+		Model* model = nullptr;
+		const WorldTransform* worldTransform = nullptr;
+		uint32_t textureHandle = kNoTextureOverride;
+	};
+
+  public: // メンバ関数
+	/// <summary>
+	/// キューを空にする
+	/// </summary>
+	void Clear() { items_.clear(); }
+
+	/// <summary>
+	/// ビュープロジェクションのセット
+	/// </summary>
+	/// <param name="viewProjection">ビュープロジェクション</param>
+	void SetViewProjection(const ViewProjection* viewProjection) {
+		viewProjection_ = viewProjection;
+	}
+
+	/// <summary>
+	/// 描画要素の追加
+	/// </summary>
+	/// <param name="model">モデル</param>
+	/// <param name="worldTransform">ワールドトランスフォーム</param>
+	void Push(Model* model, const WorldTransform& worldTransform);
+
+	/// <summary>
+	/// 描画要素の追加（テクスチャ差し替え）
+	/// </summary>
+	/// <param name="model">モデル</param>
+	/// <param name="worldTransform">ワールドトランスフォーム</param>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	void Push(Model* model, const WorldTransform& worldTransform, uint32_t textureHandle);
+
+	uint32_t GetItemCount() const override { return static_cast<uint32_t>(items_.size()); }
+
+	void Prepare() override;
+
+	void BeginRecord(ID3D12GraphicsCommandList* commandList) override;
+
+	void Record(ID3D12GraphicsCommandList* commandList, const RecordRange& range) override;
+
+  private: // メンバ変数
+	// 描画要素
+	std::vector<DrawItem> items_;
+	// 描画要素ごとのワールド座標の境界球と、選んだライトの一覧のGPUアドレス
+	std::vector<DirectX::XMFLOAT4> spheres_;
+	std::vector<D3D12_GPU_VIRTUAL_ADDRESS> objectLights_;
+	// ビュープロジェクション
+	const ViewProjection* viewProjection_ = nullptr;
+};
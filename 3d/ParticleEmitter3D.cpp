@@ -0,0 +1,196 @@
+﻿#include "ParticleEmitter3D.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+using namespace DirectX;
+
+namespace {
+
+// 4要素の読み込み、書き込み（アライメント不要）
+inline XMVECTOR Load4(const float* source) {
+	return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(source));
+}
+inline void Store4(float* destination, FXMVECTOR value) {
+	XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(destination), value);
+}
+
+} // namespace
+
+ParticleEmitter3D::ParticleEmitter3D(const Desc& desc) : desc_(desc) {
+	assert(desc.seed != 0);
+	randomState_ = desc.seed;
+
+	// 4個ずつ処理するので端数の分も確保しておく（端数の要素は描画しない）
+	uint32_t capacity = (desc.maxParticles + 3) / 4 * 4;
+	for (std::vector<float>* array :
+	     {&positionX_, &positionY_, &positionZ_, &velocityX_, &velocityY_, &velocityZ_, &life_,
+	      &inverseLifetime_}) {
+		array->assign(capacity, 0.0f);
+	}
+	sortKeys_.reserve(capacity);
+
+	// 発射方向は単位ベクトルにしておく
+	XMStoreFloat3(&desc_.direction, XMVector3Normalize(XMLoadFloat3(&desc.direction)));
+}
+
+void ParticleEmitter3D::Update(float deltaTime, ThreadPool* pool) {
+	isSorted_ = false;
+
+	// 積分（要素ごとに独立なので、区切り方によらず結果は同じ）
+	uint32_t chunkCount = (count_ + kChunkSize - 1) / kChunkSize;
+	if (pool && 1 < chunkCount) {
+		pool->ParallelFor(chunkCount, [this, deltaTime](uint32_t chunk) {
+			uint32_t first = chunk * kChunkSize;
+			Integrate(first, (std::min)(first + kChunkSize, count_), deltaTime);
+		});
+	} else {
+		Integrate(0, count_, deltaTime);
+	}
+
+	// 寿命の尽きたものを末尾と入れ替えて詰める
+	for (uint32_t i = 0; i < count_;) {
+		if (0.0f < life_[i]) {
+			i++;
+			continue;
+		}
+		uint32_t last = --count_;
+		positionX_[i] = positionX_[last];
+		positionY_[i] = positionY_[last];
+		positionZ_[i] = positionZ_[last];
+		velocityX_[i] = velocityX_[last];
+		velocityY_[i] = velocityY_[last];
+		velocityZ_[i] = velocityZ_[last];
+		life_[i] = life_[last];
+		inverseLifetime_[i] = inverseLifetime_[last];
+	}
+
+	// 発生
+	emissionAccumulator_ += desc_.emissionRate * deltaTime;
+	uint32_t emitCount = static_cast<uint32_t>(emissionAccumulator_);
+	emissionAccumulator_ -= static_cast<float>(emitCount);
+	Burst(emitCount);
+}
+
+void ParticleEmitter3D::Burst(uint32_t count) {
+	isSorted_ = false;
+
+	count = (std::min)(count, desc_.maxParticles - count_);
+	for (uint32_t i = 0; i < count; i++) {
+		Spawn();
+	}
+}
+
+void ParticleEmitter3D::SortBackToFront(const XMFLOAT3& eye) {
+	sortKeys_.resize(count_);
+
+	// 距離の2乗（正の浮動小数点数はビット列のまま大小を比べられる）を反転し、
+	// 遠いほど小さいキーにする
+	XMVECTOR eyeX = XMVectorReplicate(eye.x);
+	XMVECTOR eyeY = XMVectorReplicate(eye.y);
+	XMVECTOR eyeZ = XMVectorReplicate(eye.z);
+	for (uint32_t i = 0; i < count_; i += 4) {
+		XMVECTOR dx = XMVectorSubtract(Load4(&positionX_[i]), eyeX);
+		XMVECTOR dy = XMVectorSubtract(Load4(&positionY_[i]), eyeY);
+		XMVECTOR dz = XMVectorSubtract(Load4(&positionZ_[i]), eyeZ);
+		XMVECTOR distanceSq = XMVectorMultiplyAdd(
+		  dz, dz, XMVectorMultiplyAdd(dy, dy, XMVectorMultiply(dx, dx)));
+
+		float distances[4];
+		Store4(distances, distanceSq);
+		uint32_t lanes = (std::min)(count_ - i, 4u);
+		for (uint32_t lane = 0; lane < lanes; lane++) {
+			uint32_t bits;
+			memcpy(&bits, &distances[lane], sizeof(bits));
+			sortKeys_[i + lane] = ~bits;
+		}
+	}
+
+	radixSort_.Sort(sortKeys_.data(), count_);
+	// 全て同じ距離なら格納順のまま
+	sortedOrder_ = radixSort_.GetPassCount() > 0 ? radixSort_.GetOrder() : nullptr;
+	isSorted_ = true;
+}
+
+void ParticleEmitter3D::WriteInstances(Instance* instances) const {
+	const uint32_t* order = GetSortedOrder();
+	XMVECTOR startColor = XMLoadFloat4(&desc_.startColor);
+	XMVECTOR endColor = XMLoadFloat4(&desc_.endColor);
+	float sizeRange = desc_.endSize - desc_.startSize;
+
+	for (uint32_t i = 0; i < count_; i++) {
+		uint32_t index = order ? order[i] : i;
+		// 経過の割合で大きさと色を補間
+		float t = 1.0f - life_[index] * inverseLifetime_[index];
+		t = (std::min)((std::max)(t, 0.0f), 1.0f);
+
+		Instance& instance = instances[i];
+		instance.position = {positionX_[index], positionY_[index], positionZ_[index]};
+		instance.size = desc_.startSize + sizeRange * t;
+		XMStoreFloat4(&instance.color, XMVectorLerp(startColor, endColor, t));
+	}
+}
+
+void ParticleEmitter3D::Integrate(uint32_t first, uint32_t last, float deltaTime) {
+	// 端数の要素もまとめて処理する（最大数は4の倍数に切り上げてある）
+	XMVECTOR dt = XMVectorReplicate(deltaTime);
+	XMVECTOR accelerationX = XMVectorReplicate(desc_.acceleration.x * deltaTime);
+	XMVECTOR accelerationY = XMVectorReplicate(desc_.acceleration.y * deltaTime);
+	XMVECTOR accelerationZ = XMVectorReplicate(desc_.acceleration.z * deltaTime);
+	for (uint32_t i = first; i < last; i += 4) {
+		XMVECTOR velocityX = XMVectorAdd(Load4(&velocityX_[i]), accelerationX);
+		XMVECTOR velocityY = XMVectorAdd(Load4(&velocityY_[i]), accelerationY);
+		XMVECTOR velocityZ = XMVectorAdd(Load4(&velocityZ_[i]), accelerationZ);
+		Store4(&velocityX_[i], velocityX);
+		Store4(&velocityY_[i], velocityY);
+		Store4(&velocityZ_[i], velocityZ);
+		Store4(&positionX_[i], XMVectorMultiplyAdd(velocityX, dt, Load4(&positionX_[i])));
+		Store4(&positionY_[i], XMVectorMultiplyAdd(velocityY, dt, Load4(&positionY_[i])));
+		Store4(&positionZ_[i], XMVectorMultiplyAdd(velocityZ, dt, Load4(&positionZ_[i])));
+		Store4(&life_[i], XMVectorSubtract(Load4(&life_[i]), dt));
+	}
+}
+
+float ParticleEmitter3D::NextRandom() {
+	randomState_ ^= randomState_ << 13;
+	randomState_ ^= randomState_ >> 17;
+	randomState_ ^= randomState_ << 5;
+	// 上位24bitを使う
+	return static_cast<float>(randomState_ >> 8) * (1.0f / 16777216.0f);
+}
+
+void ParticleEmitter3D::Spawn() {
+	assert(count_ < desc_.maxParticles);
+
+	// 発射方向を軸とする円錐の中で一様な方向
+	float cosTheta = 1.0f - NextRandom() * (1.0f - std::cos(desc_.spread));
+	float sinTheta = std::sqrt((std::max)(1.0f - cosTheta * cosTheta, 0.0f));
+	float phi = XM_2PI * NextRandom();
+	float speed = desc_.speedMin + (desc_.speedMax - desc_.speedMin) * NextRandom();
+	float lifetime = desc_.lifeMin + (desc_.lifeMax - desc_.lifeMin) * NextRandom();
+	lifetime = (std::max)(lifetime, 1e-4f);
+
+	// 発射方向と直交する2軸
+	XMVECTOR axis = XMLoadFloat3(&desc_.direction);
+	XMVECTOR reference =
+	  std::abs(desc_.direction.y) < 0.99f ? XMVectorSet(0, 1, 0, 0) : XMVectorSet(1, 0, 0, 0);
+	XMVECTOR tangent = XMVector3Normalize(XMVector3Cross(reference, axis));
+	XMVECTOR bitangent = XMVector3Cross(axis, tangent);
+	XMVECTOR velocity = XMVectorScale(axis, cosTheta);
+	velocity = XMVectorAdd(velocity, XMVectorScale(tangent, sinTheta * std::cos(phi)));
+	velocity = XMVectorAdd(velocity, XMVectorScale(bitangent, sinTheta * std::sin(phi)));
+	XMFLOAT3 v;
+	XMStoreFloat3(&v, XMVectorScale(velocity, speed));
+
+	uint32_t i = count_++;
+	positionX_[i] = desc_.position.x;
+	positionY_[i] = desc_.position.y;
+	positionZ_[i] = desc_.position.z;
+	velocityX_[i] = v.x;
+	velocityY_[i] = v.y;
+	velocityZ_[i] = v.z;
+	life_[i] = lifetime;
+	inverseLifetime_[i] = 1.0f / lifetime;
+}
@@ -0,0 +1,185 @@
+﻿#pragma once
+
+#include "RadixSort.h"
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+/// <summary>
+/// 3Dパーティクルの発生源（ワールド座標）
+/// パーティクルは要素ごとの配列で持ち、一定数ずつワーカースレッドに分けて4個ずつSIMDで積分する。
+/// 描画前に視点から遠い順に並べ替え、カメラを向く四角形1個分のインスタンスデータを書き出す。
+/// 描画には依存しないので単体で動かせる
+/// </summary>
+class ParticleEmitter3D {
+  public: // 定数
+	// 1つのワーカーがまとめて積分するパーティクル数（4の倍数）
+	static const uint32_t kChunkSize = 4096;
+
+  public: // サブクラス
+	/// <summary>
+	/// 発生源の設定
+	/// </summary>
+	struct Desc {
+		// 最大数
+		uint32_t maxParticles = 1024;
+		// 1秒あたりの発生数
+		float emissionRate = 100.0f;
+		// 発生位置
+		DirectX::XMFLOAT3 position = {0, 0, 0};
+		// 発射方向と、その周りの円錐の半頂角（ラジアン）
+		DirectX::XMFLOAT3 direction = {0, 1, 0};
+		float spread = DirectX::XM_PI / 6.0f;
+		// 初速の範囲
+		float speedMin = 1.0f;
+		float speedMax = 2.0f;
+		// 寿命の範囲（秒）
+		float lifeMin = 1.0f;
+		float lifeMax = 2.0f;
+		// 加速度
+		DirectX::XMFLOAT3 acceleration = {0, 0, 0};
+		// 発生時と消滅時の色（寿命に応じて補間）
+		DirectX::XMFLOAT4 startColor = {1, 1, 1, 1};
+		DirectX::XMFLOAT4 endColor = {1, 1, 1, 0};
+		// 発生時と消滅時の大きさ（寿命に応じて補間）
+		float startSize = 1.0f;
+		float endSize = 1.0f;
+		// テクスチャハンドル
+		uint32_t textureHandle = 0;
+		// 乱数の種（0以外）
+		uint32_t seed = 1;
+	};
+
+	/// <summary>
+	/// 四角形1個分のインスタンスデータ
+	/// </summary>
+	struct Instance {
+		DirectX::XMFLOAT3 position; // 中心のワールド座標
+		float size;                 // 一辺の長さ
+		DirectX::XMFLOAT4 color;    // 色
+	};
+
+  public: // メンバ関数
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="desc">発生源の設定</param>
+	explicit ParticleEmitter3D(const Desc& desc);
+
+	/// <summary>
+	/// 更新（積分、消滅、発生の順。結果はスレッド数によらない）
+	/// </summary>
+	/// <param name="deltaTime">経過時間（秒）</param>
+	/// <param name="pool">積分を分けるスレッドプール（nullptrなら呼び出し元だけで行う）</param>
+	void Update(float deltaTime, ThreadPool* pool = nullptr);
+
+	/// <summary>
+	/// まとめて発生させる
+	/// </summary>
+	/// <param name="count">数（空きがなければ減らす）</param>
+	void Burst(uint32_t count);
+
+	/// <summary>
+	/// 全て消す
+	/// </summary>
+	void Clear() { count_ = 0; }
+
+	/// <summary>
+	/// 視点から遠い順に並べ替える（同じ距離は格納順）
+	/// </summary>
+	/// <param name="eye">視点座標</param>
+	void SortBackToFront(const DirectX::XMFLOAT3& eye);
+
+	/// <summary>
+	/// インスタンスデータの書き出し（SortBackToFront後ならその順）
+	/// </summary>
+	/// <param name="instances">書き込み先（GetCount個）</param>
+	void WriteInstances(Instance* instances) const;
+
+	/// <summary>
+	/// 発生位置の設定
+	/// </summary>
+	/// <param name="position">発生位置</param>
+	void SetPosition(const DirectX::XMFLOAT3& position) { desc_.position = position; }
+
+	/// <summary>
+	/// 1秒あたりの発生数の設定
+	/// </summary>
+	/// <param name="emissionRate">発生数（0なら止める）</param>
+	void SetEmissionRate(float emissionRate) { desc_.emissionRate = emissionRate; }
+
+	/// <summary>
+	/// 設定の取得
+	/// </summary>
+	/// <returns>設定</returns>
+	const Desc& GetDesc() const { return desc_; }
+
+	/// <summary>
+	/// 生きているパーティクル数の取得
+	/// </summary>
+	/// <returns>数</returns>
+	uint32_t GetCount() const { return count_; }
+
+	/// <summary>
+	/// 座標の取得
+	/// </summary>
+	/// <param name="index">格納順の番号</param>
+	/// <returns>ワールド座標</returns>
+	DirectX::XMFLOAT3 GetParticlePosition(uint32_t index) const {
+		return {positionX_[index], positionY_[index], positionZ_[index]};
+	}
+
+	/// <summary>
+	/// 直前のSortBackToFrontの結果の取得
+	/// </summary>
+	/// <returns>遠い順に並べた格納順の番号（並べ替えが不要だったときはnullptr）</returns>
+	const uint32_t* GetSortedOrder() const { return isSorted_ ? sortedOrder_ : nullptr; }
+
+  private: // メンバ関数
+	/// <summary>
+	/// 範囲の積分
+	/// </summary>
+	void Integrate(uint32_t first, uint32_t last, float deltaTime);
+
+	/// <summary>
+	/// 0以上1未満の乱数
+	/// </summary>
+	float NextRandom();
+
+	/// <summary>
+	/// 末尾に1個発生させる（空きがあること）
+	/// </summary>
+	void Spawn();
+
+  private: // メンバ変数
+	// 設定
+	Desc desc_;
+	// 生きている数
+	uint32_t count_ = 0;
+	// 乱数の状態（xorshift32）
+	uint32_t randomState_ = 1;
+	// 発生数の端数
+	float emissionAccumulator_ = 0.0f;
+
+	// パーティクルの状態（長さは最大数を4の倍数に切り上げ）
+	std::vector<float> positionX_;
+	std::vector<float> positionY_;
+	std::vector<float> positionZ_;
+	std::vector<float> velocityX_;
+	std::vector<float> velocityY_;
+	std::vector<float> velocityZ_;
+	// 残り寿命と、寿命の逆数
+	std::vector<float> life_;
+	std::vector<float> inverseLifetime_;
+
+	// 並べ替えキー（距離の2乗を遠い順になるよう反転したもの）
+	std::vector<uint64_t> sortKeys_;
+	// 並べ替え
+	RadixSort radixSort_;
+	// 遠い順の番号（radixSort_の結果を指す）
+	const uint32_t* sortedOrder_ = nullptr;
+	// 直前の更新以降に並べ替えたか
+	bool isSorted_ = false;
+};
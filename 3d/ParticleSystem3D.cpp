@@ -0,0 +1,270 @@
+﻿#include "ParticleSystem3D.h"
+#include "DirectXCommon.h"
+#include "TextureManager.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cassert>
+#include <d3dcompiler.h>
+#include <d3dx12.h>
+#include <string>
+
+#pragma comment(lib, "d3dcompiler.lib")
+
+using namespace DirectX;
+using namespace Microsoft::WRL;
+
+/// <summary>
+/// 静的メンバ変数の実体
+/// </summary>
+ComPtr<ID3D12RootSignature> ParticleSystem3D::sRootSignature_;
+ComPtr<ID3D12PipelineState> ParticleSystem3D::sPipelineState_;
+
+void ParticleSystem3D::StaticInitialize() {
+	// パイプライン初期化
+	InitializeGraphicsPipeline();
+}
+
+void ParticleSystem3D::InitializeGraphicsPipeline() {
+	HRESULT result = S_FALSE;
+	TextureManager* textureManager = TextureManager::GetInstance();
+	bool bindless = textureManager->IsBindless();
+	ComPtr<ID3DBlob> vsBlob;    // 頂点シェーダオブジェクト
+	ComPtr<ID3DBlob> psBlob;    // ピクセルシェーダオブジェクト
+	ComPtr<ID3DBlob> errorBlob; // エラーオブジェクト
+
+	// 頂点シェーダの読み込みとコンパイル
+	result = D3DCompileFromFile(
+	  L"Resources/shaders/ParticleVS.hlsl", // シェーダファイル名
+	  nullptr,
+	  D3D_COMPILE_STANDARD_FILE_INCLUDE, // インクルード可能にする
+	  "main", "vs_5_0", // エントリーポイント名、シェーダーモデル指定
+	  D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION, // デバッグ用設定
+	  0, &vsBlob, &errorBlob);
+	if (FAILED(result)) {
+		// errorBlobからエラー内容をstring型にコピー
+		std::string errstr;
+		errstr.resize(errorBlob->GetBufferSize());
+
+		std::copy_n(
+		  (char*)errorBlob->GetBufferPointer(), errorBlob->GetBufferSize(), errstr.begin());
+		errstr += "\n";
+		// エラー内容を出力ウィンドウに表示
+		OutputDebugStringA(errstr.c_str());
+		exit(1);
+	}
+
+	// ピクセルシェーダの読み込みとコンパイル
+	result = D3DCompileFromFile(
+	  L"Resources/shaders/ParticlePS.hlsl", // シェーダファイル名
+	  textureManager->GetShaderMacros(),
+	  D3D_COMPILE_STANDARD_FILE_INCLUDE, // インクルード可能にする
+	  "main", bindless ? "ps_5_1" : "ps_5_0", // テクスチャ配列の動的参照は5.1から
+	  D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION, // デバッグ用設定
+	  0, &psBlob, &errorBlob);
+	if (FAILED(result)) {
+		// errorBlobからエラー内容をstring型にコピー
+		std::string errstr;
+		errstr.resize(errorBlob->GetBufferSize());
+
+		std::copy_n(
+		  (char*)errorBlob->GetBufferPointer(), errorBlob->GetBufferSize(), errstr.begin());
+		errstr += "\n";
+		// エラー内容を出力ウィンドウに表示
+		OutputDebugStringA(errstr.c_str());
+		exit(1);
+	}
+
+	// 頂点レイアウト（インスタンスごと。四角形の角は頂点番号から求める）
+	D3D12_INPUT_ELEMENT_DESC inputLayout[] = {
+	  {// 中心座標(1行で書いたほうが見やすい)
+	   "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	   D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1},
+	  {// 大きさ(1行で書いたほうが見やすい)
+	   "SIZE", 0, DXGI_FORMAT_R32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	   D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1},
+	  {// 色(1行で書いたほうが見やすい)
+	   "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	   D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1},
+	};
+
+	// グラフィックスパイプラインの流れを設定
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC gpipeline{};
+	gpipeline.VS = CD3DX12_SHADER_BYTECODE(vsBlob.Get());
+	gpipeline.PS = CD3DX12_SHADER_BYTECODE(psBlob.Get());
+
+	// サンプルマスク
+	gpipeline.SampleMask = D3D12_DEFAULT_SAMPLE_MASK; // 標準設定
+	// ラスタライザステート
+	gpipeline.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
+	gpipeline.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+	// デプスステンシルステート（奥から順に描くので深度は比較だけ）
+	gpipeline.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
+	gpipeline.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
+
+	// レンダーターゲットのブレンド設定
+	D3D12_RENDER_TARGET_BLEND_DESC blenddesc{};
+	blenddesc.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL; // RBGA全てのチャンネルを描画
+	blenddesc.BlendEnable = true;
+	blenddesc.BlendOp = D3D12_BLEND_OP_ADD;
+	blenddesc.SrcBlend = D3D12_BLEND_SRC_ALPHA;
+	blenddesc.DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+
+	blenddesc.BlendOpAlpha = D3D12_BLEND_OP_ADD;
+	blenddesc.SrcBlendAlpha = D3D12_BLEND_ONE;
+	blenddesc.DestBlendAlpha = D3D12_BLEND_ZERO;
+
+	// ブレンドステートの設定
+	gpipeline.BlendState.RenderTarget[0] = blenddesc;
+
+	// 深度バッファのフォーマット
+	gpipeline.DSVFormat = DXGI_FORMAT_D32_FLOAT;
+
+	// 頂点レイアウトの設定
+	gpipeline.InputLayout.pInputElementDescs = inputLayout;
+	gpipeline.InputLayout.NumElements = _countof(inputLayout);
+
+	// 図形の形状設定（三角形）
+	gpipeline.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+
+	gpipeline.NumRenderTargets = 1;                            // 描画対象は1つ
+	gpipeline.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB; // 0～255指定のRGBA
+	gpipeline.SampleDesc.Count = 1; // 1ピクセルにつき1回サンプリング
+
+	// デスクリプタレンジ
+	CD3DX12_DESCRIPTOR_RANGE descRangeSRV;
+	descRangeSRV.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0); // t0 レジスタ
+	// バインドレス時はt0から全テクスチャ
+	CD3DX12_DESCRIPTOR_RANGE descRangeTextures;
+	descRangeTextures.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, UINT_MAX, 0);
+
+	// ルートパラメータ
+	CD3DX12_ROOT_PARAMETER rootparams[3];
+	rootparams[0].InitAsConstantBufferView(0, 0, D3D12_SHADER_VISIBILITY_VERTEX);
+	if (bindless) {
+		// テクスチャ番号（b1 レジスタ）
+		rootparams[1].InitAsConstants(1, 1, 0, D3D12_SHADER_VISIBILITY_PIXEL);
+	} else {
+		rootparams[1].InitAsDescriptorTable(1, &descRangeSRV, D3D12_SHADER_VISIBILITY_ALL);
+	}
+	rootparams[2].InitAsDescriptorTable(1, &descRangeTextures, D3D12_SHADER_VISIBILITY_PIXEL);
+
+	// スタティックサンプラー
+	CD3DX12_STATIC_SAMPLER_DESC samplerDesc = CD3DX12_STATIC_SAMPLER_DESC(0);
+
+	// ルートシグネチャの設定
+	CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc;
+	rootSignatureDesc.Init_1_0(
+	  bindless ? _countof(rootparams) : _countof(rootparams) - 1, rootparams, 1, &samplerDesc,
+	  D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+
+	ComPtr<ID3DBlob> rootSigBlob;
+	// バージョン自動判定のシリアライズ
+	result = D3DX12SerializeVersionedRootSignature(
+	  &rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1_0, &rootSigBlob, &errorBlob);
+	assert(SUCCEEDED(result));
+	// ルートシグネチャの生成
+	result = DirectXCommon::GetInstance()->GetDevice()->CreateRootSignature(
+	  0, rootSigBlob->GetBufferPointer(), rootSigBlob->GetBufferSize(),
+	  IID_PPV_ARGS(&sRootSignature_));
+	assert(SUCCEEDED(result));
+
+	gpipeline.pRootSignature = sRootSignature_.Get();
+
+	// グラフィックスパイプラインの生成
+	result = DirectXCommon::GetInstance()->GetDevice()->CreateGraphicsPipelineState(
+	  &gpipeline, IID_PPV_ARGS(&sPipelineState_));
+	assert(SUCCEEDED(result));
+}
+
+ParticleEmitter3D* ParticleSystem3D::CreateEmitter(const ParticleEmitter3D::Desc& desc) {
+	emitters_.push_back(std::make_unique<ParticleEmitter3D>(desc));
+	return emitters_.back().get();
+}
+
+void ParticleSystem3D::RemoveEmitter(ParticleEmitter3D* emitter) {
+	auto it = std::find_if(
+	  emitters_.begin(), emitters_.end(),
+	  [emitter](const std::unique_ptr<ParticleEmitter3D>& e) { return e.get() == emitter; });
+	assert(it != emitters_.end());
+	emitters_.erase(it);
+}
+
+void ParticleSystem3D::Update(float deltaTime) {
+	ThreadPool* threadPool = ThreadPool::GetInstance();
+	for (const std::unique_ptr<ParticleEmitter3D>& emitter : emitters_) {
+		emitter->Update(deltaTime, threadPool);
+	}
+}
+
+void ParticleSystem3D::Draw(
+  ID3D12GraphicsCommandList* commandList, const ViewProjection& viewProjection) {
+	assert(commandList);
+
+	// 発生源同士は発生位置が遠い順に描く
+	XMVECTOR eye = XMLoadFloat3(&viewProjection.eye);
+	auto distanceSq = [eye](const ParticleEmitter3D* emitter) {
+		XMVECTOR position = XMLoadFloat3(&emitter->GetDesc().position);
+		return XMVectorGetX(XMVector3LengthSq(XMVectorSubtract(position, eye)));
+	};
+	drawOrder_.clear();
+	for (const std::unique_ptr<ParticleEmitter3D>& emitter : emitters_) {
+		if (emitter->GetCount() > 0) {
+			drawOrder_.push_back(emitter.get());
+		}
+	}
+	if (drawOrder_.empty()) {
+		return;
+	}
+	std::stable_sort(
+	  drawOrder_.begin(), drawOrder_.end(),
+	  [&distanceSq](const ParticleEmitter3D* a, const ParticleEmitter3D* b) {
+		  return distanceSq(a) > distanceSq(b);
+	  });
+
+	// 共通の設定
+	commandList->SetPipelineState(sPipelineState_.Get());
+	commandList->SetGraphicsRootSignature(sRootSignature_.Get());
+	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+	commandList->SetGraphicsRootConstantBufferView(
+	  static_cast<UINT>(RoomParameter::kViewProjection), viewProjection.GetGPUVirtualAddress());
+
+	// デスクリプタヒープは描画ごとではなくここで1回だけセットする
+	TextureManager* textureManager = TextureManager::GetInstance();
+	textureManager->SetDescriptorHeap(commandList);
+	if (textureManager->IsBindless()) {
+		textureManager->SetGraphicsRootTextureTable(
+		  commandList, static_cast<UINT>(RoomParameter::kTextureTable));
+	}
+
+	DirectXCommon* dxCommon = DirectXCommon::GetInstance();
+	for (ParticleEmitter3D* emitter : drawOrder_) {
+		// 遠い順に並べたインスタンスデータを現在のフレームのアップロード領域へ書き込む
+		emitter->SortBackToFront(viewProjection.eye);
+		uint32_t count = emitter->GetCount();
+		size_t size = sizeof(ParticleEmitter3D::Instance) * count;
+		LinearAllocator::Allocation instances = dxCommon->AllocateUpload(size);
+		assert(instances.cpuAddress);
+		emitter->WriteInstances(static_cast<ParticleEmitter3D::Instance*>(instances.cpuAddress));
+
+		// 頂点バッファビュー
+		D3D12_VERTEX_BUFFER_VIEW vbView{};
+		vbView.BufferLocation = instances.gpuAddress;
+		vbView.SizeInBytes = static_cast<UINT>(size);
+		vbView.StrideInBytes = sizeof(ParticleEmitter3D::Instance);
+		commandList->IASetVertexBuffers(0, 1, &vbView);
+
+		textureManager->SetGraphicsRootTexture(
+		  commandList, static_cast<UINT>(RoomParameter::kTexture),
+		  emitter->GetDesc().textureHandle);
+		// 四角形4頂点をパーティクル数だけ描く
+		commandList->DrawInstanced(4, count, 0, 0);
+	}
+}
+
+uint32_t ParticleSystem3D::GetParticleCount() const {
+	uint32_t count = 0;
+	for (const std::unique_ptr<ParticleEmitter3D>& emitter : emitters_) {
+		count += emitter->GetCount();
+	}
+	return count;
+}
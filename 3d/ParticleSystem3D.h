@@ -0,0 +1,82 @@
+﻿#pragma once
+
+#include "ParticleEmitter3D.h"
+#include "ViewProjection.h"
+#include <d3d12.h>
+#include <memory>
+#include <vector>
+#include <wrl.h>
+
+/// <summary>
+/// 3Dパーティクルの管理
+/// 積分はスレッドプールで行い、描画では発生源ごとに視点から遠い順に並べたインスタンスデータを
+/// フレームごとのアップロード領域に書き込んで、カメラを向く四角形として1回のインスタンス描画で描く
+/// </summary>
+class ParticleSystem3D {
+  public: // 列挙子
+	/// <summary>
+	/// ルートパラメータ番号
+	/// </summary>
+	enum class RoomParameter {
+		kViewProjection, // ビュープロジェクション変換行列
+		kTexture,        // テクスチャ（バインドレス時はテクスチャ番号のルート定数）
+		kTextureTable,   // 全テクスチャのテーブル（バインドレス時のみ）
+	};
+
+  public: // 静的メンバ関数
+	/// <summary>
+	/// 静的初期化
+	/// </summary>
+	static void StaticInitialize();
+
+  public: // メンバ関数
+	/// <summary>
+	/// 発生源の生成
+	/// </summary>
+	/// <param name="desc">発生源の設定</param>
+	/// <returns>生成した発生源（このクラスが所有する）</returns>
+	ParticleEmitter3D* CreateEmitter(const ParticleEmitter3D::Desc& desc);
+
+	/// <summary>
+	/// 発生源の削除
+	/// </summary>
+	/// <param name="emitter">CreateEmitterで生成した発生源</param>
+	void RemoveEmitter(ParticleEmitter3D* emitter);
+
+	/// <summary>
+	/// 全ての発生源の更新
+	/// </summary>
+	/// <param name="deltaTime">経過時間（秒）</param>
+	void Update(float deltaTime);
+
+	/// <summary>
+	/// 描画（不透明なモデルを描いた後に呼ぶ。深度は書き込まない）
+	/// </summary>
+	/// <param name="commandList">描画コマンドリスト</param>
+	/// <param name="viewProjection">ビュープロジェクション</param>
+	void Draw(ID3D12GraphicsCommandList* commandList, const ViewProjection& viewProjection);
+
+	/// <summary>
+	/// 生きているパーティクル数の合計の取得
+	/// </summary>
+	/// <returns>数</returns>
+	uint32_t GetParticleCount() const;
+
+  private: // 静的メンバ変数
+	// ルートシグネチャ
+	static Microsoft::WRL::ComPtr<ID3D12RootSignature> sRootSignature_;
+	// パイプラインステートオブジェクト
+	static Microsoft::WRL::ComPtr<ID3D12PipelineState> sPipelineState_;
+
+  private: // 静的メンバ関数
+	/// <summary>
+	/// グラフィックスパイプラインの初期化
+	/// </summary>
+	static void InitializeGraphicsPipeline();
+
+  private: // メンバ変数
+	// 発生源
+	std::vector<std::unique_ptr<ParticleEmitter3D>> emitters_;
+	// 描く順の発生源（遠い順）
+	std::vector<ParticleEmitter3D*> drawOrder_;
+};
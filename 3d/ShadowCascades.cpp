@@ -0,0 +1,239 @@
+﻿#include "ShadowCascades.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace {
+
+// 4個並んだ値の読み込み
+XMVECTOR Load4(const std::vector<float>& values, uint32_t index) {
+	return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&values[index]));
+}
+
+// 光線方向に垂直な上方向（真上か真下を向いているときは奥を上にする）
+XMVECTOR UpVectorOf(const XMFLOAT3& direction) {
+	return std::abs(direction.y) > 0.99f ? XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f)
+	                                     : XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+}
+
+} // namespace
+
+void ShadowCascades::ComputeSplits(float nearZ, float farZ, float lambda, float* splits) {
+	// 手前ほど細かく区切る対数分割と、奥でも粗くなりすぎない等分を混ぜる
+	for (uint32_t i = 0; i <= kCascadeCount; i++) {
+		float t = static_cast<float>(i) / kCascadeCount;
+		float logSplit = nearZ * std::pow(farZ / nearZ, t);
+		float uniformSplit = nearZ + (farZ - nearZ) * t;
+		splits[i] = uniformSplit + (logSplit - uniformSplit) * lambda;
+	}
+	splits[0] = nearZ;
+	splits[kCascadeCount] = farZ;
+}
+
+XMMATRIX ShadowCascades::ComputeSpotViewProjection(
+  const XMFLOAT3& position, const XMFLOAT3& direction, float outerAngleCos, float range,
+  float nearZ) {
+	XMMATRIX matView = XMMatrixLookToLH(
+	  XMLoadFloat3(&position), XMVector3Normalize(XMLoadFloat3(&direction)),
+	  UpVectorOf(direction));
+	// 円錐の外側の角度を覆う視野角（180度近くは射影できないので抑える）
+	float fovAngleY = 2.0f * std::acos((std::max)((std::min)(outerAngleCos, 1.0f), 0.0f));
+	fovAngleY = (std::min)((std::max)(fovAngleY, 0.01f), XMConvertToRadians(170.0f));
+	XMMATRIX matProjection =
+	  XMMatrixPerspectiveFovLH(fovAngleY, 1.0f, nearZ, (std::max)(range, nearZ * 2.0f));
+	return matView * matProjection;
+}
+
+void ShadowCascades::CullFrustum(
+  const XMMATRIX& matViewProjection, const XMFLOAT4* spheres, uint32_t count,
+  std::vector<uint32_t>& visible) {
+	visible.clear();
+
+	// クリップ座標の範囲から平面を取り出す（行ベクトルなので列を使う）
+	XMMATRIX columns = XMMatrixTranspose(matViewProjection);
+	XMVECTOR planes[6] = {
+	  XMVectorAdd(columns.r[3], columns.r[0]),      // 左
+	  XMVectorSubtract(columns.r[3], columns.r[0]), // 右
+	  XMVectorAdd(columns.r[3], columns.r[1]),      // 下
+	  XMVectorSubtract(columns.r[3], columns.r[1]), // 上
+	  columns.r[2],                                 // 手前
+	  XMVectorSubtract(columns.r[3], columns.r[2]), // 奥
+	};
+	XMFLOAT4 planeValues[6];
+	for (uint32_t p = 0; p < 6; p++) {
+		XMStoreFloat4(&planeValues[p], XMPlaneNormalize(planes[p]));
+	}
+
+	// 4個ずつ、全ての平面の内側か半径より近ければ重なる
+	for (uint32_t i = 0; i < count; i += 4) {
+		XMMATRIX rows;
+		for (uint32_t lane = 0; lane < 4; lane++) {
+			rows.r[lane] = i + lane < count ? XMLoadFloat4(&spheres[i + lane])
+			                                : XMVectorSet(0.0f, 0.0f, 0.0f, -1.0e30f);
+		}
+		XMMATRIX sphereColumns = XMMatrixTranspose(rows);
+		XMVECTOR negativeRadius = XMVectorNegate(sphereColumns.r[3]);
+		XMVECTOR inside = XMVectorTrueInt();
+		for (uint32_t p = 0; p < 6; p++) {
+			const XMFLOAT4& plane = planeValues[p];
+			XMVECTOR distance = XMVectorMultiplyAdd(
+			  sphereColumns.r[2], XMVectorReplicate(plane.z),
+			  XMVectorMultiplyAdd(
+			    sphereColumns.r[1], XMVectorReplicate(plane.y),
+			    XMVectorMultiplyAdd(
+			      sphereColumns.r[0], XMVectorReplicate(plane.x), XMVectorReplicate(plane.w))));
+			inside = XMVectorAndInt(inside, XMVectorGreaterOrEqual(distance, negativeRadius));
+		}
+
+		uint32_t hits[4];
+		XMStoreInt4(hits, inside);
+		for (uint32_t lane = 0; lane < 4; lane++) {
+			if (hits[lane]) {
+				visible.push_back(i + lane);
+			}
+		}
+	}
+}
+
+void ShadowCascades::Initialize(const Desc& desc) { desc_ = desc; }
+
+void ShadowCascades::Build(
+  const XMMATRIX& matView, float fovAngleY, float aspectRatio, float nearZ, float farZ,
+  const XMFLOAT3& lightDir) {
+	float splits[kCascadeCount + 1];
+	ComputeSplits(nearZ, (std::min)(farZ, desc_.maxDistance), desc_.splitLambda, splits);
+
+	// ライトのビュー行列は回転だけにして、テクセルの格子をワールド座標に固定する
+	matLightView_ = XMMatrixLookToLH(
+	  XMVectorZero(), XMVector3Normalize(XMLoadFloat3(&lightDir)), UpVectorOf(lightDir));
+	XMMATRIX matInvView = XMMatrixInverse(nullptr, matView);
+
+	// 奥行きzでの視錐台の断面の角までの距離はz * sqrt(k2)
+	float tanY = std::tan(fovAngleY * 0.5f);
+	float tanX = tanY * aspectRatio;
+	float k2 = tanX * tanX + tanY * tanY;
+
+	for (uint32_t i = 0; i < kCascadeCount; i++) {
+		Cascade& cascade = cascades_[i];
+		float splitNear = splits[i];
+		float splitFar = splits[i + 1];
+
+		// 区切りの8つの角を通る球（手前と奥の角から等距離の点を視線上に取る）
+		float centerZ = (splitFar + splitNear) * (1.0f + k2) * 0.5f;
+		float radius;
+		if (centerZ >= splitFar) {
+			// 奥の断面を囲む円で手前の角も囲める
+			centerZ = splitFar;
+			radius = splitFar * std::sqrt(k2);
+		} else {
+			float dz = splitFar - centerZ;
+			radius = std::sqrt(dz * dz + splitFar * splitFar * k2);
+		}
+		// 浮動小数の誤差で大きさが揺れないように切り上げる
+		radius = std::ceil(radius * 16.0f) / 16.0f;
+		// 中心を揃えてずれる1テクセル分を両側に足した幅を解像度で割る
+		float texelSize = 2.0f * radius / static_cast<float>(desc_.resolution - 2);
+		float halfExtent = radius + texelSize;
+
+		// 中心をライト空間へ移し、xyをテクセル単位に揃える
+		XMVECTOR centerWorld =
+		  XMVector3TransformCoord(XMVectorSet(0.0f, 0.0f, centerZ, 1.0f), matInvView);
+		XMFLOAT3 center;
+		XMStoreFloat3(&center, XMVector3TransformCoord(centerWorld, matLightView_));
+		center.x = std::floor(center.x / texelSize) * texelSize;
+		center.y = std::floor(center.y / texelSize) * texelSize;
+
+		// 光の来る側は視錐台の外から影を落とす物体も入るように延ばす
+		cascade.boundsMin = {
+		  center.x - halfExtent, center.y - halfExtent, center.z - radius - desc_.casterDistance};
+		cascade.boundsMax = {center.x + halfExtent, center.y + halfExtent, center.z + radius};
+		cascade.matViewProjection = matLightView_ * XMMatrixOrthographicOffCenterLH(
+		                                              cascade.boundsMin.x, cascade.boundsMax.x,
+		                                              cascade.boundsMin.y, cascade.boundsMax.y,
+		                                              cascade.boundsMin.z, cascade.boundsMax.z);
+		cascade.splitNear = splitNear;
+		cascade.splitFar = splitFar;
+		cascade.texelSize = texelSize;
+	}
+}
+
+void ShadowCascades::Cull(
+  const XMFLOAT4* spheres, uint32_t count, std::vector<uint32_t>* visible) const {
+	// 境界球の中心をライト空間へ（4個ずつ、行を列に入れ替えてまとめて変換）
+	uint32_t paddedCount = (count + 3) / 4 * 4;
+	centerX_.resize(paddedCount);
+	centerY_.resize(paddedCount);
+	centerZ_.resize(paddedCount);
+	radiusSq_.resize(paddedCount);
+	XMFLOAT4X4 m;
+	XMStoreFloat4x4(&m, matLightView_);
+	for (uint32_t i = 0; i < paddedCount; i += 4) {
+		XMMATRIX rows;
+		for (uint32_t lane = 0; lane < 4; lane++) {
+			rows.r[lane] = i + lane < count ? XMLoadFloat4(&spheres[i + lane]) : XMVectorZero();
+		}
+		XMMATRIX columns = XMMatrixTranspose(rows);
+		XMVECTOR x = columns.r[0];
+		XMVECTOR y = columns.r[1];
+		XMVECTOR z = columns.r[2];
+		XMVECTOR lightX = XMVectorMultiplyAdd(
+		  z, XMVectorReplicate(m._31),
+		  XMVectorMultiplyAdd(
+		    y, XMVectorReplicate(m._21),
+		    XMVectorMultiplyAdd(x, XMVectorReplicate(m._11), XMVectorReplicate(m._41))));
+		XMVECTOR lightY = XMVectorMultiplyAdd(
+		  z, XMVectorReplicate(m._32),
+		  XMVectorMultiplyAdd(
+		    y, XMVectorReplicate(m._22),
+		    XMVectorMultiplyAdd(x, XMVectorReplicate(m._12), XMVectorReplicate(m._42))));
+		XMVECTOR lightZ = XMVectorMultiplyAdd(
+		  z, XMVectorReplicate(m._33),
+		  XMVectorMultiplyAdd(
+		    y, XMVectorReplicate(m._23),
+		    XMVectorMultiplyAdd(x, XMVectorReplicate(m._13), XMVectorReplicate(m._43))));
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&centerX_[i]), lightX);
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&centerY_[i]), lightY);
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&centerZ_[i]), lightZ);
+		XMStoreFloat4(
+		  reinterpret_cast<XMFLOAT4*>(&radiusSq_[i]), XMVectorMultiply(columns.r[3], columns.r[3]));
+	}
+	for (uint32_t i = count; i < paddedCount; i++) {
+		radiusSq_[i] = -1.0f;
+	}
+
+	// カスケードの箱と境界球の最短距離の2乗を4個ずつ求める
+	XMVECTOR zero = XMVectorZero();
+	for (uint32_t c = 0; c < kCascadeCount; c++) {
+		const Cascade& cascade = cascades_[c];
+		XMVECTOR minX = XMVectorReplicate(cascade.boundsMin.x);
+		XMVECTOR minY = XMVectorReplicate(cascade.boundsMin.y);
+		XMVECTOR minZ = XMVectorReplicate(cascade.boundsMin.z);
+		XMVECTOR maxX = XMVectorReplicate(cascade.boundsMax.x);
+		XMVECTOR maxY = XMVectorReplicate(cascade.boundsMax.y);
+		XMVECTOR maxZ = XMVectorReplicate(cascade.boundsMax.z);
+
+		visible[c].clear();
+		for (uint32_t i = 0; i < paddedCount; i += 4) {
+			XMVECTOR cx = Load4(centerX_, i);
+			XMVECTOR cy = Load4(centerY_, i);
+			XMVECTOR cz = Load4(centerZ_, i);
+			XMVECTOR dx =
+			  XMVectorMax(XMVectorMax(XMVectorSubtract(minX, cx), XMVectorSubtract(cx, maxX)), zero);
+			XMVECTOR dy =
+			  XMVectorMax(XMVectorMax(XMVectorSubtract(minY, cy), XMVectorSubtract(cy, maxY)), zero);
+			XMVECTOR dz =
+			  XMVectorMax(XMVectorMax(XMVectorSubtract(minZ, cz), XMVectorSubtract(cz, maxZ)), zero);
+			XMVECTOR distanceSq =
+			  XMVectorMultiplyAdd(dz, dz, XMVectorMultiplyAdd(dy, dy, XMVectorMultiply(dx, dx)));
+
+			uint32_t hits[4];
+			XMStoreInt4(hits, XMVectorLessOrEqual(distanceSq, Load4(radiusSq_, i)));
+			for (uint32_t lane = 0; lane < 4; lane++) {
+				if (hits[lane]) {
+					visible[c].push_back(i + lane);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,140 @@
+﻿#pragma once
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 影の視錐台の計算
+/// 平行光源はカメラの視錐台を奥行き方向に区切ったカスケードごとに正射影を合わせ、
+/// スポットライトは光の円錐を囲む透視射影を作る。影を落とす物体の境界球をそれぞれで判定する。
+/// 行列と座標だけを扱うので、デバイスなしで動作する
+/// </summary>
+class ShadowCascades {
+  public: // 定数
+	// カスケード数
+	static const uint32_t kCascadeCount = 4;
+
+  public: // サブクラス
+	/// <summary>
+	/// 設定
+	/// </summary>
+	struct Desc {
+		// 1カスケードのシャドウマップの解像度（テクセル）
+		uint32_t resolution = 1024;
+		// 区切りの対数分割の割合（0で等分、1で対数）
+		float splitLambda = 0.75f;
+		// 影を描く最大距離（カメラのビュー空間の奥行き）
+		float maxDistance = 100.0f;
+		// 視錐台の外から影を落とす物体を含める、光の来る側への延長
+		float casterDistance = 100.0f;
+	};
+
+	/// <summary>
+	/// カスケード
+	/// </summary>
+	struct Cascade {
+		// ワールド座標からシャドウマップのクリップ座標への変換（ライトのビュー × 正射影）
+		DirectX::XMMATRIX matViewProjection;
+		// カメラのビュー空間の奥行きの範囲
+		float splitNear;
+		float splitFar;
+		// ライト空間の範囲（x, y, zの最小と最大）
+		DirectX::XMFLOAT3 boundsMin;
+		DirectX::XMFLOAT3 boundsMax;
+		// 1テクセルのワールド座標での大きさ
+		float texelSize;
+	};
+
+  public: // 静的メンバ関数
+	/// <summary>
+	/// 奥行きの区切りの計算（対数分割と等分を混ぜる）
+	/// </summary>
+	/// <param name="nearZ">手前</param>
+	/// <param name="farZ">奥</param>
+	/// <param name="lambda">対数分割の割合</param>
+	/// <param name="splits">区切り（kCascadeCount + 1個。先頭がnearZ、末尾がfarZ）</param>
+	static void ComputeSplits(float nearZ, float farZ, float lambda, float* splits);
+
+	/// <summary>
+	/// スポットライトの影の変換の計算
+	/// </summary>
+	/// <param name="position">ライト座標</param>
+	/// <param name="direction">光線方向（単位ベクトル）</param>
+	/// <param name="outerAngleCos">減衰終了角度のコサイン</param>
+	/// <param name="range">影響範囲の半径</param>
+	/// <param name="nearZ">深度限界（手前側）</param>
+	/// <returns>ワールド座標からシャドウマップのクリップ座標への変換</returns>
+	static DirectX::XMMATRIX ComputeSpotViewProjection(
+	  const DirectX::XMFLOAT3& position, const DirectX::XMFLOAT3& direction, float outerAngleCos,
+	  float range, float nearZ = 0.1f);
+
+	/// <summary>
+	/// 視錐台に重なる境界球の判定（4個ずつSIMDで判定する）
+	/// </summary>
+	/// <param name="matViewProjection">ワールド座標からクリップ座標への変換</param>
+	/// <param name="spheres">ワールド座標の境界球（xyz:中心 w:半径）</param>
+	/// <param name="count">境界球の数</param>
+	/// <param name="visible">重なる境界球の番号</param>
+	static void CullFrustum(
+	  const DirectX::XMMATRIX& matViewProjection, const DirectX::XMFLOAT4* spheres,
+	  uint32_t count, std::vector<uint32_t>& visible);
+
+  public: // メンバ関数
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="desc">設定</param>
+	void Initialize(const Desc& desc);
+
+	/// <summary>
+	/// カスケードの構築
+	/// 区切りを囲む球に正射影を合わせるので、カメラが回っても大きさは変わらない。
+	/// 中心はライト空間でテクセル単位に揃え、カメラが動いても影のふちがちらつかないようにする
+	/// </summary>
+	/// <param name="matView">カメラのビュー行列</param>
+	/// <param name="fovAngleY">垂直方向視野角</param>
+	/// <param name="aspectRatio">アスペクト比</param>
+	/// <param name="nearZ">深度限界（手前側）</param>
+	/// <param name="farZ">深度限界（奥側）</param>
+	/// <param name="lightDir">光線方向（単位ベクトル）</param>
+	void Build(
+	  const DirectX::XMMATRIX& matView, float fovAngleY, float aspectRatio, float nearZ,
+	  float farZ, const DirectX::XMFLOAT3& lightDir);
+
+	/// <summary>
+	/// カスケードごとに重なる境界球の判定（4個ずつSIMDで判定する）
+	/// </summary>
+	/// <param name="spheres">ワールド座標の境界球（xyz:中心 w:半径）</param>
+	/// <param name="count">境界球の数</param>
+	/// <param name="visible">カスケードごとの重なる境界球の番号（kCascadeCount個）</param>
+	void Cull(
+	  const DirectX::XMFLOAT4* spheres, uint32_t count, std::vector<uint32_t>* visible) const;
+
+	/// <summary>
+	/// カスケードの取得
+	/// </summary>
+	/// <param name="index">番号（手前から）</param>
+	/// <returns>カスケード</returns>
+	const Cascade& GetCascade(uint32_t index) const { return cascades_[index]; }
+
+	/// <summary>
+	/// 設定の取得
+	/// </summary>
+	/// <returns>設定</returns>
+	const Desc& GetDesc() const { return desc_; }
+
+  private: // メンバ変数
+	// 設定
+	Desc desc_;
+	// ライトのビュー行列（回転のみ。テクセルの格子をワールド座標に固定する）
+	DirectX::XMMATRIX matLightView_ = DirectX::XMMatrixIdentity();
+	// カスケード
+	Cascade cascades_[kCascadeCount] = {};
+	// ライト空間の境界球の中心（4の倍数に埋める）
+	mutable std::vector<float> centerX_;
+	mutable std::vector<float> centerY_;
+	mutable std::vector<float> centerZ_;
+	// 境界球の半径の2乗（埋めた分は負にして、どのカスケードにも入らないようにする）
+	mutable std::vector<float> radiusSq_;
+};
@@ -0,0 +1,329 @@
+﻿#include "ShadowMap.h"
+#include "DirectXCommon.h"
+#include "Model.h"
+#include "TextureManager.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <d3dcompiler.h>
+#include <d3dx12.h>
+#include <string>
+
+#pragma comment(lib, "d3dcompiler.lib")
+
+using namespace DirectX;
+using namespace Microsoft::WRL;
+
+namespace {
+
+// 深度バイアス（自分自身の影のしま模様を防ぐ）
+const INT kDepthBias = 100;
+const float kDepthBiasClamp = 0.01f;
+const float kSlopeScaledDepthBias = 1.5f;
+
+} // namespace
+
+ShadowMap* ShadowMap::GetInstance() {
+	static ShadowMap instance;
+	return &instance;
+}
+
+void ShadowMap::Initialize() {
+	ShadowCascades::Desc desc;
+	desc.resolution = kCascadeResolution;
+	cascades_.Initialize(desc);
+
+	InitializeGraphicsPipeline();
+	CreateAtlas();
+
+	// 影なしの定数は0のまま
+	disabledConstBuffer_.Edit();
+}
+
+void ShadowMap::InitializeGraphicsPipeline() {
+	HRESULT result = S_FALSE;
+	ComPtr<ID3DBlob> vsBlob;    // 頂点シェーダオブジェクト
+	ComPtr<ID3DBlob> errorBlob; // エラーオブジェクト
+
+	// 頂点シェーダの読み込みとコンパイル
+	result = D3DCompileFromFile(
+	  L"Resources/shaders/ShadowVS.hlsl", // シェーダファイル名
+	  nullptr,
+	  D3D_COMPILE_STANDARD_FILE_INCLUDE, // インクルード可能にする
+	  "main", "vs_5_0", // エントリーポイント名、シェーダーモデル指定
+	  D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION, // デバッグ用設定
+	  0, &vsBlob, &errorBlob);
+	if (FAILED(result)) {
+		// errorBlobからエラー内容をstring型にコピー
+		std::string errstr;
+		errstr.resize(errorBlob->GetBufferSize());
+
+		std::copy_n(
+		  (char*)errorBlob->GetBufferPointer(), errorBlob->GetBufferSize(), errstr.begin());
+		errstr += "\n";
+		// エラー内容を出力ウィンドウに表示
+		OutputDebugStringA(errstr.c_str());
+		exit(1);
+	}
+
+	// 頂点レイアウト（座標だけ読む。ストライドはモデルの頂点バッファビューに従う）
+	D3D12_INPUT_ELEMENT_DESC inputLayout[] = {
+	  {// xy座標(1行で書いたほうが見やすい)
+	   "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	   D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	};
+
+	// グラフィックスパイプラインの流れを設定（ピクセルシェーダなし）
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC gpipeline{};
+	gpipeline.VS = CD3DX12_SHADER_BYTECODE(vsBlob.Get());
+
+	// サンプルマスク
+	gpipeline.SampleMask = D3D12_DEFAULT_SAMPLE_MASK; // 標準設定
+	// ラスタライザステート
+	gpipeline.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
+	gpipeline.RasterizerState.DepthBias = kDepthBias;
+	gpipeline.RasterizerState.DepthBiasClamp = kDepthBiasClamp;
+	gpipeline.RasterizerState.SlopeScaledDepthBias = kSlopeScaledDepthBias;
+	// デプスステンシルステート
+	gpipeline.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
+	// ブレンドステート（描画対象はないので標準のまま）
+	gpipeline.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
+
+	// 深度バッファのフォーマット
+	gpipeline.DSVFormat = DXGI_FORMAT_D32_FLOAT;
+
+	// 頂点レイアウトの設定
+	gpipeline.InputLayout.pInputElementDescs = inputLayout;
+	gpipeline.InputLayout.NumElements = _countof(inputLayout);
+
+	// 図形の形状設定（三角形）
+	gpipeline.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+
+	gpipeline.NumRenderTargets = 0; // 深度だけを描く
+	gpipeline.SampleDesc.Count = 1; // 1ピクセルにつき1回サンプリング
+
+	// ルートパラメータ
+	CD3DX12_ROOT_PARAMETER rootparams[2];
+	rootparams[0].InitAsConstantBufferView(0, 0, D3D12_SHADER_VISIBILITY_VERTEX);
+	rootparams[1].InitAsConstantBufferView(1, 0, D3D12_SHADER_VISIBILITY_VERTEX);
+
+	// ルートシグネチャの設定
+	CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc;
+	rootSignatureDesc.Init_1_0(
+	  _countof(rootparams), rootparams, 0, nullptr,
+	  D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+
+	ComPtr<ID3DBlob> rootSigBlob;
+	// バージョン自動判定のシリアライズ
+	result = D3DX12SerializeVersionedRootSignature(
+	  &rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1_0, &rootSigBlob, &errorBlob);
+	assert(SUCCEEDED(result));
+	// ルートシグネチャの生成
+	result = DirectXCommon::GetInstance()->GetDevice()->CreateRootSignature(
+	  0, rootSigBlob->GetBufferPointer(), rootSigBlob->GetBufferSize(),
+	  IID_PPV_ARGS(&rootSignature_));
+	assert(SUCCEEDED(result));
+
+	gpipeline.pRootSignature = rootSignature_.Get();
+
+	// グラフィックスパイプラインの生成
+	result = DirectXCommon::GetInstance()->GetDevice()->CreateGraphicsPipelineState(
+	  &gpipeline, IID_PPV_ARGS(&pipelineState_));
+	assert(SUCCEEDED(result));
+}
+
+void ShadowMap::CreateAtlas() {
+	HRESULT result = S_FALSE;
+	ID3D12Device* device = DirectXCommon::GetInstance()->GetDevice();
+
+	// カスケードとスポットライトのタイルを最小の大きさに詰める
+	std::vector<RectPacker::Size> sizes;
+	for (uint32_t i = 0; i < kCascadeCount; i++) {
+		sizes.push_back({kCascadeResolution, kCascadeResolution});
+	}
+	for (uint32_t i = 0; i < kSpotLightNum; i++) {
+		sizes.push_back({kSpotResolution, kSpotResolution});
+	}
+	bool packed = RectPacker::PackMinimum(
+	  D3D12_REQ_TEXTURE2D_U_OR_V_DIMENSION, sizes, tiles_, atlasSize_);
+	assert(packed);
+	(void)packed;
+
+	// 深度として書き、シェーダからはR32_FLOATとして読むので型なしで生成する
+	CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+	CD3DX12_RESOURCE_DESC atlasDesc = CD3DX12_RESOURCE_DESC::Tex2D(
+	  DXGI_FORMAT_R32_TYPELESS, atlasSize_.width, atlasSize_.height, 1, 1, 1, 0,
+	  D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL);
+	CD3DX12_CLEAR_VALUE clearValue = CD3DX12_CLEAR_VALUE(DXGI_FORMAT_D32_FLOAT, 1.0f, 0);
+	result = device->CreateCommittedResource(
+	  &heapProps, D3D12_HEAP_FLAG_NONE, &atlasDesc,
+	  D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, // 描画時以外は読み込みに使用
+	  &clearValue, IID_PPV_ARGS(&atlas_));
+	assert(SUCCEEDED(result));
+
+	// 深度ビュー用デスクリプタヒープ作成
+	D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc{};
+	dsvHeapDesc.NumDescriptors = 1;                    // 深度ビューは1つ
+	dsvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV; // デプスステンシルビュー
+	result = device->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(&dsvHeap_));
+	assert(SUCCEEDED(result));
+
+	// 深度ビュー作成
+	D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc = {};
+	dsvDesc.Format = DXGI_FORMAT_D32_FLOAT; // 深度値フォーマット
+	dsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
+	device->CreateDepthStencilView(
+	  atlas_.Get(), &dsvDesc, dsvHeap_->GetCPUDescriptorHandleForHeapStart());
+
+	// シェーダリソースビューはテクスチャとして登録する
+	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+	srvDesc.Format = DXGI_FORMAT_R32_FLOAT;
+	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+	srvDesc.Texture2D.MipLevels = 1;
+	textureHandle_ = TextureManager::CreateFromResource("ShadowMap", atlas_.Get(), srvDesc);
+}
+
+void ShadowMap::AddCaster(Model* model, const WorldTransform& worldTransform) {
+	assert(model);
+	casters_.push_back({model, &worldTransform});
+}
+
+void ShadowMap::Render(
+  ID3D12GraphicsCommandList* commandList, const ViewProjection& viewProjection) {
+	DirectXCommon* dxCommon = DirectXCommon::GetInstance();
+	LightGroup* lightGroup = Model::GetLightGroup();
+	// 影を落とすスポットライトの番号を確定させる
+	lightGroup->Update();
+
+	// 影を落とす物体の境界球
+	uint32_t casterCount = static_cast<uint32_t>(casters_.size());
+	casterSpheres_.resize(casterCount);
+	for (uint32_t i = 0; i < casterCount; i++) {
+		casterSpheres_[i] = casters_[i].model->GetWorldBoundingSphere(*casters_[i].worldTransform);
+		// ワールド行列を現在のフレームへ転送しておく
+		casters_[i].worldTransform->GetGPUVirtualAddress();
+	}
+
+	// アトラスを深度書き込みに切り替えてクリア
+	CD3DX12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(
+	  atlas_.Get(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+	commandList->ResourceBarrier(1, &barrier);
+	CD3DX12_CPU_DESCRIPTOR_HANDLE dsvH =
+	  CD3DX12_CPU_DESCRIPTOR_HANDLE(dsvHeap_->GetCPUDescriptorHandleForHeapStart());
+	commandList->OMSetRenderTargets(0, nullptr, false, &dsvH);
+	commandList->ClearDepthStencilView(dsvH, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
+
+	// パイプラインステートとルートシグネチャの設定
+	commandList->SetPipelineState(pipelineState_.Get());
+	commandList->SetGraphicsRootSignature(rootSignature_.Get());
+	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+	ConstBufferData& constData = constBuffer_.Edit();
+	constData.cascadeCount = 0;
+	constData.spotLightCount = 0;
+
+	// 平行光源のカスケード
+	if (
+	  0 <= dirLightIndex_ && dirLightIndex_ < LightGroup::kDirLightNum &&
+	  lightGroup->IsDirLightActive(dirLightIndex_)) {
+		XMFLOAT3 lightDir;
+		XMStoreFloat3(&lightDir, lightGroup->GetDirLightDir(dirLightIndex_));
+		cascades_.Build(
+		  viewProjection.matView, viewProjection.fovAngleY, viewProjection.aspectRatio,
+		  viewProjection.nearZ, viewProjection.farZ, lightDir);
+		cascades_.Cull(casterSpheres_.data(), casterCount, cascadeVisible_);
+
+		float splits[kCascadeCount];
+		for (uint32_t i = 0; i < kCascadeCount; i++) {
+			const ShadowCascades::Cascade& cascade = cascades_.GetCascade(i);
+			DrawTile(commandList, cascade.matViewProjection, tiles_[i], cascadeVisible_[i]);
+			constData.cascadeViewProjections[i] = cascade.matViewProjection;
+			constData.cascadeRects[i] = GetTileRect(tiles_[i]);
+			splits[i] = cascade.splitFar;
+		}
+		constData.cascadeSplits = {splits[0], splits[1], splits[2], splits[3]};
+		constData.cascadeCount = kCascadeCount;
+		constData.dirLightIndex = static_cast<uint32_t>(dirLightIndex_);
+	}
+
+	// スポットライト
+	uint32_t spotLightCount = (std::min)(
+	  static_cast<uint32_t>(lightGroup->GetShadowSpotLightCount()), kSpotLightNum);
+	for (uint32_t i = 0; i < spotLightCount; i++) {
+		LightGroup::ShadowSpotLight spotLight = lightGroup->GetShadowSpotLight(i);
+		XMMATRIX matViewProjection = ShadowCascades::ComputeSpotViewProjection(
+		  spotLight.position, spotLight.direction, spotLight.outerAngleCos, spotLight.range);
+		ShadowCascades::CullFrustum(
+		  matViewProjection, casterSpheres_.data(), casterCount, spotVisible_);
+
+		const RectPacker::Rect& tile = tiles_[kCascadeCount + i];
+		DrawTile(commandList, matViewProjection, tile, spotVisible_);
+		constData.spotViewProjections[i] = matViewProjection;
+		constData.spotRects[i] = GetTileRect(tile);
+	}
+	constData.spotLightCount = spotLightCount;
+
+	// アトラスを読み込みに戻し、レンダーターゲットを戻す
+	barrier = CD3DX12_RESOURCE_BARRIER::Transition(
+	  atlas_.Get(), D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	commandList->ResourceBarrier(1, &barrier);
+	dxCommon->SetRenderTargetState(commandList);
+
+	casters_.clear();
+	renderedFrameNumber_ = dxCommon->GetFrameNumber();
+	// 並列記録で共有するので、ここで現在のフレームへ転送しておく
+	constBuffer_.GetGPUVirtualAddress();
+}
+
+void ShadowMap::DrawTile(
+  ID3D12GraphicsCommandList* commandList, const XMMATRIX& matViewProjection,
+  const RectPacker::Rect& tile, const std::vector<uint32_t>& visible) {
+	// ビューポートとシザー矩形をタイルに合わせる
+	CD3DX12_VIEWPORT viewport = CD3DX12_VIEWPORT(
+	  float(tile.x), float(tile.y), float(tile.width), float(tile.height));
+	commandList->RSSetViewports(1, &viewport);
+	CD3DX12_RECT rect =
+	  CD3DX12_RECT(tile.x, tile.y, tile.x + tile.width, tile.y + tile.height);
+	commandList->RSSetScissorRects(1, &rect);
+
+	// タイルの変換行列は現在のフレームのアップロード領域へ書き込む
+	LinearAllocator::Allocation allocation =
+	  DirectXCommon::GetInstance()->AllocateUpload(sizeof(XMMATRIX));
+	assert(allocation.cpuAddress);
+	memcpy(allocation.cpuAddress, &matViewProjection, sizeof(XMMATRIX));
+	commandList->SetGraphicsRootConstantBufferView(
+	  static_cast<UINT>(RoomParameter::kViewProjection), allocation.gpuAddress);
+
+	// 重なる物体だけを描く
+	for (uint32_t index : visible) {
+		const Caster& caster = casters_[index];
+		commandList->SetGraphicsRootConstantBufferView(
+		  static_cast<UINT>(RoomParameter::kWorldTransform),
+		  caster.worldTransform->GetGPUVirtualAddress());
+		caster.model->DrawDepth(commandList);
+	}
+}
+
+XMFLOAT4 ShadowMap::GetTileRect(const RectPacker::Rect& tile) const {
+	float width = static_cast<float>(atlasSize_.width);
+	float height = static_cast<float>(atlasSize_.height);
+	return {tile.width / width, tile.height / height, tile.x / width, tile.y / height};
+}
+
+D3D12_GPU_VIRTUAL_ADDRESS ShadowMap::GetGPUVirtualAddress() const {
+	// 描かなかったフレームは前のフレームのアトラスを読まない
+	if (renderedFrameNumber_ != DirectXCommon::GetInstance()->GetFrameNumber()) {
+		return disabledConstBuffer_.GetGPUVirtualAddress();
+	}
+	return constBuffer_.GetGPUVirtualAddress();
+}
+
+void ShadowMap::SetGraphicsRootParameters(
+  ID3D12GraphicsCommandList* commandList, UINT rootParamIndexConstBuffer,
+  UINT rootParamIndexTexture) const {
+	commandList->SetGraphicsRootConstantBufferView(
+	  rootParamIndexConstBuffer, GetGPUVirtualAddress());
+	TextureManager::GetInstance()->SetGraphicsRootDescriptorTable(
+	  commandList, rootParamIndexTexture, textureHandle_);
+}
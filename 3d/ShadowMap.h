@@ -0,0 +1,200 @@
+﻿#pragma once
+
+#include "FrameConstantBuffer.h"
+#include "LightGroup.h"
+#include "RectPacker.h"
+#include "ShadowCascades.h"
+#include "ViewProjection.h"
+#include "WorldTransform.h"
+#include <DirectXMath.h>
+#include <d3d12.h>
+#include <vector>
+#include <wrl.h>
+
+class Model;
+
+/// <summary>
+/// シャドウマップ
+/// 1つの平行光源のカスケードと、影を落とすスポットライトを1枚のアトラスのタイルに深度だけで描く。
+/// 影を落とす物体はタイルごとに境界球で判定し、重なるものだけを描く。
+/// モデルの描画ではModel::SetLightParametersで変換行列とアトラスがセットされる
+/// </summary>
+class ShadowMap {
+  public: // 定数
+	// カスケード数
+	static const uint32_t kCascadeCount = ShadowCascades::kCascadeCount;
+	// 影を落とすスポットライトの最大数
+	static const uint32_t kSpotLightNum = LightGroup::kShadowSpotLightNum;
+	// カスケード1つのタイルの解像度
+	static const uint32_t kCascadeResolution = 1024;
+	// スポットライト1つのタイルの解像度
+	static const uint32_t kSpotResolution = 512;
+
+  public: // 列挙子
+	/// <summary>
+	/// ルートパラメータ番号
+	/// </summary>
+	enum class RoomParameter {
+		kWorldTransform, // ワールド変換行列
+		kViewProjection, // タイルのビュープロジェクション変換行列
+	};
+
+  public: // サブクラス
+	// 定数バッファ用データ構造体（Obj.hlsliと合わせる）
+	struct ConstBufferData {
+		// カスケードのビュープロジェクション変換行列
+		DirectX::XMMATRIX cascadeViewProjections[kCascadeCount];
+		// カスケードのアトラス内の範囲（xy:大きさ zw:左上。UV）
+		DirectX::XMFLOAT4 cascadeRects[kCascadeCount];
+		// カスケードの奥側の区切り（カメラのビュー空間の奥行き）
+		DirectX::XMFLOAT4 cascadeSplits;
+		// スポットライトのビュープロジェクション変換行列
+		DirectX::XMMATRIX spotViewProjections[kSpotLightNum];
+		// スポットライトのアトラス内の範囲（xy:大きさ zw:左上。UV）
+		DirectX::XMFLOAT4 spotRects[kSpotLightNum];
+		// カスケード数（0なら平行光源の影なし）
+		uint32_t cascadeCount;
+		// 影を落とす平行光源の番号
+		uint32_t dirLightIndex;
+		// 影を落とすスポットライトの数
+		uint32_t spotLightCount;
+		float pad;
+	};
+
+  public: // メンバ関数
+	/// <summary>
+	/// シングルトンインスタンスの取得
+	/// </summary>
+	/// <returns>シングルトンインスタンス</returns>
+	static ShadowMap* GetInstance();
+
+	/// <summary>
+	/// 初期化（パイプラインとアトラスの生成）
+	/// </summary>
+	void Initialize();
+
+	/// <summary>
+	/// 影を落とす平行光源の番号の設定
+	/// </summary>
+	/// <param name="index">ライト番号（-1なら平行光源の影なし）</param>
+	void SetDirLightIndex(int index) { dirLightIndex_ = index; }
+
+	int GetDirLightIndex() const { return dirLightIndex_; }
+
+	/// <summary>
+	/// 影を落とす物体の追加（Renderで描いて空になる）
+	/// </summary>
+	/// <param name="model">モデル</param>
+	/// <param name="worldTransform">ワールドトランスフォーム（Renderまで保持すること）</param>
+	void AddCaster(Model* model, const WorldTransform& worldTransform);
+
+	/// <summary>
+	/// シャドウマップの描画（モデルの描画の前にメインスレッドで呼ぶ）
+	/// 描き終えるとレンダーターゲットを戻す。呼ばなかったフレームは影なしになる
+	/// </summary>
+	/// <param name="commandList">描画コマンドリスト</param>
+	/// <param name="viewProjection">カメラのビュープロジェクション</param>
+	void Render(ID3D12GraphicsCommandList* commandList, const ViewProjection& viewProjection);
+
+	/// <summary>
+	/// 現在のフレームの定数バッファアドレスを取得（描かなかったフレームは影なしのもの）
+	/// 並列記録の前にメインスレッドで一度呼んでおくこと
+	/// </summary>
+	/// <returns>GPUアドレス</returns>
+	D3D12_GPU_VIRTUAL_ADDRESS GetGPUVirtualAddress() const;
+
+	/// <summary>
+	/// 定数バッファとアトラスをセット
+	/// </summary>
+	/// <param name="commandList">コマンドリスト</param>
+	/// <param name="rootParamIndexConstBuffer">定数バッファのルートパラメータ番号</param>
+	/// <param name="rootParamIndexTexture">アトラスのデスクリプタテーブルのルートパラメータ番号</param>
+	void SetGraphicsRootParameters(
+	  ID3D12GraphicsCommandList* commandList, UINT rootParamIndexConstBuffer,
+	  UINT rootParamIndexTexture) const;
+
+	/// <summary>
+	/// カスケードの取得
+	/// </summary>
+	/// <returns>直前のRenderで作ったカスケード</returns>
+	const ShadowCascades& GetCascades() const { return cascades_; }
+
+	/// <summary>
+	/// アトラスのテクスチャハンドルの取得
+	/// </summary>
+	/// <returns>テクスチャハンドル</returns>
+	uint32_t GetTextureHandle() const { return textureHandle_; }
+
+  private: // サブクラス
+	// 影を落とす物体
+	struct Caster {
+		Model* model;
+		const WorldTransform* worldTransform;
+	};
+
+  private: // メンバ関数
+	ShadowMap() = default;
+	~ShadowMap() = default;
+	ShadowMap(const ShadowMap&) = delete;
+	ShadowMap& operator=(const ShadowMap&) = delete;
+
+	/// <summary>
+	/// グラフィックスパイプラインの生成
+	/// </summary>
+	void InitializeGraphicsPipeline();
+
+	/// <summary>
+	/// タイルを詰めたアトラスの生成
+	/// </summary>
+	void CreateAtlas();
+
+	/// <summary>
+	/// 1つのタイルに重なる物体を描く
+	/// </summary>
+	/// <param name="commandList">描画コマンドリスト</param>
+	/// <param name="matViewProjection">タイルのビュープロジェクション変換行列</param>
+	/// <param name="tile">アトラス内のタイル</param>
+	/// <param name="visible">重なる物体の番号</param>
+	void DrawTile(
+	  ID3D12GraphicsCommandList* commandList, const DirectX::XMMATRIX& matViewProjection,
+	  const RectPacker::Rect& tile, const std::vector<uint32_t>& visible);
+
+	/// <summary>
+	/// タイルのアトラス内の範囲をUVで取得
+	/// </summary>
+	/// <param name="tile">アトラス内のタイル</param>
+	/// <returns>xy:大きさ zw:左上</returns>
+	DirectX::XMFLOAT4 GetTileRect(const RectPacker::Rect& tile) const;
+
+  private: // メンバ変数
+	// ルートシグネチャ
+	Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature_;
+	// パイプラインステートオブジェクト
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> pipelineState_;
+	// アトラス
+	Microsoft::WRL::ComPtr<ID3D12Resource> atlas_;
+	// 深度ビュー用デスクリプタヒープ
+	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> dsvHeap_;
+	// アトラスのテクスチャハンドル
+	uint32_t textureHandle_ = 0;
+	// アトラスの大きさ
+	RectPacker::Size atlasSize_;
+	// タイル（カスケード、スポットライトの順）
+	std::vector<RectPacker::Rect> tiles_;
+	// カスケード
+	ShadowCascades cascades_;
+	// 影を落とす平行光源の番号
+	int dirLightIndex_ = 0;
+	// 影を落とす物体とその境界球
+	std::vector<Caster> casters_;
+	std::vector<DirectX::XMFLOAT4> casterSpheres_;
+	// タイルごとに重なる物体の番号
+	std::vector<uint32_t> cascadeVisible_[kCascadeCount];
+	std::vector<uint32_t> spotVisible_;
+	// 定数バッファ
+	FrameConstantBuffer<ConstBufferData> constBuffer_;
+	// 影なしの定数バッファ（描かなかったフレーム用）
+	FrameConstantBuffer<ConstBufferData> disabledConstBuffer_;
+	// 描いたフレーム
+	uint64_t renderedFrameNumber_ = UINT64_MAX;
+};
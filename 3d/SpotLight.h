@@ -29,7 +29,8 @@ public: // サブクラス
 		float pad3;
 		XMFLOAT2 lightfactoranglecos;
 		unsigned int active;
-		float pad4;
+		// シャドウマップの番号（-1なら影なし）
+		int shadowIndex;
 	};
 
 public: // メンバ関数
@@ -108,6 +109,18 @@ public: // メンバ関数
 	/// <returns>有効フラグ</returns>
 	inline bool IsActive() { return active; }
 
+	/// <summary>
+	/// 影を落とすかをセット
+	/// </summary>
+	/// <param name="castShadow">影を落とすならtrue</param>
+	inline void SetCastShadow(bool castShadow) { this->castShadow = castShadow; }
+
+	/// <summary>
+	/// 影を落とすかチェック
+	/// </summary>
+	/// <returns>影を落とすならtrue</returns>
+	inline bool IsCastShadow() { return castShadow; }
+
 private: // メンバ変数
 	// ライト方向（単位ベクトル）
 	XMVECTOR lightdir = { 1,0,0,0 };
@@ -121,5 +134,7 @@ private: // メンバ変数
 	XMFLOAT2 lightFactorAngleCos = { 0.2f, 0.5f };
 	// 有効フラグ
 	bool active = false;
+	// 影を落とすか
+	bool castShadow = false;
 };
 
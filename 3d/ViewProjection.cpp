@@ -7,34 +7,9 @@
 using namespace DirectX;
 
 void ViewProjection::Initialize() {
-	CreateConstBuffer();
-	Map();
 	UpdateMatrix();
 }
 
-void ViewProjection::CreateConstBuffer() {
-	HRESULT result;
-
-	// ヒーププロパティ
-	CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-	// リソース設定
-	CD3DX12_RESOURCE_DESC resourceDesc =
-	  CD3DX12_RESOURCE_DESC::Buffer((sizeof(ConstBufferDataViewProjection) + 0xff) & ~0xff);
-
-	// 定数バッファの生成
-	result = DirectXCommon::GetInstance()->GetDevice()->CreateCommittedResource(
-	  &heapProps, // アップロード可能
-	  D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
-	  IID_PPV_ARGS(&constBuff_));
-	assert(SUCCEEDED(result));
-}
-
-void ViewProjection::Map() {
-	// 定数バッファとのデータリンク
-	HRESULT result = constBuff_->Map(0, nullptr, (void**)&constMap);
-	assert(SUCCEEDED(result));
-}
-
 void ViewProjection::UpdateMatrix() {
 	// ビュー行列の生成
 	matView = XMMatrixLookAtLH(XMLoadFloat3(&eye), XMLoadFloat3(&target), XMLoadFloat3(&up));
@@ -42,8 +17,9 @@ void ViewProjection::UpdateMatrix() {
 	// 透視投影による射影行列の生成
 	matProjection = XMMatrixPerspectiveFovLH(fovAngleY, aspectRatio, nearZ, farZ);
 
-	// 定数バッファに書き込み
-	constMap->view = matView;
-	constMap->projection = matProjection;
-	constMap->cameraPos = eye;
+	// 定数バッファに書き込み（描画時に現在のフレームの領域へ転送される）
+	ConstBufferDataViewProjection& constData = constBuffer_.Edit();
+	constData.view = matView;
+	constData.projection = matProjection;
+	constData.cameraPos = eye;
 }
@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include "FrameConstantBuffer.h"
 #include <DirectXMath.h>
 #include <d3d12.h>
 #include <wrl.h>
@@ -15,10 +16,8 @@ struct ConstBufferDataViewProjection {
 /// ビュープロジェクション変換データ
 /// </summary>
 struct ViewProjection {
-	// 定数バッファ
-	Microsoft::WRL::ComPtr<ID3D12Resource> constBuff_;
-	// マッピング済みアドレス
-	ConstBufferDataViewProjection* constMap = nullptr;
+	// 定数バッファ（フレームごとのアップロード領域に書き込む）
+	FrameConstantBuffer<ConstBufferDataViewProjection> constBuffer_;
 
 #pragma region ビュー行列の設定
 	// 視点座標
@@ -50,15 +49,14 @@ struct ViewProjection {
 	/// </summary>
 	void Initialize();
 	/// <summary>
-	/// 定数バッファ生成
-	/// </summary>
-	void CreateConstBuffer();
-	/// <summary>
-	/// マッピングする
-	/// </summary>
-	void Map();
-	/// <summary>
 	/// 行列を更新する
 	/// </summary>
 	void UpdateMatrix();
+	/// <summary>
+	/// 現在のフレームの定数バッファアドレスを取得
+	/// </summary>
+	/// <returns>GPUアドレス</returns>
+	D3D12_GPU_VIRTUAL_ADDRESS GetGPUVirtualAddress() const {
+		return constBuffer_.GetGPUVirtualAddress();
+	}
 };
@@ -6,34 +6,9 @@
 using namespace DirectX;
 
 void WorldTransform::Initialize() {
-	CreateConstBuffer();
-	Map();
 	UpdateMatrix();
 }
 
-void WorldTransform::CreateConstBuffer() {
-	HRESULT result;
-
-	// ヒーププロパティ
-	CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-	// リソース設定
-	CD3DX12_RESOURCE_DESC resourceDesc =
-	  CD3DX12_RESOURCE_DESC::Buffer((sizeof(ConstBufferDataWorldTransform) + 0xff) & ~0xff);
-
-	// 定数バッファの生成
-	result = DirectXCommon::GetInstance()->GetDevice()->CreateCommittedResource(
-	  &heapProps, // アップロード可能
-	  D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
-	  IID_PPV_ARGS(&constBuff_));
-	assert(SUCCEEDED(result));
-}
-
-void WorldTransform::Map() {
-	// 定数バッファとのデータリンク
-	HRESULT result = constBuff_->Map(0, nullptr, (void**)&constMap);
-	assert(SUCCEEDED(result));
-}
-
 void WorldTransform::UpdateMatrix() {
 	XMMATRIX matScale, matRot, matTrans;
 
@@ -60,6 +35,6 @@ void WorldTransform::UpdateMatrix() {
 		matWorldRot_ *= parent_->matWorldRot_;//【改造箇所】親行列にも回転情報を掛け算する
 	}
 
-	// 定数バッファに書き込み
-	constMap->matWorld = matWorld_;
+	// 定数バッファに書き込み（描画時に現在のフレームの領域へ転送される）
+	constBuffer_.Edit().matWorld = matWorld_;
 }
\ No newline at end of file
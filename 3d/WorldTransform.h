@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include "FrameConstantBuffer.h"
 #include <DirectXMath.h>
 #include <d3d12.h>
 #include <wrl.h>
@@ -13,10 +14,8 @@ struct ConstBufferDataWorldTransform {
 /// ワールド変換データ
 /// </summary>
 struct WorldTransform {
-	// 定数バッファ
-	Microsoft::WRL::ComPtr<ID3D12Resource> constBuff_;
-	// マッピング済みアドレス
-	ConstBufferDataWorldTransform* constMap = nullptr;
+	// 定数バッファ（フレームごとのアップロード領域に書き込む）
+	FrameConstantBuffer<ConstBufferDataWorldTransform> constBuffer_;
 	// ローカルスケール
 	DirectX::XMFLOAT3 scale_ = {1, 1, 1};
 	// X,Y,Z軸回りのローカル回転角
@@ -35,15 +34,14 @@ struct WorldTransform {
 	/// </summary>
 	void Initialize();
 	/// <summary>
-	/// 定数バッファ生成
-	/// </summary>
-	void CreateConstBuffer();
-	/// <summary>
-	/// マッピングする
-	/// </summary>
-	void Map();
-	/// <summary>
 	/// 行列を更新する
 	/// </summary>
 	void UpdateMatrix();
+	/// <summary>
+	/// 現在のフレームの定数バッファアドレスを取得
+	/// </summary>
+	/// <returns>GPUアドレス</returns>
+	D3D12_GPU_VIRTUAL_ADDRESS GetGPUVirtualAddress() const {
+		return constBuffer_.GetGPUVirtualAddress();
+	}
 };
@@ -25,30 +25,54 @@ struct DirLight
 	uint active;
 };
 
-// 点光源の数
-static const int POINTLIGHT_NUM = 3;
+// 点光源の数（構造化バッファの要素数）
+static const uint POINTLIGHT_NUM = 1024;
 
+// 構造化バッファは詰めて並ぶので、C++側の定数バッファ用データ構造体に合わせて埋める
 struct PointLight
 {
 	float3 lightpos;    // ライト座標
+	float pad1;
 	float3 lightcolor;  // ライトの色(RGB)
+	float pad2;
 	float3 lightatten;	// ライト距離減衰係数
 	uint active;
 };
 
-// スポットライトの数
-static const int SPOTLIGHT_NUM = 3;
+// スポットライトの数（構造化バッファの要素数）
+static const uint SPOTLIGHT_NUM = 1024;
 
 struct SpotLight
 {
 	float3 lightv;		// ライトの光線方向の逆ベクトル（単位ベクトル）
+	float pad0;
 	float3 lightpos;    // ライト座標
+	float pad1;
 	float3 lightcolor;  // ライトの色(RGB)
+	float pad2;
 	float3 lightatten;	// ライト距離減衰係数
+	float pad3;
 	float2 lightfactoranglecos; // ライト減衰角度のコサイン
 	uint active;
+	int shadowIndex;    // シャドウマップの番号（-1なら影なし）
 };
 
+// オブジェクトごとに選ぶライトの最大数（LightSelector.hと合わせる）
+static const uint OBJECT_LIGHT_NUM = 8;
+
+// オブジェクトごとに選んだライト（LightSelector::LightSetと合わせる）
+struct ObjectLights
+{
+	uint count;                      // 数
+	uint indices[OBJECT_LIGHT_NUM];  // ライト番号（POINTLIGHT_NUM以上はスポットライト）
+	uint3 pad;
+};
+
+// クラスタの分割数（LightCluster.hと合わせる）
+static const uint CLUSTER_COUNT_X = 16;
+static const uint CLUSTER_COUNT_Y = 9;
+static const uint CLUSTER_COUNT_Z = 24;
+
 // 丸影の数
 static const int CIRCLESHADOW_NUM = 3;
 
@@ -65,12 +89,28 @@ struct CircleShadow
 cbuffer LightGroup : register(b3)
 {
 	float3 ambientColor;
+	float2 clusterSliceParams; // クラスタの奥行きの区切り = log(z) * x + y
+	uint objectLightSelection; // 1ならクラスタでなくオブジェクトごとに選んだライトを使う
 	DirLight dirLights[DIRLIGHT_NUM];
-	PointLight pointLights[POINTLIGHT_NUM];
-	SpotLight spotLights[SPOTLIGHT_NUM];
 	CircleShadow circleShadows[CIRCLESHADOW_NUM];
 }
 
+// シャドウマップのカスケード数と影を落とすスポットライトの数（ShadowMap.hと合わせる）
+static const uint SHADOW_CASCADE_NUM = 4;
+static const uint SHADOW_SPOTLIGHT_NUM = 8;
+
+cbuffer Shadow : register(b5)
+{
+	matrix cascadeViewProjections[SHADOW_CASCADE_NUM]; // カスケードのビュープロジェクション変換行列
+	float4 cascadeRects[SHADOW_CASCADE_NUM];           // アトラス内の範囲（xy:大きさ zw:左上）
+	float4 cascadeSplits;                              // カスケードの奥側の区切り（ビュー空間）
+	matrix spotViewProjections[SHADOW_SPOTLIGHT_NUM];  // スポットライトのビュープロジェクション変換行列
+	float4 spotRects[SHADOW_SPOTLIGHT_NUM];            // アトラス内の範囲（xy:大きさ zw:左上）
+	uint cascadeCount;   // 0なら平行光源の影なし
+	uint shadowDirLight; // 影を落とす平行光源の番号
+	uint shadowSpotLightCount;
+}
+
 // 頂点シェーダーからピクセルシェーダーへのやり取りに使用する構造体
 struct VSOutput
 {
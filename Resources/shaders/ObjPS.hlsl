@@ -1,8 +1,39 @@
 #include "Obj.hlsli"
 
+#ifdef BINDLESS
+Texture2D<float4> textures[] : register(t0); // 全テクスチャ
+cbuffer TextureIndex : register(b4) {
+	uint textureIndex; // 描画に使うテクスチャの番号
+};
+#define tex textures[textureIndex]
+#else
 Texture2D<float4> tex : register(t0);  // 0番スロットに設定されたテクスチャ
+#endif
 SamplerState smp : register(s0);      // 0番スロットに設定されたサンプラー
 
+// 点光源とスポットライト、クラスタごとのライト番号（テクスチャと重ならないようレジスタ空間1）
+StructuredBuffer<PointLight> pointLights : register(t0, space1);
+StructuredBuffer<SpotLight> spotLights : register(t1, space1);
+StructuredBuffer<uint2> clusterRanges : register(t2, space1); // x:先頭 y:数
+StructuredBuffer<uint> lightIndices : register(t3, space1);   // POINTLIGHT_NUM以上はスポットライト
+StructuredBuffer<ObjectLights> objectLights : register(t4, space1); // 0番目が描画中のオブジェクトのもの
+Texture2D<float> shadowMap : register(t5, space1);   // シャドウマップのアトラス
+SamplerComparisonState shadowSmp : register(s1);     // 深度比較用サンプラー
+
+// シャドウマップを引く（1なら光が届く）
+float SampleShadow(matrix viewProjection, float4 rect, float4 worldpos)
+{
+	float4 lightpos = mul(viewProjection, worldpos);
+	float3 ndc = lightpos.xyz / lightpos.w;
+	float2 uv = float2(ndc.x * 0.5f + 0.5f, -ndc.y * 0.5f + 0.5f);
+	// タイルの外は影なし
+	if (any(uv < 0.0f) || any(uv > 1.0f) || ndc.z > 1.0f) {
+		return 1.0f;
+	}
+	return shadowMap.SampleCmpLevelZero(shadowSmp, uv * rect.xy + rect.zw, ndc.z);
+}
+
+
 float4 main(VSOutput input) : SV_TARGET
 {
 	// テクスチャマッピング
@@ -19,6 +50,20 @@ float4 main(VSOutput input) : SV_TARGET
 	// シェーディングによる色
 	float4 shadecolor = float4(ambientColor * ambient, m_alpha);
 
+	// 平行光源の影（ビュー空間の奥行きでカスケードを選ぶ）
+	float dirShadow = 1.0f;
+	if (cascadeCount > 0) {
+		float depth = mul(view, input.worldpos).z;
+		uint cascade = 0;
+		for (uint c = 0; c < cascadeCount - 1; c++) {
+			cascade += depth > cascadeSplits[c] ? 1 : 0;
+		}
+		if (depth <= cascadeSplits[cascadeCount - 1]) {
+			dirShadow = SampleShadow(
+				cascadeViewProjections[cascade], cascadeRects[cascade], input.worldpos);
+		}
+	}
+
 	// 平行光源
 	for (int i = 0; i < DIRLIGHT_NUM; i++) {
 		if (dirLights[i].active) {
@@ -31,21 +76,46 @@ float4 main(VSOutput input) : SV_TARGET
 			// 鏡面反射光
 			float3 specular = pow(saturate(dot(reflect, eyedir)), shininess) * m_specular;
 
+			// 影を落とす平行光源は影の分だけ暗くする
+			float shadow = (cascadeCount > 0 && i == shadowDirLight) ? dirShadow : 1.0f;
+
 			// 全て加算する
-			shadecolor.rgb += (diffuse + specular) * dirLights[i].lightcolor;
+			shadecolor.rgb += shadow * (diffuse + specular) * dirLights[i].lightcolor;
 		}
 	}
 
-	// 点光源
-	for (i = 0; i < POINTLIGHT_NUM; i++) {
-		if (pointLights[i].active) {
+	// 計算する点光源とスポットライトの範囲（x:先頭 y:数）
+	uint2 range;
+	if (objectLightSelection) {
+		// オブジェクトごとに選んだもの
+		range = uint2(0, objectLights[0].count);
+	} else {
+		// ピクセルの属するクラスタ（画面の縦横はLightClusterと同じく正規化デバイス座標の下から）
+		float4 viewpos = mul(view, input.worldpos);
+		float4 clippos = mul(projection, viewpos);
+		float2 ndc = clippos.xy / clippos.w;
+		uint clusterX = min(uint(saturate(ndc.x * 0.5f + 0.5f) * CLUSTER_COUNT_X), CLUSTER_COUNT_X - 1);
+		uint clusterY = min(uint(saturate(ndc.y * 0.5f + 0.5f) * CLUSTER_COUNT_Y), CLUSTER_COUNT_Y - 1);
+		float slice = floor(log(viewpos.z) * clusterSliceParams.x + clusterSliceParams.y);
+		uint clusterZ = uint(clamp(slice, 0.0f, CLUSTER_COUNT_Z - 1.0f));
+		range = clusterRanges[(clusterZ * CLUSTER_COUNT_Y + clusterY) * CLUSTER_COUNT_X + clusterX];
+	}
+
+	// 選んだものか、クラスタに重なる点光源とスポットライトだけ計算する
+	for (uint n = 0; n < range.y; n++) {
+		uint index = objectLightSelection ? objectLights[0].indices[n] : lightIndices[range.x + n];
+
+		// 点光源
+		if (index < POINTLIGHT_NUM) {
+			PointLight light = pointLights[index];
+
 			// ライトへの方向ベクトル
-			float3 lightv = pointLights[i].lightpos - input.worldpos.xyz;
+			float3 lightv = light.lightpos - input.worldpos.xyz;
 			float d = length(lightv);
 			lightv = normalize(lightv);
 
 			// 距離減衰係数
-			float atten = 1.0f / (pointLights[i].lightatten.x + pointLights[i].lightatten.y * d + pointLights[i].lightatten.z *d*d);
+			float atten = 1.0f / (light.lightatten.x + light.lightatten.y * d + light.lightatten.z *d*d);
 
 			// ライトに向かうベクトルと法線の内積
 			float3 dotlightnormal = dot(lightv, input.normal);
@@ -57,29 +127,35 @@ float4 main(VSOutput input) : SV_TARGET
 			float3 specular = pow(saturate(dot(reflect, eyedir)), shininess) * m_specular;
 
 			// 全て加算する
-			shadecolor.rgb += atten * (diffuse + specular) * pointLights[i].lightcolor;
+			shadecolor.rgb += atten * (diffuse + specular) * light.lightcolor;
 		}
-	}
+		// スポットライト
+		else {
+			SpotLight light = spotLights[index - POINTLIGHT_NUM];
 
-	// スポットライト
-	for (i = 0; i < SPOTLIGHT_NUM; i++) {
-		if (spotLights[i].active) {
 			// ライトへの方向ベクトル
-			float3 lightv = spotLights[i].lightpos - input.worldpos.xyz;
+			float3 lightv = light.lightpos - input.worldpos.xyz;
 			float d = length(lightv);
 			lightv = normalize(lightv);
 
 			// 距離減衰係数
-			float atten = saturate(1.0f / (spotLights[i].lightatten.x + spotLights[i].lightatten.y * d + spotLights[i].lightatten.z *d*d));
+			float atten = saturate(1.0f / (light.lightatten.x + light.lightatten.y * d + light.lightatten.z *d*d));
 
 			// 角度減衰
-			float cos = dot(lightv, spotLights[i].lightv);
+			float cos = dot(lightv, light.lightv);
 			// 減衰開始角度から、減衰終了角度にかけて減衰
 			// 減衰開始角度の内側は1倍 減衰終了角度の外側は0倍の輝度
-			float angleatten = smoothstep(spotLights[i].lightfactoranglecos.y, spotLights[i].lightfactoranglecos.x, cos);
+			float angleatten = smoothstep(light.lightfactoranglecos.y, light.lightfactoranglecos.x, cos);
 			// 角度減衰を乗算
 			atten *= angleatten;
 
+			// 影を落とすスポットライトはシャドウマップを乗算
+			if (light.shadowIndex >= 0 && uint(light.shadowIndex) < shadowSpotLightCount) {
+				atten *= SampleShadow(
+					spotViewProjections[light.shadowIndex], spotRects[light.shadowIndex],
+					input.worldpos);
+			}
+
 			// ライトに向かうベクトルと法線の内積
 			float3 dotlightnormal = dot(lightv, input.normal);
 			// 反射光ベクトル
@@ -90,7 +166,7 @@ float4 main(VSOutput input) : SV_TARGET
 			float3 specular = pow(saturate(dot(reflect, eyedir)), shininess) * m_specular;
 
 			// 全て加算する
-			shadecolor.rgb += atten * (diffuse + specular) * spotLights[i].lightcolor;
+			shadecolor.rgb += atten * (diffuse + specular) * light.lightcolor;
 		}
 	}
 
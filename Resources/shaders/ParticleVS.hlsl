@@ -0,0 +1,15 @@
+#include "Particle.hlsli"
+
+// 頂点番号0～3を左上、右上、左下、右下の順に四角形の角とし、ビュー空間で広げてカメラに向ける
+VSOutput main(
+  uint vertexId : SV_VertexID, float3 pos : POSITION, float size : SIZE, float4 color : COLOR) {
+	float2 uv = float2(vertexId & 1, vertexId >> 1);
+	float4 viewPos = mul(view, float4(pos, 1));
+	viewPos.xy += float2(uv.x - 0.5f, 0.5f - uv.y) * size;
+
+	VSOutput output; // ピクセルシェーダーに渡す値
+	output.svpos = mul(projection, viewPos);
+	output.uv = uv;
+	output.color = color;
+	return output;
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+cbuffer WorldTransform : register(b0) {
+	matrix world; // ワールド行列
+};
+
+cbuffer ShadowViewProjection : register(b1) {
+	matrix viewProjection; // タイルのビュープロジェクション変換行列
+};
+
+// 深度だけを描く（ピクセルシェーダなし）
+float4 main(float4 pos : POSITION) : SV_POSITION {
+	return mul(viewProjection, mul(world, pos));
+}
\ No newline at end of file
@@ -1,6 +1,14 @@
 #include "Sprite.hlsli"
 
+#ifdef BINDLESS
+Texture2D<float4> textures[] : register(t0); // 全テクスチャ
+cbuffer TextureIndex : register(b1) {
+	uint textureIndex; // 描画に使うテクスチャの番号
+};
+#define tex textures[textureIndex]
+#else
 Texture2D<float4> tex : register(t0); // 0番スロットに設定されたテクスチャ
+#endif
 SamplerState smp : register(s0);      // 0番スロットに設定されたサンプラー
 
-float4 main(VSOutput input) : SV_TARGET { return tex.Sample(smp, input.uv) * color; }
\ No newline at end of file
+float4 main(VSOutput input) : SV_TARGET { return tex.Sample(smp, input.uv) * input.color; }
\ No newline at end of file
@@ -0,0 +1,21 @@
+#include "Sprite.hlsli"
+
+#ifdef BINDLESS
+Texture2D<float4> textures[] : register(t0); // 全テクスチャ
+cbuffer TextureIndex : register(b1) {
+	uint textureIndex; // 描画に使うテクスチャの番号
+};
+#define tex textures[textureIndex]
+#else
+Texture2D<float4> tex : register(t0); // 0番スロットに設定されたテクスチャ
+#endif
+SamplerState smp : register(s0);      // 0番スロットに設定されたサンプラー
+
+float4 main(VSOutput input) : SV_TARGET {
+	// 輪郭までの距離（0.5が輪郭、大きいほど内側）
+	float distance = tex.Sample(smp, input.uv).r;
+	// 1ピクセル分の距離の変化で輪郭をなめらかにする（どの大きさでもにじまない）
+	float width = max(fwidth(distance), 1e-4);
+	float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+	return float4(input.color.rgb, input.color.a * alpha);
+}
\ No newline at end of file
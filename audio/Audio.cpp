@@ -35,6 +35,7 @@ void Audio::Initialize(const std::string& directoryPath) {
 
 	indexSoundData_ = 0u;
 	indexVoice_ = 0u;
+	nameTable_.Clear();
 }
 
 void Audio::Finalize() {
@@ -47,15 +48,9 @@ void Audio::Finalize() {
 }
 
 uint32_t Audio::LoadWave(const std::string& fileName) {
-	assert(indexSoundData_ < kMaxSoundData);
-	uint32_t handle = indexSoundData_;
-	// 読み込み済みサウンドデータを検索
-	auto it = std::find_if(soundDatas_.begin(), soundDatas_.end(), [&](const auto& soundData) {
-		return soundData.name_ == fileName;
-	});
-	if (it != soundDatas_.end()) {
-		// 読み込み済みサウンドデータの要素番号を取得
-		handle = static_cast<uint32_t>(std::distance(soundDatas_.begin(), it));
+	// 読み込み済みサウンドデータを検索（同じ名前なら正規化せずに見つかる）
+	uint32_t handle = nameTable_.Find(fileName);
+	if (handle != AssetNameTable::kNotFound) {
 		return handle;
 	}
 
@@ -66,6 +61,15 @@ uint32_t Audio::LoadWave(const std::string& fileName) {
 	}
 	std::string fullpath = currentRelative ? fileName : directoryPath_ + fileName;
 
+	// 書き方の違う同じファイルを検索
+	handle = nameTable_.FindPath(fileName, fullpath);
+	if (handle != AssetNameTable::kNotFound) {
+		return handle;
+	}
+
+	assert(indexSoundData_ < kMaxSoundData);
+	handle = indexSoundData_;
+
 	// ファイル入力ストリームのインスタンス
 	std::ifstream file;
 	// .wavファイルをバイナリモードで開く
@@ -124,6 +128,7 @@ uint32_t Audio::LoadWave(const std::string& fileName) {
 	soundData.pBuffer = reinterpret_cast<BYTE*>(pBuffer);
 	soundData.bufferSize = data.size;
 	soundData.name_ = fileName;
+	nameTable_.Insert(fileName, fullpath, handle);
 
 	indexSoundData_++;
 
@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include "AssetNameTable.h"
 #include <array>
 #include <cstdint>
 #include <set>
@@ -144,6 +145,8 @@ class Audio {
 	std::set<Voice*> voices_;
 	// サウンド格納ディレクトリ
 	std::string directoryPath_;
+	// 名前からサウンドデータハンドルへの索引
+	AssetNameTable nameTable_;
 	// 次に使うサウンドデータの番号
 	uint32_t indexSoundData_ = 0u;
 	// 次に使う再生中データの番号
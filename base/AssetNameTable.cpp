@@ -0,0 +1,94 @@
+﻿#include "AssetNameTable.h"
+#include <cassert>
+
+std::string AssetNameTable::Normalize(const std::string& path) {
+	std::vector<std::string> segments;
+	bool absolute = !path.empty() && (path[0] == '/' || path[0] == '\\');
+
+	// 区切りごとに要素を積む
+	std::string segment;
+	for (size_t i = 0; i <= path.size(); i++) {
+		char c = i < path.size() ? path[i] : '/';
+		if (c != '/' && c != '\\') {
+			// ASCIIのみ小文字にする（マルチバイト文字の後続バイトを壊さない）
+			if ('A' <= c && c <= 'Z') {
+				c = static_cast<char>(c - 'A' + 'a');
+			}
+			segment += c;
+			continue;
+		}
+
+		if (segment.empty() || segment == ".") {
+			// 空と"."は捨てる
+		} else if (segment == ".." && !segments.empty() && segments.back() != "..") {
+			segments.pop_back();
+		} else {
+			segments.push_back(segment);
+		}
+		segment.clear();
+	}
+
+	// '/'でつなぐ
+	std::string result = absolute ? "/" : "";
+	for (size_t i = 0; i < segments.size(); i++) {
+		if (i > 0) {
+			result += '/';
+		}
+		result += segments[i];
+	}
+	return result;
+}
+
+uint32_t AssetNameTable::Find(const std::string& name) const {
+	auto it = aliases_.find(name);
+	return it != aliases_.end() ? it->second : kNotFound;
+}
+
+uint32_t AssetNameTable::FindPath(const std::string& name, const std::string& path) {
+	// 正規化したキーはパスの表だけで引く（別名の"x.png"と"./x.png"の正規化結果を取り違えない）
+	auto it = paths_.find(Normalize(path));
+	if (it == paths_.end()) {
+		return kNotFound;
+	}
+
+	// 次からは名前だけで見つかるようにする
+	uint32_t handle = it->second;
+	AddKey(aliases_, keys_[handle].aliases, name, handle);
+	return handle;
+}
+
+void AssetNameTable::Insert(const std::string& name, const std::string& path, uint32_t handle) {
+	assert(handle != kNotFound);
+	Keys& keys = keys_[handle];
+	AddKey(paths_, keys.paths, Normalize(path), handle);
+	AddKey(aliases_, keys.aliases, name, handle);
+}
+
+void AssetNameTable::Erase(uint32_t handle) {
+	auto it = keys_.find(handle);
+	if (it == keys_.end()) {
+		return;
+	}
+
+	for (const std::string& key : it->second.paths) {
+		paths_.erase(key);
+	}
+	for (const std::string& key : it->second.aliases) {
+		aliases_.erase(key);
+	}
+	keys_.erase(it);
+}
+
+void AssetNameTable::Clear() {
+	paths_.clear();
+	aliases_.clear();
+	keys_.clear();
+}
+
+void AssetNameTable::AddKey(
+  std::unordered_map<std::string, uint32_t>& table, std::vector<std::string>& keys,
+  const std::string& key, uint32_t handle) {
+	if (table.emplace(key, handle).second) {
+		keys.push_back(key);
+	}
+}
@@ -0,0 +1,89 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// アセット名の索引
+/// 正規化したパスでハンドルを引き、呼び出し側が渡した名前は別名として覚えておくので、
+/// 同じ名前での2回目以降の検索は正規化せずにハッシュ1回で済む。
+/// 別名は解決前の名前なので、パスとは別の表に置いて互いに引き当てない
+/// </summary>
+class AssetNameTable {
+  public: // 定数
+	// 見つからなかったときのハンドル
+	static const uint32_t kNotFound = UINT32_MAX;
+
+  public: // 静的メンバ関数
+	/// <summary>
+	/// パスの正規化
+	/// 区切りを'/'に揃えて小文字にし、"."と空の要素を除いて".."を解決する
+	/// </summary>
+	/// <param name="path">パス</param>
+	/// <returns>正規化したパス</returns>
+	static std::string Normalize(const std::string& path);
+
+  public: // メンバ関数
+	/// <summary>
+	/// 名前で検索（登録済みの名前か別名と完全に一致するものだけ。パスとは照合しない）
+	/// </summary>
+	/// <param name="name">名前</param>
+	/// <returns>ハンドル（なければkNotFound）</returns>
+	uint32_t Find(const std::string& name) const;
+
+	/// <summary>
+	/// パスを正規化して登録済みのパスから検索し、見つかれば名前を別名として登録する
+	/// </summary>
+	/// <param name="name">名前</param>
+	/// <param name="path">名前から解決したパス</param>
+	/// <returns>ハンドル（なければkNotFound）</returns>
+	uint32_t FindPath(const std::string& name, const std::string& path);
+
+	/// <summary>
+	/// 登録
+	/// </summary>
+	/// <param name="name">名前</param>
+	/// <param name="path">名前から解決したパス</param>
+	/// <param name="handle">ハンドル</param>
+	void Insert(const std::string& name, const std::string& path, uint32_t handle);
+
+	/// <summary>
+	/// ハンドルに対応する名前と別名を全て削除
+	/// </summary>
+	/// <param name="handle">ハンドル</param>
+	void Erase(uint32_t handle);
+
+	/// <summary>
+	/// 全て削除
+	/// </summary>
+	void Clear();
+
+  private: // サブクラス
+	// ハンドルごとの登録キー（削除用）
+	struct Keys {
+		std::vector<std::string> paths;
+		std::vector<std::string> aliases;
+	};
+
+  private: // メンバ関数
+	/// <summary>
+	/// キーの追加
+	/// </summary>
+	/// <param name="table">追加先の表</param>
+	/// <param name="keys">追加先の表のハンドルごとの登録キー</param>
+	/// <param name="key">キー</param>
+	/// <param name="handle">ハンドル</param>
+	static void AddKey(
+	  std::unordered_map<std::string, uint32_t>& table, std::vector<std::string>& keys,
+	  const std::string& key, uint32_t handle);
+
+  private: // メンバ変数
+	// 正規化したパスからハンドルへ
+	std::unordered_map<std::string, uint32_t> paths_;
+	// 別名（呼び出し側が渡した名前そのまま）からハンドルへ
+	std::unordered_map<std::string, uint32_t> aliases_;
+	// ハンドルごとの登録キー
+	std::unordered_map<uint32_t, Keys> keys_;
+};
@@ -1,4 +1,5 @@
 ﻿#include "DirectXCommon.h"
+#include "ResourceUploader.h"
 #include "SafeDelete.h"
 #include <algorithm>
 #include <cassert>
@@ -15,6 +16,12 @@ DirectXCommon* DirectXCommon::GetInstance() {
 	return &instance;
 }
 
+DirectXCommon::~DirectXCommon() {
+	if (fenceEvent_) {
+		CloseHandle(fenceEvent_);
+	}
+}
+
 void DirectXCommon::Initialize(WinApp* winApp, int32_t backBufferWidth, int32_t backBufferHeight) {
 	// nullptrチェック
 	assert(winApp);
@@ -42,40 +49,34 @@ void DirectXCommon::Initialize(WinApp* winApp, int32_t backBufferWidth, int32_t
 
 	// フェンス生成
 	CreateFence();
+
+	// 最初のフレームリソース
+	frameIndex_ = swapChain_->GetCurrentBackBufferIndex();
 }
 
 void DirectXCommon::PreDraw() {
 	// バックバッファの番号を取得（2つなので0番か1番）
 	UINT bbIndex = swapChain_->GetCurrentBackBufferIndex();
 
+	// このフレームのコマンドプールを先頭から使う（GPU完了待ちは前フレームのPostDrawで済んでいる）
+	assert(frameIndex_ == bbIndex);
+	frames_[frameIndex_].usedContextCount = 0;
+	submitLists_.clear();
+	commandList_ = AcquireCommandList();
+
 	// リソースバリアを変更（表示状態→描画対象）
 	CD3DX12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(
 	  backBuffers_[bbIndex].Get(), D3D12_RESOURCE_STATE_PRESENT,
 	  D3D12_RESOURCE_STATE_RENDER_TARGET);
 	commandList_->ResourceBarrier(1, &barrier);
 
-	// レンダーターゲットビュー用ディスクリプタヒープのハンドルを取得
-	CD3DX12_CPU_DESCRIPTOR_HANDLE rtvH = CD3DX12_CPU_DESCRIPTOR_HANDLE(
-	  rtvHeap_->GetCPUDescriptorHandleForHeapStart(), bbIndex,
-	  device_->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV));
-	// 深度ステンシルビュー用デスクリプタヒープのハンドルを取得
-	CD3DX12_CPU_DESCRIPTOR_HANDLE dsvH =
-	  CD3DX12_CPU_DESCRIPTOR_HANDLE(dsvHeap_->GetCPUDescriptorHandleForHeapStart());
-	// レンダーターゲットをセット
-	commandList_->OMSetRenderTargets(1, &rtvH, false, &dsvH);
+	// レンダーターゲット、ビューポートの設定
+	SetRenderTargetState(commandList_);
 
 	// 全画面クリア
 	ClearRenderTarget();
 	// 深度バッファクリア
 	ClearDepthBuffer();
-
-	// ビューポートの設定
-	CD3DX12_VIEWPORT viewport =
-	  CD3DX12_VIEWPORT(0.0f, 0.0f, float(backBufferWidth_), float(backBufferHeight_));
-	commandList_->RSSetViewports(1, &viewport);
-	// シザリング矩形の設定
-	CD3DX12_RECT rect = CD3DX12_RECT(0, 0, backBufferWidth_, backBufferHeight_);
-	commandList_->RSSetScissorRects(1, &rect);
 }
 
 void DirectXCommon::PostDraw() {
@@ -91,9 +92,12 @@ void DirectXCommon::PostDraw() {
 	// 命令のクローズ
 	commandList_->Close();
 
-	// コマンドリストの実行
-	ID3D12CommandList* cmdLists[] = {commandList_.Get()}; // コマンドリストの配列
-	commandQueue_->ExecuteCommandLists(1, cmdLists);
+	// 予約されたリソース転送を提出し、描画の前に完了を待たせる
+	ResourceUploader::GetInstance()->Flush();
+
+	// コマンドリストの実行（記録順のまま1回で提出）
+	commandQueue_->ExecuteCommandLists(
+	  static_cast<UINT>(submitLists_.size()), submitLists_.data());
 
 	// バッファをフリップ
 	result = swapChain_->Present(1, 0);
@@ -111,18 +115,64 @@ void DirectXCommon::PostDraw() {
 	}
 #endif
 
-	// コマンドリストの実行完了を待つ
+	// このフレームのコマンド完了時のフェンス値を記録
 	commandQueue_->Signal(fence_.Get(), ++fenceVal_);
-	if (fence_->GetCompletedValue() != fenceVal_) {
-		HANDLE event = CreateEvent(nullptr, false, false, nullptr);
-		fence_->SetEventOnCompletion(fenceVal_, event);
-		WaitForSingleObject(event, INFINITE);
-		CloseHandle(event);
+	frames_[frameIndex_].fenceValue = fenceVal_;
+
+	// 次のフレームリソースを使い回す前に、それを使ったフレームの完了だけを待つ
+	frameIndex_ = swapChain_->GetCurrentBackBufferIndex();
+	WaitForFenceValue(frames_[frameIndex_].fenceValue);
+
+	// GPUが使い終わったのでアップロード領域を先頭から使い直す
+	frames_[frameIndex_].uploadAllocator->Reset();
+	frameNumber_++;
+
+	// 次のPreDrawまで記録先なし
+	commandList_ = nullptr;
+}
+
+void DirectXCommon::RecordParallel(ICommandRecorder<ID3D12GraphicsCommandList>* recorder) {
+	// PreDrawとPostDrawの間でのみ記録できる
+	assert(recorder);
+	assert(commandList_);
+
+	// 要素を連続した範囲に分割
+	std::vector<RecordRange> ranges =
+	  ParallelCommandRecorder<ID3D12GraphicsCommandList>::SplitRanges(
+	    recorder->GetItemCount(), kMaxRecordLists, kMinRecordItemsPerList);
+	if (ranges.empty()) {
+		return;
 	}
 
-	commandAllocator_->Reset(); // キューをクリア
-	commandList_->Reset(commandAllocator_.Get(),
-	                    nullptr); // 再びコマンドリストを貯める準備
+	// 1範囲だけなら現在のコマンドリストにそのまま記録
+	if (ranges.size() == 1) {
+		recorder->Prepare();
+		recorder->BeginRecord(commandList_);
+		recorder->Record(commandList_, ranges[0]);
+		return;
+	}
+
+	// ここまでの記録を閉じる
+	commandList_->Close();
+
+	// 範囲ごとのコマンドリストを提出順に確保
+	std::vector<ID3D12GraphicsCommandList*> lists(ranges.size());
+	for (size_t i = 0; i < lists.size(); i++) {
+		lists[i] = AcquireCommandList();
+		SetRenderTargetState(lists[i]);
+	}
+
+	// ワーカースレッドで並列記録
+	ParallelCommandRecorder<ID3D12GraphicsCommandList>::Record(
+	  ThreadPool::GetInstance(), recorder, ranges, lists.data());
+
+	for (ID3D12GraphicsCommandList* list : lists) {
+		list->Close();
+	}
+
+	// 以降の記録は新しいコマンドリストへ
+	commandList_ = AcquireCommandList();
+	SetRenderTargetState(commandList_);
 }
 
 void DirectXCommon::ClearRenderTarget() {
@@ -146,6 +196,19 @@ void DirectXCommon::ClearDepthBuffer() {
 	commandList_->ClearDepthStencilView(dsvH, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
 }
 
+void DirectXCommon::WaitForGpu() {
+	// 全コマンドの完了を待つ
+	commandQueue_->Signal(fence_.Get(), ++fenceVal_);
+	WaitForFenceValue(fenceVal_);
+}
+
+void DirectXCommon::WaitForFenceValue(UINT64 fenceValue) {
+	if (fence_->GetCompletedValue() < fenceValue) {
+		fence_->SetEventOnCompletion(fenceValue, fenceEvent_);
+		WaitForSingleObject(fenceEvent_, INFINITE);
+	}
+}
+
 int32_t DirectXCommon::GetBackBufferWidth() const { return backBufferWidth_; }
 
 int32_t DirectXCommon::GetBackBufferHeight() const { return backBufferHeight_; }
@@ -262,7 +325,7 @@ void DirectXCommon::CreateSwapChain() {
 	swapChainDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM; // 色情報の書式を一般的なものに
 	swapChainDesc.SampleDesc.Count = 1;                // マルチサンプルしない
 	swapChainDesc.BufferUsage = DXGI_USAGE_BACK_BUFFER; // バックバッファとして使えるように
-	swapChainDesc.BufferCount = 2;                      // バッファ数を２つに設定
+	swapChainDesc.BufferCount = kFrameCount;            // バッファ数を２つに設定
 	swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD; // フリップ後は速やかに破棄
 	swapChainDesc.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING; // ティアリングサポート
 	ComPtr<IDXGISwapChain1> swapChain1;
@@ -283,21 +346,34 @@ void DirectXCommon::CreateSwapChain() {
 void DirectXCommon::InitializeCommand() {
 	HRESULT result = S_FALSE;
 
-	// コマンドアロケータを生成
-	result = device_->CreateCommandAllocator(
-	  D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&commandAllocator_));
-	assert(SUCCEEDED(result));
-
-	// コマンドリストを生成
-	result = device_->CreateCommandList(
-	  0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator_.Get(), nullptr,
-	  IID_PPV_ARGS(&commandList_));
-	assert(SUCCEEDED(result));
-
 	// 標準設定でコマンドキューを生成
 	D3D12_COMMAND_QUEUE_DESC cmdQueueDesc{};
 	result = device_->CreateCommandQueue(&cmdQueueDesc, IID_PPV_ARGS(&commandQueue_));
 	assert(SUCCEEDED(result));
+
+	// アップロード用ページの生成元
+	uploadPageSource_ = std::make_unique<UploadPageSource>(device_.Get());
+
+	// フレームごとにメイン用のコマンドアロケータとコマンドリストを生成しておく
+	for (FrameResource& frame : frames_) {
+		CommandContext context;
+		result = device_->CreateCommandAllocator(
+		  D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&context.allocator));
+		assert(SUCCEEDED(result));
+
+		result = device_->CreateCommandList(
+		  0, D3D12_COMMAND_LIST_TYPE_DIRECT, context.allocator.Get(), nullptr,
+		  IID_PPV_ARGS(&context.list));
+		assert(SUCCEEDED(result));
+
+		// 生成直後は記録中なので閉じておく
+		context.list->Close();
+		frame.contexts.push_back(context);
+
+		// アップロード領域
+		frame.uploadAllocator =
+		  std::make_unique<LinearAllocator>(uploadPageSource_.get(), kUploadPageSize);
+	}
 }
 
 void DirectXCommon::CreateFinalRenderTargets() {
@@ -373,4 +449,62 @@ void DirectXCommon::CreateFence() {
 	// フェンスの生成
 	result = device_->CreateFence(fenceVal_, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence_));
 	assert(SUCCEEDED(result));
+
+	// フェンス待ち用イベントは1つを使い回す
+	fenceEvent_ = CreateEvent(nullptr, false, false, nullptr);
+	assert(fenceEvent_);
+}
+
+ID3D12GraphicsCommandList* DirectXCommon::AcquireCommandList() {
+	HRESULT result = S_FALSE;
+
+	FrameResource& frame = frames_[frameIndex_];
+
+	// プールが足りなければ追加生成
+	if (frame.usedContextCount == frame.contexts.size()) {
+		CommandContext context;
+		result = device_->CreateCommandAllocator(
+		  D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&context.allocator));
+		assert(SUCCEEDED(result));
+
+		result = device_->CreateCommandList(
+		  0, D3D12_COMMAND_LIST_TYPE_DIRECT, context.allocator.Get(), nullptr,
+		  IID_PPV_ARGS(&context.list));
+		assert(SUCCEEDED(result));
+
+		context.list->Close();
+		frame.contexts.push_back(context);
+	}
+
+	CommandContext& context = frame.contexts[frame.usedContextCount++];
+	context.allocator->Reset(); // キューをクリア
+	context.list->Reset(context.allocator.Get(),
+	                    nullptr); // 再びコマンドリストを貯める準備
+
+	// 確保した順に提出する
+	submitLists_.push_back(context.list.Get());
+
+	return context.list.Get();
+}
+
+void DirectXCommon::SetRenderTargetState(ID3D12GraphicsCommandList* commandList) {
+	UINT bbIndex = swapChain_->GetCurrentBackBufferIndex();
+
+	// レンダーターゲットビュー用ディスクリプタヒープのハンドルを取得
+	CD3DX12_CPU_DESCRIPTOR_HANDLE rtvH = CD3DX12_CPU_DESCRIPTOR_HANDLE(
+	  rtvHeap_->GetCPUDescriptorHandleForHeapStart(), bbIndex,
+	  device_->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV));
+	// 深度ステンシルビュー用デスクリプタヒープのハンドルを取得
+	CD3DX12_CPU_DESCRIPTOR_HANDLE dsvH =
+	  CD3DX12_CPU_DESCRIPTOR_HANDLE(dsvHeap_->GetCPUDescriptorHandleForHeapStart());
+	// レンダーターゲットをセット
+	commandList->OMSetRenderTargets(1, &rtvH, false, &dsvH);
+
+	// ビューポートの設定
+	CD3DX12_VIEWPORT viewport =
+	  CD3DX12_VIEWPORT(0.0f, 0.0f, float(backBufferWidth_), float(backBufferHeight_));
+	commandList->RSSetViewports(1, &viewport);
+	// シザリング矩形の設定
+	CD3DX12_RECT rect = CD3DX12_RECT(0, 0, backBufferWidth_, backBufferHeight_);
+	commandList->RSSetScissorRects(1, &rect);
 }
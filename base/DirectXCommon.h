@@ -1,18 +1,34 @@
 ﻿#pragma once
 
 #include <Windows.h>
+#include <array>
 #include <cstdlib>
 #include <d3d12.h>
 #include <d3dx12.h>
 #include <dxgi1_6.h>
+#include <memory>
+#include <vector>
 #include <wrl.h>
 
+#include "LinearAllocator.h"
+#include "ParallelCommandRecorder.h"
+#include "UploadPageSource.h"
 #include "WinApp.h"
 
 /// <summary>
 /// DirectX汎用
 /// </summary>
 class DirectXCommon {
+  public: // 定数
+	// フレームリソースの数（バックバッファの数）
+	static const uint32_t kFrameCount = 2;
+	// 並列記録の最大コマンドリスト数
+	static const uint32_t kMaxRecordLists = 4;
+	// 並列記録で1リストあたりに割り当てる最小要素数
+	static const uint32_t kMinRecordItemsPerList = 32;
+	// フレームごとのアップロード用ページのサイズ
+	static const size_t kUploadPageSize = 1024 * 1024;
+
   public: // メンバ関数
 
 	/// <summary>
@@ -48,17 +64,80 @@ class DirectXCommon {
 	/// </summary>
 	void ClearDepthBuffer();
 
+	/// <summary>
+	/// GPUの全コマンド完了を待つ（リソース解放前や終了時に使う）
+	/// </summary>
+	void WaitForGpu();
+
+	/// <summary>
+	/// 現在のフレームリソース番号の取得
+	/// 前フレームのPostDraw以降、このフレームのPostDrawまで同じ値を返す
+	/// </summary>
+	/// <returns>フレームリソース番号</returns>
+	UINT GetFrameIndex() const { return frameIndex_; }
+
+	/// <summary>
+	/// 通し番号のフレーム数の取得（PostDrawごとに1増える）
+	/// </summary>
+	/// <returns>フレーム数</returns>
+	uint64_t GetFrameNumber() const { return frameNumber_; }
+
+	/// <summary>
+	/// GPUが完了したフェンス値の取得
+	/// </summary>
+	/// <returns>フェンス値</returns>
+	UINT64 GetCompletedFenceValue() const { return fence_->GetCompletedValue(); }
+
+	/// <summary>
+	/// 次にシグナルするフェンス値の取得
+	/// 今記録中のコマンドは、GetCompletedFenceValueがこの値に達したら完了している
+	/// </summary>
+	/// <returns>フェンス値</returns>
+	UINT64 GetNextFenceValue() const { return fenceVal_ + 1; }
+
+	/// <summary>
+	/// 現在のフレーム用のアップロード領域の確保（スレッドセーフ）
+	/// このフレームのGPU処理が終わるまで有効
+	/// </summary>
+	/// <param name="size">サイズ</param>
+	/// <param name="alignment">アライメント（2のべき乗）</param>
+	/// <returns>確保した領域</returns>
+	LinearAllocator::Allocation
+	  AllocateUpload(size_t size, size_t alignment = LinearAllocator::kDefaultAlignment) {
+		return frames_[frameIndex_].uploadAllocator->Allocate(size, alignment);
+	}
+
 	/// <summary>
 	/// デバイスの取得
 	/// </summary>
 	/// <returns>デバイス</returns>
 	ID3D12Device* GetDevice() { return device_.Get(); }
 
+	/// <summary>
+	/// 描画用コマンドキューの取得
+	/// </summary>
+	/// <returns>コマンドキュー</returns>
+	ID3D12CommandQueue* GetCommandQueue() { return commandQueue_.Get(); }
+
 	/// <summary>
 	/// 描画コマンドリストの取得
 	/// </summary>
 	/// <returns>描画コマンドリスト</returns>
-	ID3D12GraphicsCommandList* GetCommandList() { return commandList_.Get(); }
+	ID3D12GraphicsCommandList* GetCommandList() { return commandList_; }
+
+	/// <summary>
+	/// レンダーターゲットとビューポートのセット（シャドウマップなど別の描画先から戻すときにも使う）
+	/// </summary>
+	/// <param name="commandList">コマンドリスト</param>
+	void SetRenderTargetState(ID3D12GraphicsCommandList* commandList);
+
+	/// <summary>
+	/// 描画コマンドの並列記録
+	/// 範囲ごとのコマンドリストに記録し、呼び出し順のままPostDrawで提出する。
+	/// 呼び出し後は記録先が新しいコマンドリストに切り替わるので、GetCommandListで取得し直すこと
+	/// </summary>
+	/// <param name="recorder">記録処理</param>
+	void RecordParallel(ICommandRecorder<ID3D12GraphicsCommandList>* recorder);
 
 	/// <summary>
 	/// バックバッファの幅取得
@@ -79,8 +158,6 @@ class DirectXCommon {
 	// Direct3D関連
 	Microsoft::WRL::ComPtr<IDXGIFactory7> dxgiFactory_;
 	Microsoft::WRL::ComPtr<ID3D12Device> device_;
-	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList_;
-	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> commandAllocator_;
 	Microsoft::WRL::ComPtr<ID3D12CommandQueue> commandQueue_;
 	Microsoft::WRL::ComPtr<IDXGISwapChain4> swapChain_;
 	std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> backBuffers_;
@@ -89,12 +166,41 @@ class DirectXCommon {
 	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> dsvHeap_;
 	Microsoft::WRL::ComPtr<ID3D12Fence> fence_;
 	UINT64 fenceVal_ = 0;
+	// フェンス待ち用イベント
+	HANDLE fenceEvent_ = nullptr;
 	int32_t backBufferWidth_ = 0;
 	int32_t backBufferHeight_ = 0;
 
+	// アップロード用ページの生成元（フレームリソースより先に破棄しない）
+	std::unique_ptr<UploadPageSource> uploadPageSource_;
+
+	// コマンドアロケータとコマンドリストの組
+	struct CommandContext {
+		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> allocator;
+		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> list;
+	};
+	// フレームごとのコマンドプール
+	struct FrameResource {
+		std::vector<CommandContext> contexts;
+		size_t usedContextCount = 0;
+		// このフレームのコマンド完了時のフェンス値
+		UINT64 fenceValue = 0;
+		// このフレームの定数などのアップロード領域
+		std::unique_ptr<LinearAllocator> uploadAllocator;
+	};
+	std::array<FrameResource, kFrameCount> frames_;
+	// 現在のフレームリソース番号
+	UINT frameIndex_ = 0;
+	// 通し番号のフレーム数
+	uint64_t frameNumber_ = 0;
+	// 現在の記録先コマンドリスト
+	ID3D12GraphicsCommandList* commandList_ = nullptr;
+	// 今フレームの提出順のコマンドリスト
+	std::vector<ID3D12CommandList*> submitLists_;
+
   private: // メンバ関数
 	DirectXCommon() = default;
-	~DirectXCommon() = default;
+	~DirectXCommon();
 	DirectXCommon(const DirectXCommon&) = delete;
 	const DirectXCommon& operator=(const DirectXCommon&) = delete;
 		   
@@ -127,4 +233,16 @@ class DirectXCommon {
 	/// フェンス生成
 	/// </summary>
 	void CreateFence();
+
+	/// <summary>
+	/// フェンスが指定値に達するまで待つ
+	/// </summary>
+	/// <param name="fenceValue">フェンス値</param>
+	void WaitForFenceValue(UINT64 fenceValue);
+
+	/// <summary>
+	/// 現在のフレームのプールからコマンドリストを取り出して記録を開始する
+	/// </summary>
+	/// <returns>記録開始済みのコマンドリスト</returns>
+	ID3D12GraphicsCommandList* AcquireCommandList();
 };
@@ -0,0 +1,120 @@
+﻿#include "DistanceTransform.h"
+#include "ThreadPool.h"
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// 特徴ピクセルがないことを表す距離（2乗しても溢れない）
+const float kFar = 1e20f;
+
+// 並列に処理できればスレッドプールで、できなければ順番に処理する
+void ForEach(ThreadPool* threadPool, uint32_t count, const std::function<void(uint32_t)>& func) {
+	if (threadPool) {
+		threadPool->ParallelFor(count, func);
+	} else {
+		for (uint32_t i = 0; i < count; i++) {
+			func(i);
+		}
+	}
+}
+
+} // namespace
+
+void DistanceTransform::ComputeSquared(
+  const uint8_t* features, uint32_t width, uint32_t height, float* distances,
+  ThreadPool* threadPool) {
+	if (width == 0 || height == 0) {
+		return;
+	}
+
+	// 列ごとの変換（特徴ピクセルは0、それ以外は無限遠）
+	std::vector<float> columns(size_t(width) * height);
+	for (size_t i = 0; i < columns.size(); i++) {
+		columns[i] = features[i] ? 0.0f : kFar;
+	}
+	ForEach(threadPool, width, [&](uint32_t x) {
+		std::vector<float> work(size_t(height) * 2 + 1);
+		std::vector<float> source(height);
+		std::vector<float> column(height);
+		for (uint32_t y = 0; y < height; y++) {
+			source[y] = columns[size_t(y) * width + x];
+		}
+		Transform1D(source.data(), column.data(), height, work.data());
+		for (uint32_t y = 0; y < height; y++) {
+			columns[size_t(y) * width + x] = column[y];
+		}
+	});
+
+	// 行ごとの変換
+	ForEach(threadPool, height, [&](uint32_t y) {
+		std::vector<float> work(size_t(width) * 2 + 1);
+		Transform1D(&columns[size_t(y) * width], &distances[size_t(y) * width], width, work.data());
+	});
+}
+
+void DistanceTransform::ComputeSigned(
+  const uint8_t* coverage, uint32_t width, uint32_t height, uint8_t threshold, float* distances,
+  ThreadPool* threadPool) {
+	size_t size = size_t(width) * height;
+
+	// 内側までの距離と外側までの距離
+	std::vector<uint8_t> inside(size);
+	std::vector<uint8_t> outside(size);
+	for (size_t i = 0; i < size; i++) {
+		inside[i] = coverage[i] >= threshold;
+		outside[i] = !inside[i];
+	}
+	std::vector<float> toInside(size);
+	std::vector<float> toOutside(size);
+	ComputeSquared(inside.data(), width, height, toInside.data(), threadPool);
+	ComputeSquared(outside.data(), width, height, toOutside.data(), threadPool);
+
+	// ピクセル中心同士の距離から、輪郭（中間）までの距離に直す
+	for (size_t i = 0; i < size; i++) {
+		if (inside[i]) {
+			distances[i] = 0.5f - std::sqrt(toOutside[i]);
+		} else {
+			distances[i] = std::sqrt(toInside[i]) - 0.5f;
+		}
+	}
+}
+
+void DistanceTransform::Transform1D(const float* f, float* d, uint32_t count, float* work) {
+	// 下側包絡線を構成する放物線の頂点と、隣との境界
+	uint32_t* v = reinterpret_cast<uint32_t*>(work);
+	float* z = work + count;
+
+	// 頂点の値 f[p] + p^2 を比べて包絡線を作る
+	auto intersect = [f](uint32_t q, uint32_t p) {
+		float fq = f[q] + float(q) * q;
+		float fp = f[p] + float(p) * p;
+		return (fq - fp) / (2.0f * (float(q) - float(p)));
+	};
+
+	int k = 0;
+	v[0] = 0;
+	z[0] = -INFINITY;
+	z[1] = INFINITY;
+	for (uint32_t q = 1; q < count; q++) {
+		float s = intersect(q, v[k]);
+		while (s <= z[k]) {
+			k--;
+			s = intersect(q, v[k]);
+		}
+		k++;
+		v[k] = q;
+		z[k] = s;
+		z[k + 1] = INFINITY;
+	}
+
+	// 包絡線を読み出す
+	k = 0;
+	for (uint32_t q = 0; q < count; q++) {
+		while (z[k + 1] < float(q)) {
+			k++;
+		}
+		float offset = float(q) - float(v[k]);
+		d[q] = offset * offset + f[v[k]];
+	}
+}
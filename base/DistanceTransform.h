@@ -0,0 +1,49 @@
+﻿#pragma once
+
+#include <cstdint>
+
+class ThreadPool;
+
+/// <summary>
+/// ユークリッド距離変換
+/// Felzenszwalb-Huttenlockerの方法で、各ピクセルから最も近い特徴ピクセルまでの正確な距離を
+/// 列ごと、行ごとの1次元変換2回で求める
+/// </summary>
+class DistanceTransform {
+  public: // 静的メンバ関数
+	/// <summary>
+	/// 最も近い特徴ピクセルまでの距離の2乗
+	/// </summary>
+	/// <param name="features">0以外が特徴ピクセル（width * height）</param>
+	/// <param name="width">幅</param>
+	/// <param name="height">高さ</param>
+	/// <param name="distances">書き込み先（width * height、特徴ピクセルがなければ非常に大きな値）</param>
+	/// <param name="threadPool">列、行を並列に処理するスレッドプール（nullptrなら呼び出し元のみ）</param>
+	static void ComputeSquared(
+	  const uint8_t* features, uint32_t width, uint32_t height, float* distances,
+	  ThreadPool* threadPool = nullptr);
+
+	/// <summary>
+	/// 符号付き距離（輪郭の外側が正、内側が負。単位はピクセル）
+	/// 隣り合う内側と外側のピクセルの中間を輪郭とみなす
+	/// </summary>
+	/// <param name="coverage">被覆率（width * height）</param>
+	/// <param name="width">幅</param>
+	/// <param name="height">高さ</param>
+	/// <param name="threshold">これ以上を内側とする被覆率</param>
+	/// <param name="distances">書き込み先（width * height）</param>
+	/// <param name="threadPool">列、行を並列に処理するスレッドプール（nullptrなら呼び出し元のみ）</param>
+	static void ComputeSigned(
+	  const uint8_t* coverage, uint32_t width, uint32_t height, uint8_t threshold,
+	  float* distances, ThreadPool* threadPool = nullptr);
+
+  private: // 静的メンバ関数
+	/// <summary>
+	/// 1次元の変換 d[q] = min_p((q - p)^2 + f[p])
+	/// </summary>
+	/// <param name="f">入力（count個）</param>
+	/// <param name="d">書き込み先（count個）</param>
+	/// <param name="count">要素数</param>
+	/// <param name="work">作業領域（count * 2 + 1 個）</param>
+	static void Transform1D(const float* f, float* d, uint32_t count, float* work);
+};
@@ -0,0 +1,59 @@
+﻿#pragma once
+
+#include "DirectXCommon.h"
+#include <cassert>
+#include <cstring>
+
+/// <summary>
+/// フレームごとのアップロード領域に書き込む定数データ
+/// CPU側に値を保持し、描画で参照された時にそのフレームの線形アロケータから領域を確保して書き込む。
+/// 個別のリソースは持たない
+/// </summary>
+/// <typeparam name="T">データ型</typeparam>
+template<class T> class FrameConstantBuffer {
+  public: // メンバ関数
+	/// <summary>
+	/// 書き換え用にデータを取得（次に参照された時に新しい領域へ書き込む）
+	/// </summary>
+	/// <returns>CPU側のデータ</returns>
+	T& Edit() {
+		written_ = false;
+		return data_;
+	}
+
+	/// <summary>
+	/// データの取得
+	/// </summary>
+	/// <returns>CPU側のデータ</returns>
+	const T& GetData() const { return data_; }
+
+	/// <summary>
+	/// 現在のフレームのGPUアドレスを取得（このフレームで未書き込みなら確保して書き込む）
+	/// 並列記録中に共有する場合は、事前にメインスレッドで一度呼んでおくこと
+	/// </summary>
+	/// <returns>GPUアドレス</returns>
+	D3D12_GPU_VIRTUAL_ADDRESS GetGPUVirtualAddress() const {
+		DirectXCommon* dxCommon = DirectXCommon::GetInstance();
+		uint64_t frameNumber = dxCommon->GetFrameNumber();
+		if (!written_ || writtenFrame_ != frameNumber) {
+			LinearAllocator::Allocation allocation = dxCommon->AllocateUpload(sizeof(T));
+			assert(allocation.cpuAddress);
+			memcpy(allocation.cpuAddress, &data_, sizeof(T));
+			gpuAddress_ = allocation.gpuAddress;
+			writtenFrame_ = frameNumber;
+			written_ = true;
+		}
+
+		return gpuAddress_;
+	}
+
+  private: // メンバ変数
+	// CPU側のデータ
+	T data_{};
+	// 書き込み済みの領域のGPUアドレス
+	mutable D3D12_GPU_VIRTUAL_ADDRESS gpuAddress_ = 0;
+	// 書き込んだフレーム
+	mutable uint64_t writtenFrame_ = 0;
+	// 書き込み済みか
+	mutable bool written_ = false;
+};
@@ -0,0 +1,152 @@
+﻿#pragma once
+
+#include "DirectXCommon.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <d3dx12.h>
+#include <vector>
+
+/// <summary>
+/// フレームごとに領域を切り替えるアップロードバッファ
+/// CPU側に値を保持し、参照されたフレームの領域へ必要な時だけ転送する。
+/// フレームの領域ごとに書き換えた範囲を覚え、その範囲だけを写す。
+/// GPUが使用中の前フレームの領域は書き換えない
+/// </summary>
+/// <typeparam name="T">データ型</typeparam>
+template<class T> class FrameUploadBuffer {
+  public: // 定数
+	// 1フレーム分の領域サイズ（定数バッファとして使えるよう256バイト境界に揃える）
+	static const size_t kSlotSize = (sizeof(T) + 0xff) & ~size_t(0xff);
+	// フレームごとに覚える未転送の範囲の最大数（超えたら1つにまとめる）
+	static const size_t kMaxDirtyRanges = 32;
+
+  public: // メンバ関数
+	/// <summary>
+	/// バッファ生成
+	/// </summary>
+	void Create() {
+		HRESULT result;
+
+		// ヒーププロパティ
+		CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+		// リソース設定
+		CD3DX12_RESOURCE_DESC resourceDesc =
+		  CD3DX12_RESOURCE_DESC::Buffer(kSlotSize * DirectXCommon::kFrameCount);
+
+		// バッファの生成
+		result = DirectXCommon::GetInstance()->GetDevice()->CreateCommittedResource(
+		  &heapProps, // アップロード可能
+		  D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
+		  IID_PPV_ARGS(&resource_));
+		assert(SUCCEEDED(result));
+
+		// バッファとのデータリンク
+		result = resource_->Map(0, nullptr, (void**)&mapped_);
+		assert(SUCCEEDED(result));
+
+		MarkAllDirty();
+	}
+
+	/// <summary>
+	/// 書き換え用にデータを取得（全フレームの領域を未転送にする）
+	/// </summary>
+	/// <returns>CPU側のデータ</returns>
+	T& Edit() {
+		MarkAllDirty();
+		return data_;
+	}
+
+	/// <summary>
+	/// 一部だけ書き換え用にデータを取得（そのメンバの範囲だけを全フレームで未転送にする）
+	/// </summary>
+	/// <param name="member">GetDataで取得したデータのメンバ</param>
+	/// <returns>書き換え用のメンバ</returns>
+	template<class U> U& Edit(const U& member) {
+		size_t begin = reinterpret_cast<const uint8_t*>(&member) -
+		               reinterpret_cast<const uint8_t*>(&data_);
+		assert(begin + sizeof(U) <= sizeof(T));
+		for (std::vector<DirtyRange>& ranges : dirtyRanges_) {
+			AddDirtyRange(ranges, begin, begin + sizeof(U));
+		}
+		return const_cast<U&>(member);
+	}
+
+	/// <summary>
+	/// データの取得
+	/// </summary>
+	/// <returns>CPU側のデータ</returns>
+	const T& GetData() const { return data_; }
+
+	/// <summary>
+	/// 現在のフレームの領域のGPUアドレスを取得（未転送なら転送する）
+	/// 並列記録中に共有する場合は、事前にメインスレッドで一度呼んでおくこと
+	/// </summary>
+	/// <returns>GPUアドレス</returns>
+	D3D12_GPU_VIRTUAL_ADDRESS GetGPUVirtualAddress() const {
+		assert(mapped_);
+
+		UINT frameIndex = DirectXCommon::GetInstance()->GetFrameIndex();
+		std::vector<DirtyRange>& ranges = dirtyRanges_[frameIndex];
+		uint8_t* slot = mapped_ + kSlotSize * frameIndex;
+		for (const DirtyRange& range : ranges) {
+			memcpy(
+			  slot + range.begin, reinterpret_cast<const uint8_t*>(&data_) + range.begin,
+			  range.end - range.begin);
+		}
+		ranges.clear();
+
+		return resource_->GetGPUVirtualAddress() + kSlotSize * frameIndex;
+	}
+
+  private: // サブクラス
+	// 未転送の範囲（バイト単位）
+	struct DirtyRange {
+		size_t begin;
+		size_t end;
+	};
+
+  private: // メンバ関数
+	/// <summary>
+	/// 全フレームの領域の全体を未転送にする
+	/// </summary>
+	void MarkAllDirty() {
+		for (std::vector<DirtyRange>& ranges : dirtyRanges_) {
+			ranges.assign(1, DirtyRange{0, sizeof(T)});
+		}
+	}
+
+	/// <summary>
+	/// 未転送の範囲の追加（直前の範囲と重なるか接していればつなげる）
+	/// </summary>
+	static void AddDirtyRange(std::vector<DirtyRange>& ranges, size_t begin, size_t end) {
+		if (!ranges.empty()) {
+			DirtyRange& last = ranges.back();
+			if (begin <= last.end && last.begin <= end) {
+				last.begin = (std::min)(last.begin, begin);
+				last.end = (std::max)(last.end, end);
+				return;
+			}
+		}
+		// 多すぎれば全てを含む1つの範囲にまとめる
+		if (ranges.size() >= kMaxDirtyRanges) {
+			for (const DirtyRange& range : ranges) {
+				begin = (std::min)(begin, range.begin);
+				end = (std::max)(end, range.end);
+			}
+			ranges.assign(1, DirtyRange{begin, end});
+			return;
+		}
+		ranges.push_back({begin, end});
+	}
+
+  private: // メンバ変数
+	// バッファ
+	Microsoft::WRL::ComPtr<ID3D12Resource> resource_;
+	// マッピング済みアドレス
+	uint8_t* mapped_ = nullptr;
+	// CPU側のデータ
+	T data_{};
+	// フレームの領域ごとの未転送の範囲
+	mutable std::vector<DirtyRange> dirtyRanges_[DirectXCommon::kFrameCount];
+};
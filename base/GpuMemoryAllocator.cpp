@@ -0,0 +1,245 @@
+﻿#include "GpuMemoryAllocator.h"
+#include "DirectXCommon.h"
+#include <algorithm>
+#include <cassert>
+#include <d3dx12.h>
+
+using namespace Microsoft::WRL;
+
+namespace {
+
+// テクスチャ用のヒープか
+bool IsTexturePool(GpuMemoryAllocator::Pool pool) {
+	return pool == GpuMemoryAllocator::Pool::kCpuTexture ||
+	       pool == GpuMemoryAllocator::Pool::kDefaultTexture;
+}
+
+// 切り上げ（alignmentは2のべき乗）
+UINT64 AlignUp(UINT64 value, UINT64 alignment) {
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+GpuMemoryAllocator* GpuMemoryAllocator::GetInstance() {
+	static GpuMemoryAllocator instance;
+	return &instance;
+}
+
+void GpuMemoryAllocator::Initialize(ID3D12Device* device) {
+	assert(device);
+
+	device_ = device;
+
+	// デバイスと同じアダプタを取得（メモリ予算の問い合わせ用）
+	ComPtr<IDXGIFactory4> factory;
+	HRESULT result = CreateDXGIFactory1(IID_PPV_ARGS(&factory));
+	assert(SUCCEEDED(result));
+	result = factory->EnumAdapterByLuid(device_->GetAdapterLuid(), IID_PPV_ARGS(&adapter_));
+	assert(SUCCEEDED(result));
+}
+
+HRESULT GpuMemoryAllocator::CreatePlacedResource(
+  Pool pool, const D3D12_RESOURCE_DESC& resourceDesc, D3D12_RESOURCE_STATES initialState,
+  const D3D12_CLEAR_VALUE* clearValue, ComPtr<ID3D12Resource>& resource,
+  Allocation& allocation) {
+	assert(device_);
+	assert(pool != Pool::kCount);
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	// 先に使い終わった領域を返しておく
+	CollectGarbageLocked();
+
+	// 小さいテクスチャは4KB境界で置けるか試す
+	D3D12_RESOURCE_DESC desc = resourceDesc;
+	D3D12_RESOURCE_ALLOCATION_INFO info{};
+	if (IsTexturePool(pool) && desc.Alignment == 0) {
+		desc.Alignment = D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT;
+		info = device_->GetResourceAllocationInfo(0, 1, &desc);
+		if (info.Alignment != D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT) {
+			desc.Alignment = 0;
+			info = device_->GetResourceAllocationInfo(0, 1, &desc);
+		}
+	} else {
+		info = device_->GetResourceAllocationInfo(0, 1, &desc);
+	}
+
+	std::vector<Heap>& heaps = heaps_[static_cast<size_t>(pool)];
+
+	// 既存のヒープから空きを探す
+	allocation = Allocation();
+	allocation.pool = pool;
+	if (info.SizeInBytes <= kHeapSize) {
+		for (uint32_t i = 0; i < heaps.size(); i++) {
+			if (!heaps[i].heap || heaps[i].dedicated) {
+				continue;
+			}
+			allocation.block = heaps[i].allocator->Allocate(info.SizeInBytes, info.Alignment);
+			if (allocation.block.IsValid()) {
+				allocation.heapIndex = i;
+				break;
+			}
+		}
+	}
+
+	// なければヒープを追加する（大きなリソースは専用ヒープ）
+	if (!allocation.IsValid()) {
+		bool dedicated = info.SizeInBytes > kHeapSize;
+		UINT64 heapSize = kHeapSize;
+		if (dedicated) {
+			heapSize = AlignUp(info.SizeInBytes, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+		}
+		uint32_t heapIndex = CreateHeap(pool, heapSize, dedicated);
+		if (heapIndex == UINT32_MAX) {
+			allocation = Allocation();
+			return E_OUTOFMEMORY;
+		}
+		allocation.block = heaps[heapIndex].allocator->Allocate(info.SizeInBytes, info.Alignment);
+		assert(allocation.block.IsValid());
+		allocation.heapIndex = heapIndex;
+	}
+
+	// 確保した位置にリソースを配置
+	HRESULT result = device_->CreatePlacedResource(
+	  heaps[allocation.heapIndex].heap.Get(), allocation.block.offset, &desc, initialState,
+	  clearValue, IID_PPV_ARGS(&resource));
+	if (FAILED(result)) {
+		FreeAllocation(allocation);
+		allocation = Allocation();
+	}
+	return result;
+}
+
+void GpuMemoryAllocator::Release(ComPtr<ID3D12Resource>& resource, Allocation& allocation) {
+	if (!allocation.IsValid()) {
+		resource.Reset();
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	// 現在記録中のコマンドが完了するまで解放しない
+	PendingFree pending;
+	pending.resource = std::move(resource);
+	pending.allocation = allocation;
+	pending.fenceValue = DirectXCommon::GetInstance()->GetNextFenceValue();
+	pendingFrees_.push_back(std::move(pending));
+
+	resource.Reset();
+	allocation = Allocation();
+
+	CollectGarbageLocked();
+}
+
+void GpuMemoryAllocator::CollectGarbage() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	CollectGarbageLocked();
+}
+
+GpuMemoryAllocator::Stats GpuMemoryAllocator::GetStats() {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	Stats stats;
+	for (const std::vector<Heap>& heaps : heaps_) {
+		for (const Heap& heap : heaps) {
+			if (!heap.heap) {
+				continue;
+			}
+			TlsfAllocator::Stats heapStats = heap.allocator->GetStats();
+			stats.reservedSize += heapStats.capacity;
+			stats.usedSize += heapStats.usedSize;
+			stats.largestFreeBlock = (std::max)(stats.largestFreeBlock, heapStats.largestFreeBlock);
+			stats.allocationCount += heapStats.allocationCount;
+			stats.heapCount++;
+		}
+	}
+	for (const PendingFree& pending : pendingFrees_) {
+		stats.pendingFreeSize += pending.allocation.block.size;
+	}
+
+	// OSから見たビデオメモリの予算と使用量
+	if (adapter_) {
+		DXGI_QUERY_VIDEO_MEMORY_INFO memoryInfo{};
+		if (SUCCEEDED(adapter_->QueryVideoMemoryInfo(
+		      0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &memoryInfo))) {
+			stats.localBudget = memoryInfo.Budget;
+			stats.localUsage = memoryInfo.CurrentUsage;
+		}
+	}
+	return stats;
+}
+
+uint32_t GpuMemoryAllocator::CreateHeap(Pool pool, UINT64 size, bool dedicated) {
+	// ヒーププロパティとリソースの種類の制限
+	CD3DX12_HEAP_PROPERTIES heapProps;
+	D3D12_HEAP_FLAGS heapFlags = D3D12_HEAP_FLAG_NONE;
+	switch (pool) {
+	case Pool::kUploadBuffer:
+		heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+		heapFlags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+		break;
+	case Pool::kCpuTexture:
+		heapProps =
+		  CD3DX12_HEAP_PROPERTIES(D3D12_CPU_PAGE_PROPERTY_WRITE_BACK, D3D12_MEMORY_POOL_L0);
+		heapFlags = D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+		break;
+	case Pool::kDefaultBuffer:
+		heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+		heapFlags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+		break;
+	case Pool::kDefaultTexture:
+	default:
+		heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+		heapFlags = D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+		break;
+	}
+
+	// ヒープの生成
+	CD3DX12_HEAP_DESC heapDesc(
+	  size, heapProps, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT, heapFlags);
+	Heap heap;
+	HRESULT result = device_->CreateHeap(&heapDesc, IID_PPV_ARGS(&heap.heap));
+	if (FAILED(result)) {
+		return UINT32_MAX;
+	}
+
+	// テクスチャは小さい配置境界（4KB）単位、バッファは64KB単位で切り分ける
+	UINT64 granularity = IsTexturePool(pool) ? D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT
+	                                         : D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+	heap.allocator = std::make_unique<TlsfAllocator>(size, granularity);
+	heap.dedicated = dedicated;
+
+	// 解放済みの番号があれば使い回す
+	std::vector<Heap>& heaps = heaps_[static_cast<size_t>(pool)];
+	for (uint32_t i = 0; i < heaps.size(); i++) {
+		if (!heaps[i].heap) {
+			heaps[i] = std::move(heap);
+			return i;
+		}
+	}
+	heaps.push_back(std::move(heap));
+	return static_cast<uint32_t>(heaps.size() - 1);
+}
+
+void GpuMemoryAllocator::FreeAllocation(const Allocation& allocation) {
+	Heap& heap = heaps_[static_cast<size_t>(allocation.pool)][allocation.heapIndex];
+	heap.allocator->Free(allocation.block);
+
+	// 専用ヒープは空になったら解放
+	if (heap.dedicated && heap.allocator->IsEmpty()) {
+		heap.heap.Reset();
+		heap.allocator.reset();
+	}
+}
+
+void GpuMemoryAllocator::CollectGarbageLocked() {
+	UINT64 completedValue = DirectXCommon::GetInstance()->GetCompletedFenceValue();
+
+	while (!pendingFrees_.empty() && pendingFrees_.front().fenceValue <= completedValue) {
+		PendingFree& pending = pendingFrees_.front();
+		pending.resource.Reset();
+		FreeAllocation(pending.allocation);
+		pendingFrees_.pop_front();
+	}
+}
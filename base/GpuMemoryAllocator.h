@@ -0,0 +1,153 @@
+﻿#pragma once
+
+#include "TlsfAllocator.h"
+#include <array>
+#include <d3d12.h>
+#include <deque>
+#include <dxgi1_6.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <wrl.h>
+
+/// <summary>
+/// GPUメモリアロケータ
+/// 大きなヒープを確保し、TLSFで切り分けた位置に配置リソースを生成する。
+/// 解放はGPUの使用が終わるまで遅延する
+/// </summary>
+class GpuMemoryAllocator {
+  public: // 定数
+	// 1ヒープのサイズ
+	static const UINT64 kHeapSize = 64ull * 1024 * 1024;
+
+  public: // サブクラス
+	// ヒープの種類（リソースの種類とCPUアクセスで分ける）
+	enum class Pool {
+		kUploadBuffer,   // CPU書き込み可能なバッファ
+		kCpuTexture,     // CPU書き込み可能なテクスチャ（WriteToSubresource用）
+		kDefaultBuffer,  // GPU専用のバッファ
+		kDefaultTexture, // GPU専用のテクスチャ（レンダーターゲット以外）
+		kCount,
+	};
+
+	// 確保した領域
+	struct Allocation {
+		Pool pool = Pool::kCount;
+		uint32_t heapIndex = UINT32_MAX;
+		TlsfAllocator::Allocation block;
+
+		bool IsValid() const { return heapIndex != UINT32_MAX; }
+	};
+
+	// 統計
+	struct Stats {
+		UINT64 reservedSize = 0;      // 確保済みヒープの合計
+		UINT64 usedSize = 0;          // 配置済みリソースの合計
+		UINT64 pendingFreeSize = 0;   // GPUの完了待ちで解放を遅らせているサイズ
+		UINT64 largestFreeBlock = 0;  // 最大の連続空き領域
+		uint32_t heapCount = 0;       // ヒープ数
+		uint32_t allocationCount = 0; // 配置済みリソース数
+		UINT64 localBudget = 0;       // ビデオメモリの予算（OSが割り当てる目安）
+		UINT64 localUsage = 0;        // ビデオメモリのプロセス全体の使用量
+	};
+
+  public: // メンバ関数
+	/// <summary>
+	/// シングルトンインスタンスの取得
+	/// </summary>
+	/// <returns>シングルトンインスタンス</returns>
+	static GpuMemoryAllocator* GetInstance();
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="device">デバイス</param>
+	void Initialize(ID3D12Device* device);
+
+	/// <summary>
+	/// 配置リソースの生成
+	/// </summary>
+	/// <param name="pool">ヒープの種類</param>
+	/// <param name="resourceDesc">リソース設定</param>
+	/// <param name="initialState">初期状態</param>
+	/// <param name="clearValue">クリア値（不要ならnullptr）</param>
+	/// <param name="resource">生成したリソース</param>
+	/// <param name="allocation">確保した領域（Releaseに渡す）</param>
+	/// <returns>結果</returns>
+	HRESULT CreatePlacedResource(
+	  Pool pool, const D3D12_RESOURCE_DESC& resourceDesc, D3D12_RESOURCE_STATES initialState,
+	  const D3D12_CLEAR_VALUE* clearValue, Microsoft::WRL::ComPtr<ID3D12Resource>& resource,
+	  Allocation& allocation);
+
+	/// <summary>
+	/// 配置リソースの解放（GPUが使い終わってから領域を返す）
+	/// </summary>
+	/// <param name="resource">リソース（空になる）</param>
+	/// <param name="allocation">確保した領域（無効になる）</param>
+	void Release(Microsoft::WRL::ComPtr<ID3D12Resource>& resource, Allocation& allocation);
+
+	/// <summary>
+	/// GPUが使い終わった領域を返す（確保と解放の時にも呼ばれる）
+	/// </summary>
+	void CollectGarbage();
+
+	/// <summary>
+	/// 統計の取得
+	/// </summary>
+	/// <returns>統計</returns>
+	Stats GetStats();
+
+  private: // サブクラス
+	// ヒープ
+	struct Heap {
+		Microsoft::WRL::ComPtr<ID3D12Heap> heap;
+		std::unique_ptr<TlsfAllocator> allocator;
+		// 専用ヒープ（kHeapSizeを超えるリソース用、空になったら解放する）
+		bool dedicated = false;
+	};
+
+	// 解放待ち
+	struct PendingFree {
+		Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+		Allocation allocation;
+		UINT64 fenceValue = 0;
+	};
+
+  private: // メンバ関数
+	GpuMemoryAllocator() = default;
+	~GpuMemoryAllocator() = default;
+	GpuMemoryAllocator(const GpuMemoryAllocator&) = delete;
+	GpuMemoryAllocator& operator=(const GpuMemoryAllocator&) = delete;
+
+	/// <summary>
+	/// ヒープの生成
+	/// </summary>
+	/// <param name="pool">ヒープの種類</param>
+	/// <param name="size">サイズ</param>
+	/// <param name="dedicated">専用ヒープか</param>
+	/// <returns>ヒープ番号</returns>
+	uint32_t CreateHeap(Pool pool, UINT64 size, bool dedicated);
+
+	/// <summary>
+	/// 領域を返す（ロック済みで呼ぶ）
+	/// </summary>
+	/// <param name="allocation">確保した領域</param>
+	void FreeAllocation(const Allocation& allocation);
+
+	/// <summary>
+	/// GPUが使い終わった領域を返す（ロック済みで呼ぶ）
+	/// </summary>
+	void CollectGarbageLocked();
+
+  private: // メンバ変数
+	// デバイス
+	ID3D12Device* device_ = nullptr;
+	// アダプタ（メモリ予算の取得用）
+	Microsoft::WRL::ComPtr<IDXGIAdapter3> adapter_;
+	// 種類ごとのヒープ
+	std::array<std::vector<Heap>, static_cast<size_t>(Pool::kCount)> heaps_;
+	// 解放待ち（フェンス値の昇順）
+	std::deque<PendingFree> pendingFrees_;
+	// 排他
+	std::mutex mutex_;
+};
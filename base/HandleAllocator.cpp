@@ -0,0 +1,56 @@
+﻿#include "HandleAllocator.h"
+#include <cassert>
+
+HandleAllocator::HandleAllocator(uint32_t capacity) { Grow(capacity); }
+
+uint32_t HandleAllocator::Allocate() {
+	if (freeList_.empty()) {
+		return kInvalidHandle;
+	}
+
+	uint32_t handle = freeList_.back();
+	freeList_.pop_back();
+	allocated_[handle] = true;
+	allocatedCount_++;
+	return handle;
+}
+
+void HandleAllocator::Free(uint32_t handle) {
+	assert(IsAllocated(handle));
+
+	allocated_[handle] = false;
+	allocatedCount_--;
+	freeList_.push_back(handle);
+}
+
+void HandleAllocator::Grow(uint32_t capacity) {
+	uint32_t oldCapacity = GetCapacity();
+	if (capacity <= oldCapacity) {
+		return;
+	}
+
+	allocated_.resize(capacity, false);
+
+	// 追加分は若い番号から取り出されるよう逆順に積む
+	std::vector<uint32_t> added;
+	added.reserve(capacity - oldCapacity);
+	for (uint32_t i = capacity; i > oldCapacity; i--) {
+		added.push_back(i - 1);
+	}
+	freeList_.insert(freeList_.begin(), added.begin(), added.end());
+}
+
+void HandleAllocator::Reset() {
+	uint32_t capacity = GetCapacity();
+	allocated_.assign(capacity, false);
+	freeList_.clear();
+	freeList_.reserve(capacity);
+	for (uint32_t i = capacity; i > 0; i--) {
+		freeList_.push_back(i - 1);
+	}
+	allocatedCount_ = 0;
+}
+
+bool HandleAllocator::IsAllocated(uint32_t handle) const {
+	return handle < allocated_.size() && allocated_[handle];
+}
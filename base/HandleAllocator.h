@@ -0,0 +1,71 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// ハンドル（番号）の割り当て
+/// [0, 容量) の番号を空きリストで使い回す。番号を管理するだけなので、デバイスなしで動作する
+/// </summary>
+class HandleAllocator {
+  public: // 定数
+	// 無効なハンドル
+	static const uint32_t kInvalidHandle = UINT32_MAX;
+
+  public: // メンバ関数
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="capacity">容量</param>
+	explicit HandleAllocator(uint32_t capacity);
+
+	/// <summary>
+	/// 確保（解放済みの番号を優先して使い回す）
+	/// </summary>
+	/// <returns>ハンドル（空きがなければ無効）</returns>
+	uint32_t Allocate();
+
+	/// <summary>
+	/// 解放
+	/// </summary>
+	/// <param name="handle">ハンドル</param>
+	void Free(uint32_t handle);
+
+	/// <summary>
+	/// 容量を増やす（確保済みの番号はそのまま）
+	/// </summary>
+	/// <param name="capacity">新しい容量</param>
+	void Grow(uint32_t capacity);
+
+	/// <summary>
+	/// 全て解放
+	/// </summary>
+	void Reset();
+
+	/// <summary>
+	/// 確保済みか
+	/// </summary>
+	/// <param name="handle">ハンドル</param>
+	/// <returns>確保済みならtrue</returns>
+	bool IsAllocated(uint32_t handle) const;
+
+	/// <summary>
+	/// 容量の取得
+	/// </summary>
+	/// <returns>容量</returns>
+	uint32_t GetCapacity() const { return static_cast<uint32_t>(allocated_.size()); }
+
+	/// <summary>
+	/// 確保数の取得
+	/// </summary>
+	/// <returns>確保数</returns>
+	uint32_t GetAllocatedCount() const { return allocatedCount_; }
+
+  private: // メンバ変数
+	// 確保済みフラグ
+	std::vector<bool> allocated_;
+	// 空き番号（末尾から取り出す）
+	std::vector<uint32_t> freeList_;
+	// 確保数
+	uint32_t allocatedCount_ = 0;
+};
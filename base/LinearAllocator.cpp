@@ -0,0 +1,102 @@
+﻿#include "LinearAllocator.h"
+#include <cassert>
+
+LinearAllocator::LinearAllocator(IPageSource* pageSource, size_t pageSize)
+    : pageSource_(pageSource), pageSize_(pageSize) {
+	assert(pageSource_);
+	assert(pageSize_ > 0);
+}
+
+LinearAllocator::~LinearAllocator() {
+	Reset();
+	for (const Page& page : pages_) {
+		pageSource_->ReleasePage(page);
+	}
+	pages_.clear();
+}
+
+LinearAllocator::Allocation LinearAllocator::Allocate(size_t size, size_t alignment) {
+	// アライメントは2のべき乗
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	Allocation allocation;
+
+	// ページに収まらないサイズは専用ページ
+	if (size + alignment - 1 > pageSize_) {
+		Page page = pageSource_->CreatePage(size + alignment - 1);
+		assert(page.cpuAddress);
+		largePages_.push_back(page);
+
+		size_t offset = 0;
+		bool fitted = SubAllocate(page, offset, size, alignment, allocation);
+		assert(fitted);
+		(void)fitted;
+		usedSize_ += offset;
+		return allocation;
+	}
+
+	// 使用中のページから順に収まるページを探し、なければ追加する
+	while (true) {
+		if (currentPage_ == pages_.size()) {
+			Page page = pageSource_->CreatePage(pageSize_);
+			assert(page.cpuAddress);
+			pages_.push_back(page);
+		}
+
+		size_t prevOffset = offset_;
+		if (SubAllocate(pages_[currentPage_], offset_, size, alignment, allocation)) {
+			usedSize_ += offset_ - prevOffset;
+			return allocation;
+		}
+
+		// ページ末尾の残りは捨てて次のページへ
+		usedSize_ += pages_[currentPage_].size - offset_;
+		currentPage_++;
+		offset_ = 0;
+	}
+}
+
+void LinearAllocator::Reset() {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	for (const Page& page : largePages_) {
+		pageSource_->ReleasePage(page);
+	}
+	largePages_.clear();
+
+	currentPage_ = 0;
+	offset_ = 0;
+	usedSize_ = 0;
+}
+
+size_t LinearAllocator::GetPageCount() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return pages_.size();
+}
+
+size_t LinearAllocator::GetUsedSize() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return usedSize_;
+}
+
+bool LinearAllocator::SubAllocate(
+  const Page& page, size_t& offset, size_t size, size_t alignment, Allocation& allocation) {
+	// GPUアドレス基準で境界を揃える
+	uint64_t address = page.gpuAddress + offset;
+	uint64_t alignedAddress = (address + alignment - 1) & ~uint64_t(alignment - 1);
+	size_t alignedOffset = offset + static_cast<size_t>(alignedAddress - address);
+
+	if (alignedOffset + size > page.size) {
+		return false;
+	}
+
+	allocation.cpuAddress = page.cpuAddress + alignedOffset;
+	allocation.gpuAddress = alignedAddress;
+	allocation.size = size;
+	allocation.pageId = page.id;
+	allocation.pageOffset = alignedOffset;
+	offset = alignedOffset + size;
+	return true;
+}
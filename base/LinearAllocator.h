@@ -0,0 +1,127 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/// <summary>
+/// 線形（バンプ）アロケータ
+/// 永続マップされた大きなページから先頭順に切り出し、Resetで全て再利用可能にする。
+/// ページの生成はIPageSourceに任せるので、デバイスなしで動作する
+/// </summary>
+class LinearAllocator {
+  public: // 定数
+	// 既定のアライメント（定数バッファの配置境界）
+	static const size_t kDefaultAlignment = 256;
+
+  public: // サブクラス
+	// ページ
+	struct Page {
+		uint8_t* cpuAddress = nullptr; // 書き込み先
+		uint64_t gpuAddress = 0;       // GPUアドレス
+		size_t size = 0;               // サイズ
+		uint32_t id = 0;               // ページソースが識別に使う番号
+	};
+
+	// 確保した領域
+	struct Allocation {
+		void* cpuAddress = nullptr;
+		uint64_t gpuAddress = 0;
+		size_t size = 0;
+		uint32_t pageId = 0;   // 確保元ページの番号
+		size_t pageOffset = 0; // 確保元ページ内のオフセット
+	};
+
+	// ページの生成と解放
+	class IPageSource {
+	  public:
+		virtual ~IPageSource() = default;
+
+		/// <summary>
+		/// ページ生成
+		/// </summary>
+		/// <param name="size">サイズ</param>
+		/// <returns>ページ</returns>
+		virtual Page CreatePage(size_t size) = 0;
+
+		/// <summary>
+		/// ページ解放
+		/// </summary>
+		/// <param name="page">ページ</param>
+		virtual void ReleasePage(const Page& page) = 0;
+	};
+
+  public: // メンバ関数
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="pageSource">ページソース</param>
+	/// <param name="pageSize">1ページのサイズ</param>
+	LinearAllocator(IPageSource* pageSource, size_t pageSize);
+
+	/// <summary>
+	/// デストラクタ（全ページをページソースへ返す）
+	/// </summary>
+	~LinearAllocator();
+
+	/// <summary>
+	/// 領域の確保（スレッドセーフ）
+	/// ページに収まらないサイズは専用ページを作り、次のResetで解放する
+	/// </summary>
+	/// <param name="size">サイズ</param>
+	/// <param name="alignment">GPUアドレスのアライメント（2のべき乗）</param>
+	/// <returns>確保した領域</returns>
+	Allocation Allocate(size_t size, size_t alignment = kDefaultAlignment);
+
+	/// <summary>
+	/// 全領域を再利用可能にする（GPUが使い終わってから呼ぶこと）
+	/// </summary>
+	void Reset();
+
+	/// <summary>
+	/// 保持している通常ページ数の取得
+	/// </summary>
+	/// <returns>ページ数</returns>
+	size_t GetPageCount() const;
+
+	/// <summary>
+	/// 前回のReset以降に使用したサイズの取得（アライメントの詰め物を含む）
+	/// </summary>
+	/// <returns>使用サイズ</returns>
+	size_t GetUsedSize() const;
+
+  private: // メンバ関数
+	LinearAllocator(const LinearAllocator&) = delete;
+	LinearAllocator& operator=(const LinearAllocator&) = delete;
+
+	/// <summary>
+	/// ページ内の領域を切り出す
+	/// </summary>
+	/// <param name="page">ページ</param>
+	/// <param name="offset">使用済みオフセット（確保できたら進める）</param>
+	/// <param name="size">サイズ</param>
+	/// <param name="alignment">アライメント</param>
+	/// <param name="allocation">確保した領域</param>
+	/// <returns>収まったか</returns>
+	static bool SubAllocate(
+	  const Page& page, size_t& offset, size_t size, size_t alignment, Allocation& allocation);
+
+  private: // メンバ変数
+	// ページソース
+	IPageSource* pageSource_ = nullptr;
+	// 1ページのサイズ
+	size_t pageSize_ = 0;
+	// 通常ページ（Resetしても保持する）
+	std::vector<Page> pages_;
+	// 大きな確保用の専用ページ（Resetで解放する）
+	std::vector<Page> largePages_;
+	// 使用中のページ番号
+	size_t currentPage_ = 0;
+	// 使用中のページのオフセット
+	size_t offset_ = 0;
+	// 使用サイズ
+	size_t usedSize_ = 0;
+	// 確保の排他
+	mutable std::mutex mutex_;
+};
@@ -0,0 +1,104 @@
+﻿#pragma once
+
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 記録範囲 [begin, end)
+/// </summary>
+struct RecordRange {
+	uint32_t begin = 0;
+	uint32_t end = 0;
+};
+
+/// <summary>
+/// コマンド記録インターフェース
+/// </summary>
+/// <typeparam name="CommandList">コマンドリストの型</typeparam>
+template<class CommandList> class ICommandRecorder {
+  public:
+	virtual ~ICommandRecorder() = default;
+
+	/// <summary>
+	/// 記録する要素数の取得
+	/// </summary>
+	/// <returns>要素数</returns>
+	virtual uint32_t GetItemCount() const = 0;
+
+	/// <summary>
+	/// 記録前処理（メインスレッドで1回だけ呼ばれる）
+	/// </summary>
+	virtual void Prepare() {}
+
+	/// <summary>
+	/// コマンドリストごとの共通設定（パイプライン、ルートシグネチャなど）
+	/// </summary>
+	/// <param name="commandList">記録先コマンドリスト</param>
+	virtual void BeginRecord(CommandList* commandList) = 0;
+
+	/// <summary>
+	/// 範囲内の要素を記録
+	/// </summary>
+	/// <param name="commandList">記録先コマンドリスト</param>
+	/// <param name="range">記録範囲</param>
+	virtual void Record(CommandList* commandList, const RecordRange& range) = 0;
+};
+
+/// <summary>
+/// 並列コマンド記録のスケジューラ
+/// </summary>
+/// <typeparam name="CommandList">コマンドリストの型</typeparam>
+template<class CommandList> class ParallelCommandRecorder {
+  public:
+	/// <summary>
+	/// 要素を連続した範囲に分割する
+	/// </summary>
+	/// <param name="itemCount">要素数</param>
+	/// <param name="maxRanges">最大分割数</param>
+	/// <param name="minItemsPerRange">1範囲あたりの最小要素数</param>
+	/// <returns>先頭から順に並んだ範囲</returns>
+	static std::vector<RecordRange>
+	  SplitRanges(uint32_t itemCount, uint32_t maxRanges, uint32_t minItemsPerRange) {
+		std::vector<RecordRange> ranges;
+		if (itemCount == 0 || maxRanges == 0) {
+			return ranges;
+		}
+
+		minItemsPerRange = (std::max)(minItemsPerRange, 1u);
+		uint32_t rangeCount = (itemCount + minItemsPerRange - 1) / minItemsPerRange;
+		rangeCount = (std::min)(rangeCount, maxRanges);
+
+		// 端数は先頭の範囲から1つずつ配る
+		uint32_t base = itemCount / rangeCount;
+		uint32_t remainder = itemCount % rangeCount;
+		uint32_t begin = 0;
+		ranges.resize(rangeCount);
+		for (uint32_t i = 0; i < rangeCount; i++) {
+			uint32_t size = base + (i < remainder ? 1 : 0);
+			ranges[i].begin = begin;
+			ranges[i].end = begin + size;
+			begin += size;
+		}
+		return ranges;
+	}
+
+	/// <summary>
+	/// 各範囲を対応するコマンドリストへ並列に記録する
+	/// </summary>
+	/// <param name="pool">スレッドプール</param>
+	/// <param name="recorder">記録処理</param>
+	/// <param name="ranges">記録範囲</param>
+	/// <param name="commandLists">範囲と同じ数の記録先（提出順）</param>
+	static void Record(
+	  ThreadPool* pool, ICommandRecorder<CommandList>* recorder,
+	  const std::vector<RecordRange>& ranges, CommandList* const* commandLists) {
+		recorder->Prepare();
+
+		pool->ParallelFor(static_cast<uint32_t>(ranges.size()), [&](uint32_t index) {
+			recorder->BeginRecord(commandLists[index]);
+			recorder->Record(commandLists[index], ranges[index]);
+		});
+	}
+};
@@ -0,0 +1,59 @@
+﻿#include "RadixSort.h"
+#include <cstring>
+
+void RadixSort::Sort(const uint64_t* keys, uint32_t count) {
+	for (uint32_t i = 0; i < 2; i++) {
+		keys_[i].resize(count);
+		indices_[i].resize(count);
+	}
+	current_ = 0;
+	passCount_ = 0;
+	if (count == 0) {
+		return;
+	}
+
+	memcpy(keys_[0].data(), keys, sizeof(uint64_t) * count);
+	for (uint32_t i = 0; i < count; i++) {
+		indices_[0][i] = i;
+	}
+
+	// 全バイトの出現数を1回で数える
+	uint32_t histograms[8][256] = {};
+	for (uint32_t i = 0; i < count; i++) {
+		uint64_t key = keys[i];
+		for (uint32_t byte = 0; byte < 8; byte++) {
+			histograms[byte][(key >> (byte * 8)) & 0xff]++;
+		}
+	}
+
+	for (uint32_t byte = 0; byte < 8; byte++) {
+		uint32_t* histogram = histograms[byte];
+		uint32_t shift = byte * 8;
+
+		// 全要素で同じ値なら順番は変わらない
+		if (histogram[(keys[0] >> shift) & 0xff] == count) {
+			continue;
+		}
+
+		// 出現数を書き込み先の先頭位置に変える
+		uint32_t offset = 0;
+		for (uint32_t bucket = 0; bucket < 256; bucket++) {
+			uint32_t bucketCount = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += bucketCount;
+		}
+
+		// 前から順に分配する（同じ値の順は保たれる）
+		const uint64_t* srcKeys = keys_[current_].data();
+		const uint32_t* srcIndices = indices_[current_].data();
+		uint64_t* dstKeys = keys_[current_ ^ 1].data();
+		uint32_t* dstIndices = indices_[current_ ^ 1].data();
+		for (uint32_t i = 0; i < count; i++) {
+			uint32_t position = histogram[(srcKeys[i] >> shift) & 0xff]++;
+			dstKeys[position] = srcKeys[i];
+			dstIndices[position] = srcIndices[i];
+		}
+		current_ ^= 1;
+		passCount_++;
+	}
+}
@@ -0,0 +1,40 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 64bitキーの安定な基数ソート
+/// 下位バイトから8bitずつ分配し、全要素で同じ値のバイトは飛ばす。
+/// 作業領域は保持して使い回す
+/// </summary>
+class RadixSort {
+  public: // メンバ関数
+	/// <summary>
+	/// 並べ替え（同じキーは元の順を保つ）
+	/// </summary>
+	/// <param name="keys">キー</param>
+	/// <param name="count">要素数</param>
+	void Sort(const uint64_t* keys, uint32_t count);
+
+	/// <summary>
+	/// 直前のSortの結果の取得
+	/// </summary>
+	/// <returns>キーの昇順に並べた元の添え字（要素数はSortに渡したもの）</returns>
+	const uint32_t* GetOrder() const { return indices_[current_].data(); }
+
+	/// <summary>
+	/// 直前のSortで分配した回数の取得
+	/// </summary>
+	/// <returns>回数（0なら全てのキーが同じで、元の順のまま）</returns>
+	uint32_t GetPassCount() const { return passCount_; }
+
+  private: // メンバ変数
+	// キーと添え字（分配元と分配先を交互に使う）
+	std::vector<uint64_t> keys_[2];
+	std::vector<uint32_t> indices_[2];
+	// 結果の入っている側
+	uint32_t current_ = 0;
+	// 直前のSortで分配した回数
+	uint32_t passCount_ = 0;
+};
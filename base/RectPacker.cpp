@@ -0,0 +1,160 @@
+﻿#include "RectPacker.h"
+#include <algorithm>
+#include <numeric>
+
+bool RectPacker::PackAll(
+  uint32_t width, uint32_t height, const std::vector<Size>& sizes, std::vector<Rect>& rects) {
+	// 高さ、幅の大きい順（同じなら元の順）に並べる
+	std::vector<size_t> order(sizes.size());
+	std::iota(order.begin(), order.end(), size_t(0));
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+		if (sizes[a].height != sizes[b].height) {
+			return sizes[a].height > sizes[b].height;
+		}
+		return sizes[a].width > sizes[b].width;
+	});
+
+	RectPacker packer(width, height);
+	rects.assign(sizes.size(), Rect());
+	for (size_t i : order) {
+		if (!packer.Insert(sizes[i].width, sizes[i].height, rects[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool RectPacker::PackMinimum(
+  uint32_t maxSize, const std::vector<Size>& sizes, std::vector<Rect>& rects, Size& packedSize) {
+	// 面積と最大の辺から始める
+	uint64_t area = 0;
+	uint32_t maxWidth = 1;
+	uint32_t maxHeight = 1;
+	for (const Size& size : sizes) {
+		area += uint64_t(size.width) * size.height;
+		maxWidth = (std::max)(maxWidth, size.width);
+		maxHeight = (std::max)(maxHeight, size.height);
+	}
+
+	Size candidate = {1, 1};
+	while (candidate.width < maxWidth) {
+		candidate.width *= 2;
+	}
+	while (candidate.height < maxHeight) {
+		candidate.height *= 2;
+	}
+
+	// 入らなければ短い方の辺を倍にしていく
+	while (candidate.width <= maxSize && candidate.height <= maxSize) {
+		if (uint64_t(candidate.width) * candidate.height >= area &&
+		    PackAll(candidate.width, candidate.height, sizes, rects)) {
+			packedSize = candidate;
+			return true;
+		}
+		if (candidate.width <= candidate.height) {
+			candidate.width *= 2;
+		} else {
+			candidate.height *= 2;
+		}
+	}
+	return false;
+}
+
+RectPacker::RectPacker(uint32_t width, uint32_t height) : width_(width), height_(height) {
+	Reset();
+}
+
+bool RectPacker::Insert(uint32_t width, uint32_t height, Rect& rect) {
+	if (width == 0 || height == 0) {
+		rect = {0, 0, width, height};
+		return true;
+	}
+
+	// 上端が最も低くなる位置（同じなら幅の狭い区間）を探す
+	size_t bestIndex = skyline_.size();
+	uint32_t bestY = UINT32_MAX;
+	uint32_t bestWidth = UINT32_MAX;
+	for (size_t i = 0; i < skyline_.size(); i++) {
+		uint32_t y = 0;
+		if (!Fit(i, width, height, y)) {
+			continue;
+		}
+		if (y < bestY || (y == bestY && skyline_[i].width < bestWidth)) {
+			bestIndex = i;
+			bestY = y;
+			bestWidth = skyline_[i].width;
+		}
+	}
+	if (bestIndex == skyline_.size()) {
+		return false;
+	}
+
+	rect = {skyline_[bestIndex].x, bestY, width, height};
+
+	// 置いた矩形の上端を新しい区間として挿入
+	Segment segment = {rect.x, rect.y + height, width};
+	skyline_.insert(skyline_.begin() + bestIndex, segment);
+
+	// 覆われた区間を削る
+	for (size_t i = bestIndex + 1; i < skyline_.size();) {
+		const Segment& prev = skyline_[i - 1];
+		uint32_t prevRight = prev.x + prev.width;
+		if (skyline_[i].x >= prevRight) {
+			break;
+		}
+		uint32_t shrink = prevRight - skyline_[i].x;
+		if (skyline_[i].width <= shrink) {
+			skyline_.erase(skyline_.begin() + i);
+			continue;
+		}
+		skyline_[i].x += shrink;
+		skyline_[i].width -= shrink;
+		break;
+	}
+
+	// 同じ高さの隣り合う区間を結合
+	for (size_t i = 0; i + 1 < skyline_.size();) {
+		if (skyline_[i].y == skyline_[i + 1].y) {
+			skyline_[i].width += skyline_[i + 1].width;
+			skyline_.erase(skyline_.begin() + i + 1);
+		} else {
+			i++;
+		}
+	}
+
+	usedArea_ += uint64_t(width) * height;
+	return true;
+}
+
+void RectPacker::Reset() {
+	skyline_.clear();
+	skyline_.push_back({0, 0, width_});
+	usedArea_ = 0;
+}
+
+float RectPacker::GetOccupancy() const {
+	uint64_t area = uint64_t(width_) * height_;
+	return area > 0 ? static_cast<float>(double(usedArea_) / double(area)) : 0.0f;
+}
+
+bool RectPacker::Fit(size_t index, uint32_t width, uint32_t height, uint32_t& y) const {
+	uint32_t x = skyline_[index].x;
+	if (x + width > width_) {
+		return false;
+	}
+
+	// 幅が掛かる区間の最も高い位置に置く
+	uint32_t remaining = width;
+	y = skyline_[index].y;
+	for (size_t i = index; remaining > 0; i++) {
+		if (i >= skyline_.size()) {
+			return false;
+		}
+		y = (std::max)(y, skyline_[i].y);
+		if (y + height > height_) {
+			return false;
+		}
+		remaining -= (std::min)(remaining, skyline_[i].width);
+	}
+	return true;
+}
@@ -0,0 +1,102 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 矩形の詰め込み（スカイライン法、左下優先）
+/// 同じ入力なら常に同じ配置になる。座標だけを扱うので、デバイスなしで動作する
+/// </summary>
+class RectPacker {
+  public: // サブクラス
+	// 大きさ
+	struct Size {
+		uint32_t width = 0;
+		uint32_t height = 0;
+	};
+
+	// 配置した矩形
+	struct Rect {
+		uint32_t x = 0;
+		uint32_t y = 0;
+		uint32_t width = 0;
+		uint32_t height = 0;
+	};
+
+  public: // 静的メンバ関数
+	/// <summary>
+	/// まとめて詰め込む（高さ、幅の大きい順に置くと無駄が少ない）
+	/// </summary>
+	/// <param name="width">領域の幅</param>
+	/// <param name="height">領域の高さ</param>
+	/// <param name="sizes">矩形の大きさ</param>
+	/// <param name="rects">配置した矩形（sizesと同じ順）</param>
+	/// <returns>全て収まればtrue</returns>
+	static bool PackAll(
+	  uint32_t width, uint32_t height, const std::vector<Size>& sizes, std::vector<Rect>& rects);
+
+	/// <summary>
+	/// 全て収まる最小の2のべき乗の正方形（か横長）を探して詰め込む
+	/// </summary>
+	/// <param name="maxSize">辺の最大</param>
+	/// <param name="sizes">矩形の大きさ</param>
+	/// <param name="rects">配置した矩形（sizesと同じ順）</param>
+	/// <param name="packedSize">領域の大きさ</param>
+	/// <returns>maxSize以内に収まればtrue</returns>
+	static bool PackMinimum(
+	  uint32_t maxSize, const std::vector<Size>& sizes, std::vector<Rect>& rects,
+	  Size& packedSize);
+
+  public: // メンバ関数
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="width">領域の幅</param>
+	/// <param name="height">領域の高さ</param>
+	RectPacker(uint32_t width, uint32_t height);
+
+	/// <summary>
+	/// 1つ配置する
+	/// </summary>
+	/// <param name="width">幅</param>
+	/// <param name="height">高さ</param>
+	/// <param name="rect">配置した矩形</param>
+	/// <returns>収まればtrue</returns>
+	bool Insert(uint32_t width, uint32_t height, Rect& rect);
+
+	/// <summary>
+	/// 全て空にする
+	/// </summary>
+	void Reset();
+
+	/// <summary>
+	/// 使用率の取得
+	/// </summary>
+	/// <returns>配置した面積 / 領域の面積</returns>
+	float GetOccupancy() const;
+
+  private: // サブクラス
+	// スカイラインの区間（xから幅widthの範囲の高さがy）
+	struct Segment {
+		uint32_t x;
+		uint32_t y;
+		uint32_t width;
+	};
+
+  private: // メンバ関数
+	/// <summary>
+	/// 区間indexから幅widthを置いたときの高さを求める
+	/// </summary>
+	/// <returns>収まらなければfalse</returns>
+	bool Fit(size_t index, uint32_t width, uint32_t height, uint32_t& y) const;
+
+  private: // メンバ変数
+	// 領域の大きさ
+	uint32_t width_ = 0;
+	uint32_t height_ = 0;
+	// スカイライン（x順）
+	std::vector<Segment> skyline_;
+	// 配置した面積
+	uint64_t usedArea_ = 0;
+};
@@ -0,0 +1,227 @@
+﻿#include "ResourceUploader.h"
+#include <cassert>
+#include <cstring>
+#include <d3dx12.h>
+#include <vector>
+
+using namespace Microsoft::WRL;
+
+ResourceUploader* ResourceUploader::GetInstance() {
+	static ResourceUploader instance;
+	return &instance;
+}
+
+ResourceUploader::~ResourceUploader() {
+	if (fenceEvent_) {
+		CloseHandle(fenceEvent_);
+	}
+}
+
+void ResourceUploader::Initialize(ID3D12Device* device, ID3D12CommandQueue* directQueue) {
+	assert(device);
+	assert(directQueue);
+
+	device_ = device;
+	directQueue_ = directQueue;
+
+	HRESULT result = S_FALSE;
+
+	// コピー専用のコマンドキューを生成
+	D3D12_COMMAND_QUEUE_DESC queueDesc{};
+	queueDesc.Type = D3D12_COMMAND_LIST_TYPE_COPY;
+	result = device_->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&copyQueue_));
+	assert(SUCCEEDED(result));
+
+	// フェンスの生成
+	result = device_->CreateFence(fenceValue_, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence_));
+	assert(SUCCEEDED(result));
+	fenceEvent_ = CreateEvent(nullptr, false, false, nullptr);
+	assert(fenceEvent_);
+
+	// バッチごとのコマンドリストとステージング領域
+	pageSource_ = std::make_unique<UploadPageSource>(device_);
+	for (Batch& batch : batches_) {
+		result = device_->CreateCommandAllocator(
+		  D3D12_COMMAND_LIST_TYPE_COPY, IID_PPV_ARGS(&batch.allocator));
+		assert(SUCCEEDED(result));
+
+		result = device_->CreateCommandList(
+		  0, D3D12_COMMAND_LIST_TYPE_COPY, batch.allocator.Get(), nullptr,
+		  IID_PPV_ARGS(&batch.list));
+		assert(SUCCEEDED(result));
+		batch.list->Close();
+
+		batch.staging = std::make_unique<LinearAllocator>(pageSource_.get(), kStagingPageSize);
+	}
+}
+
+HRESULT ResourceUploader::UploadBuffer(
+  const void* data, size_t size, ComPtr<ID3D12Resource>& resource,
+  GpuMemoryAllocator::Allocation& allocation) {
+	assert(device_);
+
+	// DEFAULTヒープにバッファを生成（COMMONから暗黙の状態遷移で使う）
+	CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(size);
+	HRESULT result = GpuMemoryAllocator::GetInstance()->CreatePlacedResource(
+	  GpuMemoryAllocator::Pool::kDefaultBuffer, resourceDesc, D3D12_RESOURCE_STATE_COMMON, nullptr,
+	  resource, allocation);
+	if (FAILED(result)) {
+		return result;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	ID3D12GraphicsCommandList* commandList = BeginRecord();
+
+	// ステージングにコピーしてから転送コマンドを積む
+	LinearAllocator::Allocation staging = batches_[batchIndex_].staging->Allocate(size);
+	memcpy(staging.cpuAddress, data, size);
+	commandList->CopyBufferRegion(
+	  resource.Get(), 0, pageSource_->GetResource(staging.pageId), staging.pageOffset, size);
+
+	return S_OK;
+}
+
+HRESULT ResourceUploader::UploadTexture(
+  const D3D12_RESOURCE_DESC& resourceDesc, const D3D12_SUBRESOURCE_DATA* subresources,
+  UINT subresourceCount, ComPtr<ID3D12Resource>& resource,
+  GpuMemoryAllocator::Allocation& allocation) {
+	assert(device_);
+
+	// DEFAULTヒープにテクスチャを生成
+	HRESULT result = GpuMemoryAllocator::GetInstance()->CreatePlacedResource(
+	  GpuMemoryAllocator::Pool::kDefaultTexture, resourceDesc, D3D12_RESOURCE_STATE_COMMON,
+	  nullptr, resource, allocation);
+	if (FAILED(result)) {
+		return result;
+	}
+
+	// サブリソースごとのコピー配置を求める
+	std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> layouts(subresourceCount);
+	std::vector<UINT> rowCounts(subresourceCount);
+	std::vector<UINT64> rowSizes(subresourceCount);
+	UINT64 totalSize = 0;
+	device_->GetCopyableFootprints(
+	  &resourceDesc, 0, subresourceCount, 0, layouts.data(), rowCounts.data(), rowSizes.data(),
+	  &totalSize);
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	ID3D12GraphicsCommandList* commandList = BeginRecord();
+
+	LinearAllocator::Allocation staging = batches_[batchIndex_].staging->Allocate(
+	  static_cast<size_t>(totalSize), D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+	ID3D12Resource* stagingResource = pageSource_->GetResource(staging.pageId);
+
+	for (UINT i = 0; i < subresourceCount; i++) {
+		// 行ピッチを合わせながらステージングにコピー
+		const D3D12_SUBRESOURCE_FOOTPRINT& footprint = layouts[i].Footprint;
+		uint8_t* dst = static_cast<uint8_t*>(staging.cpuAddress) + layouts[i].Offset;
+		const uint8_t* src = static_cast<const uint8_t*>(subresources[i].pData);
+		for (UINT z = 0; z < footprint.Depth; z++) {
+			for (UINT y = 0; y < rowCounts[i]; y++) {
+				memcpy(
+				  dst + footprint.RowPitch * (rowCounts[i] * z + y),
+				  src + subresources[i].SlicePitch * z + subresources[i].RowPitch * y,
+				  static_cast<size_t>(rowSizes[i]));
+			}
+		}
+
+		// 転送コマンド
+		D3D12_PLACED_SUBRESOURCE_FOOTPRINT srcLayout = layouts[i];
+		srcLayout.Offset += staging.pageOffset;
+		CD3DX12_TEXTURE_COPY_LOCATION dstLocation(resource.Get(), i);
+		CD3DX12_TEXTURE_COPY_LOCATION srcLocation(stagingResource, srcLayout);
+		commandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+	}
+
+	return S_OK;
+}
+
+HRESULT ResourceUploader::CopyTextureMips(
+  const D3D12_RESOURCE_DESC& resourceDesc, ID3D12Resource* source, UINT firstSourceMip,
+  ComPtr<ID3D12Resource>& resource, GpuMemoryAllocator::Allocation& allocation) {
+	assert(device_);
+	assert(source);
+	D3D12_RESOURCE_DESC sourceDesc = source->GetDesc();
+	assert(firstSourceMip + resourceDesc.MipLevels <= sourceDesc.MipLevels);
+	assert(resourceDesc.DepthOrArraySize == sourceDesc.DepthOrArraySize);
+
+	// DEFAULTヒープにテクスチャを生成
+	HRESULT result = GpuMemoryAllocator::GetInstance()->CreatePlacedResource(
+	  GpuMemoryAllocator::Pool::kDefaultTexture, resourceDesc, D3D12_RESOURCE_STATE_COMMON,
+	  nullptr, resource, allocation);
+	if (FAILED(result)) {
+		return result;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	ID3D12GraphicsCommandList* commandList = BeginRecord();
+
+	// ミップごとにGPU上でコピー（コピー元は共通状態からコピー元として暗黙に昇格する）
+	UINT arraySize = resourceDesc.DepthOrArraySize;
+	for (UINT slice = 0; slice < arraySize; slice++) {
+		for (UINT mip = 0; mip < resourceDesc.MipLevels; mip++) {
+			UINT dstIndex = D3D12CalcSubresource(mip, slice, 0, resourceDesc.MipLevels, arraySize);
+			UINT srcIndex =
+			  D3D12CalcSubresource(firstSourceMip + mip, slice, 0, sourceDesc.MipLevels, arraySize);
+			CD3DX12_TEXTURE_COPY_LOCATION dstLocation(resource.Get(), dstIndex);
+			CD3DX12_TEXTURE_COPY_LOCATION srcLocation(source, srcIndex);
+			commandList->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+		}
+	}
+
+	return S_OK;
+}
+
+UINT64 ResourceUploader::Flush() {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	if (!recording_) {
+		return fenceValue_;
+	}
+
+	// コピーキューに提出
+	Batch& batch = batches_[batchIndex_];
+	batch.list->Close();
+	ID3D12CommandList* commandLists[] = {batch.list.Get()};
+	copyQueue_->ExecuteCommandLists(_countof(commandLists), commandLists);
+	copyQueue_->Signal(fence_.Get(), ++fenceValue_);
+	batch.fenceValue = fenceValue_;
+	recording_ = false;
+
+	// 以降に描画キューへ提出するコマンドはコピー完了後に実行させる（CPUは待たない）
+	directQueue_->Wait(fence_.Get(), fenceValue_);
+
+	// 次のバッチへ
+	batchIndex_ = (batchIndex_ + 1) % kBatchCount;
+	return fenceValue_;
+}
+
+bool ResourceUploader::IsComplete(UINT64 fenceValue) const {
+	return fence_->GetCompletedValue() >= fenceValue;
+}
+
+void ResourceUploader::WaitForFenceValue(UINT64 fenceValue) {
+	if (fence_->GetCompletedValue() < fenceValue) {
+		fence_->SetEventOnCompletion(fenceValue, fenceEvent_);
+		WaitForSingleObject(fenceEvent_, INFINITE);
+	}
+}
+
+ID3D12GraphicsCommandList* ResourceUploader::BeginRecord() {
+	Batch& batch = batches_[batchIndex_];
+	if (recording_) {
+		return batch.list.Get();
+	}
+
+	// このバッチの前回の転送が終わってから使い回す
+	WaitForFenceValue(batch.fenceValue);
+	batch.staging->Reset();
+
+	HRESULT result = batch.allocator->Reset();
+	assert(SUCCEEDED(result));
+	result = batch.list->Reset(batch.allocator.Get(), nullptr);
+	assert(SUCCEEDED(result));
+
+	recording_ = true;
+	return batch.list.Get();
+}
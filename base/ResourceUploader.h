@@ -0,0 +1,143 @@
+﻿#pragma once
+
+#include "GpuMemoryAllocator.h"
+#include "LinearAllocator.h"
+#include "UploadPageSource.h"
+#include <array>
+#include <d3d12.h>
+#include <memory>
+#include <mutex>
+#include <wrl.h>
+
+/// <summary>
+/// リソースアップローダ
+/// 静的なバッファとテクスチャをDEFAULTヒープに生成し、コピーキューで転送する。
+/// 転送はまとめて提出し、描画キューはコピー完了のフェンスをGPU上で待つ
+/// </summary>
+class ResourceUploader {
+  public: // 定数
+	// 同時に転送中にできるバッチ数
+	static const uint32_t kBatchCount = 2;
+	// ステージング用ページのサイズ
+	static const size_t kStagingPageSize = 4 * 1024 * 1024;
+
+  public: // メンバ関数
+	/// <summary>
+	/// シングルトンインスタンスの取得
+	/// </summary>
+	/// <returns>シングルトンインスタンス</returns>
+	static ResourceUploader* GetInstance();
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="device">デバイス</param>
+	/// <param name="directQueue">転送完了を待たせる描画キュー</param>
+	void Initialize(ID3D12Device* device, ID3D12CommandQueue* directQueue);
+
+	/// <summary>
+	/// バッファの生成と転送の予約（スレッドセーフ）
+	/// </summary>
+	/// <param name="data">データ</param>
+	/// <param name="size">サイズ</param>
+	/// <param name="resource">生成したバッファ</param>
+	/// <param name="allocation">確保した領域</param>
+	/// <returns>結果</returns>
+	HRESULT UploadBuffer(
+	  const void* data, size_t size, Microsoft::WRL::ComPtr<ID3D12Resource>& resource,
+	  GpuMemoryAllocator::Allocation& allocation);
+
+	/// <summary>
+	/// テクスチャの生成と転送の予約（スレッドセーフ）
+	/// </summary>
+	/// <param name="resourceDesc">リソース設定</param>
+	/// <param name="subresources">サブリソースごとのデータ</param>
+	/// <param name="subresourceCount">サブリソース数</param>
+	/// <param name="resource">生成したテクスチャ</param>
+	/// <param name="allocation">確保した領域</param>
+	/// <returns>結果</returns>
+	HRESULT UploadTexture(
+	  const D3D12_RESOURCE_DESC& resourceDesc, const D3D12_SUBRESOURCE_DATA* subresources,
+	  UINT subresourceCount, Microsoft::WRL::ComPtr<ID3D12Resource>& resource,
+	  GpuMemoryAllocator::Allocation& allocation);
+
+	/// <summary>
+	/// テクスチャを生成し、既存のテクスチャの粗いミップをGPU上でコピーする予約（スレッドセーフ）
+	/// コピー元は完了まで破棄しない（GpuMemoryAllocator::Releaseなら記録済みの描画の完了まで待つ）
+	/// </summary>
+	/// <param name="resourceDesc">リソース設定（コピー元の指定のミップから先と同じ大きさ）</param>
+	/// <param name="source">コピー元のテクスチャ</param>
+	/// <param name="firstSourceMip">生成するテクスチャの先頭にするコピー元のミップ</param>
+	/// <param name="resource">生成したテクスチャ</param>
+	/// <param name="allocation">確保した領域</param>
+	/// <returns>結果</returns>
+	HRESULT CopyTextureMips(
+	  const D3D12_RESOURCE_DESC& resourceDesc, ID3D12Resource* source, UINT firstSourceMip,
+	  Microsoft::WRL::ComPtr<ID3D12Resource>& resource,
+	  GpuMemoryAllocator::Allocation& allocation);
+
+	/// <summary>
+	/// 予約した転送をコピーキューに提出し、描画キューに完了を待たせる
+	/// </summary>
+	/// <returns>完了時のフェンス値（提出するものがなければ最後に提出したフェンス値）</returns>
+	UINT64 Flush();
+
+	/// <summary>
+	/// 転送が完了したか
+	/// </summary>
+	/// <param name="fenceValue">Flushが返したフェンス値</param>
+	/// <returns>完了していればtrue</returns>
+	bool IsComplete(UINT64 fenceValue) const;
+
+	/// <summary>
+	/// 転送の完了をCPUで待つ
+	/// </summary>
+	/// <param name="fenceValue">Flushが返したフェンス値</param>
+	void WaitForFenceValue(UINT64 fenceValue);
+
+  private: // サブクラス
+	// 転送のまとまり
+	struct Batch {
+		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> allocator;
+		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> list;
+		// 転送元データ
+		std::unique_ptr<LinearAllocator> staging;
+		// 完了時のフェンス値
+		UINT64 fenceValue = 0;
+	};
+
+  private: // メンバ関数
+	ResourceUploader() = default;
+	~ResourceUploader();
+	ResourceUploader(const ResourceUploader&) = delete;
+	ResourceUploader& operator=(const ResourceUploader&) = delete;
+
+	/// <summary>
+	/// 記録中のバッチのコマンドリストを取得（ロック済みで呼ぶ）
+	/// </summary>
+	/// <returns>記録開始済みのコマンドリスト</returns>
+	ID3D12GraphicsCommandList* BeginRecord();
+
+  private: // メンバ変数
+	// デバイス
+	ID3D12Device* device_ = nullptr;
+	// 転送完了を待たせる描画キュー
+	ID3D12CommandQueue* directQueue_ = nullptr;
+	// コピーキュー
+	Microsoft::WRL::ComPtr<ID3D12CommandQueue> copyQueue_;
+	// コピー完了のフェンス
+	Microsoft::WRL::ComPtr<ID3D12Fence> fence_;
+	UINT64 fenceValue_ = 0;
+	// フェンス待ち用イベント
+	HANDLE fenceEvent_ = nullptr;
+	// ステージング用ページの生成元（バッチより先に破棄しない）
+	std::unique_ptr<UploadPageSource> pageSource_;
+	// バッチ
+	std::array<Batch, kBatchCount> batches_;
+	// 記録中のバッチ番号
+	uint32_t batchIndex_ = 0;
+	// 記録中か
+	bool recording_ = false;
+	// 排他
+	std::mutex mutex_;
+};
@@ -0,0 +1,189 @@
+﻿#include "TextureBaker.h"
+#include <Windows.h>
+#include <cassert>
+
+using namespace DirectX;
+
+/// <summary>
+/// 静的メンバ変数の実体
+/// </summary>
+const float TextureBaker::kMaxMeanSquaredError = 0.005f;
+
+namespace {
+
+// 最終更新時刻の取得
+bool GetLastWriteTime(const std::wstring& path, ULARGE_INTEGER& time) {
+	WIN32_FILE_ATTRIBUTE_DATA data{};
+	if (!GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &data)) {
+		return false;
+	}
+	time.LowPart = data.ftLastWriteTime.dwLowDateTime;
+	time.HighPart = data.ftLastWriteTime.dwHighDateTime;
+	return true;
+}
+
+// ベイク対象の拡張子か
+bool IsSourceImage(const std::wstring& fileName) {
+	size_t dot = fileName.find_last_of(L'.');
+	if (dot == std::wstring::npos) {
+		return false;
+	}
+	std::wstring ext = fileName.substr(dot);
+	return _wcsicmp(ext.c_str(), L".png") == 0 || _wcsicmp(ext.c_str(), L".jpg") == 0 ||
+	       _wcsicmp(ext.c_str(), L".jpeg") == 0;
+}
+
+} // namespace
+
+HRESULT TextureBaker::Bake(const std::wstring& srcPath, const std::wstring& dstPath, Format format) {
+	HRESULT result = S_FALSE;
+
+	// WICテクスチャのロード
+	TexMetadata metadata{};
+	ScratchImage scratchImg{};
+	result = LoadFromWICFile(srcPath.c_str(), WIC_FLAGS_NONE, &metadata, scratchImg);
+	if (FAILED(result)) {
+		return result;
+	}
+
+	// ミップマップ生成（実行時と同じフィルタ）
+	ScratchImage mipChain{};
+	result = GenerateMipMaps(
+	  scratchImg.GetImages(), scratchImg.GetImageCount(), scratchImg.GetMetadata(),
+	  TEX_FILTER_DEFAULT, 0, mipChain);
+	if (SUCCEEDED(result)) {
+		scratchImg = std::move(mipChain);
+	}
+	metadata = scratchImg.GetMetadata();
+
+	// ディフューズテクスチャとしてSRGBで保存
+	bool compressible = (metadata.width % 4 == 0) && (metadata.height % 4 == 0);
+	if (!compressible) {
+		scratchImg.OverrideFormat(MakeSRGB(metadata.format));
+		return SaveToDDSFile(
+		  scratchImg.GetImages(), scratchImg.GetImageCount(), scratchImg.GetMetadata(),
+		  DDS_FLAGS_NONE, dstPath.c_str());
+	}
+
+	// ブロック圧縮と往復の誤差の確認
+	ScratchImage compressed{};
+	float mse = 0.0f;
+	result = Compress(scratchImg, format, compressed, mse);
+	if (FAILED(result)) {
+		return result;
+	}
+	if (mse > kMaxMeanSquaredError) {
+		std::string message = "TextureBaker: compression error too large (" +
+		                      std::to_string(mse) + ")\n";
+		OutputDebugStringA(message.c_str());
+		return E_FAIL;
+	}
+
+	// DDSで保存
+	return SaveToDDSFile(
+	  compressed.GetImages(), compressed.GetImageCount(), compressed.GetMetadata(),
+	  DDS_FLAGS_NONE, dstPath.c_str());
+}
+
+HRESULT TextureBaker::Compress(
+  const ScratchImage& source, Format format, ScratchImage& compressed, float& mse) {
+	// 形式の決定
+	if (format == Format::kAuto) {
+		format = source.IsAlphaAllOpaque() ? Format::kBC1 : Format::kBC7;
+	}
+	DXGI_FORMAT compressedFormat = DXGI_FORMAT_BC7_UNORM_SRGB;
+	switch (format) {
+	case Format::kBC1:
+		compressedFormat = DXGI_FORMAT_BC1_UNORM_SRGB;
+		break;
+	case Format::kBC3:
+		compressedFormat = DXGI_FORMAT_BC3_UNORM_SRGB;
+		break;
+	case Format::kBC7:
+	default:
+		compressedFormat = DXGI_FORMAT_BC7_UNORM_SRGB;
+		break;
+	}
+
+	// ブロック圧縮（元の画素はSRGBとして扱う）
+	HRESULT result = DirectX::Compress(
+	  source.GetImages(), source.GetImageCount(), source.GetMetadata(), compressedFormat,
+	  TEX_COMPRESS_PARALLEL | TEX_COMPRESS_SRGB_IN | TEX_COMPRESS_BC7_QUICK,
+	  TEX_THRESHOLD_DEFAULT, compressed);
+	if (FAILED(result)) {
+		return result;
+	}
+
+	// 往復の誤差
+	return MeasureError(source, compressed, mse);
+}
+
+uint32_t TextureBaker::BakeDirectory(const std::wstring& directoryPath, Format format) {
+	uint32_t bakedCount = 0;
+
+	WIN32_FIND_DATAW findData{};
+	HANDLE find = FindFirstFileW((directoryPath + L"*").c_str(), &findData);
+	if (find == INVALID_HANDLE_VALUE) {
+		return 0;
+	}
+
+	do {
+		std::wstring fileName = findData.cFileName;
+		if (fileName == L"." || fileName == L"..") {
+			continue;
+		}
+
+		std::wstring path = directoryPath + fileName;
+		if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+			// サブディレクトリも
+			bakedCount += BakeDirectory(path + L"/", format);
+		} else if (IsSourceImage(fileName) && !IsBakedUpToDate(path)) {
+			if (SUCCEEDED(Bake(path, GetBakedPath(path), format))) {
+				bakedCount++;
+			}
+		}
+	} while (FindNextFileW(find, &findData));
+
+	FindClose(find);
+	return bakedCount;
+}
+
+std::wstring TextureBaker::GetBakedPath(const std::wstring& srcPath) {
+	size_t dot = srcPath.find_last_of(L'.');
+	size_t slash = srcPath.find_last_of(L"/\\");
+	if (dot == std::wstring::npos || (slash != std::wstring::npos && dot < slash)) {
+		return srcPath + L".dds";
+	}
+	return srcPath.substr(0, dot) + L".dds";
+}
+
+bool TextureBaker::IsBakedUpToDate(const std::wstring& srcPath) {
+	ULARGE_INTEGER srcTime{};
+	ULARGE_INTEGER bakedTime{};
+	if (!GetLastWriteTime(GetBakedPath(srcPath), bakedTime)) {
+		return false;
+	}
+	// 元の画像がなければDDSだけで使う
+	if (!GetLastWriteTime(srcPath, srcTime)) {
+		return true;
+	}
+	return bakedTime.QuadPart >= srcTime.QuadPart;
+}
+
+HRESULT TextureBaker::MeasureError(
+  const ScratchImage& source, const ScratchImage& compressed, float& mse) {
+	// 展開（SRGBの形式で展開される）
+	ScratchImage decompressed{};
+	HRESULT result =
+	  Decompress(*compressed.GetImage(0, 0, 0), DXGI_FORMAT_UNKNOWN, decompressed);
+	if (FAILED(result)) {
+		return result;
+	}
+
+	// RGBAの平均二乗誤差（元の画像もSRGBとして比べる）
+	float mseChannels[4] = {};
+	result = ComputeMSE(
+	  *source.GetImage(0, 0, 0), *decompressed.GetImage(0, 0, 0), mse, mseChannels,
+	  CMSE_IMAGE1_SRGB);
+	return result;
+}
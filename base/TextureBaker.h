@@ -0,0 +1,81 @@
+﻿#pragma once
+
+#include <DirectXTex.h>
+#include <string>
+
+/// <summary>
+/// テクスチャのベイク
+/// PNG/JPGをミップマップ付きのブロック圧縮DDSに変換しておき、実行時のデコードとミップ生成を省く。
+/// ベイク済みのDDSはTextureManagerが元の画像の代わりに読み込む
+/// </summary>
+class TextureBaker {
+  public: // 列挙子
+	/// <summary>
+	/// 圧縮形式
+	/// </summary>
+	enum class Format {
+		kAuto, // 不透明ならBC1、アルファがあればBC7
+		kBC1,  // RGB 4bpp（1bitアルファ）
+		kBC3,  // RGBA 8bpp（補間アルファ）
+		kBC7,  // RGBA 8bpp（高品質）
+	};
+
+	// 圧縮の誤差の許容値（RGBAの平均二乗誤差、0～1）
+	static const float kMaxMeanSquaredError;
+
+  public: // 静的メンバ関数
+	/// <summary>
+	/// 1ファイルのベイク
+	/// 幅と高さが4の倍数でない画像は圧縮せず、ミップマップだけ付けて保存する
+	/// </summary>
+	/// <param name="srcPath">元の画像のパス</param>
+	/// <param name="dstPath">出力するDDSのパス</param>
+	/// <param name="format">圧縮形式</param>
+	/// <returns>結果（誤差が許容値を超えたらE_FAIL）</returns>
+	static HRESULT Bake(const std::wstring& srcPath, const std::wstring& dstPath, Format format);
+
+	/// <summary>
+	/// 画像のブロック圧縮（全ミップ）と往復誤差の計測
+	/// 元の画素はSRGBとして扱う。幅と高さが4の倍数でなくても端のブロックを詰めて圧縮する
+	/// </summary>
+	/// <param name="source">元の画像</param>
+	/// <param name="format">圧縮形式</param>
+	/// <param name="compressed">圧縮した画像</param>
+	/// <param name="mse">最上位ミップのRGBAの平均二乗誤差</param>
+	/// <returns>結果</returns>
+	static HRESULT Compress(
+	  const DirectX::ScratchImage& source, Format format, DirectX::ScratchImage& compressed,
+	  float& mse);
+
+	/// <summary>
+	/// ディレクトリ以下のPNG/JPGを、隣に同名のDDSとしてベイクする（DDSが新しければ飛ばす）
+	/// </summary>
+	/// <param name="directoryPath">ディレクトリパス</param>
+	/// <param name="format">圧縮形式</param>
+	/// <returns>ベイクしたファイル数</returns>
+	static uint32_t BakeDirectory(const std::wstring& directoryPath, Format format = Format::kAuto);
+
+	/// <summary>
+	/// ベイク済みDDSのパスを求める（拡張子を.ddsに置き換える）
+	/// </summary>
+	/// <param name="srcPath">元の画像のパス</param>
+	/// <returns>DDSのパス</returns>
+	static std::wstring GetBakedPath(const std::wstring& srcPath);
+
+	/// <summary>
+	/// 元の画像より新しいベイク済みDDSがあるか
+	/// </summary>
+	/// <param name="srcPath">元の画像のパス</param>
+	/// <returns>あればtrue</returns>
+	static bool IsBakedUpToDate(const std::wstring& srcPath);
+
+	/// <summary>
+	/// 圧縮の往復誤差を求める（圧縮したものを展開して元と比べる、最上位ミップのみ）
+	/// </summary>
+	/// <param name="source">元の画像</param>
+	/// <param name="compressed">圧縮した画像</param>
+	/// <param name="mse">RGBAの平均二乗誤差</param>
+	/// <returns>結果</returns>
+	static HRESULT MeasureError(
+	  const DirectX::ScratchImage& source, const DirectX::ScratchImage& compressed, float& mse);
+};
@@ -1,13 +1,75 @@
 ﻿#include "TextureManager.h"
+#include "RectPacker.h"
+#include "ResourceUploader.h"
+#include "TextureBaker.h"
+#include "ThreadPool.h"
 #include <DirectXTex.h>
+#include <algorithm>
 #include <cassert>
+#include <vector>
 
 using namespace DirectX;
+using namespace Microsoft::WRL;
+
+/// <summary>
+/// 静的メンバ変数の実体
+/// </summary>
+const std::string TextureManager::kPlaceholderName = "white1x1.png";
+
+namespace {
+
+// シェーダーのマクロ
+const D3D_SHADER_MACRO kBindlessMacros[] = {
+  {"BINDLESS", "1"},
+  {nullptr, nullptr},
+};
+const D3D_SHADER_MACRO kDefaultMacros[] = {
+  {nullptr, nullptr},
+};
+
+// 未使用の番号に置くヌルのビューの設定
+D3D12_SHADER_RESOURCE_VIEW_DESC GetNullSrvDesc() {
+	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+	srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+	srvDesc.Texture2D.MipLevels = 1;
+	return srvDesc;
+}
+
+} // namespace
 
 uint32_t TextureManager::Load(const std::string& fileName) {
 	return TextureManager::GetInstance()->LoadInternal(fileName);
 }
 
+uint32_t TextureManager::LoadAsync(
+  const std::string& fileName, std::function<void(uint32_t textureHandle)> onLoaded) {
+	return TextureManager::GetInstance()->LoadAsyncInternal(fileName, std::move(onLoaded));
+}
+
+uint32_t TextureManager::LoadAtlas(
+  const std::string& atlasName, const std::vector<std::string>& fileNames) {
+	return TextureManager::GetInstance()->LoadAtlasInternal(atlasName, fileNames);
+}
+
+uint32_t TextureManager::CreateFromPixels(
+  const std::string& name, DXGI_FORMAT format, uint32_t width, uint32_t height,
+  const void* pixels, size_t rowPitch) {
+	return TextureManager::GetInstance()->CreateFromPixelsInternal(
+	  name, format, width, height, pixels, rowPitch);
+}
+
+uint32_t TextureManager::CreateFromResource(
+  const std::string& name, ID3D12Resource* resource,
+  const D3D12_SHADER_RESOURCE_VIEW_DESC& srvDesc) {
+	return TextureManager::GetInstance()->CreateFromResourceInternal(name, resource, srvDesc);
+}
+
+void TextureManager::Unload(uint32_t textureHandle) {
+	TextureManager::GetInstance()->UnloadInternal(textureHandle);
+}
+
 TextureManager* TextureManager::GetInstance() {
 	static TextureManager instance;
 	return &instance;
@@ -23,152 +85,901 @@ void TextureManager::Initialize(ID3D12Device* device, std::string directoryPath)
 	sDescriptorHandleIncrementSize_ =
 	  device_->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 
+	// 全テクスチャをインデックスで参照できるか（Tier1はテーブル全体の初期化とサイズに制限がある）
+	D3D12_FEATURE_DATA_D3D12_OPTIONS options{};
+	HRESULT result =
+	  device_->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options));
+	bindless_ = SUCCEEDED(result) && options.ResourceBindingTier >= D3D12_RESOURCE_BINDING_TIER_2;
+
+	// 常駐させるミップの予算
+	residency_.SetBudget(kDefaultResidencyBudget);
+
 	// 全テクスチャリセット
 	ResetAll();
 }
 
 void TextureManager::ResetAll() {
-	HRESULT result = S_FALSE;
+	// 読み込み中の要求を終わらせてから破棄
+	for (auto& pair : loadRequests_) {
+		cancelledRequests_.push_back(pair.second);
+	}
+	loadRequests_.clear();
+	for (auto& pair : streamRequests_) {
+		cancelledRequests_.push_back(pair.second);
+	}
+	streamRequests_.clear();
+	for (std::shared_ptr<LoadRequest>& request : cancelledRequests_) {
+		WaitLoadRequest(*request);
+		GpuMemoryAllocator::GetInstance()->Release(request->resource, request->allocation);
+	}
+	cancelledRequests_.clear();
+	placeholderHandle_ = HandleAllocator::kInvalidHandle;
+
+	// 全テクスチャを破棄
+	for (Texture& texture : textures_) {
+		GpuMemoryAllocator::GetInstance()->Release(texture.resource, texture.allocation);
+		texture.name.clear();
+		texture.refCount = 0;
+	}
+	pendingFrees_.clear();
+	nameTable_.Clear();
+	atlasRegions_.clear();
+	{
+		std::lock_guard<std::mutex> lock(residencyMutex_);
+		residency_.Clear();
+	}
 
-	// デスクリプタヒープを生成
-	D3D12_DESCRIPTOR_HEAP_DESC descHeapDesc = {};
-	descHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-	descHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE; // シェーダから見えるように
-	descHeapDesc.NumDescriptors = kNumDescriptors; // シェーダーリソースビュー1つ
-	result = device_->CreateDescriptorHeap(&descHeapDesc, IID_PPV_ARGS(&descriptorHeap_)); // 生成
-	assert(SUCCEEDED(result));
+	// 初期の容量でデスクリプタヒープを作り直す
+	for (ComPtr<ID3D12DescriptorHeap>& descriptorHeap : descriptorHeaps_) {
+		if (descriptorHeap) {
+			retiredHeaps_.push_back(
+			  {descriptorHeap, DirectXCommon::GetInstance()->GetNextFenceValue()});
+		}
+		descriptorHeap.Reset();
+	}
+	cpuDescriptorHeap_.Reset();
+	textures_.clear();
+	handleAllocator_ = HandleAllocator(0);
+	CreateDescriptorHeaps(static_cast<uint32_t>(kNumDescriptors));
+}
+
+void TextureManager::Update() {
+	// デコードと転送の予約が終わった要求を取り出す
+	std::vector<std::shared_ptr<LoadRequest>> completed;
+	for (auto it = loadRequests_.begin(); it != loadRequests_.end();) {
+		if (it->second->state.load() == LoadRequest::State::kDone) {
+			completed.push_back(it->second);
+			it = loadRequests_.erase(it);
+		} else {
+			++it;
+		}
+	}
 
-	indexNextDescriptorHeap_ = 0;
+	for (auto it = streamRequests_.begin(); it != streamRequests_.end();) {
+		if (it->second->state.load() == LoadRequest::State::kDone) {
+			completed.push_back(it->second);
+			it = streamRequests_.erase(it);
+		} else {
+			++it;
+		}
+	}
 
-	// 全テクスチャを初期化
-	for (size_t i = 0; i < kNumDescriptors; i++) {
-		textures_[i].resource.Reset();
-		textures_[i].cpuDescHandleSRV.ptr = 0;
-		textures_[i].gpuDescHandleSRV.ptr = 0;
-		textures_[i].name.clear();
+	// 差し替え（転送はPostDrawで提出され、描画キューはその完了を待つ）
+	for (std::shared_ptr<LoadRequest>& request : completed) {
+		CompleteLoadRequest(*request);
 	}
+
+	// 前のフレームの描画で必要になったミップを読み込む
+	UpdateResidency();
+
+	// 読み込み中に解放された要求の後始末
+	cancelledRequests_.erase(
+	  std::remove_if(
+	    cancelledRequests_.begin(), cancelledRequests_.end(),
+	    [](std::shared_ptr<LoadRequest>& request) {
+		    if (request->state.load() != LoadRequest::State::kDone) {
+			    return false;
+		    }
+		    GpuMemoryAllocator::GetInstance()->Release(request->resource, request->allocation);
+		    return true;
+	    }),
+	  cancelledRequests_.end());
 }
 
-const D3D12_RESOURCE_DESC TextureManager::GetResoureDesc(uint32_t textureHandle) {
+bool TextureManager::IsLoaded(uint32_t textureHandle) const {
+	return handleAllocator_.IsAllocated(textureHandle) && textures_[textureHandle].refCount > 0 &&
+	       loadRequests_.count(textureHandle) == 0;
+}
 
+uint32_t TextureManager::GetLoadGeneration(uint32_t textureHandle) const {
 	assert(textureHandle < textures_.size());
+	return textures_[textureHandle].generation;
+}
+
+void TextureManager::RequestMip(uint32_t textureHandle, float screenSize) {
+	assert(textureHandle < textures_.size());
+	const D3D12_RESOURCE_DESC& desc = textures_[textureHandle].desc;
+
+	// 画面上の大きさに見合ったミップ
+	uint32_t textureSize = static_cast<uint32_t>((std::max)(desc.Width, UINT64(desc.Height)));
+	uint32_t mip = TextureResidency::ComputeMip(
+	  textureSize, screenSize, (std::max)(UINT16(1), desc.MipLevels));
+
+	std::lock_guard<std::mutex> lock(residencyMutex_);
+	residency_.Request(textureHandle, mip);
+}
+
+void TextureManager::SetResidencyBudget(uint64_t budget) {
+	std::lock_guard<std::mutex> lock(residencyMutex_);
+	residency_.SetBudget(budget);
+}
+
+uint64_t TextureManager::GetResidentSize() {
+	std::lock_guard<std::mutex> lock(residencyMutex_);
+	return residency_.GetResidentSize();
+}
+
+bool TextureManager::FindAtlasRegion(const std::string& fileName, AtlasRegion& region) const {
+	auto it = atlasRegions_.find(AssetNameTable::Normalize(GetFullPath(fileName)));
+	if (it == atlasRegions_.end()) {
+		return false;
+	}
+	region = it->second;
+	return true;
+}
+
+const D3D12_RESOURCE_DESC TextureManager::GetResoureDesc(uint32_t textureHandle) {
+
+	assert(handleAllocator_.IsAllocated(textureHandle));
+	// 読み込み中は代わりのテクスチャ
+	if (loadRequests_.count(textureHandle) > 0) {
+		textureHandle = placeholderHandle_;
+	}
 	Texture& texture = textures_.at(textureHandle);
-	return texture.resource->GetDesc();
+	return texture.desc;
+}
+
+const D3D_SHADER_MACRO* TextureManager::GetShaderMacros() const {
+	return bindless_ ? kBindlessMacros : kDefaultMacros;
+}
+
+void TextureManager::SetDescriptorHeap(ID3D12GraphicsCommandList* commandList) {
+	// デスクリプタヒープの配列
+	ID3D12DescriptorHeap* ppHeaps[] = {SyncDescriptorHeap()};
+	commandList->SetDescriptorHeaps(_countof(ppHeaps), ppHeaps);
+}
+
+void TextureManager::SetGraphicsRootTextureTable(
+  ID3D12GraphicsCommandList* commandList, UINT rootParamIndex) {
+	assert(bindless_);
+	// ヒープの先頭からの全テクスチャ
+	commandList->SetGraphicsRootDescriptorTable(
+	  rootParamIndex, SyncDescriptorHeap()->GetGPUDescriptorHandleForHeapStart());
+}
+
+void TextureManager::SetGraphicsRootTexture(
+  ID3D12GraphicsCommandList* commandList, UINT rootParamIndex, uint32_t textureHandle) {
+	assert(textureHandle < textures_.size());
+
+	if (bindless_) {
+		// テクスチャ番号をルート定数でセット
+		commandList->SetGraphicsRoot32BitConstant(rootParamIndex, textureHandle, 0);
+	} else {
+		// シェーダリソースビューをセット
+		commandList->SetGraphicsRootDescriptorTable(
+		  rootParamIndex,
+		  CD3DX12_GPU_DESCRIPTOR_HANDLE(
+		    SyncDescriptorHeap()->GetGPUDescriptorHandleForHeapStart(), textureHandle,
+		    sDescriptorHandleIncrementSize_));
+	}
 }
 
 void TextureManager::SetGraphicsRootDescriptorTable(
-  ID3D12GraphicsCommandList* commandList, UINT rootParamIndex,
-  uint32_t textureHandle) { // デスクリプタヒープの配列
+  ID3D12GraphicsCommandList* commandList, UINT rootParamIndex, uint32_t textureHandle) {
 	assert(textureHandle < textures_.size());
-	ID3D12DescriptorHeap* ppHeaps[] = {descriptorHeap_.Get()};
-	commandList->SetDescriptorHeaps(_countof(ppHeaps), ppHeaps);
 
 	// シェーダリソースビューをセット
 	commandList->SetGraphicsRootDescriptorTable(
-	  rootParamIndex, textures_[textureHandle].gpuDescHandleSRV);
+	  rootParamIndex, CD3DX12_GPU_DESCRIPTOR_HANDLE(
+	                    SyncDescriptorHeap()->GetGPUDescriptorHandleForHeapStart(),
+	                    textureHandle, sDescriptorHandleIncrementSize_));
 }
 
 uint32_t TextureManager::LoadInternal(const std::string& fileName) {
 
-	assert(indexNextDescriptorHeap_ < kNumDescriptors);
-	uint32_t handle = indexNextDescriptorHeap_;
-
 	// 読み込み済みテクスチャを検索
-	auto it = std::find_if(textures_.begin(), textures_.end(), [&](const auto& texture) {
-		return texture.name == fileName;
-	});
-	if (it != textures_.end()) {
-		// 読み込み済みテクスチャの要素番号を取得
-		handle = static_cast<uint32_t>(std::distance(textures_.begin(), it));
+	std::string fullPath;
+	uint32_t handle = AcquireLoaded(fileName, fullPath);
+	if (handle != HandleAllocator::kInvalidHandle) {
+		// 非同期読み込み中なら完了を待って差し替える
+		auto it = loadRequests_.find(handle);
+		if (it != loadRequests_.end()) {
+			std::shared_ptr<LoadRequest> request = it->second;
+			loadRequests_.erase(it);
+			WaitLoadRequest(*request);
+			CompleteLoadRequest(*request);
+		}
 		return handle;
 	}
 
-	// 書き込むテクスチャの参照
+	handle = RegisterTexture(fileName, fullPath);
+
+	// この場でデコードと転送の予約
+	LoadRequest request;
+	request.fullPath = fullPath;
+	request.handle = handle;
+	ExecuteLoadRequest(request);
+	CompleteLoadRequest(request);
+
+	return handle;
+}
+
+uint32_t TextureManager::LoadAsyncInternal(
+  const std::string& fileName, std::function<void(uint32_t)> onLoaded) {
+
+	// 代わりのテクスチャは同期で読み込んでおく
+	if (placeholderHandle_ == HandleAllocator::kInvalidHandle) {
+		placeholderHandle_ = LoadInternal(kPlaceholderName);
+	}
+
+	// 読み込み済みか読み込み中のテクスチャを検索
+	std::string fullPath;
+	uint32_t handle = AcquireLoaded(fileName, fullPath);
+	if (handle != HandleAllocator::kInvalidHandle) {
+		auto it = loadRequests_.find(handle);
+		if (it != loadRequests_.end()) {
+			if (onLoaded) {
+				it->second->callbacks.push_back(std::move(onLoaded));
+			}
+		} else if (onLoaded) {
+			onLoaded(handle);
+		}
+		return handle;
+	}
+
+	handle = RegisterTexture(fileName, fullPath);
+
+	// 完了までは代わりのテクスチャのビューを置く
+	D3D12_CPU_DESCRIPTOR_HANDLE heapStart = cpuDescriptorHeap_->GetCPUDescriptorHandleForHeapStart();
+	device_->CopyDescriptorsSimple(
+	  1, CD3DX12_CPU_DESCRIPTOR_HANDLE(heapStart, handle, sDescriptorHandleIncrementSize_),
+	  CD3DX12_CPU_DESCRIPTOR_HANDLE(heapStart, placeholderHandle_, sDescriptorHandleIncrementSize_),
+	  D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	PublishDescriptor(handle);
+
+	// デコードはワーカースレッドで
+	std::shared_ptr<LoadRequest> request = std::make_shared<LoadRequest>();
+	request->fullPath = fullPath;
+	request->handle = handle;
+	if (onLoaded) {
+		request->callbacks.push_back(std::move(onLoaded));
+	}
+	loadRequests_.emplace(handle, request);
+	EnqueueLoadRequest(request);
+
+	return handle;
+}
+
+uint32_t TextureManager::LoadAtlasInternal(
+  const std::string& atlasName, const std::vector<std::string>& fileNames) {
+
+	// 読み込み済みのアトラスを検索
+	std::string fullPath;
+	uint32_t handle = AcquireLoaded(atlasName, fullPath);
+	if (handle != HandleAllocator::kInvalidHandle) {
+		return handle;
+	}
+
+	HRESULT result;
+
+	// 画像を読み込んでRGBA8に揃える
+	std::vector<ScratchImage> images(fileNames.size());
+	std::vector<RectPacker::Size> sizes(fileNames.size());
+	for (size_t i = 0; i < fileNames.size(); i++) {
+		// ユニコード文字列に変換
+		wchar_t wfilePath[256];
+		MultiByteToWideChar(
+		  CP_ACP, 0, GetFullPath(fileNames[i]).c_str(), -1, wfilePath, _countof(wfilePath));
+
+		// WICテクスチャのロード（SRGBかどうかはアトラスのフォーマットで扱う）
+		result = LoadFromWICFile(wfilePath, WIC_FLAGS_IGNORE_SRGB, nullptr, images[i]);
+		assert(SUCCEEDED(result));
+		if (images[i].GetMetadata().format != DXGI_FORMAT_R8G8B8A8_UNORM) {
+			ScratchImage converted;
+			result = Convert(
+			  *images[i].GetImage(0, 0, 0), DXGI_FORMAT_R8G8B8A8_UNORM, TEX_FILTER_DEFAULT,
+			  TEX_THRESHOLD_DEFAULT, converted);
+			assert(SUCCEEDED(result));
+			images[i] = std::move(converted);
+		}
+
+		// 余白を含めた大きさ
+		const TexMetadata& metadata = images[i].GetMetadata();
+		sizes[i].width = static_cast<uint32_t>(metadata.width) + kAtlasPadding * 2;
+		sizes[i].height = static_cast<uint32_t>(metadata.height) + kAtlasPadding * 2;
+	}
+
+	// 全て収まる最小の大きさに詰め込む
+	std::vector<RectPacker::Rect> rects;
+	RectPacker::Size atlasSize;
+	if (!RectPacker::PackMinimum(kMaxAtlasSize, sizes, rects, atlasSize)) {
+		// 収まらなければ登録しない（呼び出し側で画像を分けて複数のアトラスにする）
+		std::string message = "TextureManager: atlas does not fit in " +
+		                      std::to_string(kMaxAtlasSize) + "x" + std::to_string(kMaxAtlasSize) +
+		                      " (" + atlasName + ")\n";
+		OutputDebugStringA(message.c_str());
+		return HandleAllocator::kInvalidHandle;
+	}
+
+	handle = RegisterTexture(atlasName, fullPath);
+
+	// 画像を配置した位置に書き込み、余白は最も近い端のピクセルで埋める
+	std::vector<uint32_t> pixels(size_t(atlasSize.width) * atlasSize.height, 0);
+	for (size_t i = 0; i < images.size(); i++) {
+		const Image* image = images[i].GetImage(0, 0, 0);
+		uint32_t width = static_cast<uint32_t>(image->width);
+		uint32_t height = static_cast<uint32_t>(image->height);
+		const RectPacker::Rect& rect = rects[i];
+
+		for (uint32_t y = 0; y < rect.height; y++) {
+			uint32_t srcY = (std::min)(y - (std::min)(y, kAtlasPadding), height - 1);
+			const uint32_t* srcRow =
+			  reinterpret_cast<const uint32_t*>(image->pixels + image->rowPitch * srcY);
+			uint32_t* dstRow = &pixels[size_t(rect.y + y) * atlasSize.width + rect.x];
+			for (uint32_t x = 0; x < rect.width; x++) {
+				dstRow[x] = srcRow[(std::min)(x - (std::min)(x, kAtlasPadding), width - 1)];
+			}
+		}
+
+		// 余白の内側を画像の範囲として登録
+		AtlasRegion region;
+		region.textureHandle = handle;
+		region.texBase = {float(rect.x + kAtlasPadding), float(rect.y + kAtlasPadding)};
+		region.texSize = {float(width), float(height)};
+		atlasRegions_[AssetNameTable::Normalize(GetFullPath(fileNames[i]))] = region;
+	}
+
+	// ミップはにじむので作らない
+	UploadPixels(
+	  handle, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, atlasSize.width, atlasSize.height, pixels.data(),
+	  sizeof(uint32_t) * atlasSize.width);
+
+	return handle;
+}
+
+uint32_t TextureManager::CreateFromPixelsInternal(
+  const std::string& name, DXGI_FORMAT format, uint32_t width, uint32_t height,
+  const void* pixels, size_t rowPitch) {
+
+	// 生成済みのテクスチャを検索
+	std::string fullPath;
+	uint32_t handle = AcquireLoaded(name, fullPath);
+	if (handle != HandleAllocator::kInvalidHandle) {
+		return handle;
+	}
+
+	handle = RegisterTexture(name, fullPath);
+	UploadPixels(handle, format, width, height, pixels, rowPitch);
+
+	return handle;
+}
+
+uint32_t TextureManager::CreateFromResourceInternal(
+  const std::string& name, ID3D12Resource* resource,
+  const D3D12_SHADER_RESOURCE_VIEW_DESC& srvDesc) {
+	assert(resource);
+
+	// 登録済みのリソースを検索
+	std::string fullPath;
+	uint32_t handle = AcquireLoaded(name, fullPath);
+	if (handle != HandleAllocator::kInvalidHandle) {
+		return handle;
+	}
+
+	// 呼び出し側のリソースを参照し、ヒープ内の領域は持たない
+	handle = RegisterTexture(name, fullPath);
 	Texture& texture = textures_.at(handle);
-	texture.name = fileName;
+	texture.resource = resource;
+	texture.desc = resource->GetDesc();
+	WriteDescriptor(handle, resource, srvDesc);
+
+	return handle;
+}
 
-	// ディレクトリパスとファイル名を連結してフルパスを得る
+void TextureManager::UploadPixels(
+  uint32_t handle, DXGI_FORMAT format, uint32_t width, uint32_t height, const void* pixels,
+  size_t rowPitch) {
+	HRESULT result;
+
+	// リソース設定
+	CD3DX12_RESOURCE_DESC texresDesc = CD3DX12_RESOURCE_DESC::Tex2D(format, width, height, 1, 1);
+	D3D12_SUBRESOURCE_DATA subresource{};
+	subresource.pData = pixels;
+	subresource.RowPitch = static_cast<LONG_PTR>(rowPitch);
+	subresource.SlicePitch = subresource.RowPitch * height;
+
+	// テクスチャ用バッファをDEFAULTヒープに生成し、コピーキューで転送する
+	Texture& texture = textures_.at(handle);
+	result = ResourceUploader::GetInstance()->UploadTexture(
+	  texresDesc, &subresource, 1, texture.resource, texture.allocation);
+	assert(SUCCEEDED(result));
+	texture.desc = texresDesc;
+
+	// シェーダリソースビュー作成
+	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+	srvDesc.Format = texresDesc.Format;
+	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D; // 2Dテクスチャ
+	srvDesc.Texture2D.MipLevels = 1;
+	WriteDescriptor(handle, texture.resource.Get(), srvDesc);
+}
+
+std::string TextureManager::GetFullPath(const std::string& fileName) const {
 	bool currentRelative = false;
 	if (2 < fileName.size()) {
 		currentRelative = (fileName[0] == '.') && (fileName[1] == '/');
 	}
-	std::string fullPath = currentRelative ? fileName : directoryPath_ + fileName;
+	return currentRelative ? fileName : directoryPath_ + fileName;
+}
+
+uint32_t TextureManager::AcquireLoaded(const std::string& fileName, std::string& fullPath) {
+	// 同じ名前なら正規化せずに見つかる
+	uint32_t handle = nameTable_.Find(fileName);
+
+	if (handle == AssetNameTable::kNotFound) {
+		// ディレクトリパスとファイル名を連結してフルパスを得る
+		fullPath = GetFullPath(fileName);
+
+		// 書き方の違う同じファイルを検索
+		handle = nameTable_.FindPath(fileName, fullPath);
+	}
+
+	if (handle == AssetNameTable::kNotFound) {
+		return HandleAllocator::kInvalidHandle;
+	}
+
+	// 読み込み済みテクスチャの参照を増やす
+	textures_[handle].refCount++;
+	return handle;
+}
+
+uint32_t TextureManager::RegisterTexture(
+  const std::string& fileName, const std::string& fullPath) {
+	uint32_t handle = AllocateHandle();
+	nameTable_.Insert(fileName, fullPath, handle);
+
+	// 書き込むテクスチャの参照
+	Texture& texture = textures_.at(handle);
+	texture.name = fileName;
+	texture.refCount = 1;
+	texture.generation++;
+
+	return handle;
+}
+
+void TextureManager::EnqueueLoadRequest(const std::shared_ptr<LoadRequest>& request) {
+	ThreadPool::GetInstance()->Enqueue([request]() {
+		// WICを使うのでスレッドごとにCOMを初期化
+		static thread_local HRESULT comResult = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+		(void)comResult;
+		ExecuteLoadRequest(*request);
+	});
+}
+
+bool TextureManager::ExecuteLoadRequest(LoadRequest& request) {
+	// 実行権を取る
+	LoadRequest::State expected = LoadRequest::State::kQueued;
+	if (!request.state.compare_exchange_strong(expected, LoadRequest::State::kDecoding)) {
+		return false;
+	}
 
 	// ユニコード文字列に変換
 	wchar_t wfilePath[256];
-	MultiByteToWideChar(CP_ACP, 0, fullPath.c_str(), -1, wfilePath, _countof(wfilePath));
+	MultiByteToWideChar(
+	  CP_ACP, 0, request.fullPath.c_str(), -1, wfilePath, _countof(wfilePath));
 
 	HRESULT result;
 
 	TexMetadata metadata{};
 	ScratchImage scratchImg{};
 
-	// WICテクスチャのロード
-	result = LoadFromWICFile(wfilePath, WIC_FLAGS_NONE, &metadata, scratchImg);
-	assert(SUCCEEDED(result));
-
-	ScratchImage mipChain{};
-	// ミップマップ生成
-	result = GenerateMipMaps(
-	  scratchImg.GetImages(), scratchImg.GetImageCount(), scratchImg.GetMetadata(),
-	  TEX_FILTER_DEFAULT, 0, mipChain);
-	if (SUCCEEDED(result)) {
-		scratchImg = std::move(mipChain);
-		metadata = scratchImg.GetMetadata();
+	// ベイク済みのDDSがあればそちらを使う（圧縮とミップ生成は済んでいる）
+	std::wstring filePath = wfilePath;
+	bool isDds = _wcsicmp(TextureBaker::GetBakedPath(filePath).c_str(), filePath.c_str()) == 0;
+	if (!isDds && TextureBaker::IsBakedUpToDate(filePath)) {
+		filePath = TextureBaker::GetBakedPath(filePath);
+		isDds = true;
 	}
 
-	// 読み込んだディフューズテクスチャをSRGBとして扱う
-	metadata.format = MakeSRGB(metadata.format);
+	if (isDds) {
+		// DDSテクスチャのロード
+		result = LoadFromDDSFile(filePath.c_str(), DDS_FLAGS_NONE, &metadata, scratchImg);
+		assert(SUCCEEDED(result));
 
-	// リソース設定
-	CD3DX12_RESOURCE_DESC texresDesc = CD3DX12_RESOURCE_DESC::Tex2D(
+		// 幅と高さが4の倍数でない圧縮テクスチャはリソースを作れないので、展開して使う
+		bool aligned = metadata.width % 4 == 0 && metadata.height % 4 == 0;
+		if (IsCompressed(metadata.format) && !aligned) {
+			std::string message = "TextureManager: compressed texture size is not a multiple of 4 (";
+			message += request.fullPath + ")\n";
+			OutputDebugStringA(message.c_str());
+
+			ScratchImage decompressed{};
+			DXGI_FORMAT format = IsSRGB(metadata.format) ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB
+			                                             : DXGI_FORMAT_R8G8B8A8_UNORM;
+			result = Decompress(
+			  scratchImg.GetImages(), scratchImg.GetImageCount(), metadata, format, decompressed);
+			assert(SUCCEEDED(result));
+			scratchImg = std::move(decompressed);
+			metadata = scratchImg.GetMetadata();
+		}
+	} else {
+		// WICテクスチャのロード
+		result = LoadFromWICFile(filePath.c_str(), WIC_FLAGS_NONE, &metadata, scratchImg);
+		assert(SUCCEEDED(result));
+
+		ScratchImage mipChain{};
+		// ミップマップ生成
+		result = GenerateMipMaps(
+		  scratchImg.GetImages(), scratchImg.GetImageCount(), scratchImg.GetMetadata(),
+		  TEX_FILTER_DEFAULT, 0, mipChain);
+		if (SUCCEEDED(result)) {
+			scratchImg = std::move(mipChain);
+			metadata = scratchImg.GetMetadata();
+		}
+
+		// 読み込んだディフューズテクスチャをSRGBとして扱う
+		metadata.format = MakeSRGB(metadata.format);
+	}
+
+	// 全ミップのリソース設定
+	request.desc = CD3DX12_RESOURCE_DESC::Tex2D(
 	  metadata.format, metadata.width, (UINT)metadata.height, (UINT16)metadata.arraySize,
 	  (UINT16)metadata.mipLevels);
 
-	// ヒーププロパティ
-	CD3DX12_HEAP_PROPERTIES heapProps =
-	  CD3DX12_HEAP_PROPERTIES(D3D12_CPU_PAGE_PROPERTY_WRITE_BACK, D3D12_MEMORY_POOL_L0);
+	// ミップごとのサイズ（圧縮フォーマットは4の倍数でないミップを先頭に置けないので末尾にまとめる）
+	request.mipSizes.clear();
+	for (size_t i = 0; i < metadata.mipLevels; i++) {
+		const Image* img = scratchImg.GetImage(i, 0, 0);
+		// 最も詳細なミップは常に先頭に置ける（4の倍数であることは読み込み時に保証している）
+		bool topLevel = i == 0 || !IsCompressed(metadata.format) ||
+		                (img->width % 4 == 0 && img->height % 4 == 0);
+		if (topLevel && request.mipSizes.size() == i) {
+			request.mipSizes.push_back(img->slicePitch);
+		} else {
+			request.mipSizes.back() += img->slicePitch;
+		}
+	}
 
-	// テクスチャ用バッファの生成
-	result = device_->CreateCommittedResource(
-	  &heapProps, D3D12_HEAP_FLAG_NONE, &texresDesc,
-	  D3D12_RESOURCE_STATE_GENERIC_READ, // テクスチャ用指定
-	  nullptr, IID_PPV_ARGS(&texture.resource));
+	// 常駐させるミップから先だけを転送する
+	size_t firstMip = (std::min)(size_t(request.firstMip), request.mipSizes.size() - 1);
+	request.firstMip = static_cast<uint32_t>(firstMip);
+	const Image* firstImg = scratchImg.GetImage(firstMip, 0, 0);
+	CD3DX12_RESOURCE_DESC texresDesc = CD3DX12_RESOURCE_DESC::Tex2D(
+	  metadata.format, firstImg->width, (UINT)firstImg->height, (UINT16)metadata.arraySize,
+	  (UINT16)(metadata.mipLevels - firstMip));
+
+	// ミップごとの生データ
+	std::vector<D3D12_SUBRESOURCE_DATA> subresources(metadata.mipLevels - firstMip);
+	for (size_t i = 0; i < subresources.size(); i++) {
+		const Image* img = scratchImg.GetImage(firstMip + i, 0, 0); // 生データ抽出
+		subresources[i].pData = img->pixels;                        // 元データアドレス
+		subresources[i].RowPitch = img->rowPitch;                   // 1ラインサイズ
+		subresources[i].SlicePitch = img->slicePitch;               // 1枚サイズ
+	}
+
+	// テクスチャ用バッファをDEFAULTヒープに生成し、コピーキューで転送する
+	result = ResourceUploader::GetInstance()->UploadTexture(
+	  texresDesc, subresources.data(), static_cast<UINT>(subresources.size()), request.resource,
+	  request.allocation);
 	assert(SUCCEEDED(result));
 
-	// テクスチャバッファにデータ転送
-	for (size_t i = 0; i < metadata.mipLevels; i++) {
-		const Image* img = scratchImg.GetImage(i, 0, 0); // 生データ抽出
-		result = texture.resource->WriteToSubresource(
-		  (UINT)i,
-		  nullptr,              // 全領域へコピー
-		  img->pixels,          // 元データアドレス
-		  (UINT)img->rowPitch,  // 1ラインサイズ
-		  (UINT)img->slicePitch // 1枚サイズ
-		);
-		assert(SUCCEEDED(result));
+	// シェーダリソースビューの設定
+	request.srvDesc.Format = texresDesc.Format;
+	request.srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	request.srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D; // 2Dテクスチャ
+	request.srvDesc.Texture2D.MipLevels = texresDesc.MipLevels;
+
+	// 完了を通知
+	{
+		std::lock_guard<std::mutex> lock(request.mutex);
+		request.state = LoadRequest::State::kDone;
+	}
+	request.doneCondition.notify_all();
+	return true;
+}
+
+void TextureManager::WaitLoadRequest(LoadRequest& request) {
+	// まだ始まっていなければこのスレッドで実行する
+	if (ExecuteLoadRequest(request)) {
+		return;
 	}
 
+	std::unique_lock<std::mutex> lock(request.mutex);
+	request.doneCondition.wait(
+	  lock, [&request]() { return request.state.load() == LoadRequest::State::kDone; });
+}
+
+void TextureManager::CompleteLoadRequest(LoadRequest& request) {
+	assert(request.state.load() == LoadRequest::State::kDone);
+
+	// 常駐ミップの入れ替えなら、古いリソースは記録済みのコマンドが完了してから破棄する
+	Texture& texture = textures_.at(request.handle);
+	bool streamed = texture.resource != nullptr;
+	GpuMemoryAllocator::GetInstance()->Release(texture.resource, texture.allocation);
+
 	// シェーダリソースビュー作成
-	texture.cpuDescHandleSRV = CD3DX12_CPU_DESCRIPTOR_HANDLE(
-	  descriptorHeap_->GetCPUDescriptorHandleForHeapStart(), handle, sDescriptorHandleIncrementSize_);
-	texture.gpuDescHandleSRV = CD3DX12_GPU_DESCRIPTOR_HANDLE(
-	  descriptorHeap_->GetGPUDescriptorHandleForHeapStart(), handle, sDescriptorHandleIncrementSize_);
+	texture.resource = std::move(request.resource);
+	texture.allocation = request.allocation;
+	request.allocation = GpuMemoryAllocator::Allocation();
+	texture.desc = request.desc;
+	texture.residentMip = request.firstMip;
+	// 常駐ミップの入れ替えでは全ミップの設定は変わらない
+	if (!streamed) {
+		texture.generation++;
+	}
+	WriteDescriptor(request.handle, texture.resource.Get(), request.srvDesc);
+
+	// ミップが複数あれば常駐の管理に加える
+	{
+		std::lock_guard<std::mutex> lock(residencyMutex_);
+		if (streamed) {
+			residency_.SetResidentMip(request.handle, request.firstMip);
+		} else if (request.mipSizes.size() > 1) {
+			residency_.Add(request.handle, request.mipSizes, request.firstMip);
+		}
+	}
 
-	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{}; // 設定構造体
-	D3D12_RESOURCE_DESC resDesc = texture.resource->GetDesc();
+	// 完了時の処理（中で読み込みや解放をしてもいいように取り出してから呼ぶ）
+	std::vector<std::function<void(uint32_t)>> callbacks = std::move(request.callbacks);
+	for (std::function<void(uint32_t)>& callback : callbacks) {
+		callback(request.handle);
+	}
+}
 
-	srvDesc.Format = resDesc.Format;
-	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D; // 2Dテクスチャ
-	srvDesc.Texture2D.MipLevels = (UINT)metadata.mipLevels;
+void TextureManager::UpdateResidency() {
+	std::vector<TextureResidency::Change> changes;
+	{
+		std::lock_guard<std::mutex> lock(residencyMutex_);
+		residency_.Update(DirectXCommon::GetInstance()->GetFrameNumber(), changes);
+	}
 
-	device_->CreateShaderResourceView(
-	  texture.resource.Get(), //ビューと関連付けるバッファ
-	  &srvDesc,               //テクスチャ設定情報
-	  texture.cpuDescHandleSRV);
+	// 変わるミップから先を読み込み直す（完了までは今のリソースのまま描画する）
+	for (const TextureResidency::Change& change : changes) {
+		if (loadRequests_.count(change.id) > 0 || streamRequests_.count(change.id) > 0) {
+			continue;
+		}
+		// 粗くするだけなら常駐しているミップから作る
+		if (change.residentMip > textures_[change.id].residentMip) {
+			DropResidentMips(change.id, change.residentMip);
+			continue;
+		}
+		std::shared_ptr<LoadRequest> request = std::make_shared<LoadRequest>();
+		request->fullPath = GetFullPath(textures_[change.id].name);
+		request->handle = change.id;
+		request->firstMip = change.residentMip;
+		streamRequests_.emplace(change.id, request);
+		EnqueueLoadRequest(request);
+	}
+}
+
+void TextureManager::DropResidentMips(uint32_t textureHandle, uint32_t residentMip) {
+	Texture& texture = textures_.at(textureHandle);
+	assert(texture.resource);
+	assert(texture.residentMip < residentMip && residentMip < texture.desc.MipLevels);
+
+	// 残すミップから先の大きさのリソース
+	CD3DX12_RESOURCE_DESC texresDesc = CD3DX12_RESOURCE_DESC::Tex2D(
+	  texture.desc.Format, (std::max)(texture.desc.Width >> residentMip, UINT64(1)),
+	  (std::max)(texture.desc.Height >> residentMip, UINT(1)), texture.desc.DepthOrArraySize,
+	  static_cast<UINT16>(texture.desc.MipLevels - residentMip));
+
+	// 非同期読み込みと同じ手順で差し替える（コピーは読み込みの転送と一緒に提出される）
+	LoadRequest request;
+	request.handle = textureHandle;
+	request.firstMip = residentMip;
+	request.desc = texture.desc;
+	HRESULT result = ResourceUploader::GetInstance()->CopyTextureMips(
+	  texresDesc, texture.resource.Get(), residentMip - texture.residentMip, request.resource,
+	  request.allocation);
+	assert(SUCCEEDED(result));
 
-	indexNextDescriptorHeap_++;
+	// シェーダリソースビューの設定
+	request.srvDesc.Format = texresDesc.Format;
+	request.srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	request.srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D; // 2Dテクスチャ
+	request.srvDesc.Texture2D.MipLevels = texresDesc.MipLevels;
 
+	request.state = LoadRequest::State::kDone;
+	CompleteLoadRequest(request);
+}
+
+void TextureManager::UnloadInternal(uint32_t textureHandle) {
+	assert(handleAllocator_.IsAllocated(textureHandle));
+	Texture& texture = textures_[textureHandle];
+	assert(texture.refCount > 0);
+
+	if (--texture.refCount > 0) {
+		return;
+	}
+
+	// 読み込み中なら完了後に破棄する
+	auto it = loadRequests_.find(textureHandle);
+	if (it != loadRequests_.end()) {
+		cancelledRequests_.push_back(it->second);
+		loadRequests_.erase(it);
+	}
+	it = streamRequests_.find(textureHandle);
+	if (it != streamRequests_.end()) {
+		cancelledRequests_.push_back(it->second);
+		streamRequests_.erase(it);
+	}
+	{
+		std::lock_guard<std::mutex> lock(residencyMutex_);
+		residency_.Remove(textureHandle);
+	}
+
+	// リソースと番号は記録済みのコマンドが完了してから回収する
+	GpuMemoryAllocator::GetInstance()->Release(texture.resource, texture.allocation);
+	texture.name.clear();
+	nameTable_.Erase(textureHandle);
+
+	// アトラスならまとめた画像の範囲も消す
+	for (auto it = atlasRegions_.begin(); it != atlasRegions_.end();) {
+		if (it->second.textureHandle == textureHandle) {
+			it = atlasRegions_.erase(it);
+		} else {
+			++it;
+		}
+	}
+	pendingFrees_.push_back(
+	  {textureHandle, DirectXCommon::GetInstance()->GetNextFenceValue()});
+}
+
+uint32_t TextureManager::AllocateHandle() {
+	// 使い終わった番号を先に回収
+	CollectGarbage();
+
+	uint32_t handle = handleAllocator_.Allocate();
+	if (handle == HandleAllocator::kInvalidHandle) {
+		// 足りなければヒープを倍に拡張
+		CreateDescriptorHeaps(handleAllocator_.GetCapacity() * 2);
+		handle = handleAllocator_.Allocate();
+	}
+	assert(handle != HandleAllocator::kInvalidHandle);
 	return handle;
 }
+
+void TextureManager::CreateDescriptorHeaps(uint32_t capacity) {
+	HRESULT result = S_FALSE;
+	uint32_t oldCapacity = handleAllocator_.GetCapacity();
+
+	// デスクリプタヒープの原本を生成
+	D3D12_DESCRIPTOR_HEAP_DESC descHeapDesc = {};
+	descHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+	descHeapDesc.NumDescriptors = capacity;
+	ComPtr<ID3D12DescriptorHeap> cpuDescriptorHeap;
+	result = device_->CreateDescriptorHeap(&descHeapDesc, IID_PPV_ARGS(&cpuDescriptorHeap));
+	assert(SUCCEEDED(result));
+
+	// 既存のデスクリプタを原本から引き継ぐ
+	if (cpuDescriptorHeap_) {
+		device_->CopyDescriptorsSimple(
+		  oldCapacity, cpuDescriptorHeap->GetCPUDescriptorHandleForHeapStart(),
+		  cpuDescriptorHeap_->GetCPUDescriptorHandleForHeapStart(),
+		  D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	}
+	cpuDescriptorHeap_ = cpuDescriptorHeap;
+	handleAllocator_.Grow(capacity);
+	textures_.resize(capacity);
+
+	// 追加した番号にはヌルのビューを置く（バインドレスのテーブルはヒープ全体を指すため）
+	D3D12_SHADER_RESOURCE_VIEW_DESC nullSrvDesc = GetNullSrvDesc();
+	for (uint32_t i = oldCapacity; i < capacity; i++) {
+		device_->CreateShaderResourceView(
+		  nullptr, &nullSrvDesc,
+		  CD3DX12_CPU_DESCRIPTOR_HANDLE(
+		    cpuDescriptorHeap_->GetCPUDescriptorHandleForHeapStart(), i,
+		    sDescriptorHandleIncrementSize_));
+	}
+
+	// フレームごとのシェーダから見えるヒープを生成し、原本をまとめてコピー
+	std::lock_guard<std::mutex> lock(heapMutex_);
+	descHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE; // シェーダから見えるように
+	for (uint32_t i = 0; i < DirectXCommon::kFrameCount; i++) {
+		// 記録済みのコマンドが古いヒープを参照しているので、完了まで保持する
+		if (descriptorHeaps_[i]) {
+			retiredHeaps_.push_back(
+			  {descriptorHeaps_[i], DirectXCommon::GetInstance()->GetNextFenceValue()});
+		}
+
+		result = device_->CreateDescriptorHeap(&descHeapDesc, IID_PPV_ARGS(&descriptorHeaps_[i]));
+		assert(SUCCEEDED(result));
+		device_->CopyDescriptorsSimple(
+		  capacity, descriptorHeaps_[i]->GetCPUDescriptorHandleForHeapStart(),
+		  cpuDescriptorHeap_->GetCPUDescriptorHandleForHeapStart(),
+		  D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+		dirtyHandles_[i].clear();
+	}
+}
+
+void TextureManager::CollectGarbage() {
+	UINT64 completedValue = DirectXCommon::GetInstance()->GetCompletedFenceValue();
+
+	// 番号を回収し、ヌルのビューに戻す
+	D3D12_SHADER_RESOURCE_VIEW_DESC nullSrvDesc = GetNullSrvDesc();
+	while (!pendingFrees_.empty() && pendingFrees_.front().fenceValue <= completedValue) {
+		uint32_t handle = pendingFrees_.front().handle;
+		WriteDescriptor(handle, nullptr, nullSrvDesc);
+		handleAllocator_.Free(handle);
+		pendingFrees_.pop_front();
+	}
+
+	// 使い終わった古いヒープを破棄
+	retiredHeaps_.erase(
+	  std::remove_if(
+	    retiredHeaps_.begin(), retiredHeaps_.end(),
+	    [&](const RetiredHeap& retired) { return retired.fenceValue <= completedValue; }),
+	  retiredHeaps_.end());
+}
+
+ID3D12DescriptorHeap* TextureManager::SyncDescriptorHeap() {
+	DirectXCommon* dxCommon = DirectXCommon::GetInstance();
+	uint64_t frameNumber = dxCommon->GetFrameNumber();
+	UINT frameIndex = dxCommon->GetFrameIndex();
+
+	// フレームが進んでいたら、このフレームのヒープ（GPUの使用は終わっている）に未反映分をコピー
+	if (syncedFrameNumber_.load() != frameNumber) {
+		std::lock_guard<std::mutex> lock(heapMutex_);
+		if (syncedFrameNumber_.load() != frameNumber) {
+			for (uint32_t handle : dirtyHandles_[frameIndex]) {
+				device_->CopyDescriptorsSimple(
+				  1,
+				  CD3DX12_CPU_DESCRIPTOR_HANDLE(
+				    descriptorHeaps_[frameIndex]->GetCPUDescriptorHandleForHeapStart(), handle,
+				    sDescriptorHandleIncrementSize_),
+				  CD3DX12_CPU_DESCRIPTOR_HANDLE(
+				    cpuDescriptorHeap_->GetCPUDescriptorHandleForHeapStart(), handle,
+				    sDescriptorHandleIncrementSize_),
+				  D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+			}
+			dirtyHandles_[frameIndex].clear();
+			syncedFrameNumber_ = frameNumber;
+		}
+	}
+
+	return descriptorHeaps_[frameIndex].Get();
+}
+
+void TextureManager::PublishDescriptor(uint32_t handle) {
+	ID3D12DescriptorHeap* currentHeap = SyncDescriptorHeap();
+	UINT frameIndex = DirectXCommon::GetInstance()->GetFrameIndex();
+
+	// 記録中のフレームのヒープにはすぐにコピー
+	device_->CopyDescriptorsSimple(
+	  1,
+	  CD3DX12_CPU_DESCRIPTOR_HANDLE(
+	    currentHeap->GetCPUDescriptorHandleForHeapStart(), handle,
+	    sDescriptorHandleIncrementSize_),
+	  CD3DX12_CPU_DESCRIPTOR_HANDLE(
+	    cpuDescriptorHeap_->GetCPUDescriptorHandleForHeapStart(), handle,
+	    sDescriptorHandleIncrementSize_),
+	  D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+	// GPUが使用中かもしれない他のフレームのヒープは、そのフレームの番が来てから
+	std::lock_guard<std::mutex> lock(heapMutex_);
+	for (uint32_t i = 0; i < DirectXCommon::kFrameCount; i++) {
+		if (i != frameIndex) {
+			dirtyHandles_[i].push_back(handle);
+		}
+	}
+}
+
+void TextureManager::WriteDescriptor(
+  uint32_t handle, ID3D12Resource* resource, const D3D12_SHADER_RESOURCE_VIEW_DESC& srvDesc) {
+	CD3DX12_CPU_DESCRIPTOR_HANDLE cpuHandle(
+	  cpuDescriptorHeap_->GetCPUDescriptorHandleForHeapStart(), handle,
+	  sDescriptorHandleIncrementSize_);
+	device_->CreateShaderResourceView(resource, &srvDesc, cpuHandle);
+
+	PublishDescriptor(handle);
+}
@@ -1,18 +1,44 @@
 ﻿#pragma once
 
+#include "AssetNameTable.h"
+#include "DirectXCommon.h"
+#include "GpuMemoryAllocator.h"
+#include "HandleAllocator.h"
+#include "TextureResidency.h"
 #include <array>
+#include <atomic>
+#include <DirectXMath.h>
+#include <condition_variable>
 #include <d3dx12.h>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <wrl.h>
 
 /// <summary>
 /// テクスチャマネージャ
+/// テクスチャハンドルは参照カウント付きで、Unloadで数が0になった番号はGPUの使用後に使い回す。
+/// 番号が足りなくなったらデスクリプタヒープを倍に拡張する。
+/// シェーダから見えるヒープはフレームごとに持ち、GPUが使用中のヒープは書き換えない。
+/// 小さな画像はアトラスにまとめて1枚のテクスチャとして読み込める。
+/// ミップは描画時の画面上の大きさに応じて、予算内で読み込み直したり追い出したりする
 /// </summary>
 class TextureManager {
   public:
-	// デスクリプターの数
+	// デスクリプターの初期数
 	static const size_t kNumDescriptors = 256;
+	// 非同期読み込み中に代わりに表示するテクスチャ
+	static const std::string kPlaceholderName;
+	// アトラスの辺の最大
+	static const uint32_t kMaxAtlasSize = 4096;
+	// アトラス内の画像の間の余白（画像の端のピクセルで埋め、フィルタのにじみを防ぐ）
+	static const uint32_t kAtlasPadding = 1;
+	// 常駐させるミップの予算の初期値
+	static const uint64_t kDefaultResidencyBudget = 256ull * 1024 * 1024;
 
 	/// <summary>
 	/// テクスチャ
@@ -20,21 +46,96 @@ class TextureManager {
 	struct Texture {
 		// テクスチャリソース
 		Microsoft::WRL::ComPtr<ID3D12Resource> resource;
-		// シェーダリソースビューのハンドル(CPU)
-		CD3DX12_CPU_DESCRIPTOR_HANDLE cpuDescHandleSRV;
-		// シェーダリソースビューのハンドル(CPU)
-		CD3DX12_GPU_DESCRIPTOR_HANDLE gpuDescHandleSRV;
+		// ヒープ内の領域
+		GpuMemoryAllocator::Allocation allocation;
 		// 名前
 		std::string name;
+		// 参照カウント
+		uint32_t refCount = 0;
+		// 全ミップのリソース設定
+		D3D12_RESOURCE_DESC desc{};
+		// 常駐している最も詳細なミップ
+		uint32_t residentMip = 0;
+		// 読み込み世代（登録と非同期読み込みの完了で増える）
+		uint32_t generation = 0;
 	};
 
 	/// <summary>
-	/// 読み込み
+	/// アトラス内の画像の範囲
+	/// </summary>
+	struct AtlasRegion {
+		// アトラスのテクスチャハンドル
+		uint32_t textureHandle = 0;
+		// 左上座標（ピクセル）
+		DirectX::XMFLOAT2 texBase = {0, 0};
+		// 幅、高さ（ピクセル）
+		DirectX::XMFLOAT2 texSize = {0, 0};
+	};
+
+	/// <summary>
+	/// 読み込み（読み込み済みなら参照カウントを増やす）
+	/// デスクリプタヒープが拡張されることがあるので、描画コマンドの記録中には呼ばない
 	/// </summary>
 	/// <param name="fileName">ファイル名</param>
 	/// <returns>テクスチャハンドル</returns>
 	static uint32_t Load(const std::string& fileName);
 
+	/// <summary>
+	/// 非同期読み込み
+	/// デコードとミップマップ生成はワーカースレッドで行い、完了までは代わりのテクスチャを表示する。
+	/// ハンドルはすぐに使える
+	/// </summary>
+	/// <param name="fileName">ファイル名</param>
+	/// <param name="onLoaded">完了時にメインスレッドで呼ぶ処理（読み込み済みならすぐ呼ぶ）</param>
+	/// <returns>テクスチャハンドル</returns>
+	static uint32_t LoadAsync(
+	  const std::string& fileName,
+	  std::function<void(uint32_t textureHandle)> onLoaded = nullptr);
+
+	/// <summary>
+	/// 画像をアトラスにまとめて読み込み（読み込み済みなら参照カウントを増やす）
+	/// 各画像の範囲はFindAtlasRegionで取得する。ミップマップは作らない。
+	/// kMaxAtlasSize四方に収まらなければ読み込まない
+	/// </summary>
+	/// <param name="atlasName">アトラスの名前（ファイル名と重ならないもの）</param>
+	/// <param name="fileNames">まとめる画像のファイル名</param>
+	/// <returns>テクスチャハンドル（収まらなければHandleAllocator::kInvalidHandle）</returns>
+	static uint32_t
+	  LoadAtlas(const std::string& atlasName, const std::vector<std::string>& fileNames);
+
+	/// <summary>
+	/// CPUで作った画像からテクスチャ生成（同じ名前が生成済みなら参照カウントを増やす）
+	/// ミップマップは作らない
+	/// </summary>
+	/// <param name="name">名前（ファイル名と重ならないもの）</param>
+	/// <param name="format">フォーマット</param>
+	/// <param name="width">幅</param>
+	/// <param name="height">高さ</param>
+	/// <param name="pixels">画素</param>
+	/// <param name="rowPitch">1行のバイト数</param>
+	/// <returns>テクスチャハンドル</returns>
+	static uint32_t CreateFromPixels(
+	  const std::string& name, DXGI_FORMAT format, uint32_t width, uint32_t height,
+	  const void* pixels, size_t rowPitch);
+
+	/// <summary>
+	/// 生成済みのリソースをテクスチャとして登録（同じ名前が登録済みなら参照カウントを増やす）
+	/// シャドウマップなど描画先のリソースを読むためのもの。状態の遷移は呼び出し側で行う
+	/// </summary>
+	/// <param name="name">名前（ファイル名と重ならないもの）</param>
+	/// <param name="resource">リソース</param>
+	/// <param name="srvDesc">ビューの設定</param>
+	/// <returns>テクスチャハンドル</returns>
+	static uint32_t CreateFromResource(
+	  const std::string& name, ID3D12Resource* resource,
+	  const D3D12_SHADER_RESOURCE_VIEW_DESC& srvDesc);
+
+	/// <summary>
+	/// 解放（参照カウントを減らし、0になったらGPUの使用後に破棄する）
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	static void Unload(uint32_t textureHandle);
+
 	/// <summary>
 	/// シングルトンインスタンスの取得
 	/// </summary>
@@ -53,14 +154,117 @@ class TextureManager {
 	void ResetAll();
 
 	/// <summary>
-	/// リソース情報取得
+	/// 毎フレーム処理（メインスレッドで、描画の記録前に呼ぶ）
+	/// 非同期読み込みが終わったテクスチャを差し替えて完了時の処理を呼ぶ
+	/// </summary>
+	void Update();
+
+	/// <summary>
+	/// 読み込みが完了しているか
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	/// <returns>完了していればtrue</returns>
+	bool IsLoaded(uint32_t textureHandle) const;
+
+	/// <summary>
+	/// 読み込み世代の取得
+	/// 変わっていればGetResoureDescが返す設定も変わっている（代わりのテクスチャから本来の画像へ等）
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	/// <returns>読み込み世代</returns>
+	uint32_t GetLoadGeneration(uint32_t textureHandle) const;
+
+	/// <summary>
+	/// 非同期読み込み中の数の取得
+	/// </summary>
+	/// <returns>読み込み中の数</returns>
+	uint32_t GetLoadingCount() const { return static_cast<uint32_t>(loadRequests_.size()); }
+
+	/// <summary>
+	/// 読み込み済みのテクスチャ数の取得
+	/// </summary>
+	/// <returns>テクスチャ数（破棄待ちを含む）</returns>
+	uint32_t GetTextureCount() const { return handleAllocator_.GetAllocatedCount(); }
+
+	/// <summary>
+	/// デスクリプタヒープの容量の取得
+	/// </summary>
+	/// <returns>容量</returns>
+	uint32_t GetDescriptorCapacity() const { return handleAllocator_.GetCapacity(); }
+
+	/// <summary>
+	/// アトラスにまとめた画像の範囲を検索（アトラスが解放されるまで有効）
+	/// </summary>
+	/// <param name="fileName">LoadAtlasに渡したファイル名</param>
+	/// <param name="region">画像の範囲</param>
+	/// <returns>見つかればtrue</returns>
+	bool FindAtlasRegion(const std::string& fileName, AtlasRegion& region) const;
+
+	/// <summary>
+	/// 描画に必要なミップを伝える（描画の記録中にどのスレッドからでも呼べる）
+	/// 次のUpdateで、前のフレームに必要だったミップを読み込み、予算を超える分は追い出す
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	/// <param name="screenSize">テクスチャ全体を貼ったときの画面上の大きさ（ピクセル）</param>
+	void RequestMip(uint32_t textureHandle, float screenSize);
+
+	/// <summary>
+	/// 常駐させるミップの予算の設定
+	/// </summary>
+	/// <param name="budget">ミップの合計サイズの上限</param>
+	void SetResidencyBudget(uint64_t budget);
+
+	/// <summary>
+	/// 常駐しているミップの合計サイズの取得
+	/// </summary>
+	/// <returns>サイズ</returns>
+	uint64_t GetResidentSize();
+
+	/// <summary>
+	/// リソース情報取得（非同期読み込み中は代わりのテクスチャの情報、常駐ミップによらず全ミップの設定）
 	/// </summary>
 	/// <param name="textureHandle">テクスチャハンドル</param>
 	/// <returns>リソース情報</returns>
 	const D3D12_RESOURCE_DESC GetResoureDesc(uint32_t textureHandle);
 
 	/// <summary>
-	/// デスクリプタテーブルをセット
+	/// バインドレスで描画するか
+	/// （リソースバインディングTier2以上で有効。テクスチャハンドルがそのままヒープ内の番号になる）
+	/// </summary>
+	/// <returns>バインドレスならtrue</returns>
+	bool IsBindless() const { return bindless_; }
+
+	/// <summary>
+	/// シェーダーのコンパイルに渡すマクロ（バインドレスならBINDLESSを定義）
+	/// </summary>
+	/// <returns>マクロ配列</returns>
+	const D3D_SHADER_MACRO* GetShaderMacros() const;
+
+	/// <summary>
+	/// デスクリプタヒープをセット（コマンドリストごとに1回）
+	/// </summary>
+	/// <param name="commandList">コマンドリスト</param>
+	void SetDescriptorHeap(ID3D12GraphicsCommandList* commandList);
+
+	/// <summary>
+	/// 全テクスチャのデスクリプタテーブルをセット（バインドレス時のみ、コマンドリストごとに1回）
+	/// </summary>
+	/// <param name="commandList">コマンドリスト</param>
+	/// <param name="rootParamIndex">ルートパラメータ番号</param>
+	void SetGraphicsRootTextureTable(ID3D12GraphicsCommandList* commandList, UINT rootParamIndex);
+
+	/// <summary>
+	/// 描画に使うテクスチャをセット
+	/// バインドレス時はルート定数にテクスチャ番号を、そうでなければデスクリプタテーブルをセットする
+	/// </summary>
+	/// <param name="commandList">コマンドリスト</param>
+	/// <param name="rootParamIndex">ルートパラメータ番号</param>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	void SetGraphicsRootTexture(
+	  ID3D12GraphicsCommandList* commandList, UINT rootParamIndex, uint32_t textureHandle);
+
+	/// <summary>
+	/// 1つのテクスチャのデスクリプタテーブルをセット（バインドレスかによらない）
 	/// </summary>
 	/// <param name="commandList">コマンドリスト</param>
 	/// <param name="rootParamIndex">ルートパラメータ番号</param>
@@ -68,6 +272,47 @@ class TextureManager {
 	void SetGraphicsRootDescriptorTable(
 	  ID3D12GraphicsCommandList* commandList, UINT rootParamIndex, uint32_t textureHandle);
 
+  private:
+	// 破棄待ちのハンドル
+	struct PendingFree {
+		uint32_t handle;
+		UINT64 fenceValue;
+	};
+
+	// 拡張前のデスクリプタヒープ（GPUの使用が終わるまで保持）
+	struct RetiredHeap {
+		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> heap;
+		UINT64 fenceValue;
+	};
+
+	// 読み込み要求（ワーカースレッドと共有）
+	struct LoadRequest {
+		// 状態
+		enum class State { kQueued, kDecoding, kDone };
+
+		// フルパス
+		std::string fullPath;
+		// テクスチャハンドル
+		uint32_t handle = 0;
+		// 転送する最も詳細なミップ
+		uint32_t firstMip = 0;
+		// 状態
+		std::atomic<State> state{State::kQueued};
+		// 完了通知
+		std::mutex mutex;
+		std::condition_variable doneCondition;
+		// 生成したテクスチャ
+		Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+		GpuMemoryAllocator::Allocation allocation;
+		D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+		// 全ミップのリソース設定
+		D3D12_RESOURCE_DESC desc{};
+		// ミップごとのサイズ（先頭に置けない小さいミップは末尾にまとめる）
+		std::vector<uint64_t> mipSizes;
+		// 完了時の処理（メインスレッドのみで触る）
+		std::vector<std::function<void(uint32_t)>> callbacks;
+	};
+
   private:
 	TextureManager() = default;
 	~TextureManager() = default;
@@ -80,16 +325,189 @@ class TextureManager {
 	UINT sDescriptorHandleIncrementSize_ = 0u;
 	// ディレクトリパス
 	std::string directoryPath_;
-	// デスクリプタヒープ
-	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> descriptorHeap_;
-	// 次に使うデスクリプタヒープの番号
-	uint32_t indexNextDescriptorHeap_ = 0u;
+	// デスクリプタヒープ（シェーダから見える、フレームごと）
+	std::array<Microsoft::WRL::ComPtr<ID3D12DescriptorHeap>, DirectXCommon::kFrameCount>
+	  descriptorHeaps_;
+	// フレームごとのヒープに未反映のハンドル
+	std::array<std::vector<uint32_t>, DirectXCommon::kFrameCount> dirtyHandles_;
+	// 未反映分を反映したフレーム番号
+	std::atomic<uint64_t> syncedFrameNumber_{UINT64_MAX};
+	// ヒープの反映の排他
+	std::mutex heapMutex_;
+	// デスクリプタヒープの原本（CPUのみ、拡張時のコピー元）
+	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> cpuDescriptorHeap_;
+	// 拡張前のデスクリプタヒープ
+	std::vector<RetiredHeap> retiredHeaps_;
+	// ハンドルの割り当て
+	HandleAllocator handleAllocator_{0};
+	// 破棄待ちのハンドル
+	std::deque<PendingFree> pendingFrees_;
 	// テクスチャコンテナ
-	std::array<Texture, kNumDescriptors> textures_;
+	std::vector<Texture> textures_;
+	// 名前からテクスチャハンドルへの索引
+	AssetNameTable nameTable_;
+	// 非同期読み込み中の要求
+	std::unordered_map<uint32_t, std::shared_ptr<LoadRequest>> loadRequests_;
+	// 常駐ミップの入れ替え中の要求
+	std::unordered_map<uint32_t, std::shared_ptr<LoadRequest>> streamRequests_;
+	// 読み込み中に解放された要求（完了後にリソースを破棄する）
+	std::vector<std::shared_ptr<LoadRequest>> cancelledRequests_;
+	// 正規化したフルパスからアトラス内の範囲への索引
+	std::unordered_map<std::string, AtlasRegion> atlasRegions_;
+	// 常駐させるミップの決定
+	TextureResidency residency_;
+	// 常駐ミップの要求の排他
+	std::mutex residencyMutex_;
+	// 代わりのテクスチャのハンドル
+	uint32_t placeholderHandle_ = HandleAllocator::kInvalidHandle;
+	// バインドレスで描画するか
+	bool bindless_ = false;
 
 	/// <summary>
 	/// 読み込み
 	/// </summary>
 	/// <param name="fileName">ファイル名</param>
 	uint32_t LoadInternal(const std::string& fileName);
+
+	/// <summary>
+	/// 非同期読み込み
+	/// </summary>
+	uint32_t LoadAsyncInternal(
+	  const std::string& fileName, std::function<void(uint32_t)> onLoaded);
+
+	/// <summary>
+	/// アトラスの読み込み
+	/// </summary>
+	uint32_t LoadAtlasInternal(
+	  const std::string& atlasName, const std::vector<std::string>& fileNames);
+
+	/// <summary>
+	/// CPUで作った画像からテクスチャ生成
+	/// </summary>
+	uint32_t CreateFromPixelsInternal(
+	  const std::string& name, DXGI_FORMAT format, uint32_t width, uint32_t height,
+	  const void* pixels, size_t rowPitch);
+
+	/// <summary>
+	/// 生成済みのリソースをテクスチャとして登録
+	/// </summary>
+	uint32_t CreateFromResourceInternal(
+	  const std::string& name, ID3D12Resource* resource,
+	  const D3D12_SHADER_RESOURCE_VIEW_DESC& srvDesc);
+
+	/// <summary>
+	/// 登録済みのハンドルに1ミップの画像を転送し、シェーダリソースビューを作る
+	/// </summary>
+	/// <param name="handle">テクスチャハンドル</param>
+	/// <param name="format">フォーマット</param>
+	/// <param name="width">幅</param>
+	/// <param name="height">高さ</param>
+	/// <param name="pixels">画素</param>
+	/// <param name="rowPitch">1行のバイト数</param>
+	void UploadPixels(
+	  uint32_t handle, DXGI_FORMAT format, uint32_t width, uint32_t height, const void* pixels,
+	  size_t rowPitch);
+
+	/// <summary>
+	/// ディレクトリパスとファイル名を連結してフルパスを得る
+	/// </summary>
+	/// <param name="fileName">ファイル名</param>
+	/// <returns>フルパス</returns>
+	std::string GetFullPath(const std::string& fileName) const;
+
+	/// <summary>
+	/// 読み込み済みか読み込み中のテクスチャを検索し、あれば参照を増やす
+	/// </summary>
+	/// <param name="fileName">ファイル名</param>
+	/// <param name="fullPath">検索のために解決したフルパス（見つからなかったときのみ）</param>
+	/// <returns>テクスチャハンドル（なければ無効）</returns>
+	uint32_t AcquireLoaded(const std::string& fileName, std::string& fullPath);
+
+	/// <summary>
+	/// 新しいテクスチャの登録
+	/// </summary>
+	/// <returns>テクスチャハンドル</returns>
+	uint32_t RegisterTexture(const std::string& fileName, const std::string& fullPath);
+
+	/// <summary>
+	/// 読み込み要求をワーカースレッドで実行する
+	/// </summary>
+	/// <param name="request">読み込み要求</param>
+	static void EnqueueLoadRequest(const std::shared_ptr<LoadRequest>& request);
+
+	/// <summary>
+	/// 読み込み要求の実行権を取ってデコードと転送の予約を行う（どのスレッドからでもよい）
+	/// </summary>
+	/// <param name="request">読み込み要求</param>
+	/// <returns>実行権を取れたらtrue（他のスレッドが実行中ならfalse）</returns>
+	static bool ExecuteLoadRequest(LoadRequest& request);
+
+	/// <summary>
+	/// 読み込み要求の完了待ち
+	/// </summary>
+	/// <param name="request">読み込み要求</param>
+	static void WaitLoadRequest(LoadRequest& request);
+
+	/// <summary>
+	/// 完了した読み込み要求の結果をテクスチャに反映（常駐ミップの入れ替えなら古いリソースを破棄）
+	/// </summary>
+	/// <param name="request">読み込み要求</param>
+	void CompleteLoadRequest(LoadRequest& request);
+
+	/// <summary>
+	/// 常駐させるミップを決めて、変わるテクスチャの読み込み直しを始める
+	/// </summary>
+	void UpdateResidency();
+
+	/// <summary>
+	/// 常駐しているミップのうち粗い方だけを残す（ファイルは読み直さず、GPU上でコピーする）
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	/// <param name="residentMip">残す最も詳細なミップ</param>
+	void DropResidentMips(uint32_t textureHandle, uint32_t residentMip);
+
+	/// <summary>
+	/// 解放
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	void UnloadInternal(uint32_t textureHandle);
+
+	/// <summary>
+	/// ハンドルの確保（足りなければヒープを拡張する）
+	/// </summary>
+	/// <returns>テクスチャハンドル</returns>
+	uint32_t AllocateHandle();
+
+	/// <summary>
+	/// デスクリプタヒープを生成し直す（既存のデスクリプタは引き継ぐ）
+	/// </summary>
+	/// <param name="capacity">容量</param>
+	void CreateDescriptorHeaps(uint32_t capacity);
+
+	/// <summary>
+	/// GPUの使用が終わったハンドルとヒープの回収
+	/// </summary>
+	void CollectGarbage();
+
+	/// <summary>
+	/// 現在のフレームのヒープに未反映のデスクリプタをコピーする
+	/// </summary>
+	/// <returns>現在のフレームのヒープ</returns>
+	ID3D12DescriptorHeap* SyncDescriptorHeap();
+
+	/// <summary>
+	/// 原本のデスクリプタをシェーダから見えるヒープへ反映
+	/// 現在のフレームのヒープにはすぐに、他のフレームのヒープにはGPUの使用後にコピーする
+	/// </summary>
+	/// <param name="handle">テクスチャハンドル</param>
+	void PublishDescriptor(uint32_t handle);
+
+	/// <summary>
+	/// シェーダリソースビューの書き込み（原本に作成してシェーダから見えるヒープへコピー）
+	/// </summary>
+	/// <param name="handle">テクスチャハンドル</param>
+	/// <param name="resource">リソース（nullptrならヌルのビュー）</param>
+	/// <param name="srvDesc">ビューの設定</param>
+	void WriteDescriptor(
+	  uint32_t handle, ID3D12Resource* resource, const D3D12_SHADER_RESOURCE_VIEW_DESC& srvDesc);
 };
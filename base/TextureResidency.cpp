@@ -0,0 +1,143 @@
+﻿#include "TextureResidency.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+uint32_t TextureResidency::ComputeMip(uint32_t textureSize, float screenSize, uint32_t mipCount) {
+	assert(mipCount > 0);
+	// 画面上の1ピクセルに並ぶテクセル数が1以下になるミップ
+	if (!(screenSize > 0.0f)) {
+		return mipCount - 1;
+	}
+	float ratio = static_cast<float>(textureSize) / screenSize;
+	if (ratio <= 1.0f) {
+		return 0;
+	}
+	uint32_t mip = static_cast<uint32_t>(std::floor(std::log2(ratio)));
+	return (std::min)(mip, mipCount - 1);
+}
+
+void TextureResidency::Add(
+  uint32_t id, const std::vector<uint64_t>& mipSizes, uint32_t residentMip) {
+	assert(!mipSizes.empty());
+	assert(residentMip < mipSizes.size());
+
+	if (entries_.size() <= id) {
+		entries_.resize(id + 1);
+	}
+	Entry& entry = entries_[id];
+	assert(!entry.valid);
+
+	// 粗い方から足し込んでおく
+	entry = Entry();
+	entry.valid = true;
+	entry.sizeFrom.assign(mipSizes.size() + 1, 0);
+	for (size_t i = mipSizes.size(); i > 0; i--) {
+		entry.sizeFrom[i - 1] = entry.sizeFrom[i] + mipSizes[i - 1];
+	}
+	entry.residentMip = residentMip;
+}
+
+void TextureResidency::Remove(uint32_t id) {
+	if (id < entries_.size()) {
+		entries_[id] = Entry();
+	}
+}
+
+void TextureResidency::Request(uint32_t id, uint32_t mip) {
+	if (id >= entries_.size() || !entries_[id].valid) {
+		return;
+	}
+	Entry& entry = entries_[id];
+	entry.requestedMip = (std::min)(entry.requestedMip, mip);
+}
+
+void TextureResidency::SetResidentMip(uint32_t id, uint32_t residentMip) {
+	assert(id < entries_.size() && entries_[id].valid);
+	entries_[id].residentMip = (std::min)(residentMip, entries_[id].GetCoarsestMip());
+}
+
+void TextureResidency::Update(uint64_t frame, std::vector<Change>& changes) {
+	changes.clear();
+
+	// 使われたものは必要なミップまで読み込む（粗くするのは予算を超えたときだけ）
+	uint64_t total = 0;
+	std::vector<uint32_t> order;
+	for (uint32_t id = 0; id < entries_.size(); id++) {
+		Entry& entry = entries_[id];
+		if (!entry.valid) {
+			continue;
+		}
+		entry.targetMip = entry.residentMip;
+		if (entry.requestedMip != UINT32_MAX) {
+			entry.requestedMip = (std::min)(entry.requestedMip, entry.GetCoarsestMip());
+			entry.targetMip = (std::min)(entry.targetMip, entry.requestedMip);
+			entry.lastUsedFrame = frame;
+		}
+		total += entry.sizeFrom[entry.targetMip];
+		order.push_back(id);
+	}
+
+	if (total > budget_) {
+		// 長く使われていない順（同じなら番号順）
+		std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+			if (entries_[a].lastUsedFrame != entries_[b].lastUsedFrame) {
+				return entries_[a].lastUsedFrame < entries_[b].lastUsedFrame;
+			}
+			return a < b;
+		});
+
+		// まずは必要以上に詳細なミップから、それでも足りなければ見えているものも粗くする
+		Evict(order, true, total);
+		Evict(order, false, total);
+	}
+
+	// 変更を取り出して要求をリセット
+	for (uint32_t id : order) {
+		Entry& entry = entries_[id];
+		if (entry.targetMip != entry.residentMip) {
+			changes.push_back({id, entry.targetMip});
+		}
+		entry.requestedMip = UINT32_MAX;
+	}
+	std::sort(changes.begin(), changes.end(), [](const Change& a, const Change& b) {
+		return a.id < b.id;
+	});
+}
+
+uint32_t TextureResidency::GetResidentMip(uint32_t id) const {
+	assert(id < entries_.size() && entries_[id].valid);
+	return entries_[id].residentMip;
+}
+
+uint64_t TextureResidency::GetResidentSize() const {
+	uint64_t total = 0;
+	for (const Entry& entry : entries_) {
+		if (entry.valid) {
+			total += entry.sizeFrom[entry.residentMip];
+		}
+	}
+	return total;
+}
+
+void TextureResidency::Evict(
+  const std::vector<uint32_t>& order, bool useRequestedMip, uint64_t& total) {
+	for (uint32_t id : order) {
+		if (total <= budget_) {
+			return;
+		}
+		Entry& entry = entries_[id];
+
+		// 使われていなければ最も粗いミップまで落としてよい
+		uint32_t floorMip = entry.GetCoarsestMip();
+		if (useRequestedMip && entry.requestedMip != UINT32_MAX) {
+			floorMip = entry.requestedMip;
+		}
+
+		// 1段ずつ粗くする
+		while (entry.targetMip < floorMip && total > budget_) {
+			total -= entry.sizeFrom[entry.targetMip] - entry.sizeFrom[entry.targetMip + 1];
+			entry.targetMip++;
+		}
+	}
+}
@@ -0,0 +1,128 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// テクスチャの常駐ミップの決定（予算内でLRU順に追い出す）
+/// 描画時の画面上の大きさから必要なミップを受け取り、フレームごとに常駐させるミップを決める。
+/// ミップの大きさと番号だけを扱うので、デバイスなしで動作する
+/// </summary>
+class TextureResidency {
+  public: // サブクラス
+	// 常駐ミップの変更
+	struct Change {
+		// テクスチャの番号
+		uint32_t id;
+		// 常駐させる最も詳細なミップ
+		uint32_t residentMip;
+	};
+
+  public: // 静的メンバ関数
+	/// <summary>
+	/// 画面上の大きさから必要なミップを求める
+	/// </summary>
+	/// <param name="textureSize">テクスチャの辺の長さ（ピクセル）</param>
+	/// <param name="screenSize">画面上の大きさ（ピクセル）</param>
+	/// <param name="mipCount">ミップ数</param>
+	/// <returns>ミップ番号</returns>
+	static uint32_t ComputeMip(uint32_t textureSize, float screenSize, uint32_t mipCount);
+
+  public: // メンバ関数
+	/// <summary>
+	/// 予算の設定
+	/// </summary>
+	/// <param name="budget">常駐させるミップの合計サイズの上限</param>
+	void SetBudget(uint64_t budget) { budget_ = budget; }
+
+	uint64_t GetBudget() const { return budget_; }
+
+	/// <summary>
+	/// テクスチャの追加
+	/// </summary>
+	/// <param name="id">テクスチャの番号</param>
+	/// <param name="mipSizes">ミップごとのサイズ（詳細な順）</param>
+	/// <param name="residentMip">常駐している最も詳細なミップ</param>
+	void Add(uint32_t id, const std::vector<uint64_t>& mipSizes, uint32_t residentMip);
+
+	/// <summary>
+	/// 全テクスチャの削除（予算はそのまま）
+	/// </summary>
+	void Clear() { entries_.clear(); }
+
+	/// <summary>
+	/// テクスチャの削除
+	/// </summary>
+	/// <param name="id">テクスチャの番号</param>
+	void Remove(uint32_t id);
+
+	/// <summary>
+	/// 描画に必要なミップを伝える（次のUpdateまでで最も詳細なものを使う）
+	/// </summary>
+	/// <param name="id">テクスチャの番号</param>
+	/// <param name="mip">必要なミップ</param>
+	void Request(uint32_t id, uint32_t mip);
+
+	/// <summary>
+	/// 常駐ミップが変わったことを伝える（読み込みの完了時）
+	/// </summary>
+	/// <param name="id">テクスチャの番号</param>
+	/// <param name="residentMip">常駐している最も詳細なミップ</param>
+	void SetResidentMip(uint32_t id, uint32_t residentMip);
+
+	/// <summary>
+	/// 常駐させるミップを決める
+	/// 必要なミップまで読み込み、予算を超える分は長く使われていないものから粗いミップへ落とす
+	/// </summary>
+	/// <param name="frame">フレーム番号</param>
+	/// <param name="changes">常駐ミップを変えるテクスチャ</param>
+	void Update(uint64_t frame, std::vector<Change>& changes);
+
+	/// <summary>
+	/// 常駐している最も詳細なミップの取得
+	/// </summary>
+	/// <param name="id">テクスチャの番号</param>
+	/// <returns>ミップ番号</returns>
+	uint32_t GetResidentMip(uint32_t id) const;
+
+	/// <summary>
+	/// 常駐しているミップの合計サイズの取得
+	/// </summary>
+	/// <returns>サイズ</returns>
+	uint64_t GetResidentSize() const;
+
+  private: // サブクラス
+	// テクスチャごとの情報
+	struct Entry {
+		// 登録済みか
+		bool valid = false;
+		// ミップ以降の合計サイズ（[i] はミップi以降、末尾は0）
+		std::vector<uint64_t> sizeFrom;
+		// 常駐している最も詳細なミップ
+		uint32_t residentMip = 0;
+		// 今回の必要なミップ（要求がなければ無効）
+		uint32_t requestedMip = UINT32_MAX;
+		// 最後に使われたフレーム番号
+		uint64_t lastUsedFrame = 0;
+		// 決定中の常駐ミップ
+		uint32_t targetMip = 0;
+
+		// 最も粗いミップ
+		uint32_t GetCoarsestMip() const { return static_cast<uint32_t>(sizeFrom.size() - 2); }
+	};
+
+  private: // メンバ関数
+	/// <summary>
+	/// 予算に収まるまで、候補を順に指定のミップまで粗くする
+	/// </summary>
+	/// <param name="order">候補（優先して落とす順）</param>
+	/// <param name="useRequestedMip">必要なミップより粗くしないならtrue</param>
+	/// <param name="total">決定中の合計サイズ</param>
+	void Evict(const std::vector<uint32_t>& order, bool useRequestedMip, uint64_t& total);
+
+  private: // メンバ変数
+	// 予算
+	uint64_t budget_ = UINT64_MAX;
+	// テクスチャごとの情報（番号で引く）
+	std::vector<Entry> entries_;
+};
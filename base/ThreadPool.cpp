@@ -0,0 +1,120 @@
+﻿#include "ThreadPool.h"
+#include <algorithm>
+#include <memory>
+
+ThreadPool* ThreadPool::GetInstance() {
+	static ThreadPool instance;
+	return &instance;
+}
+
+ThreadPool::ThreadPool(uint32_t threadCount) {
+	if (threadCount == 0) {
+		// 呼び出し元スレッドの分を除く
+		uint32_t hardwareCount = std::thread::hardware_concurrency();
+		threadCount = (std::max)(hardwareCount, 2u) - 1;
+	}
+
+	workers_.reserve(threadCount);
+	for (uint32_t i = 0; i < threadCount; i++) {
+		workers_.emplace_back(&ThreadPool::WorkerMain, this);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+	taskCondition_.notify_all();
+
+	for (std::thread& worker : workers_) {
+		worker.join();
+	}
+}
+
+void ThreadPool::Enqueue(std::function<void()> task) {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		tasks_.emplace_back(std::move(task));
+	}
+	taskCondition_.notify_one();
+}
+
+void ThreadPool::ParallelFor(uint32_t count, const std::function<void(uint32_t index)>& func) {
+	if (count == 0) {
+		return;
+	}
+
+	// 1要素かワーカーなしなら呼び出し元で処理
+	if (count == 1 || workers_.empty()) {
+		for (uint32_t i = 0; i < count; i++) {
+			func(i);
+		}
+		return;
+	}
+
+	// ヘルパータスクと共有する状態（呼び出し元が先に戻ってもいいように共有所有）
+	struct Shared {
+		std::atomic<uint32_t> next{0};
+		std::atomic<uint32_t> done{0};
+		std::mutex mutex;
+		std::condition_variable condition;
+	};
+	auto shared = std::make_shared<Shared>();
+	const std::function<void(uint32_t)>* pFunc = &func;
+
+	// 未処理の要素を取り出して処理する
+	auto run = [shared, pFunc, count]() {
+		uint32_t index;
+		while ((index = shared->next.fetch_add(1)) < count) {
+			(*pFunc)(index);
+			if (shared->done.fetch_add(1) + 1 == count) {
+				std::lock_guard<std::mutex> lock(shared->mutex);
+				shared->condition.notify_all();
+			}
+		}
+	};
+
+	uint32_t helperCount = (std::min)(count - 1, GetThreadCount());
+	for (uint32_t i = 0; i < helperCount; i++) {
+		Enqueue(run);
+	}
+
+	// 呼び出し元も処理に参加
+	run();
+
+	// 全要素の完了待ち
+	std::unique_lock<std::mutex> lock(shared->mutex);
+	shared->condition.wait(lock, [&]() { return shared->done.load() == count; });
+}
+
+void ThreadPool::WaitIdle() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	idleCondition_.wait(lock, [this]() { return tasks_.empty() && runningCount_ == 0; });
+}
+
+void ThreadPool::WorkerMain() {
+	while (true) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			taskCondition_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+			if (stop_ && tasks_.empty()) {
+				return;
+			}
+			task = std::move(tasks_.front());
+			tasks_.pop_front();
+			runningCount_++;
+		}
+
+		task();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			runningCount_--;
+			if (tasks_.empty() && runningCount_ == 0) {
+				idleCondition_.notify_all();
+			}
+		}
+	}
+}
@@ -0,0 +1,81 @@
+﻿#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// ワーカースレッドプール
+/// </summary>
+class ThreadPool {
+  public:
+	/// <summary>
+	/// シングルトンインスタンスの取得
+	/// </summary>
+	/// <returns>シングルトンインスタンス</returns>
+	static ThreadPool* GetInstance();
+
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="threadCount">ワーカー数（0ならハードウェアスレッド数-1）</param>
+	explicit ThreadPool(uint32_t threadCount = 0);
+
+	/// <summary>
+	/// デストラクタ
+	/// </summary>
+	~ThreadPool();
+
+	/// <summary>
+	/// ワーカー数の取得
+	/// </summary>
+	/// <returns>ワーカー数</returns>
+	uint32_t GetThreadCount() const { return static_cast<uint32_t>(workers_.size()); }
+
+	/// <summary>
+	/// タスクの追加
+	/// </summary>
+	/// <param name="task">タスク</param>
+	void Enqueue(std::function<void()> task);
+
+	/// <summary>
+	/// 並列ループ。呼び出し元スレッドも処理に参加し、全て終わるまで戻らない
+	/// </summary>
+	/// <param name="count">要素数</param>
+	/// <param name="func">要素ごとの処理</param>
+	void ParallelFor(uint32_t count, const std::function<void(uint32_t index)>& func);
+
+	/// <summary>
+	/// 追加済みタスクの完了待ち
+	/// </summary>
+	void WaitIdle();
+
+  private:
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/// <summary>
+	/// ワーカースレッドの処理
+	/// </summary>
+	void WorkerMain();
+
+	// ワーカースレッド
+	std::vector<std::thread> workers_;
+	// タスクキュー
+	std::deque<std::function<void()>> tasks_;
+	// キュー保護
+	std::mutex mutex_;
+	// タスク追加通知
+	std::condition_variable taskCondition_;
+	// 完了通知
+	std::condition_variable idleCondition_;
+	// 実行中タスク数
+	uint32_t runningCount_ = 0;
+	// 終了フラグ
+	bool stop_ = false;
+};
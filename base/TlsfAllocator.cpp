@@ -0,0 +1,349 @@
+﻿#include "TlsfAllocator.h"
+#include <algorithm>
+#include <cassert>
+
+namespace {
+
+// 最上位ビットの位置
+uint32_t FindLastSet(uint64_t value) {
+	assert(value != 0);
+	uint32_t bit = 0;
+	while (value >>= 1) {
+		bit++;
+	}
+	return bit;
+}
+
+// 最下位ビットの位置
+uint32_t FindFirstSet(uint64_t value) {
+	assert(value != 0);
+	uint32_t bit = 0;
+	while ((value & 1) == 0) {
+		value >>= 1;
+		bit++;
+	}
+	return bit;
+}
+
+// 切り上げ（alignmentは2のべき乗）
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+TlsfAllocator::TlsfAllocator(uint64_t capacity, uint64_t granularity)
+    : capacity_(capacity), granularity_(granularity) {
+	// 最小単位は2のべき乗、容量はその倍数
+	assert(granularity_ > 0 && (granularity_ & (granularity_ - 1)) == 0);
+	assert(capacity_ > 0 && capacity_ % granularity_ == 0);
+
+	for (uint32_t fl = 0; fl < kFirstLevelCount; fl++) {
+		for (uint32_t sl = 0; sl < kSecondLevelCount; sl++) {
+			freeLists_[fl][sl] = kInvalidBlock;
+		}
+	}
+
+	// 全体を1つの空きブロックにする
+	firstBlock_ = NewBlock();
+	blocks_[firstBlock_].offset = 0;
+	blocks_[firstBlock_].size = capacity_;
+	blocks_[firstBlock_].isFree = true;
+	InsertFreeBlock(firstBlock_);
+}
+
+TlsfAllocator::Allocation TlsfAllocator::Allocate(uint64_t size, uint64_t alignment) {
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+	Allocation allocation;
+
+	size = AlignUp((std::max)(size, uint64_t(1)), granularity_);
+	alignment = (std::max)(alignment, granularity_);
+	// 境界合わせで先頭を捨てても収まるサイズで探す
+	uint64_t searchSize = size + (alignment - granularity_);
+	if (searchSize > capacity_) {
+		return allocation;
+	}
+
+	// 切り上げたリストから探す
+	uint32_t fl, sl;
+	MappingSearch(searchSize, fl, sl);
+	uint32_t block = FindSuitableBlock(fl, sl);
+
+	// 見つからなければ、同じリスト内で収まるブロックを探す
+	if (block == kInvalidBlock) {
+		MappingInsert(searchSize, fl, sl);
+		for (uint32_t b = freeLists_[fl][sl]; b != kInvalidBlock; b = blocks_[b].nextFree) {
+			if (blocks_[b].size >= searchSize) {
+				block = b;
+				break;
+			}
+		}
+	}
+	if (block == kInvalidBlock) {
+		return allocation;
+	}
+	RemoveFreeBlock(block);
+
+	// 先頭の詰め物を空きブロックとして切り離す
+	uint64_t padding = AlignUp(blocks_[block].offset, alignment) - blocks_[block].offset;
+	if (padding > 0) {
+		uint32_t back = Split(block, padding);
+		InsertFreeBlock(block);
+		block = back;
+	}
+
+	// 余りを空きブロックとして切り離す
+	if (blocks_[block].size > size) {
+		uint32_t rest = Split(block, size);
+		InsertFreeBlock(rest);
+	}
+
+	Block& b = blocks_[block];
+	b.isFree = false;
+	b.alignment = alignment;
+	allocationCount_++;
+	usedSize_ += b.size;
+
+	allocation.offset = b.offset;
+	allocation.size = b.size;
+	allocation.block = block;
+	return allocation;
+}
+
+void TlsfAllocator::Free(const Allocation& allocation) {
+	uint32_t block = allocation.block;
+	assert(block < blocks_.size());
+	assert(!blocks_[block].isFree);
+
+	blocks_[block].isFree = true;
+	allocationCount_--;
+	usedSize_ -= blocks_[block].size;
+
+	// 後ろの空きブロックと結合
+	uint32_t next = blocks_[block].nextPhysical;
+	if (next != kInvalidBlock && blocks_[next].isFree) {
+		RemoveFreeBlock(next);
+		MergeWithNext(block);
+	}
+
+	// 前の空きブロックと結合
+	uint32_t prev = blocks_[block].prevPhysical;
+	if (prev != kInvalidBlock && blocks_[prev].isFree) {
+		RemoveFreeBlock(prev);
+		MergeWithNext(prev);
+		block = prev;
+	}
+
+	InsertFreeBlock(block);
+}
+
+TlsfAllocator::Stats TlsfAllocator::GetStats() const {
+	Stats stats;
+	stats.capacity = capacity_;
+	stats.usedSize = usedSize_;
+	stats.allocationCount = allocationCount_;
+
+	for (uint32_t b = firstBlock_; b != kInvalidBlock; b = blocks_[b].nextPhysical) {
+		if (blocks_[b].isFree) {
+			stats.freeSize += blocks_[b].size;
+			stats.largestFreeBlock = (std::max)(stats.largestFreeBlock, blocks_[b].size);
+			stats.freeBlockCount++;
+		}
+	}
+	return stats;
+}
+
+bool TlsfAllocator::Validate() const {
+	uint64_t expectedOffset = 0;
+	uint32_t prev = kInvalidBlock;
+	uint32_t freeCount = 0;
+	uint32_t usedCount = 0;
+	uint64_t usedSize = 0;
+
+	// 物理順の連続性
+	for (uint32_t b = firstBlock_; b != kInvalidBlock; b = blocks_[b].nextPhysical) {
+		const Block& block = blocks_[b];
+		if (block.offset != expectedOffset || block.size == 0 || block.prevPhysical != prev) {
+			return false;
+		}
+		if (block.offset % granularity_ != 0 || block.size % granularity_ != 0) {
+			return false;
+		}
+		if (block.isFree) {
+			// 隣り合う空きブロックは結合されているはず
+			if (prev != kInvalidBlock && blocks_[prev].isFree) {
+				return false;
+			}
+			freeCount++;
+		} else {
+			if (block.offset % block.alignment != 0) {
+				return false;
+			}
+			usedCount++;
+			usedSize += block.size;
+		}
+		expectedOffset += block.size;
+		prev = b;
+	}
+	if (expectedOffset != capacity_ || usedCount != allocationCount_ || usedSize != usedSize_) {
+		return false;
+	}
+
+	// 空きリストとビットマップ
+	uint32_t listedCount = 0;
+	for (uint32_t fl = 0; fl < kFirstLevelCount; fl++) {
+		bool anySecondLevel = secondLevelBitmaps_[fl] != 0;
+		if (anySecondLevel != ((firstLevelBitmap_ >> fl) & 1)) {
+			return false;
+		}
+		for (uint32_t sl = 0; sl < kSecondLevelCount; sl++) {
+			bool hasBlock = freeLists_[fl][sl] != kInvalidBlock;
+			if (hasBlock != ((secondLevelBitmaps_[fl] >> sl) & 1)) {
+				return false;
+			}
+			uint32_t prevFree = kInvalidBlock;
+			for (uint32_t b = freeLists_[fl][sl]; b != kInvalidBlock; b = blocks_[b].nextFree) {
+				uint32_t blockFl, blockSl;
+				MappingInsert(blocks_[b].size, blockFl, blockSl);
+				if (!blocks_[b].isFree || blocks_[b].prevFree != prevFree || blockFl != fl ||
+				    blockSl != sl) {
+					return false;
+				}
+				listedCount++;
+				prevFree = b;
+			}
+		}
+	}
+	return listedCount == freeCount;
+}
+
+void TlsfAllocator::MappingInsert(uint64_t size, uint32_t& fl, uint32_t& sl) const {
+	uint64_t units = size / granularity_;
+	if (units < kSecondLevelCount) {
+		// 小さいサイズは第1レベル0に線形に並べる
+		fl = 0;
+		sl = static_cast<uint32_t>(units);
+	} else {
+		uint32_t msb = FindLastSet(units);
+		fl = msb - kSecondLevelBits + 1;
+		sl = static_cast<uint32_t>(units >> (msb - kSecondLevelBits)) - kSecondLevelCount;
+	}
+	assert(fl < kFirstLevelCount);
+}
+
+void TlsfAllocator::MappingSearch(uint64_t size, uint32_t& fl, uint32_t& sl) const {
+	uint64_t units = size / granularity_;
+	if (units >= kSecondLevelCount) {
+		// 同じリスト内で最小のブロックでも収まるよう、次のリストまで切り上げる
+		units += (uint64_t(1) << (FindLastSet(units) - kSecondLevelBits)) - 1;
+	}
+	MappingInsert(units * granularity_, fl, sl);
+}
+
+uint32_t TlsfAllocator::FindSuitableBlock(uint32_t& fl, uint32_t& sl) const {
+	// 同じ第1レベルでsl以上
+	uint32_t secondLevelMap = secondLevelBitmaps_[fl] & (~0u << sl);
+	if (secondLevelMap == 0) {
+		// より大きい第1レベル
+		if (fl + 1 >= kFirstLevelCount) {
+			return kInvalidBlock;
+		}
+		uint64_t firstLevelMap = firstLevelBitmap_ & (~uint64_t(0) << (fl + 1));
+		if (firstLevelMap == 0) {
+			return kInvalidBlock;
+		}
+		fl = FindFirstSet(firstLevelMap);
+		secondLevelMap = secondLevelBitmaps_[fl];
+	}
+	sl = FindFirstSet(secondLevelMap);
+	return freeLists_[fl][sl];
+}
+
+void TlsfAllocator::InsertFreeBlock(uint32_t block) {
+	uint32_t fl, sl;
+	MappingInsert(blocks_[block].size, fl, sl);
+
+	Block& b = blocks_[block];
+	b.isFree = true;
+	b.prevFree = kInvalidBlock;
+	b.nextFree = freeLists_[fl][sl];
+	if (b.nextFree != kInvalidBlock) {
+		blocks_[b.nextFree].prevFree = block;
+	}
+	freeLists_[fl][sl] = block;
+
+	firstLevelBitmap_ |= uint64_t(1) << fl;
+	secondLevelBitmaps_[fl] |= 1u << sl;
+}
+
+void TlsfAllocator::RemoveFreeBlock(uint32_t block) {
+	uint32_t fl, sl;
+	MappingInsert(blocks_[block].size, fl, sl);
+
+	Block& b = blocks_[block];
+	if (b.prevFree != kInvalidBlock) {
+		blocks_[b.prevFree].nextFree = b.nextFree;
+	} else {
+		freeLists_[fl][sl] = b.nextFree;
+	}
+	if (b.nextFree != kInvalidBlock) {
+		blocks_[b.nextFree].prevFree = b.prevFree;
+	}
+	b.prevFree = kInvalidBlock;
+	b.nextFree = kInvalidBlock;
+
+	// リストが空になったらビットを落とす
+	if (freeLists_[fl][sl] == kInvalidBlock) {
+		secondLevelBitmaps_[fl] &= ~(1u << sl);
+		if (secondLevelBitmaps_[fl] == 0) {
+			firstLevelBitmap_ &= ~(uint64_t(1) << fl);
+		}
+	}
+}
+
+uint32_t TlsfAllocator::Split(uint32_t block, uint64_t size) {
+	assert(size < blocks_[block].size);
+
+	// NewBlockでblocks_が伸びるので参照は後で取る
+	uint32_t back = NewBlock();
+	Block& front = blocks_[block];
+	Block& b = blocks_[back];
+
+	b.offset = front.offset + size;
+	b.size = front.size - size;
+	b.isFree = front.isFree;
+	b.prevPhysical = block;
+	b.nextPhysical = front.nextPhysical;
+	if (b.nextPhysical != kInvalidBlock) {
+		blocks_[b.nextPhysical].prevPhysical = back;
+	}
+	front.size = size;
+	front.nextPhysical = back;
+	return back;
+}
+
+void TlsfAllocator::MergeWithNext(uint32_t block) {
+	uint32_t next = blocks_[block].nextPhysical;
+	assert(next != kInvalidBlock);
+
+	blocks_[block].size += blocks_[next].size;
+	blocks_[block].nextPhysical = blocks_[next].nextPhysical;
+	if (blocks_[block].nextPhysical != kInvalidBlock) {
+		blocks_[blocks_[block].nextPhysical].prevPhysical = block;
+	}
+	DeleteBlock(next);
+}
+
+uint32_t TlsfAllocator::NewBlock() {
+	if (!unusedBlocks_.empty()) {
+		uint32_t block = unusedBlocks_.back();
+		unusedBlocks_.pop_back();
+		blocks_[block] = Block();
+		return block;
+	}
+	blocks_.emplace_back();
+	return static_cast<uint32_t>(blocks_.size() - 1);
+}
+
+void TlsfAllocator::DeleteBlock(uint32_t block) { unusedBlocks_.push_back(block); }
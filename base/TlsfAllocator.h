@@ -0,0 +1,163 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// TLSF（Two-Level Segregated Fit）による範囲の割り当て
+/// [0, 容量) のオフセットを管理するだけでメモリには触れないので、デバイスなしで動作する。
+/// 確保・解放とも定数時間
+/// </summary>
+class TlsfAllocator {
+  public: // 定数
+	// 無効なブロック番号
+	static const uint32_t kInvalidBlock = UINT32_MAX;
+	// 第2レベルの分割数（2のべき）
+	static const uint32_t kSecondLevelBits = 4;
+	static const uint32_t kSecondLevelCount = 1u << kSecondLevelBits;
+	// 第1レベルの数
+	static const uint32_t kFirstLevelCount = 64 - kSecondLevelBits;
+
+  public: // サブクラス
+	// 確保した範囲
+	struct Allocation {
+		uint64_t offset = 0;
+		uint64_t size = 0;
+		uint32_t block = kInvalidBlock; // 解放に使う番号
+
+		bool IsValid() const { return block != kInvalidBlock; }
+	};
+
+	// 統計
+	struct Stats {
+		uint64_t capacity = 0;         // 容量
+		uint64_t usedSize = 0;         // 使用中のサイズ（アライメントの詰め物を除く）
+		uint64_t freeSize = 0;         // 空きサイズ
+		uint64_t largestFreeBlock = 0; // 最大の連続空き領域
+		uint32_t allocationCount = 0;  // 確保数
+		uint32_t freeBlockCount = 0;   // 空きブロック数
+	};
+
+  public: // メンバ関数
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="capacity">容量</param>
+	/// <param name="granularity">最小単位（2のべき乗、オフセットとサイズはこの倍数になる）</param>
+	TlsfAllocator(uint64_t capacity, uint64_t granularity);
+
+	/// <summary>
+	/// 確保
+	/// </summary>
+	/// <param name="size">サイズ</param>
+	/// <param name="alignment">オフセットのアライメント（2のべき乗）</param>
+	/// <returns>確保した範囲（空きがなければ無効）</returns>
+	Allocation Allocate(uint64_t size, uint64_t alignment);
+
+	/// <summary>
+	/// 解放（隣接する空きブロックと結合する）
+	/// </summary>
+	/// <param name="allocation">確保した範囲</param>
+	void Free(const Allocation& allocation);
+
+	/// <summary>
+	/// 全て空の状態か
+	/// </summary>
+	/// <returns>確保がなければtrue</returns>
+	bool IsEmpty() const { return allocationCount_ == 0; }
+
+	/// <summary>
+	/// 統計の取得
+	/// </summary>
+	/// <returns>統計</returns>
+	Stats GetStats() const;
+
+	/// <summary>
+	/// 内部構造の整合性チェック（物理順の連続性、空きリストとビットマップの一致）
+	/// </summary>
+	/// <returns>整合していればtrue</returns>
+	bool Validate() const;
+
+  private: // サブクラス
+	// ブロック（物理的に隣接する順と、空きリストの両方でつなぐ）
+	struct Block {
+		uint64_t offset = 0;
+		uint64_t size = 0;
+		uint64_t alignment = 0;
+		uint32_t prevPhysical = kInvalidBlock;
+		uint32_t nextPhysical = kInvalidBlock;
+		uint32_t prevFree = kInvalidBlock;
+		uint32_t nextFree = kInvalidBlock;
+		bool isFree = false;
+	};
+
+  private: // メンバ関数
+	/// <summary>
+	/// サイズから格納先のリスト番号を求める
+	/// </summary>
+	void MappingInsert(uint64_t size, uint32_t& fl, uint32_t& sl) const;
+
+	/// <summary>
+	/// サイズから、必ず収まるブロックのあるリスト番号を求める（切り上げ）
+	/// </summary>
+	void MappingSearch(uint64_t size, uint32_t& fl, uint32_t& sl) const;
+
+	/// <summary>
+	/// 指定リスト以上で空きのあるリストを探す
+	/// </summary>
+	/// <returns>ブロック番号</returns>
+	uint32_t FindSuitableBlock(uint32_t& fl, uint32_t& sl) const;
+
+	/// <summary>
+	/// 空きリストへ追加
+	/// </summary>
+	void InsertFreeBlock(uint32_t block);
+
+	/// <summary>
+	/// 空きリストから外す
+	/// </summary>
+	void RemoveFreeBlock(uint32_t block);
+
+	/// <summary>
+	/// ブロックを前半sizeと後半に分割する
+	/// </summary>
+	/// <returns>後半のブロック番号</returns>
+	uint32_t Split(uint32_t block, uint64_t size);
+
+	/// <summary>
+	/// 空きブロックを物理的に次のブロックと結合する
+	/// </summary>
+	void MergeWithNext(uint32_t block);
+
+	/// <summary>
+	/// ブロックの生成
+	/// </summary>
+	uint32_t NewBlock();
+
+	/// <summary>
+	/// ブロックの破棄
+	/// </summary>
+	void DeleteBlock(uint32_t block);
+
+  private: // メンバ変数
+	// 容量
+	uint64_t capacity_ = 0;
+	// 最小単位
+	uint64_t granularity_ = 0;
+	// ブロック
+	std::vector<Block> blocks_;
+	// 再利用するブロック番号
+	std::vector<uint32_t> unusedBlocks_;
+	// 物理的に先頭のブロック
+	uint32_t firstBlock_ = kInvalidBlock;
+	// 空きリストの先頭
+	uint32_t freeLists_[kFirstLevelCount][kSecondLevelCount];
+	// 空きのある第1レベル
+	uint64_t firstLevelBitmap_ = 0;
+	// 空きのある第2レベル
+	uint32_t secondLevelBitmaps_[kFirstLevelCount] = {};
+	// 確保数
+	uint32_t allocationCount_ = 0;
+	// 使用中のサイズ
+	uint64_t usedSize_ = 0;
+};
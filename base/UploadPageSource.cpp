@@ -0,0 +1,47 @@
+﻿#include "UploadPageSource.h"
+#include <cassert>
+#include <d3dx12.h>
+
+UploadPageSource::UploadPageSource(ID3D12Device* device) : device_(device) { assert(device_); }
+
+LinearAllocator::Page UploadPageSource::CreatePage(size_t size) {
+	HRESULT result;
+
+	// ヒーププロパティ
+	CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	// リソース設定
+	CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(size);
+
+	// ページ用バッファの生成
+	Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+	result = device_->CreateCommittedResource(
+	  &heapProps, // アップロード可能
+	  D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
+	  IID_PPV_ARGS(&resource));
+	assert(SUCCEEDED(result));
+
+	LinearAllocator::Page page;
+	// 解放するまでマップしたままにする
+	result = resource->Map(0, nullptr, (void**)&page.cpuAddress);
+	assert(SUCCEEDED(result));
+	page.gpuAddress = resource->GetGPUVirtualAddress();
+	page.size = size;
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	page.id = nextId_++;
+	resources_.emplace(page.id, resource);
+
+	return page;
+}
+
+ID3D12Resource* UploadPageSource::GetResource(uint32_t pageId) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto it = resources_.find(pageId);
+	assert(it != resources_.end());
+	return it->second.Get();
+}
+
+void UploadPageSource::ReleasePage(const LinearAllocator::Page& page) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	resources_.erase(page.id);
+}
@@ -0,0 +1,41 @@
+﻿#pragma once
+
+#include "LinearAllocator.h"
+#include <d3d12.h>
+#include <mutex>
+#include <unordered_map>
+#include <wrl.h>
+
+/// <summary>
+/// アップロードヒープのページ生成
+/// 永続マップしたコミットリソースをページとして貸し出す
+/// </summary>
+class UploadPageSource : public LinearAllocator::IPageSource {
+  public: // メンバ関数
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="device">デバイス</param>
+	explicit UploadPageSource(ID3D12Device* device);
+
+	LinearAllocator::Page CreatePage(size_t size) override;
+
+	void ReleasePage(const LinearAllocator::Page& page) override;
+
+	/// <summary>
+	/// ページのリソースの取得（コピー元として使う時など）
+	/// </summary>
+	/// <param name="pageId">ページ番号</param>
+	/// <returns>リソース</returns>
+	ID3D12Resource* GetResource(uint32_t pageId);
+
+  private: // メンバ変数
+	// デバイス
+	ID3D12Device* device_ = nullptr;
+	// ページ番号ごとのリソース
+	std::unordered_map<uint32_t, Microsoft::WRL::ComPtr<ID3D12Resource>> resources_;
+	// 次のページ番号
+	uint32_t nextId_ = 0;
+	// 排他
+	std::mutex mutex_;
+};
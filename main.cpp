@@ -1,12 +1,28 @@
 ﻿#include "Audio.h"
 #include "DirectXCommon.h"
 #include "GameScene.h"
+#include "GpuMemoryAllocator.h"
+#include "ParticleSystem3D.h"
+#include "ResourceUploader.h"
+#include "TextureBaker.h"
 #include "TextureManager.h"
+#include "ThreadPool.h"
 #include "WinApp.h"
 #include "AxisIndicator.h"
+#include <cassert>
+#include <cstring>
 
 // Windowsアプリでのエントリーポイント(main関数)
-int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
+int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR lpCmdLine, int) {
+	// テクスチャのベイクだけ行って終了（"--bake-textures"）
+	if (strstr(lpCmdLine, "--bake-textures") != nullptr) {
+		HRESULT result = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+		assert(SUCCEEDED(result));
+		TextureBaker::BakeDirectory(L"Resources/");
+		CoUninitialize();
+		return 0;
+	}
+
 	WinApp* win = nullptr;
 	DirectXCommon* dxCommon = nullptr;
 	// 汎用機能
@@ -24,6 +40,11 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	dxCommon = DirectXCommon::GetInstance();
 	dxCommon->Initialize(win);
 
+	// GPUメモリアロケータの初期化
+	GpuMemoryAllocator::GetInstance()->Initialize(dxCommon->GetDevice());
+	// リソースアップローダの初期化
+	ResourceUploader::GetInstance()->Initialize(dxCommon->GetDevice(), dxCommon->GetCommandQueue());
+
 #pragma region 汎用機能初期化
 	// 入力の初期化
 	input = Input::GetInstance();
@@ -47,6 +68,9 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	// 3Dモデル静的初期化
 	Model::StaticInitialize();
 
+	// 3Dパーティクル静的初期化
+	ParticleSystem3D::StaticInitialize();
+
 	// 軸方向表示初期化
 	axisIndicator = AxisIndicator::GetInstance();
 	axisIndicator->Initialize();
@@ -65,6 +89,8 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 
 		// 入力関連の毎フレーム処理
 		input->Update();
+		// 非同期読み込みが終わったテクスチャの差し替え
+		TextureManager::GetInstance()->Update();
 		// ゲームシーンの毎フレーム処理
 		gameScene->Update();
 		// 軸表示の更新
@@ -80,6 +106,11 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 		dxCommon->PostDraw();
 	}
 
+	// 読み込み中のテクスチャのデコードと転送の予約を終わらせる
+	ThreadPool::GetInstance()->WaitIdle();
+	// GPUが使用中のリソースを解放しないように完了を待つ
+	dxCommon->WaitForGpu();
+
 	// 各種解放
 	SafeDelete(gameScene);
 	audio->Finalize();
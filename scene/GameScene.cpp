@@ -1,4 +1,5 @@
 ﻿#include "GameScene.h"
+#include "ShadowMap.h"
 #include "TextureManager.h"
 #include <cassert>
 #include <random>
@@ -104,23 +105,41 @@ void GameScene::Draw() {
 #pragma endregion
 
 #pragma region 3Dオブジェクト描画
+	// シャドウマップ描画
+	ShadowMap* shadowMap = ShadowMap::GetInstance();
+	for (size_t i = 0; i < _countof(worldTransform_); i++)
+	{
+		shadowMap->AddCaster(model_, worldTransform_[i]);
+	}
+	for (size_t i = 0; i < _countof(targetTransform_); i++)
+	{
+		shadowMap->AddCaster(model_, targetTransform_[i]);
+	}
+	shadowMap->Render(commandList, viewProjection_);
+
 	// 3Dオブジェクト描画前処理
 	Model::PreDraw(commandList);
 
 	/// <summary>
 	/// ここに3Dオブジェクトの描画処理を追加できる
 	/// </summary>
+	drawQueue_.Clear();
+	drawQueue_.SetViewProjection(&viewProjection_);
 	for (size_t i = 0; i < _countof(worldTransform_); i++)
 	{
-		model_->Draw(worldTransform_[i], viewProjection_, textureHandle_);
+		drawQueue_.Push(model_, worldTransform_[i], textureHandle_);
 	}
 	for (size_t i = 0; i < _countof(targetTransform_); i++)
 	{
-		model_->Draw(targetTransform_[i], viewProjection_, textureHandle_);
+		drawQueue_.Push(model_, targetTransform_[i], textureHandle_);
 	}
+	// 描画キューを並列記録
+	dxCommon_->RecordParallel(&drawQueue_);
 
 	// 3Dオブジェクト描画後処理
 	Model::PostDraw();
+	// 並列記録で記録先が切り替わるので取得し直す
+	commandList = dxCommon_->GetCommandList();
 #pragma endregion
 
 #pragma region 前景スプライト描画
@@ -5,6 +5,7 @@
 #include "DebugText.h"
 #include "Input.h"
 #include "Model.h"
+#include "ModelDrawQueue.h"
 #include "SafeDelete.h"
 #include "Sprite.h"
 #include "ViewProjection.h"
@@ -61,6 +62,9 @@ class GameScene {
 
 	ViewProjection viewProjection_;
 
+	// モデル描画キュー
+	ModelDrawQueue drawQueue_;
+
 	/// <summary>
 	/// ゲームシーン用
 	/// </summary>
@@ -0,0 +1,72 @@
+﻿#include "AssetNameTable.h"
+#include "TestUtility.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// 1万アセットでの名前検索のコスト
+// 以前の全スロットを文字列比較する線形探索と比べる
+int main() {
+	const uint32_t kAssetCount = 10000;
+	const uint32_t kLookupCount = 100000;
+
+	std::vector<std::string> names;
+	std::vector<std::string> paths;
+	for (uint32_t i = 0; i < kAssetCount; i++) {
+		names.push_back("ui/icons/icon_" + std::to_string(i) + ".png");
+		paths.push_back("Resources/" + names.back());
+	}
+
+	AssetNameTable table;
+	for (uint32_t i = 0; i < kAssetCount; i++) {
+		table.Insert(names[i], paths[i], i);
+	}
+
+	// 毎フレーム同じ名前で呼ぶ場合（別名のハッシュ1回）
+	Test::Random random(1);
+	std::vector<uint32_t> order(kLookupCount);
+	for (uint32_t& index : order) {
+		index = random.Next(kAssetCount);
+	}
+	uint32_t found = 0;
+	double alias = Test::MeasureMilliseconds(5, [&]() {
+		for (uint32_t index : order) {
+			found += table.Find(names[index]) == index;
+		}
+	});
+	Test::Report("Find (alias)", alias, kLookupCount);
+
+	// 初めての書き方（正規化してパスで引く）
+	std::vector<std::string> otherNames;
+	for (uint32_t index : order) {
+		otherNames.push_back("./UI/Icons/../icons/icon_" + std::to_string(index) + ".png");
+	}
+	double normalize = Test::MeasureMilliseconds(1, [&]() {
+		for (uint32_t i = 0; i < kLookupCount; i++) {
+			found += table.FindPath(otherNames[i], "Resources/" + otherNames[i]) == order[i];
+		}
+	});
+	Test::Report("FindPath (normalize + path)", normalize, kLookupCount);
+
+	// 見つからない名前
+	double miss = Test::MeasureMilliseconds(5, [&]() {
+		for (uint32_t i = 0; i < kLookupCount; i++) {
+			found += table.Find(otherNames[i] + "_missing") == AssetNameTable::kNotFound;
+		}
+	});
+	Test::Report("Find (miss)", miss, kLookupCount);
+
+	// 線形探索（比較用に1千回だけ）
+	const uint32_t kLinearCount = 1000;
+	double linear = Test::MeasureMilliseconds(1, [&]() {
+		for (uint32_t i = 0; i < kLinearCount; i++) {
+			auto it = std::find(paths.begin(), paths.end(), paths[order[i]]);
+			found += static_cast<uint32_t>(it - paths.begin()) == order[i];
+		}
+	});
+	Test::Report("linear scan (reference)", linear, kLinearCount);
+
+	Test::KeepAlive(found);
+	TEST_CHECK(found == 5 * kLookupCount + kLookupCount + 5 * kLookupCount + kLinearCount);
+	return Test::Finish("AssetNameTableBenchmark");
+}
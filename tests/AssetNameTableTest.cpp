@@ -0,0 +1,111 @@
+﻿#include "AssetNameTable.h"
+#include "TestUtility.h"
+
+namespace {
+
+// 区切り、大文字小文字、"."、".."、空の要素を揃えること
+void TestNormalize() {
+	TEST_CHECK(AssetNameTable::Normalize("x.png") == "x.png");
+	TEST_CHECK(AssetNameTable::Normalize("./x.png") == "x.png");
+	TEST_CHECK(AssetNameTable::Normalize("Resources/X.PNG") == "resources/x.png");
+	TEST_CHECK(AssetNameTable::Normalize("Resources\\sub\\x.png") == "resources/sub/x.png");
+	TEST_CHECK(AssetNameTable::Normalize("Resources//./sub/../x.png") == "resources/x.png");
+	TEST_CHECK(AssetNameTable::Normalize("../x.png") == "../x.png");
+	TEST_CHECK(AssetNameTable::Normalize("a/../../x.png") == "../x.png");
+	TEST_CHECK(AssetNameTable::Normalize("/abs/./x.png") == "/abs/x.png");
+	TEST_CHECK(AssetNameTable::Normalize("dir/") == "dir");
+	TEST_CHECK(AssetNameTable::Normalize("") == "");
+	// ASCII以外のバイトはそのまま
+	TEST_CHECK(AssetNameTable::Normalize("Resources/\xE7\x94\xBB\xE5\x83\x8F.png") ==
+	           "resources/\xE7\x94\xBB\xE5\x83\x8F.png");
+}
+
+// 書き方の違う同じパスは同じハンドルになり、名前は別名として覚えること
+void TestAlias() {
+	AssetNameTable table;
+	table.Insert("x.png", "Resources/x.png", 1);
+
+	TEST_CHECK(table.Find("x.png") == 1);
+	TEST_CHECK(table.Find("./Resources/x.png") == AssetNameTable::kNotFound);
+	TEST_CHECK(table.FindPath("./Resources/x.png", "./Resources/x.png") == 1);
+	// 2回目からは名前だけで見つかる
+	TEST_CHECK(table.Find("./Resources/x.png") == 1);
+	TEST_CHECK(table.FindPath("RESOURCES\\X.png", "RESOURCES\\X.png") == 1);
+	TEST_CHECK(table.Find("RESOURCES\\X.png") == 1);
+}
+
+// 別名と正規化したパスを取り違えないこと
+// "./x.png"はカレントディレクトリのx.pngで、Resources/x.pngの別名"x.png"とは別のファイル
+void TestAliasDoesNotMatchPath() {
+	AssetNameTable table;
+	table.Insert("x.png", "Resources/x.png", 1);
+
+	TEST_CHECK(table.FindPath("./x.png", "./x.png") == AssetNameTable::kNotFound);
+	TEST_CHECK(table.Find("./x.png") == AssetNameTable::kNotFound);
+
+	// 別のファイルとして登録しても、元の名前は元のハンドルのまま
+	table.Insert("./x.png", "./x.png", 2);
+	TEST_CHECK(table.Find("./x.png") == 2);
+	TEST_CHECK(table.FindPath("x.png", "x.png") == 2);
+	TEST_CHECK(table.Find("x.png") == 1);
+	TEST_CHECK(table.FindPath("Resources/x.png", "Resources/x.png") == 1);
+
+	// パスに見える名前も、正規化した別のパスとは照合しない
+	AssetNameTable other;
+	other.Insert("resources/y.png", "Data/resources/y.png", 3);
+	TEST_CHECK(other.FindPath("y", "Resources/y.png") == AssetNameTable::kNotFound);
+}
+
+// 正規化して同じになる別名同士は1つのハンドルにまとまり、違うパスは衝突しないこと
+void TestCollision() {
+	AssetNameTable table;
+	table.Insert("a.png", "Resources/a.png", 10);
+	table.Insert("b.png", "Resources/b.png", 11);
+	table.Insert("sub/a.png", "Resources/sub/a.png", 12);
+
+	TEST_CHECK(table.FindPath("A.PNG", "Resources/A.PNG") == 10);
+	TEST_CHECK(table.FindPath("sub/../a.png", "Resources/sub/../a.png") == 10);
+	TEST_CHECK(table.FindPath("sub\\a.png", "Resources\\sub\\a.png") == 12);
+	TEST_CHECK(table.FindPath("c.png", "Resources/c.png") == AssetNameTable::kNotFound);
+
+	// 既に登録済みの別名は上書きしない
+	table.Insert("a.png", "Resources/other.png", 13);
+	TEST_CHECK(table.Find("a.png") == 10);
+	TEST_CHECK(table.FindPath("other.png", "Resources/other.png") == 13);
+}
+
+// 削除するとパスと全ての別名が消え、他のハンドルには影響しないこと
+void TestErase() {
+	AssetNameTable table;
+	table.Insert("x.png", "Resources/x.png", 1);
+	table.Insert("y.png", "Resources/y.png", 2);
+	table.FindPath("./Resources/x.png", "./Resources/x.png");
+
+	table.Erase(1);
+	TEST_CHECK(table.Find("x.png") == AssetNameTable::kNotFound);
+	TEST_CHECK(table.Find("./Resources/x.png") == AssetNameTable::kNotFound);
+	TEST_CHECK(table.FindPath("x.png", "Resources/x.png") == AssetNameTable::kNotFound);
+	TEST_CHECK(table.Find("y.png") == 2);
+
+	// 同じハンドル番号を別のファイルで使い回せる
+	table.Insert("z.png", "Resources/z.png", 1);
+	TEST_CHECK(table.Find("z.png") == 1);
+	TEST_CHECK(table.Find("x.png") == AssetNameTable::kNotFound);
+
+	table.Erase(100);
+	table.Clear();
+	TEST_CHECK(table.Find("y.png") == AssetNameTable::kNotFound);
+	TEST_CHECK(table.FindPath("z.png", "Resources/z.png") == AssetNameTable::kNotFound);
+}
+
+} // namespace
+
+int main() {
+	TestNormalize();
+	TestAlias();
+	TestAliasDoesNotMatchPath();
+	TestCollision();
+	TestErase();
+
+	return Test::Finish("AssetNameTableTest");
+}
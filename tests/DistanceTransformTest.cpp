@@ -0,0 +1,136 @@
+﻿#include "DistanceTransform.h"
+#include "TestUtility.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 特徴ピクセルがないときの距離の下限
+const float kFarThreshold = 1e19f;
+
+// 総当たりで求めた最も近い特徴ピクセルまでの距離の2乗（なければ負）
+std::vector<float> ComputeBruteForce(
+  const std::vector<uint8_t>& features, uint32_t width, uint32_t height) {
+	std::vector<float> distances(features.size(), -1.0f);
+	for (uint32_t y = 0; y < height; y++) {
+		for (uint32_t x = 0; x < width; x++) {
+			float& best = distances[size_t(y) * width + x];
+			for (uint32_t fy = 0; fy < height; fy++) {
+				for (uint32_t fx = 0; fx < width; fx++) {
+					if (!features[size_t(fy) * width + fx]) {
+						continue;
+					}
+					float dx = float(x) - float(fx);
+					float dy = float(y) - float(fy);
+					float distance = dx * dx + dy * dy;
+					if (best < 0.0f || distance < best) {
+						best = distance;
+					}
+				}
+			}
+		}
+	}
+	return distances;
+}
+
+// 総当たりと比べる（整数の2乗和なので一致する）
+bool MatchesBruteForce(
+  const std::vector<uint8_t>& features, uint32_t width, uint32_t height, ThreadPool* pool) {
+	std::vector<float> distances(features.size());
+	DistanceTransform::ComputeSquared(features.data(), width, height, distances.data(), pool);
+	std::vector<float> expected = ComputeBruteForce(features, width, height);
+
+	for (size_t i = 0; i < features.size(); i++) {
+		bool match =
+		  expected[i] < 0.0f ? distances[i] >= kFarThreshold : distances[i] == expected[i];
+		if (!match) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// ランダムな大きさと密度で総当たりと一致すること（1行、1列、疎な画像を含む）
+void TestSquared(ThreadPool* pool) {
+	Test::Random random(1);
+	for (int i = 0; i < 60; i++) {
+		uint32_t width = 1 + random.Next(48);
+		uint32_t height = 1 + random.Next(48);
+		uint32_t density = 1 + random.Next(i % 3 == 0 ? 10 : 300);
+		std::vector<uint8_t> features(size_t(width) * height);
+		for (uint8_t& feature : features) {
+			feature = random.Next(1000) < density ? 255 : 0;
+		}
+		TEST_CHECK(MatchesBruteForce(features, width, height, pool));
+	}
+}
+
+// 特徴ピクセルが0個、1個、全部の場合
+void TestEdgeCases(ThreadPool* pool) {
+	const uint32_t width = 37;
+	const uint32_t height = 23;
+	std::vector<uint8_t> features(width * height, 0);
+	TEST_CHECK(MatchesBruteForce(features, width, height, pool));
+
+	// 角の1個（最大の距離になる）
+	features[width * height - 1] = 1;
+	TEST_CHECK(MatchesBruteForce(features, width, height, pool));
+	std::vector<float> distances(width * height);
+	DistanceTransform::ComputeSquared(features.data(), width, height, distances.data(), pool);
+	TEST_CHECK(distances[0] == float((width - 1) * (width - 1) + (height - 1) * (height - 1)));
+
+	std::fill(features.begin(), features.end(), uint8_t(1));
+	DistanceTransform::ComputeSquared(features.data(), width, height, distances.data(), pool);
+	TEST_CHECK(std::all_of(distances.begin(), distances.end(), [](float d) { return d == 0.0f; }));
+
+	// 大きさ0は何もしない
+	DistanceTransform::ComputeSquared(features.data(), 0, height, distances.data(), pool);
+}
+
+// 円の符号付き距離が解析解と1ピクセル未満で一致すること
+void TestSignedCircle(ThreadPool* pool) {
+	const int size = 128;
+	const float center = 64.0f;
+	const float radius = 40.0f;
+	std::vector<uint8_t> coverage(size * size);
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			float dx = x + 0.5f - center;
+			float dy = y + 0.5f - center;
+			coverage[y * size + x] = std::sqrt(dx * dx + dy * dy) < radius ? 255 : 0;
+		}
+	}
+	std::vector<float> distances(size * size);
+	DistanceTransform::ComputeSigned(coverage.data(), size, size, 128, distances.data(), pool);
+
+	float maxError = 0.0f;
+	bool signMatches = true;
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			float dx = x + 0.5f - center;
+			float dy = y + 0.5f - center;
+			float expected = std::sqrt(dx * dx + dy * dy) - radius;
+			float distance = distances[y * size + x];
+			maxError = (std::max)(maxError, std::fabs(expected - distance));
+			// 内側は負、外側は正
+			signMatches = signMatches && (coverage[y * size + x] != 0) == (distance < 0.0f);
+		}
+	}
+	TEST_CHECK(maxError < 1.0f);
+	TEST_CHECK(signMatches);
+}
+
+} // namespace
+
+int main() {
+	// 呼び出し元のみとスレッドプールで同じ結果になること
+	ThreadPool pool(4);
+	for (ThreadPool* threadPool : {static_cast<ThreadPool*>(nullptr), &pool}) {
+		TestSquared(threadPool);
+		TestEdgeCases(threadPool);
+		TestSignedCircle(threadPool);
+	}
+
+	return Test::Finish("DistanceTransformTest");
+}
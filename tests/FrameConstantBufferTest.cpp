@@ -0,0 +1,89 @@
+﻿// テスト用のDirectXCommon（fake/DirectXCommon.h）と同じ場所に複製したものを読み込む
+#include "FrameConstantBuffer.h"
+#include "TestUtility.h"
+
+namespace {
+
+struct ConstBufferData {
+	float values[12];
+	uint32_t id;
+};
+
+// 直前に書き込んだ内容
+const ConstBufferData* GetLastWritten() {
+	return static_cast<const ConstBufferData*>(
+	  DirectXCommon::GetInstance()->lastAllocation.cpuAddress);
+}
+
+// 同じフレームで編集しなければ書き込みは1回だけで、同じアドレスを返すこと
+void TestWriteOncePerFrame() {
+	DirectXCommon* dxCommon = DirectXCommon::GetInstance();
+	dxCommon->NextFrame();
+
+	FrameConstantBuffer<ConstBufferData> buffer;
+	buffer.Edit().id = 1;
+
+	uint32_t before = dxCommon->allocationCount;
+	D3D12_GPU_VIRTUAL_ADDRESS address = buffer.GetGPUVirtualAddress();
+	TEST_CHECK(dxCommon->allocationCount == before + 1);
+	TEST_CHECK(address == dxCommon->lastAllocation.gpuAddress);
+	TEST_CHECK(address % LinearAllocator::kDefaultAlignment == 0);
+	TEST_CHECK(GetLastWritten()->id == 1);
+
+	for (int i = 0; i < 10; i++) {
+		TEST_CHECK(buffer.GetGPUVirtualAddress() == address);
+	}
+	TEST_CHECK(dxCommon->allocationCount == before + 1);
+}
+
+// 編集すると新しい領域へ書き、それまでの領域の内容は残ること
+void TestEditWritesNewRegion() {
+	DirectXCommon* dxCommon = DirectXCommon::GetInstance();
+	dxCommon->NextFrame();
+
+	FrameConstantBuffer<ConstBufferData> buffer;
+	buffer.Edit().id = 1;
+	D3D12_GPU_VIRTUAL_ADDRESS first = buffer.GetGPUVirtualAddress();
+	const ConstBufferData* firstData = GetLastWritten();
+
+	// 書き込むまではCPU側だけが変わる
+	buffer.Edit().id = 2;
+	TEST_CHECK(buffer.GetData().id == 2);
+	TEST_CHECK(firstData->id == 1);
+
+	D3D12_GPU_VIRTUAL_ADDRESS second = buffer.GetGPUVirtualAddress();
+	TEST_CHECK(second != first);
+	TEST_CHECK(GetLastWritten()->id == 2);
+	// 先に積んだ描画が参照する内容はそのまま
+	TEST_CHECK(firstData->id == 1);
+}
+
+// フレームが変わると編集しなくても書き直すこと
+void TestRewriteEveryFrame() {
+	DirectXCommon* dxCommon = DirectXCommon::GetInstance();
+	dxCommon->NextFrame();
+
+	FrameConstantBuffer<ConstBufferData> buffer;
+	buffer.Edit().id = 7;
+	buffer.GetGPUVirtualAddress();
+
+	for (int frame = 0; frame < 5; frame++) {
+		dxCommon->NextFrame();
+		uint32_t before = dxCommon->allocationCount;
+
+		D3D12_GPU_VIRTUAL_ADDRESS address = buffer.GetGPUVirtualAddress();
+		TEST_CHECK(dxCommon->allocationCount == before + 1);
+		TEST_CHECK(address == dxCommon->lastAllocation.gpuAddress);
+		TEST_CHECK(GetLastWritten()->id == 7);
+	}
+}
+
+} // namespace
+
+int main() {
+	TestWriteOncePerFrame();
+	TestEditWritesNewRegion();
+	TestRewriteEveryFrame();
+
+	return Test::Finish("FrameConstantBufferTest");
+}
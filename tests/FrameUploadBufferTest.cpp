@@ -0,0 +1,154 @@
+﻿// テスト用のDirectXCommon（fake/DirectXCommon.h）と同じ場所に複製したものを読み込む
+#include "FrameUploadBuffer.h"
+#include "TestUtility.h"
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+struct Light {
+	float values[4];
+	uint32_t active;
+	uint32_t padding[3];
+};
+
+struct ConstBufferData {
+	Light lights[40];
+	float ambient[4];
+	uint32_t flags;
+};
+
+using Buffer = FrameUploadBuffer<ConstBufferData>;
+
+// 参照したフレームの領域（GPUアドレスに対応するCPU側のメモリ）
+uint8_t* GetSlot(D3D12_GPU_VIRTUAL_ADDRESS address) {
+	return DirectXCommon::GetInstance()->GetDevice()->lastResource->GetMemory(address);
+}
+
+// 参照した領域がCPU側のデータと一致するか
+bool MatchesData(const Buffer& buffer, const uint8_t* slot) {
+	return memcmp(slot, &buffer.GetData(), sizeof(ConstBufferData)) == 0;
+}
+
+// ランダムな編集（メンバ単位、要素単位、全体）
+void EditRandom(Buffer& buffer, Test::Random& random) {
+	const ConstBufferData& data = buffer.GetData();
+	uint32_t value = random.Next();
+	uint32_t light = random.Next(40);
+	switch (random.Next(16)) {
+	case 0:
+		buffer.Edit().flags = value;
+		break;
+	case 1:
+		buffer.Edit(data.flags) = value;
+		break;
+	case 2:
+		buffer.Edit(data.ambient)[value % 4] = random.Range(0.0f, 1.0f);
+		break;
+	case 3:
+	case 4:
+	case 5: {
+		Light& edited = buffer.Edit(data.lights[light]);
+		edited.values[value % 4] = random.Range(-1.0f, 1.0f);
+		edited.active = value & 1;
+		break;
+	}
+	default:
+		// 1つのメンバだけ（離れた範囲が増えて、最大数を超えるとまとめられる）
+		buffer.Edit(data.lights[light].values[value % 4]) = random.Range(-1.0f, 1.0f);
+		break;
+	}
+}
+
+// ランダムな編集と参照の後、参照した領域はいつもCPU側のデータと一致し、
+// 使用中の他のフレームの領域は書き換わらないこと（範囲の最大数を超える編集を含む）
+void TestRandomEdits() {
+	DirectXCommon* dxCommon = DirectXCommon::GetInstance();
+	Buffer buffer;
+	buffer.Create();
+	D3D12_GPU_VIRTUAL_ADDRESS base = buffer.GetGPUVirtualAddress() -
+	                                 Buffer::kSlotSize * dxCommon->GetFrameIndex();
+
+	Test::Random random(3);
+	for (int frame = 0; frame < 2000; frame++) {
+		dxCommon->NextFrame();
+		UINT frameIndex = dxCommon->GetFrameIndex();
+
+		// 参照しないフレームもある（その間の編集は次に参照したときに写す）
+		uint32_t referenceCount = random.Next(4);
+		for (uint32_t r = 0; r <= referenceCount; r++) {
+			// 0～80個の編集（32個を超えれば範囲がまとめられる）
+			uint32_t editCount = random.Next(8) == 0 ? random.Next(81) : random.Next(6);
+			for (uint32_t e = 0; e < editCount; e++) {
+				EditRandom(buffer, random);
+			}
+			if (r == referenceCount) {
+				break;
+			}
+
+			std::vector<uint8_t> slots[DirectXCommon::kFrameCount];
+			for (uint32_t i = 0; i < DirectXCommon::kFrameCount; i++) {
+				const uint8_t* slot = GetSlot(base + Buffer::kSlotSize * i);
+				slots[i].assign(slot, slot + sizeof(ConstBufferData));
+			}
+
+			D3D12_GPU_VIRTUAL_ADDRESS address = buffer.GetGPUVirtualAddress();
+			TEST_CHECK(address == base + Buffer::kSlotSize * frameIndex);
+			TEST_CHECK(MatchesData(buffer, GetSlot(address)));
+
+			// 他のフレームの領域は変わらない
+			for (uint32_t i = 0; i < DirectXCommon::kFrameCount; i++) {
+				if (i != frameIndex) {
+					const uint8_t* slot = GetSlot(base + Buffer::kSlotSize * i);
+					TEST_CHECK(memcmp(slot, slots[i].data(), slots[i].size()) == 0);
+				}
+			}
+		}
+	}
+}
+
+// 編集したメンバの範囲だけを写し、他のバイトには触れないこと
+void TestCopiesOnlyEditedRanges() {
+	DirectXCommon* dxCommon = DirectXCommon::GetInstance();
+	Buffer buffer;
+	buffer.Create();
+
+	// 全フレームの領域を一度転送しておく
+	std::vector<uint8_t*> slots;
+	for (uint32_t i = 0; i < DirectXCommon::kFrameCount; i++) {
+		dxCommon->NextFrame();
+		slots.push_back(GetSlot(buffer.GetGPUVirtualAddress()));
+	}
+
+	// 転送済みの領域に印を付け、別のメンバだけを編集する
+	const size_t ambientOffset = offsetof(ConstBufferData, ambient);
+	for (uint8_t* slot : slots) {
+		slot[ambientOffset] = 0xcd;
+	}
+	buffer.Edit(buffer.GetData().flags) = 5;
+	buffer.Edit(buffer.GetData().lights[3]).active = 1;
+
+	for (uint32_t i = 0; i < DirectXCommon::kFrameCount; i++) {
+		dxCommon->NextFrame();
+		uint8_t* slot = GetSlot(buffer.GetGPUVirtualAddress());
+		const ConstBufferData* written = reinterpret_cast<const ConstBufferData*>(slot);
+		TEST_CHECK(written->flags == 5);
+		TEST_CHECK(written->lights[3].active == 1);
+		TEST_CHECK(slot[ambientOffset] == 0xcd);
+	}
+
+	// 全体の編集は全て写す
+	buffer.Edit();
+	dxCommon->NextFrame();
+	TEST_CHECK(MatchesData(buffer, GetSlot(buffer.GetGPUVirtualAddress())));
+}
+
+} // namespace
+
+int main() {
+	TestRandomEdits();
+	TestCopiesOnlyEditedRanges();
+
+	return Test::Finish("FrameUploadBufferTest");
+}
@@ -0,0 +1,134 @@
+﻿#include "HandleAllocator.h"
+#include "TestUtility.h"
+#include <algorithm>
+
+namespace {
+
+// 若い番号から順に払い出し、使い切ったら無効を返すこと
+void TestAllocateInOrder() {
+	HandleAllocator allocator(8);
+	TEST_CHECK(allocator.GetCapacity() == 8);
+	for (uint32_t i = 0; i < 8; i++) {
+		TEST_CHECK(allocator.Allocate() == i);
+		TEST_CHECK(allocator.IsAllocated(i));
+	}
+	TEST_CHECK(allocator.GetAllocatedCount() == 8);
+	TEST_CHECK(allocator.Allocate() == HandleAllocator::kInvalidHandle);
+	TEST_CHECK(!allocator.IsAllocated(8));
+	TEST_CHECK(!allocator.IsAllocated(HandleAllocator::kInvalidHandle));
+}
+
+// 解放した番号を未使用の番号より先に、最後に解放したものから使い回すこと
+void TestRecycle() {
+	HandleAllocator allocator(16);
+	for (uint32_t i = 0; i < 6; i++) {
+		allocator.Allocate();
+	}
+	allocator.Free(2);
+	allocator.Free(4);
+	TEST_CHECK(!allocator.IsAllocated(2));
+	TEST_CHECK(allocator.GetAllocatedCount() == 4);
+
+	TEST_CHECK(allocator.Allocate() == 4);
+	TEST_CHECK(allocator.Allocate() == 2);
+	TEST_CHECK(allocator.Allocate() == 6);
+}
+
+// 容量を増やしても確保済みの番号はそのままで、使い回しが先、追加分は若い順
+void TestGrow() {
+	HandleAllocator allocator(4);
+	for (uint32_t i = 0; i < 4; i++) {
+		allocator.Allocate();
+	}
+	allocator.Free(1);
+
+	allocator.Grow(8);
+	TEST_CHECK(allocator.GetCapacity() == 8);
+	TEST_CHECK(allocator.GetAllocatedCount() == 3);
+	TEST_CHECK(allocator.IsAllocated(0) && allocator.IsAllocated(2) && allocator.IsAllocated(3));
+
+	TEST_CHECK(allocator.Allocate() == 1);
+	for (uint32_t i = 4; i < 8; i++) {
+		TEST_CHECK(allocator.Allocate() == i);
+	}
+	TEST_CHECK(allocator.Allocate() == HandleAllocator::kInvalidHandle);
+
+	// 縮めることはない
+	allocator.Grow(2);
+	TEST_CHECK(allocator.GetCapacity() == 8);
+	TEST_CHECK(allocator.GetAllocatedCount() == 8);
+}
+
+// 全て解放すると最初と同じ順に払い出すこと
+void TestReset() {
+	HandleAllocator allocator(5);
+	allocator.Allocate();
+	allocator.Allocate();
+	allocator.Free(0);
+	allocator.Reset();
+	TEST_CHECK(allocator.GetAllocatedCount() == 0);
+	for (uint32_t i = 0; i < 5; i++) {
+		TEST_CHECK(!allocator.IsAllocated(i));
+	}
+	for (uint32_t i = 0; i < 5; i++) {
+		TEST_CHECK(allocator.Allocate() == i);
+	}
+}
+
+// ランダムな確保・解放・拡張で、使用中の番号を二重に払い出さないこと
+void TestRandom() {
+	HandleAllocator allocator(64);
+	std::vector<bool> used(64, false);
+	std::vector<uint32_t> live;
+	Test::Random random(42);
+
+	for (int i = 0; i < 100000; i++) {
+		uint32_t operation = random.Next(100);
+		if (operation < 55) {
+			uint32_t handle = allocator.Allocate();
+			if (live.size() == used.size()) {
+				TEST_CHECK(handle == HandleAllocator::kInvalidHandle);
+				continue;
+			}
+			if (!TEST_CHECK(handle < used.size()) || !TEST_CHECK(!used[handle])) {
+				break;
+			}
+			used[handle] = true;
+			live.push_back(handle);
+		} else if (operation < 99) {
+			if (live.empty()) {
+				continue;
+			}
+			size_t index = random.Next(static_cast<uint32_t>(live.size()));
+			allocator.Free(live[index]);
+			used[live[index]] = false;
+			live[index] = live.back();
+			live.pop_back();
+		} else if (used.size() < 4096) {
+			uint32_t capacity = static_cast<uint32_t>(used.size()) + 1 + random.Next(64);
+			allocator.Grow(capacity);
+			used.resize(capacity, false);
+		}
+
+		TEST_CHECK(allocator.GetAllocatedCount() == live.size());
+		TEST_CHECK(allocator.GetCapacity() == used.size());
+	}
+
+	bool matches = true;
+	for (uint32_t handle = 0; handle < used.size(); handle++) {
+		matches = matches && allocator.IsAllocated(handle) == used[handle];
+	}
+	TEST_CHECK(matches);
+}
+
+} // namespace
+
+int main() {
+	TestAllocateInOrder();
+	TestRecycle();
+	TestGrow();
+	TestReset();
+	TestRandom();
+
+	return Test::Finish("HandleAllocatorTest");
+}
@@ -0,0 +1,65 @@
+﻿#pragma once
+
+#include "LinearAllocator.h"
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+/// <summary>
+/// テスト用のページソース
+/// CPUのヒープからページを作り、GPUアドレスはページごとにずらした架空の値を振る
+/// </summary>
+class HeapPageSource : public LinearAllocator::IPageSource {
+  public:
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="gpuBaseOffset">GPUアドレスの端数（境界合わせがGPUアドレス基準か確かめる）</param>
+	explicit HeapPageSource(uint64_t gpuBaseOffset = 0) : gpuBaseOffset_(gpuBaseOffset) {}
+
+	~HeapPageSource() {
+		for (LinearAllocator::Page& page : livePages_) {
+			free(page.cpuAddress);
+		}
+	}
+
+	LinearAllocator::Page CreatePage(size_t size) override {
+		LinearAllocator::Page page;
+		page.cpuAddress = static_cast<uint8_t*>(malloc(size));
+		page.gpuAddress = (uint64_t(nextId_) + 1) * 0x100000000ull + gpuBaseOffset_;
+		page.size = size;
+		page.id = nextId_++;
+		livePages_.push_back(page);
+		createCount++;
+		return page;
+	}
+
+	void ReleasePage(const LinearAllocator::Page& page) override {
+		for (size_t i = 0; i < livePages_.size(); i++) {
+			if (livePages_[i].id == page.id) {
+				free(livePages_[i].cpuAddress);
+				livePages_.erase(livePages_.begin() + i);
+				releaseCount++;
+				return;
+			}
+		}
+		// 知らないページや二重解放
+		invalidReleaseCount++;
+	}
+
+	/// <summary>
+	/// 解放されていないページ数の取得
+	/// </summary>
+	/// <returns>ページ数</returns>
+	size_t GetLivePageCount() const { return livePages_.size(); }
+
+	// 生成と解放の回数
+	uint32_t createCount = 0;
+	uint32_t releaseCount = 0;
+	uint32_t invalidReleaseCount = 0;
+
+  private:
+	uint64_t gpuBaseOffset_;
+	uint32_t nextId_ = 0;
+	std::vector<LinearAllocator::Page> livePages_;
+};
@@ -0,0 +1,269 @@
+﻿#include "LightCluster.h"
+#include "TestUtility.h"
+#include "ThreadPool.h"
+#include <cfloat>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace {
+
+// 境界上の判定の丸め誤差を許す、半径に対する割合
+const float kRadiusTolerance = 1e-4f;
+
+// 視点と投影の設定
+struct Camera {
+	XMMATRIX matView;
+	float fovAngleY;
+	float aspectRatio;
+	float nearZ;
+	float farZ;
+};
+
+// 斜めを向いたカメラ
+Camera MakeCamera() {
+	Camera camera;
+	camera.matView = XMMatrixLookToLH(
+	  XMVectorSet(5.0f, 2.0f, -10.0f, 1.0f), XMVector3Normalize(XMVectorSet(0.2f, -0.1f, 1.0f, 0)),
+	  XMVectorSet(0, 1, 0, 0));
+	camera.fovAngleY = XMConvertToRadians(60.0f);
+	camera.aspectRatio = 16.0f / 9.0f;
+	camera.nearZ = 0.5f;
+	camera.farZ = 200.0f;
+	return camera;
+}
+
+// クラスタのビュー空間の箱と、ビュー空間の境界球の最短距離の2乗
+float GetDistanceSq(const Camera& camera, uint32_t x, uint32_t y, uint32_t z, XMFLOAT4 sphere) {
+	float tanHalfFovY = std::tan(camera.fovAngleY * 0.5f);
+	float tanHalfFovX = tanHalfFovY * camera.aspectRatio;
+	float ratio = camera.farZ / camera.nearZ;
+	float nearDepth = camera.nearZ * std::pow(ratio, float(z) / LightCluster::kCountZ);
+	float farDepth = camera.nearZ * std::pow(ratio, float(z + 1) / LightCluster::kCountZ);
+
+	// 箱は奥行きの範囲で最も広がる側で取る
+	auto extent = [nearDepth, farDepth](float slope, bool isMax) {
+		return slope * ((slope > 0.0f) == isMax ? farDepth : nearDepth);
+	};
+	float left = (-1.0f + 2.0f * x / LightCluster::kCountX) * tanHalfFovX;
+	float right = (-1.0f + 2.0f * (x + 1) / LightCluster::kCountX) * tanHalfFovX;
+	float bottom = (-1.0f + 2.0f * y / LightCluster::kCountY) * tanHalfFovY;
+	float top = (-1.0f + 2.0f * (y + 1) / LightCluster::kCountY) * tanHalfFovY;
+	float minimum[3] = {extent(left, false), extent(bottom, false), nearDepth};
+	float maximum[3] = {extent(right, true), extent(top, true), farDepth};
+	float center[3] = {sphere.x, sphere.y, sphere.z};
+
+	float distanceSq = 0.0f;
+	for (int axis = 0; axis < 3; axis++) {
+		float outside = (std::max)(minimum[axis] - center[axis], center[axis] - maximum[axis]);
+		float d = (std::max)(outside, 0.0f);
+		distanceSq += d * d;
+	}
+	return distanceSq;
+}
+
+// 全クラスタと全ライトの総当たりと比べる
+// 境界の付近（半径の誤差の範囲）で判定が分かれるものは、どちらでもよい
+bool MatchesBruteForce(
+  const LightCluster& cluster, const Camera& camera, const std::vector<XMFLOAT4>& spheres,
+  const std::vector<uint32_t>& lightIds) {
+	std::vector<XMFLOAT4> viewSpheres(spheres.size());
+	for (size_t i = 0; i < spheres.size(); i++) {
+		XMVECTOR center = XMVector3TransformCoord(XMLoadFloat4(&spheres[i]), camera.matView);
+		XMStoreFloat4(&viewSpheres[i], center);
+		viewSpheres[i].w = spheres[i].w;
+	}
+
+	const std::vector<LightCluster::Range>& ranges = cluster.GetRanges();
+	const std::vector<uint32_t>& indices = cluster.GetIndices();
+	uint32_t offset = 0;
+	for (uint32_t z = 0; z < LightCluster::kCountZ; z++) {
+		for (uint32_t y = 0; y < LightCluster::kCountY; y++) {
+			for (uint32_t x = 0; x < LightCluster::kCountX; x++) {
+				// クラスタ番号順に隙間なく並ぶ
+				const LightCluster::Range& range = ranges[LightCluster::GetClusterIndex(x, y, z)];
+				if (range.offset != offset) {
+					return false;
+				}
+				offset += range.count;
+
+				// 入力順に並ぶので、先頭から照らし合わせる
+				uint32_t next = range.offset;
+				uint32_t end = range.offset + range.count;
+				for (size_t i = 0; i < spheres.size(); i++) {
+					float distanceSq = GetDistanceSq(camera, x, y, z, viewSpheres[i]);
+					float inner = viewSpheres[i].w * (1.0f - kRadiusTolerance);
+					float outer = viewSpheres[i].w * (1.0f + kRadiusTolerance);
+					bool listed = next < end && indices[next] == lightIds[i];
+					if (listed) {
+						next++;
+					}
+					if (listed ? outer * outer < distanceSq : distanceSq <= inner * inner) {
+						return false;
+					}
+				}
+				// 余分な番号（埋めた要素など）はない
+				if (next != end) {
+					return false;
+				}
+			}
+		}
+	}
+	return offset == indices.size();
+}
+
+// ランダムなライト（視錐台の近くに散らばり、手前と奥の境界をまたぐものを含む）
+void MakeLights(
+  uint32_t seed, uint32_t count, const Camera& camera, std::vector<XMFLOAT4>* spheres,
+  std::vector<uint32_t>* lightIds) {
+	Test::Random random(seed);
+	XMMATRIX matInverseView = XMMatrixInverse(nullptr, camera.matView);
+	spheres->clear();
+	lightIds->clear();
+	for (uint32_t i = 0; i < count; i++) {
+		XMFLOAT4 view;
+		switch (i % 4) {
+		case 0: // 手前の境界付近（視点の後ろを含む）
+			view = {
+			  random.Range(-2.0f, 2.0f), random.Range(-2.0f, 2.0f), random.Range(-3.0f, 2.0f),
+			  random.Range(0.5f, 3.0f)};
+			break;
+		case 1: // 奥の境界付近
+			view = {
+			  random.Range(-80.0f, 80.0f), random.Range(-50.0f, 50.0f),
+			  random.Range(180.0f, 230.0f), random.Range(1.0f, 40.0f)};
+			break;
+		default: // 視錐台の中と周り
+			view = {
+			  random.Range(-100.0f, 100.0f), random.Range(-60.0f, 60.0f),
+			  random.Range(-10.0f, 200.0f), random.Range(0.5f, 15.0f)};
+			break;
+		}
+		XMFLOAT4 sphere;
+		XMStoreFloat4(&sphere, XMVector3TransformCoord(XMLoadFloat4(&view), matInverseView));
+		sphere.w = view.w;
+		spheres->push_back(sphere);
+		lightIds->push_back(i * 7 + 3);
+	}
+}
+
+// ライト数を変えて総当たりと一致すること（4の倍数でない数で、埋めた要素が混ざらないこと）
+void TestMatchesBruteForce() {
+	Camera camera = MakeCamera();
+	const uint32_t counts[] = {0, 1, 2, 3, 5, 6, 7, 61, 250};
+	for (uint32_t count : counts) {
+		std::vector<XMFLOAT4> spheres;
+		std::vector<uint32_t> lightIds;
+		MakeLights(count, count, camera, &spheres, &lightIds);
+
+		LightCluster cluster;
+		cluster.Build(
+		  camera.matView, camera.fovAngleY, camera.aspectRatio, camera.nearZ, camera.farZ,
+		  spheres.data(), lightIds.data(), count);
+		TEST_CHECK(cluster.GetRanges().size() == LightCluster::kClusterCount);
+		TEST_CHECK(MatchesBruteForce(cluster, camera, spheres, lightIds));
+	}
+}
+
+// 手前と奥の外側、境界をまたぐもの、減衰しないライト
+void TestNearFar() {
+	// 原点から+Zを向く
+	Camera camera = MakeCamera();
+	camera.matView = XMMatrixIdentity();
+
+	std::vector<XMFLOAT4> spheres = {
+	  {0, 0, -5.0f, 1.0f},        // 視点の後ろ（どこにも入らない）
+	  {0, 0, 0.0f, 1.0f},         // 手前の境界をまたぐ
+	  {0, 0, 300.0f, 50.0f},      // 奥の外（どこにも入らない）
+	  {0, 0, 220.0f, 25.0f},      // 奥の境界をまたぐ
+	  {0, 0, 50.0f, FLT_MAX},     // 減衰しない（全てに入る）
+	  {1000.0f, 0, 50.0f, 10.0f}, // 横の外（どこにも入らない）
+	};
+	std::vector<uint32_t> lightIds = {10, 11, 12, 13, 14, 15};
+
+	LightCluster cluster;
+	cluster.Build(
+	  camera.matView, camera.fovAngleY, camera.aspectRatio, camera.nearZ, camera.farZ,
+	  spheres.data(), lightIds.data(), static_cast<uint32_t>(spheres.size()));
+	TEST_CHECK(MatchesBruteForce(cluster, camera, spheres, lightIds));
+
+	// 区切りごとにどのライトが入ったか
+	uint32_t sliceHits[LightCluster::kCountZ][6] = {};
+	const std::vector<uint32_t>& indices = cluster.GetIndices();
+	for (uint32_t z = 0; z < LightCluster::kCountZ; z++) {
+		for (uint32_t i = 0; i < LightCluster::kCountX * LightCluster::kCountY; i++) {
+			const LightCluster::Range& range =
+			  cluster.GetRanges()[LightCluster::GetClusterIndex(0, 0, z) + i];
+			for (uint32_t j = 0; j < range.count; j++) {
+				sliceHits[z][indices[range.offset + j] - 10]++;
+			}
+		}
+	}
+	const uint32_t kSliceClusterCount = LightCluster::kCountX * LightCluster::kCountY;
+	TEST_CHECK(sliceHits[0][0] == 0 && sliceHits[0][1] > 0);
+	TEST_CHECK(sliceHits[LightCluster::kCountZ - 1][3] > 0);
+	for (uint32_t z = 0; z < LightCluster::kCountZ; z++) {
+		TEST_CHECK(sliceHits[z][0] == 0 && sliceHits[z][2] == 0 && sliceHits[z][5] == 0);
+		TEST_CHECK(sliceHits[z][4] == kSliceClusterCount);
+	}
+}
+
+// スレッドプールで区切りを分けても、呼び出し元だけで構築した結果と一致すること
+void TestThreadPool() {
+	Camera camera = MakeCamera();
+	std::vector<XMFLOAT4> spheres;
+	std::vector<uint32_t> lightIds;
+	MakeLights(99, 503, camera, &spheres, &lightIds);
+
+	LightCluster serial;
+	serial.Build(
+	  camera.matView, camera.fovAngleY, camera.aspectRatio, camera.nearZ, camera.farZ,
+	  spheres.data(), lightIds.data(), static_cast<uint32_t>(spheres.size()));
+	TEST_CHECK(MatchesBruteForce(serial, camera, spheres, lightIds));
+
+	const uint32_t threadCounts[] = {1, 2, 7};
+	for (uint32_t threadCount : threadCounts) {
+		ThreadPool pool(threadCount);
+		LightCluster parallel;
+		// 2回目は作業領域を使い回す（前回より少ないライト）
+		for (uint32_t count : {uint32_t(spheres.size()), 100u}) {
+			parallel.Build(
+			  camera.matView, camera.fovAngleY, camera.aspectRatio, camera.nearZ, camera.farZ,
+			  spheres.data(), lightIds.data(), count, &pool);
+			serial.Build(
+			  camera.matView, camera.fovAngleY, camera.aspectRatio, camera.nearZ, camera.farZ,
+			  spheres.data(), lightIds.data(), count);
+			TEST_CHECK(parallel.GetIndices() == serial.GetIndices());
+			bool sameRanges = true;
+			for (uint32_t i = 0; i < LightCluster::kClusterCount; i++) {
+				const LightCluster::Range& a = parallel.GetRanges()[i];
+				const LightCluster::Range& b = serial.GetRanges()[i];
+				sameRanges = sameRanges && a.offset == b.offset && a.count == b.count;
+			}
+			TEST_CHECK(sameRanges);
+		}
+	}
+}
+
+// 減衰から求めた半径で、明るさがちょうど下限になること
+void TestComputeRange() {
+	XMFLOAT3 atten = {1.0f, 0.1f, 0.05f};
+	float range = LightCluster::ComputeRange(atten, 2.0f);
+	float brightness = 2.0f / (atten.x + atten.y * range + atten.z * range * range);
+	TEST_CHECK_NEAR(brightness, LightCluster::kAttenuationCutoff, 1e-6f);
+	// 線形のみ、減衰なし、最初から暗い
+	TEST_CHECK_NEAR(LightCluster::ComputeRange({1.0f, 1.0f, 0.0f}, 1.0f), 255.0f, 1e-3f);
+	TEST_CHECK(LightCluster::ComputeRange({1.0f, 0.0f, 0.0f}, 1.0f) == FLT_MAX);
+	TEST_CHECK(LightCluster::ComputeRange({1000.0f, 0.0f, 0.0f}, 1.0f) == 0.0f);
+}
+
+} // namespace
+
+int main() {
+	TestMatchesBruteForce();
+	TestNearFar();
+	TestThreadPool();
+	TestComputeRange();
+
+	return Test::Finish("LightClusterTest");
+}
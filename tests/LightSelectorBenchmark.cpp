@@ -0,0 +1,88 @@
+﻿#include "LightSelector.h"
+#include "TestUtility.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+// 1万オブジェクト × 1千ライトのライト選択
+// 比較用に、全ライトを採点して部分ソートする1つずつの実装も測る
+int main() {
+	const uint32_t kObjectCount = 10000;
+	const uint32_t kLightCount = 1000;
+
+	Test::Random random(1);
+	std::vector<XMFLOAT4> lightSpheres(kLightCount);
+	std::vector<XMFLOAT3> attens(kLightCount);
+	std::vector<float> intensities(kLightCount);
+	std::vector<uint32_t> lightIds(kLightCount);
+	for (uint32_t i = 0; i < kLightCount; i++) {
+		lightSpheres[i] = {
+		  random.Range(0.0f, 200.0f), random.Range(0.0f, 20.0f), random.Range(0.0f, 200.0f),
+		  random.Range(5.0f, 45.0f)};
+		attens[i] = {1.0f, random.Range(0.0f, 0.2f), random.Range(0.0f, 0.05f)};
+		intensities[i] = random.Range(0.2f, 1.2f);
+		lightIds[i] = i;
+	}
+	std::vector<XMFLOAT4> objects(kObjectCount);
+	for (XMFLOAT4& object : objects) {
+		object = {
+		  random.Range(0.0f, 200.0f), random.Range(0.0f, 20.0f), random.Range(0.0f, 200.0f),
+		  random.Range(0.5f, 3.5f)};
+	}
+
+	LightSelector selector;
+	selector.SetLights(
+	  lightSpheres.data(), attens.data(), intensities.data(), lightIds.data(), kLightCount);
+	std::vector<LightSelector::LightSet> lightSets(kObjectCount);
+
+	double serial = Test::MeasureMilliseconds(
+	  5, [&]() { selector.Select(objects.data(), kObjectCount, lightSets.data()); });
+	Test::Report("Select", serial, kObjectCount);
+
+	double parallel = Test::MeasureMilliseconds(5, [&]() {
+		selector.Select(objects.data(), kObjectCount, lightSets.data(), ThreadPool::GetInstance());
+	});
+	Test::Report("Select (ThreadPool)", parallel, kObjectCount);
+
+	uint64_t selectedCount = 0;
+	for (const LightSelector::LightSet& lightSet : lightSets) {
+		selectedCount += lightSet.count;
+	}
+	printf("%.2f lights per object\n", double(selectedCount) / kObjectCount);
+
+	// 全ライトの点数を求めて上位を部分ソートする（1つずつ）
+	std::vector<std::pair<float, uint32_t>> scores(kLightCount);
+	uint32_t checksum = 0;
+	double bruteForce = Test::MeasureMilliseconds(1, [&]() {
+		for (const XMFLOAT4& object : objects) {
+			for (uint32_t i = 0; i < kLightCount; i++) {
+				const XMFLOAT4& light = lightSpheres[i];
+				float dx = light.x - object.x;
+				float dy = light.y - object.y;
+				float dz = light.z - object.z;
+				float length = std::sqrt(dx * dx + dy * dy + dz * dz);
+				float distance = (std::max)(length - object.w, 0.0f);
+				float score = 0.0f;
+				if (distance < light.w) {
+					float denominator =
+					  attens[i].x + distance * (attens[i].y + distance * attens[i].z);
+					score = intensities[i] / denominator;
+				}
+				scores[i] = {score, i};
+			}
+			std::partial_sort(
+			  scores.begin(), scores.begin() + LightSelector::kMaxLights, scores.end(),
+			  [](const std::pair<float, uint32_t>& a, const std::pair<float, uint32_t>& b) {
+				  return a.first > b.first;
+			  });
+			checksum += scores[0].second;
+		}
+	});
+	Test::KeepAlive(checksum);
+	Test::Report("brute force (scalar + partial_sort)", bruteForce, kObjectCount);
+
+	printf("speedup %.2fx (%.2fx with ThreadPool)\n", bruteForce / serial, bruteForce / parallel);
+	return Test::Finish("LightSelectorBenchmark");
+}
@@ -0,0 +1,187 @@
+﻿#include "LightSelector.h"
+#include "TestUtility.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace DirectX;
+
+namespace {
+
+// ライトの配列
+struct Lights {
+	std::vector<XMFLOAT4> spheres;
+	std::vector<XMFLOAT3> attens;
+	std::vector<float> intensities;
+	std::vector<uint32_t> lightIds;
+};
+
+// 総当たりで選んだライト（点数の計算はSelectと同じ順で行う）
+LightSelector::LightSet SelectBruteForce(const Lights& lights, const XMFLOAT4& sphere) {
+	std::vector<std::pair<float, uint32_t>> candidates;
+	for (uint32_t i = 0; i < lights.spheres.size(); i++) {
+		const XMFLOAT4& light = lights.spheres[i];
+		float dx = light.x - sphere.x;
+		float dy = light.y - sphere.y;
+		float dz = light.z - sphere.z;
+		float distance = (std::max)(std::sqrt(dz * dz + (dy * dy + dx * dx)) - sphere.w, 0.0f);
+		if (!(distance < light.w)) {
+			continue;
+		}
+		const XMFLOAT3& atten = lights.attens[i];
+		float score = lights.intensities[i] / (distance * (distance * atten.z + atten.y) + atten.x);
+		if (score > 0.0f) {
+			candidates.push_back({score, lights.lightIds[i]});
+		}
+	}
+	// 点数の高い順（同じ点数なら先のライト）
+	std::stable_sort(
+	  candidates.begin(), candidates.end(),
+	  [](const std::pair<float, uint32_t>& a, const std::pair<float, uint32_t>& b) {
+		  return a.first > b.first;
+	  });
+
+	LightSelector::LightSet lightSet = {};
+	uint32_t candidateCount = static_cast<uint32_t>(candidates.size());
+	lightSet.count = (std::min)(candidateCount, LightSelector::kMaxLights);
+	for (uint32_t i = 0; i < lightSet.count; i++) {
+		lightSet.indices[i] = candidates[i].second;
+	}
+	return lightSet;
+}
+
+// 選んだ数と番号が同じであること（数より後ろは見ない）
+bool IsSameSelection(const LightSelector::LightSet& a, const LightSelector::LightSet& b) {
+	return a.count == b.count && std::equal(a.indices, a.indices + a.count, b.indices);
+}
+
+// ランダムなライト（同じ位置、同じ明るさのものを混ぜる）
+Lights MakeLights(uint32_t seed, uint32_t count) {
+	Test::Random random(seed);
+	Lights lights;
+	for (uint32_t i = 0; i < count; i++) {
+		if (i % 10 == 9) {
+			// 直前と同じライト（点数が同じになる）
+			lights.spheres.push_back(lights.spheres.back());
+			lights.attens.push_back(lights.attens.back());
+			lights.intensities.push_back(lights.intensities.back());
+		} else {
+			lights.spheres.push_back(
+			  {random.Range(0.0f, 100.0f), random.Range(0.0f, 10.0f), random.Range(0.0f, 100.0f),
+			   random.Range(5.0f, 30.0f)});
+			lights.attens.push_back(
+			  {1.0f, random.Range(0.0f, 0.2f), random.Range(0.0f, 0.05f)});
+			lights.intensities.push_back(random.Range(0.0f, 1.5f));
+		}
+		lights.lightIds.push_back(1000 + i * 3);
+	}
+	return lights;
+}
+
+// ランダムなオブジェクト
+std::vector<XMFLOAT4> MakeObjects(uint32_t seed, uint32_t count) {
+	Test::Random random(seed);
+	std::vector<XMFLOAT4> objects;
+	for (uint32_t i = 0; i < count; i++) {
+		objects.push_back(
+		  {random.Range(-10.0f, 110.0f), random.Range(0.0f, 10.0f), random.Range(-10.0f, 110.0f),
+		   random.Range(0.0f, 5.0f)});
+	}
+	return objects;
+}
+
+// ライト数を変えて総当たりと一致すること（4の倍数でない数で、埋めた要素が選ばれないこと）
+void TestMatchesBruteForce() {
+	const uint32_t lightCounts[] = {0, 1, 2, 3, 5, 7, 8, 9, 63, 300};
+	for (uint32_t lightCount : lightCounts) {
+		Lights lights = MakeLights(lightCount + 1, lightCount);
+		LightSelector selector;
+		selector.SetLights(
+		  lights.spheres.data(), lights.attens.data(), lights.intensities.data(),
+		  lights.lightIds.data(), lightCount);
+		TEST_CHECK(selector.GetLightCount() == lightCount);
+
+		std::vector<XMFLOAT4> objects = MakeObjects(lightCount + 2, 500);
+		bool same = true;
+		bool filled = false;
+		for (const XMFLOAT4& object : objects) {
+			LightSelector::LightSet lightSet;
+			selector.Select(object, lightSet);
+			same = same && IsSameSelection(lightSet, SelectBruteForce(lights, object));
+			same = same && lightSet.pad[0] == 0 && lightSet.pad[1] == 0 && lightSet.pad[2] == 0;
+			filled = filled || lightSet.count == LightSelector::kMaxLights;
+		}
+		TEST_CHECK(same);
+		// 多ければ上位だけを選ぶ場合も含まれる
+		TEST_CHECK(filled == (lightCount >= 63));
+	}
+}
+
+// 範囲の境界と点数の順
+void TestScoring() {
+	Lights lights;
+	lights.spheres = {
+	  {0, 0, 10.0f, 5.0f}, // 表面から5で範囲ちょうど（選ばない）
+	  {0, 0, 9.0f, 5.0f},  // 範囲内
+	  {0, 0, 1.0f, 1.0f},  // オブジェクトの中（距離0）
+	  {0, 0, 2.0f, 5.0f},  // 明るさ0（選ばない）
+	};
+	lights.attens = {{1, 0, 0}, {1, 0, 0}, {1, 1, 0}, {1, 0, 0}};
+	lights.intensities = {1.0f, 0.5f, 0.8f, 0.0f};
+	lights.lightIds = {0, 1, 2, 3};
+	LightSelector selector;
+	selector.SetLights(
+	  lights.spheres.data(), lights.attens.data(), lights.intensities.data(),
+	  lights.lightIds.data(), 4);
+
+	LightSelector::LightSet lightSet;
+	selector.Select({0, 0, 0, 5.0f}, lightSet);
+	TEST_CHECK(lightSet.count == 2);
+	TEST_CHECK(lightSet.indices[0] == 2 && lightSet.indices[1] == 1);
+	TEST_CHECK(IsSameSelection(lightSet, SelectBruteForce(lights, {0, 0, 0, 5.0f})));
+}
+
+// スレッドプールで分けても、1つずつ選んだ結果と一致すること
+void TestThreadPool() {
+	Lights lights = MakeLights(7, 203);
+	LightSelector selector;
+	selector.SetLights(
+	  lights.spheres.data(), lights.attens.data(), lights.intensities.data(),
+	  lights.lightIds.data(), 203);
+
+	// 1つのタスクの数に端数が出る数
+	const uint32_t kObjectCount = 2000;
+	std::vector<XMFLOAT4> objects = MakeObjects(8, kObjectCount);
+	std::vector<LightSelector::LightSet> serial(kObjectCount);
+	selector.Select(objects.data(), kObjectCount, serial.data());
+	bool same = true;
+	for (uint32_t i = 0; i < kObjectCount; i++) {
+		LightSelector::LightSet lightSet;
+		selector.Select(objects[i], lightSet);
+		same = same && IsSameSelection(lightSet, serial[i]);
+	}
+	TEST_CHECK(same);
+
+	const uint32_t threadCounts[] = {1, 2, 7};
+	for (uint32_t threadCount : threadCounts) {
+		ThreadPool pool(threadCount);
+		std::vector<LightSelector::LightSet> parallel(kObjectCount);
+		selector.Select(objects.data(), kObjectCount, parallel.data(), &pool);
+		bool sameParallel = true;
+		for (uint32_t i = 0; i < kObjectCount; i++) {
+			sameParallel = sameParallel && IsSameSelection(parallel[i], serial[i]);
+		}
+		TEST_CHECK(sameParallel);
+	}
+}
+
+} // namespace
+
+int main() {
+	TestMatchesBruteForce();
+	TestScoring();
+	TestThreadPool();
+
+	return Test::Finish("LightSelectorTest");
+}
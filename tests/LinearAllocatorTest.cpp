@@ -0,0 +1,186 @@
+﻿#include "HeapPageSource.h"
+#include "LinearAllocator.h"
+#include "TestUtility.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+const size_t kPageSize = 64 * 1024;
+
+// 確保した領域が重ならず、ページ内でCPUとGPUのオフセットが一致すること
+bool IsValidLayout(std::vector<LinearAllocator::Allocation> allocations) {
+	std::sort(
+	  allocations.begin(), allocations.end(),
+	  [](const LinearAllocator::Allocation& a, const LinearAllocator::Allocation& b) {
+		  return a.gpuAddress < b.gpuAddress;
+	  });
+	for (size_t i = 1; i < allocations.size(); i++) {
+		if (allocations[i - 1].gpuAddress + allocations[i - 1].size > allocations[i].gpuAddress) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// GPUアドレスが指定の境界に揃うこと（ページの先頭がずれていても）
+void TestAlignment() {
+	HeapPageSource pageSource(64);
+	LinearAllocator allocator(&pageSource, kPageSize);
+
+	Test::Random random(1);
+	std::vector<LinearAllocator::Allocation> allocations;
+	for (int i = 0; i < 2000; i++) {
+		size_t alignment = size_t(1) << random.Next(13);
+		size_t size = 1 + random.Next(700);
+		LinearAllocator::Allocation allocation = allocator.Allocate(size, alignment);
+
+		TEST_CHECK(allocation.cpuAddress != nullptr);
+		TEST_CHECK(allocation.gpuAddress % alignment == 0);
+		TEST_CHECK(allocation.size == size);
+		TEST_CHECK(allocation.pageOffset + size <= kPageSize);
+		// ページ内の位置がCPUとGPUで同じ
+		uint64_t pageGpuAddress = (uint64_t(allocation.pageId) + 1) * 0x100000000ull + 64;
+		TEST_CHECK(allocation.gpuAddress - pageGpuAddress == allocation.pageOffset);
+		allocations.push_back(allocation);
+	}
+	TEST_CHECK(IsValidLayout(allocations));
+
+	// 既定は定数バッファの配置境界
+	LinearAllocator::Allocation allocation = allocator.Allocate(sizeof(float) * 4);
+	TEST_CHECK(allocation.gpuAddress % LinearAllocator::kDefaultAlignment == 0);
+}
+
+// 書き込んだ内容が他の確保で壊れないこと
+void TestWrite() {
+	HeapPageSource pageSource;
+	LinearAllocator allocator(&pageSource, kPageSize);
+
+	std::vector<LinearAllocator::Allocation> allocations;
+	for (uint32_t i = 0; i < 1000; i++) {
+		LinearAllocator::Allocation allocation = allocator.Allocate(sizeof(uint32_t) * 8);
+		for (uint32_t j = 0; j < 8; j++) {
+			static_cast<uint32_t*>(allocation.cpuAddress)[j] = i * 8 + j;
+		}
+		allocations.push_back(allocation);
+	}
+
+	bool intact = true;
+	for (uint32_t i = 0; i < allocations.size(); i++) {
+		for (uint32_t j = 0; j < 8; j++) {
+			intact = intact && static_cast<uint32_t*>(allocations[i].cpuAddress)[j] == i * 8 + j;
+		}
+	}
+	TEST_CHECK(intact);
+}
+
+// Resetで先頭から使い直し、同じ確保の繰り返しではページが増えないこと
+void TestReset() {
+	HeapPageSource pageSource;
+	LinearAllocator allocator(&pageSource, kPageSize);
+
+	LinearAllocator::Allocation first;
+	for (int frame = 0; frame < 10; frame++) {
+		for (int i = 0; i < 1000; i++) {
+			LinearAllocator::Allocation allocation = allocator.Allocate(200);
+			if (i == 0) {
+				if (frame == 0) {
+					first = allocation;
+				}
+				// 毎フレーム同じ先頭から
+				TEST_CHECK(allocation.gpuAddress == first.gpuAddress);
+			}
+		}
+		// 256バイト境界で1000個 = 4ページ弱
+		TEST_CHECK(allocator.GetPageCount() == 4);
+		TEST_CHECK(allocator.GetUsedSize() >= 1000 * 200);
+		allocator.Reset();
+		TEST_CHECK(allocator.GetUsedSize() == 0);
+	}
+	TEST_CHECK(pageSource.createCount == 4);
+	TEST_CHECK(pageSource.releaseCount == 0);
+}
+
+// 使用サイズはページ末尾の捨てた分とアライメントの詰め物を含むこと
+void TestUsedSize() {
+	HeapPageSource pageSource;
+	LinearAllocator allocator(&pageSource, 1024);
+
+	allocator.Allocate(100, 256); // 0..100
+	TEST_CHECK(allocator.GetUsedSize() == 100);
+	allocator.Allocate(100, 256); // 256..356
+	TEST_CHECK(allocator.GetUsedSize() == 356);
+	allocator.Allocate(700, 256); // 収まらないので次のページの先頭へ
+	TEST_CHECK(allocator.GetUsedSize() == 1024 + 700);
+	TEST_CHECK(allocator.GetPageCount() == 2);
+}
+
+// ページに収まらない確保は専用ページになり、Resetで解放されること
+void TestLargeAllocation() {
+	HeapPageSource pageSource;
+	{
+		LinearAllocator allocator(&pageSource, 4096);
+
+		allocator.Allocate(16);
+		LinearAllocator::Allocation large = allocator.Allocate(10000);
+		TEST_CHECK(large.cpuAddress != nullptr);
+		TEST_CHECK(large.gpuAddress % LinearAllocator::kDefaultAlignment == 0);
+		memset(large.cpuAddress, 0xcd, large.size);
+		// 通常ページとは別扱い
+		TEST_CHECK(allocator.GetPageCount() == 1);
+		TEST_CHECK(pageSource.GetLivePageCount() == 2);
+
+		// 大きな確保の後も通常ページの続きから
+		LinearAllocator::Allocation next = allocator.Allocate(16);
+		TEST_CHECK(next.pageId != large.pageId);
+		TEST_CHECK(next.pageOffset == LinearAllocator::kDefaultAlignment);
+
+		allocator.Reset();
+		TEST_CHECK(pageSource.GetLivePageCount() == 1);
+	}
+	// デストラクタで全て返す
+	TEST_CHECK(pageSource.GetLivePageCount() == 0);
+	TEST_CHECK(pageSource.invalidReleaseCount == 0);
+}
+
+// 複数スレッドから同時に確保しても重ならないこと
+void TestConcurrentAllocate() {
+	HeapPageSource pageSource;
+	LinearAllocator allocator(&pageSource, kPageSize);
+
+	const uint32_t kThreadCount = 8;
+	const uint32_t kAllocationCount = 2000;
+	std::vector<std::vector<LinearAllocator::Allocation>> results(kThreadCount);
+	std::vector<std::thread> threads;
+	for (uint32_t t = 0; t < kThreadCount; t++) {
+		threads.emplace_back([&allocator, &results, t]() {
+			for (uint32_t i = 0; i < kAllocationCount; i++) {
+				results[t].push_back(allocator.Allocate(64 + (i % 5) * 100));
+			}
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	std::vector<LinearAllocator::Allocation> allocations;
+	for (std::vector<LinearAllocator::Allocation>& result : results) {
+		allocations.insert(allocations.end(), result.begin(), result.end());
+	}
+	TEST_CHECK(allocations.size() == kThreadCount * kAllocationCount);
+	TEST_CHECK(IsValidLayout(allocations));
+}
+
+} // namespace
+
+int main() {
+	TestAlignment();
+	TestWrite();
+	TestReset();
+	TestUsedSize();
+	TestLargeAllocation();
+	TestConcurrentAllocate();
+
+	return Test::Finish("LinearAllocatorTest");
+}
@@ -0,0 +1,183 @@
+﻿#include "ParallelCommandRecorder.h"
+#include "TestUtility.h"
+#include <atomic>
+#include <thread>
+
+namespace {
+
+// 偽のコマンドリスト（記録した要素と記録したスレッドを残す）
+struct FakeCommandList {
+	std::vector<uint32_t> items;
+	uint32_t beginCount = 0;
+	bool beganBeforeRecord = true;
+	std::thread::id thread;
+	bool singleThread = true;
+};
+
+// 要素番号をそのまま記録する
+class FakeRecorder : public ICommandRecorder<FakeCommandList> {
+  public:
+	explicit FakeRecorder(uint32_t itemCount) : itemCount_(itemCount) {}
+
+	uint32_t GetItemCount() const override { return itemCount_; }
+
+	void Prepare() override {
+		prepareCount++;
+		prepareThread = std::this_thread::get_id();
+	}
+
+	void BeginRecord(FakeCommandList* commandList) override {
+		commandList->beginCount++;
+		commandList->thread = std::this_thread::get_id();
+	}
+
+	void Record(FakeCommandList* commandList, const RecordRange& range) override {
+		if (commandList->beginCount == 0) {
+			commandList->beganBeforeRecord = false;
+		}
+		for (uint32_t i = range.begin; i < range.end; i++) {
+			if (commandList->thread != std::this_thread::get_id()) {
+				commandList->singleThread = false;
+			}
+			commandList->items.push_back(i);
+			// 記録の重さをばらつかせて、完了順と提出順をずらす
+			if ((i * 7919u) % 13u == 0) {
+				std::this_thread::yield();
+			}
+		}
+		recordCount++;
+	}
+
+	uint32_t prepareCount = 0;
+	std::thread::id prepareThread;
+	std::atomic<uint32_t> recordCount{0};
+
+  private:
+	uint32_t itemCount_;
+};
+
+using Recorder = ParallelCommandRecorder<FakeCommandList>;
+
+// 分割した範囲が先頭から隙間なく並び、大きさの差が1以内であること
+void TestSplitRanges() {
+	const uint32_t itemCounts[] = {0, 1, 2, 5, 31, 32, 33, 64, 100, 103, 1000, 4097};
+	const uint32_t maxRangeCounts[] = {0, 1, 3, 4, 8, 64};
+	const uint32_t minItemCounts[] = {0, 1, 16, 32, 5000};
+
+	for (uint32_t itemCount : itemCounts) {
+		for (uint32_t maxRanges : maxRangeCounts) {
+			for (uint32_t minItems : minItemCounts) {
+				std::vector<RecordRange> ranges =
+				  Recorder::SplitRanges(itemCount, maxRanges, minItems);
+
+				if (itemCount == 0 || maxRanges == 0) {
+					TEST_CHECK(ranges.empty());
+					continue;
+				}
+
+				uint32_t minPerRange = (std::max)(minItems, 1u);
+				uint32_t expectedCount =
+				  (std::min)((itemCount + minPerRange - 1) / minPerRange, maxRanges);
+				TEST_CHECK(ranges.size() == expectedCount);
+
+				uint32_t begin = 0;
+				uint32_t smallest = UINT32_MAX;
+				uint32_t largest = 0;
+				for (const RecordRange& range : ranges) {
+					TEST_CHECK(range.begin == begin);
+					TEST_CHECK(range.end > range.begin);
+					smallest = (std::min)(smallest, range.end - range.begin);
+					largest = (std::max)(largest, range.end - range.begin);
+					begin = range.end;
+				}
+				TEST_CHECK(begin == itemCount);
+				TEST_CHECK(largest - smallest <= 1);
+			}
+		}
+	}
+}
+
+// 並列に記録しても、提出順に連結すると元の順になること
+void TestRecordOrder(ThreadPool* pool) {
+	const uint32_t itemCounts[] = {1, 7, 32, 33, 100, 1000, 10007};
+
+	for (uint32_t itemCount : itemCounts) {
+		std::vector<RecordRange> ranges = Recorder::SplitRanges(itemCount, 8, 16);
+
+		for (int repeat = 0; repeat < 20; repeat++) {
+			FakeRecorder recorder(itemCount);
+			std::vector<FakeCommandList> lists(ranges.size());
+			std::vector<FakeCommandList*> listPointers;
+			for (FakeCommandList& list : lists) {
+				listPointers.push_back(&list);
+			}
+
+			Recorder::Record(pool, &recorder, ranges, listPointers.data());
+
+			// 前処理は呼び出し元スレッドで1回だけ
+			TEST_CHECK(recorder.prepareCount == 1);
+			TEST_CHECK(recorder.prepareThread == std::this_thread::get_id());
+			TEST_CHECK(recorder.recordCount.load() == ranges.size());
+
+			std::vector<uint32_t> submitted;
+			for (size_t i = 0; i < lists.size(); i++) {
+				// 範囲ごとに1回だけ共通設定をしてから記録し、1つのスレッドで書き切る
+				TEST_CHECK(lists[i].beginCount == 1);
+				TEST_CHECK(lists[i].beganBeforeRecord);
+				TEST_CHECK(lists[i].singleThread);
+				TEST_CHECK(lists[i].items.size() == ranges[i].end - ranges[i].begin);
+				submitted.insert(submitted.end(), lists[i].items.begin(), lists[i].items.end());
+			}
+
+			TEST_CHECK(submitted.size() == itemCount);
+			bool ordered = true;
+			for (uint32_t i = 0; i < submitted.size(); i++) {
+				ordered = ordered && submitted[i] == i;
+			}
+			TEST_CHECK(ordered);
+		}
+	}
+}
+
+// 全要素を1回ずつ処理してから戻ること
+void TestParallelFor(ThreadPool* pool) {
+	const uint32_t counts[] = {0, 1, 2, 3, 100, 10000};
+	for (uint32_t count : counts) {
+		std::vector<std::atomic<uint32_t>> visits(count);
+		for (std::atomic<uint32_t>& visit : visits) {
+			visit = 0;
+		}
+		pool->ParallelFor(count, [&](uint32_t index) { visits[index]++; });
+
+		bool once = true;
+		for (std::atomic<uint32_t>& visit : visits) {
+			once = once && visit.load() == 1;
+		}
+		TEST_CHECK(once);
+	}
+
+	// Enqueueしたタスクの完了待ち
+	std::atomic<uint32_t> done{0};
+	for (int i = 0; i < 100; i++) {
+		pool->Enqueue([&done]() { done++; });
+	}
+	pool->WaitIdle();
+	TEST_CHECK(done.load() == 100);
+}
+
+} // namespace
+
+int main() {
+	TestSplitRanges();
+
+	// ワーカー数によらず同じ結果になること
+	const uint32_t threadCounts[] = {1, 2, 7};
+	for (uint32_t threadCount : threadCounts) {
+		ThreadPool pool(threadCount);
+		TestRecordOrder(&pool);
+		TestParallelFor(&pool);
+	}
+	TestRecordOrder(ThreadPool::GetInstance());
+
+	return Test::Finish("ParallelCommandRecorderTest");
+}
@@ -0,0 +1,40 @@
+﻿#include "ParticleEmitter2D.h"
+#include "TestUtility.h"
+
+// 100万個のパーティクルの1フレーム（積分、描画用の配列、頂点生成）
+int main() {
+	const uint32_t kParticleCount = 1000000;
+	const float kDeltaTime = 1.0f / 60.0f;
+
+	ParticleEmitter2D::Desc desc;
+	desc.maxParticles = kParticleCount;
+	desc.emissionRate = 2000000.0f;
+	desc.acceleration = {0.0f, 98.0f};
+	desc.lifeMin = 2.0f;
+	desc.lifeMax = 4.0f;
+	desc.seed = 7;
+	ParticleEmitter2D emitter(desc);
+
+	// 最大数まで埋める（以降は消えた分だけ発生する）
+	while (emitter.GetCount() < kParticleCount) {
+		emitter.Update(kDeltaTime);
+	}
+	printf("%u particles\n", emitter.GetCount());
+
+	double update = Test::MeasureMilliseconds(30, [&]() { emitter.Update(kDeltaTime); });
+	Test::Report("Update", update, emitter.GetCount());
+
+	SpriteQuadKernel::Sprites sprites = {};
+	double build = Test::MeasureMilliseconds(30, [&]() { sprites = emitter.BuildSprites(); });
+	Test::Report("BuildSprites", build, emitter.GetCount());
+
+	std::vector<SpriteQuadKernel::Vertex> vertices(size_t(emitter.GetCount()) * 4);
+	double generate = Test::MeasureMilliseconds(10, [&]() {
+		SpriteQuadKernel::Generate(sprites, emitter.GetCount(), vertices.data());
+	});
+	Test::KeepAlive(vertices[vertices.size() / 2]);
+	Test::Report("SpriteQuadKernel::Generate", generate, emitter.GetCount());
+
+	printf("frame %.3f ms\n", update + build + generate);
+	return Test::Finish("ParticleEmitter2DBenchmark");
+}
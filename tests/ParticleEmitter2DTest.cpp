@@ -0,0 +1,139 @@
+﻿#include "ParticleEmitter2D.h"
+#include "TestUtility.h"
+#include <cstring>
+
+using namespace DirectX;
+
+namespace {
+
+// 描画用の配列が全て同じビット列であること
+bool IsSameState(ParticleEmitter2D& a, ParticleEmitter2D& b) {
+	if (a.GetCount() != b.GetCount()) {
+		return false;
+	}
+	SpriteQuadKernel::Sprites spritesA = a.BuildSprites();
+	SpriteQuadKernel::Sprites spritesB = b.BuildSprites();
+	size_t size = sizeof(float) * a.GetCount();
+	return std::memcmp(spritesA.positionX, spritesB.positionX, size) == 0 &&
+	       std::memcmp(spritesA.positionY, spritesB.positionY, size) == 0 &&
+	       std::memcmp(spritesA.sizeX, spritesB.sizeX, size) == 0 &&
+	       std::memcmp(spritesA.color, spritesB.color, sizeof(XMFLOAT4) * a.GetCount()) == 0;
+}
+
+// 同じ種と同じ経過時間の列なら、毎フレーム同じ状態になること
+void TestDeterminism() {
+	ParticleEmitter2D::Desc desc;
+	desc.maxParticles = 1001; // 4の倍数でない
+	desc.emissionRate = 1500.0f;
+	desc.acceleration = {10.0f, 98.0f};
+	desc.lifeMin = 0.2f;
+	desc.lifeMax = 1.5f;
+	desc.endSize = 4.0f;
+	desc.seed = 12345;
+	ParticleEmitter2D a(desc);
+	ParticleEmitter2D b(desc);
+
+	Test::Random random(1);
+	bool same = true;
+	bool reachedMax = false;
+	for (int frame = 0; frame < 300; frame++) {
+		// 可変フレームレート、途中での移動とまとめての発生
+		float deltaTime = random.Range(1.0f / 240.0f, 1.0f / 20.0f);
+		if (frame % 50 == 25) {
+			XMFLOAT2 position = {random.Range(0.0f, 100.0f), random.Range(0.0f, 100.0f)};
+			a.SetPosition(position);
+			b.SetPosition(position);
+			a.Burst(200);
+			b.Burst(200);
+		}
+		a.Update(deltaTime);
+		b.Update(deltaTime);
+		// 片方だけ描画用の配列を作っても結果は変わらない
+		if (frame % 3 == 0) {
+			a.BuildSprites();
+		}
+		same = same && IsSameState(a, b);
+		reachedMax = reachedMax || a.GetCount() == desc.maxParticles;
+		TEST_CHECK(a.GetCount() <= desc.maxParticles);
+	}
+	TEST_CHECK(same);
+	TEST_CHECK(reachedMax);
+
+	// 種が違えば別の状態になる
+	desc.seed = 54321;
+	ParticleEmitter2D c(desc);
+	ParticleEmitter2D d(desc);
+	c.Burst(100);
+	d.Burst(100);
+	c.Update(0.1f);
+	d.Update(0.1f);
+	TEST_CHECK(IsSameState(c, d));
+	TEST_CHECK(!IsSameState(a, c));
+}
+
+// 積分、寿命、発生数、色と大きさの補間が設定どおりであること
+void TestBehavior() {
+	ParticleEmitter2D::Desc desc;
+	desc.maxParticles = 10;
+	desc.emissionRate = 0.0f;
+	desc.position = {100.0f, 200.0f};
+	desc.direction = 0.0f;
+	desc.spread = 0.0f;
+	desc.speedMin = desc.speedMax = 30.0f;
+	desc.lifeMin = desc.lifeMax = 1.0f;
+	desc.acceleration = {0.0f, 10.0f};
+	desc.startColor = {1.0f, 0.0f, 0.0f, 1.0f};
+	desc.endColor = {0.0f, 0.0f, 1.0f, 0.0f};
+	desc.startSize = 10.0f;
+	desc.endSize = 20.0f;
+	ParticleEmitter2D emitter(desc);
+
+	// 空きの分だけ発生する
+	emitter.Burst(7);
+	emitter.Burst(7);
+	TEST_CHECK(emitter.GetCount() == 10);
+
+	// 半分の寿命（加速度を足してから速度で進める）
+	const int kSteps = 30;
+	const float dt = 1.0f / 60.0f;
+	for (int i = 0; i < kSteps; i++) {
+		emitter.Update(dt);
+	}
+	float expectedY = 200.0f + 10.0f * dt * dt * kSteps * (kSteps + 1) / 2.0f;
+	SpriteQuadKernel::Sprites sprites = emitter.BuildSprites();
+	for (uint32_t i = 0; i < emitter.GetCount(); i++) {
+		TEST_CHECK_NEAR(sprites.positionX[i], 100.0f + 30.0f * dt * kSteps, 1e-3f);
+		TEST_CHECK_NEAR(sprites.positionY[i], expectedY, 1e-3f);
+		TEST_CHECK_NEAR(sprites.sizeX[i], 15.0f, 1e-3f);
+		TEST_CHECK_NEAR(sprites.color[i].x, 0.5f, 1e-3f);
+		TEST_CHECK_NEAR(sprites.color[i].z, 0.5f, 1e-3f);
+		TEST_CHECK_NEAR(sprites.color[i].w, 0.5f, 1e-3f);
+	}
+
+	// 寿命が尽きると消える
+	for (int i = 0; i < kSteps + 1; i++) {
+		emitter.Update(dt);
+	}
+	TEST_CHECK(emitter.GetCount() == 0);
+
+	// 1秒あたりの発生数（端数は次のフレームへ持ち越す）
+	desc.lifeMin = desc.lifeMax = 100.0f;
+	desc.maxParticles = 1000;
+	desc.emissionRate = 90.0f;
+	ParticleEmitter2D continuous(desc);
+	for (int i = 0; i < 120; i++) {
+		continuous.Update(1.0f / 120.0f);
+	}
+	TEST_CHECK(continuous.GetCount() >= 89 && continuous.GetCount() <= 90);
+	continuous.Clear();
+	TEST_CHECK(continuous.GetCount() == 0);
+}
+
+} // namespace
+
+int main() {
+	TestDeterminism();
+	TestBehavior();
+
+	return Test::Finish("ParticleEmitter2DTest");
+}
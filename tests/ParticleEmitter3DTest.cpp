@@ -0,0 +1,146 @@
+﻿#include "ParticleEmitter3D.h"
+#include "TestUtility.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace DirectX;
+
+namespace {
+
+// 広がって飛ぶ発生源の設定
+ParticleEmitter3D::Desc MakeDesc(uint32_t maxParticles, uint32_t seed) {
+	ParticleEmitter3D::Desc desc;
+	desc.maxParticles = maxParticles;
+	desc.emissionRate = float(maxParticles);
+	desc.spread = XM_PIDIV2;
+	desc.speedMin = 1.0f;
+	desc.speedMax = 5.0f;
+	desc.lifeMin = 0.5f;
+	desc.lifeMax = 3.0f;
+	desc.acceleration = {0.5f, -9.8f, 0.25f};
+	desc.startSize = 0.5f;
+	desc.endSize = 2.0f;
+	desc.seed = seed;
+	return desc;
+}
+
+// std::stable_sortで求めた遠い順（距離の計算はSortBackToFrontと同じ順で行う）
+std::vector<uint32_t> SortReference(const ParticleEmitter3D& emitter, const XMFLOAT3& eye) {
+	std::vector<float> distances(emitter.GetCount());
+	for (uint32_t i = 0; i < emitter.GetCount(); i++) {
+		XMFLOAT3 position = emitter.GetParticlePosition(i);
+		float dx = position.x - eye.x;
+		float dy = position.y - eye.y;
+		float dz = position.z - eye.z;
+		distances[i] = dz * dz + (dy * dy + dx * dx);
+	}
+	std::vector<uint32_t> order(emitter.GetCount());
+	for (uint32_t i = 0; i < order.size(); i++) {
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(), order.end(), [&distances](uint32_t a, uint32_t b) {
+		return distances[a] > distances[b];
+	});
+	return order;
+}
+
+// 遠い順の並べ替えがstable_sortと一致し、インスタンスデータがその順に並ぶこと
+void TestSortBackToFront() {
+	const uint32_t maxCounts[] = {1, 3, 4, 5, 257, 10000};
+	for (uint32_t maxCount : maxCounts) {
+		ParticleEmitter3D emitter(MakeDesc(maxCount, maxCount));
+		for (int frame = 0; frame < 40; frame++) {
+			emitter.Update(1.0f / 30.0f);
+		}
+		if (!TEST_CHECK(0 < emitter.GetCount())) {
+			continue;
+		}
+
+		const XMFLOAT3 eyes[] = {{0, 0, -10}, {3, 2, 1}, {0, 0, 0}};
+		for (const XMFLOAT3& eye : eyes) {
+			emitter.SortBackToFront(eye);
+			std::vector<uint32_t> expected = SortReference(emitter, eye);
+			const uint32_t* order = emitter.GetSortedOrder();
+			if (!TEST_CHECK(order != nullptr || emitter.GetCount() == 1)) {
+				continue;
+			}
+			if (order) {
+				TEST_CHECK(std::equal(expected.begin(), expected.end(), order));
+			}
+
+			std::vector<ParticleEmitter3D::Instance> instances(emitter.GetCount());
+			emitter.WriteInstances(instances.data());
+			bool inOrder = true;
+			for (uint32_t i = 0; i < emitter.GetCount(); i++) {
+				XMFLOAT3 position = emitter.GetParticlePosition(expected[i]);
+				inOrder =
+				  inOrder && std::memcmp(&instances[i].position, &position, sizeof(position)) == 0;
+			}
+			TEST_CHECK(inOrder);
+		}
+
+		// 更新すると並べ替えの結果は無効になる
+		emitter.Update(1.0f / 30.0f);
+		TEST_CHECK(emitter.GetSortedOrder() == nullptr);
+	}
+
+	// 全て同じ距離なら格納順のまま（発生直後は全て発生位置）
+	ParticleEmitter3D emitter(MakeDesc(100, 1));
+	emitter.Burst(100);
+	emitter.SortBackToFront({1, 2, 3});
+	TEST_CHECK(emitter.GetSortedOrder() == nullptr);
+}
+
+// 2つの発生源の状態が全て同じビット列であること
+bool IsSameState(const ParticleEmitter3D& a, const ParticleEmitter3D& b) {
+	if (a.GetCount() != b.GetCount()) {
+		return false;
+	}
+	std::vector<ParticleEmitter3D::Instance> instancesA(a.GetCount());
+	std::vector<ParticleEmitter3D::Instance> instancesB(b.GetCount());
+	a.WriteInstances(instancesA.data());
+	b.WriteInstances(instancesB.data());
+	return std::memcmp(
+	         instancesA.data(), instancesB.data(),
+	         sizeof(ParticleEmitter3D::Instance) * a.GetCount()) == 0;
+}
+
+// スレッドプールで分けて積分しても、呼び出し元だけで積分した結果と一致すること
+void TestParallelMatchesSerial() {
+	// 区切りの端数が出る数
+	const uint32_t kMaxParticles = ParticleEmitter3D::kChunkSize * 5 + 123;
+	const uint32_t threadCounts[] = {1, 2, 7};
+	for (uint32_t threadCount : threadCounts) {
+		ThreadPool pool(threadCount);
+		ParticleEmitter3D parallel(MakeDesc(kMaxParticles, 42));
+		ParticleEmitter3D serial(MakeDesc(kMaxParticles, 42));
+
+		Test::Random random(threadCount);
+		bool same = true;
+		bool chunked = false;
+		for (int frame = 0; frame < 60; frame++) {
+			float deltaTime = random.Range(1.0f / 120.0f, 1.0f / 20.0f);
+			parallel.Update(deltaTime, &pool);
+			serial.Update(deltaTime);
+			same = same && IsSameState(parallel, serial);
+			chunked = chunked || ParticleEmitter3D::kChunkSize * 2 < parallel.GetCount();
+		}
+		TEST_CHECK(same);
+		TEST_CHECK(chunked);
+
+		// 並べ替えた順も一致する
+		parallel.SortBackToFront({0, 5, -20});
+		serial.SortBackToFront({0, 5, -20});
+		TEST_CHECK(IsSameState(parallel, serial));
+	}
+}
+
+} // namespace
+
+int main() {
+	TestSortBackToFront();
+	TestParallelMatchesSerial();
+
+	return Test::Finish("ParticleEmitter3DTest");
+}
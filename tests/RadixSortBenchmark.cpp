@@ -0,0 +1,57 @@
+﻿#include "RadixSort.h"
+#include "TestUtility.h"
+#include <algorithm>
+
+namespace {
+
+// SpriteBatch::MakeSortKeyと同じ配置のキー（レイヤー16bit、シェーダ、ブレンドモード、テクスチャ）
+uint64_t MakeSpriteKey(int16_t layer, uint32_t shader, uint32_t blendMode, uint32_t texture) {
+	return uint64_t(uint16_t(layer + 0x8000)) << 48 | uint64_t(shader) << 44 |
+	       uint64_t(blendMode) << 40 | uint64_t(texture);
+}
+
+// 基数ソートとstable_sortで並べ替えて比べる
+void Measure(const char* name, const std::vector<uint64_t>& keys) {
+	uint32_t count = static_cast<uint32_t>(keys.size());
+	RadixSort sorter;
+	double radix = Test::MeasureMilliseconds(20, [&]() { sorter.Sort(keys.data(), count); });
+	Test::Report(name, radix, count);
+
+	std::vector<uint32_t> order(count);
+	double stable = Test::MeasureMilliseconds(20, [&]() {
+		for (uint32_t i = 0; i < count; i++) {
+			order[i] = i;
+		}
+		std::stable_sort(order.begin(), order.end(), [&keys](uint32_t a, uint32_t b) {
+			return keys[a] < keys[b];
+		});
+	});
+	Test::Report("  std::stable_sort", stable, count);
+
+	// 同じ並びになる
+	TEST_CHECK(std::equal(order.begin(), order.end(), sorter.GetOrder()));
+	printf("  %u passes, speedup %.2fx\n", sorter.GetPassCount(), stable / radix);
+}
+
+} // namespace
+
+// 10万枚のスプライトの並べ替え
+int main() {
+	const uint32_t kSpriteCount = 100000;
+	Test::Random random(1);
+
+	// レイヤー順（8レイヤー）
+	std::vector<uint64_t> layer(kSpriteCount);
+	// レイヤー、テクスチャ順（8レイヤー、2ブレンドモード、64テクスチャ）
+	std::vector<uint64_t> layerTexture(kSpriteCount);
+	for (uint32_t i = 0; i < kSpriteCount; i++) {
+		int16_t spriteLayer = static_cast<int16_t>(random.Next(8));
+		layer[i] = MakeSpriteKey(spriteLayer, 0, 0, 0);
+		layerTexture[i] = MakeSpriteKey(spriteLayer, 0, random.Next(2), random.Next(64));
+	}
+
+	Measure("RadixSort (layer)", layer);
+	Measure("RadixSort (layer + texture)", layerTexture);
+
+	return Test::Finish("RadixSortBenchmark");
+}
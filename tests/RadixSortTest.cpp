@@ -0,0 +1,92 @@
+﻿#include "RadixSort.h"
+#include "TestUtility.h"
+#include <algorithm>
+
+namespace {
+
+// std::stable_sortで求めた並び
+std::vector<uint32_t> SortReference(const std::vector<uint64_t>& keys) {
+	std::vector<uint32_t> order(keys.size());
+	for (uint32_t i = 0; i < order.size(); i++) {
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(), order.end(), [&keys](uint32_t a, uint32_t b) {
+		return keys[a] < keys[b];
+	});
+	return order;
+}
+
+// 結果がstable_sortと添え字まで一致すること
+bool MatchesReference(RadixSort& sorter, const std::vector<uint64_t>& keys) {
+	uint32_t count = static_cast<uint32_t>(keys.size());
+	sorter.Sort(keys.data(), count);
+	std::vector<uint32_t> expected = SortReference(keys);
+	return std::equal(expected.begin(), expected.end(), sorter.GetOrder());
+}
+
+// 様々なキーの分布でstable_sortと一致すること（作業領域は使い回す）
+void TestMatchesStableSort() {
+	RadixSort sorter;
+	Test::Random random(1);
+	const uint32_t counts[] = {0, 1, 2, 3, 255, 256, 257, 1000, 5000, 17, 0, 4096};
+	for (uint32_t count : counts) {
+		for (int distribution = 0; distribution < 4; distribution++) {
+			std::vector<uint64_t> keys(count);
+			for (uint64_t& key : keys) {
+				uint64_t high = random.Next();
+				uint64_t low = random.Next();
+				switch (distribution) {
+				case 0: // 64bit全体がばらばら
+					key = high << 32 | low;
+					break;
+				case 1: // 同じキーが多い（安定性を見る）
+					key = uint64_t(random.Next(4)) << 48 | random.Next(3);
+					break;
+				case 2: // 最上位バイトだけが違う
+					key = uint64_t(random.Next(256)) << 56;
+					break;
+				default: // 下位バイトだけが違う
+					key = 0x1234567800000000ull | random.Next(256);
+					break;
+				}
+			}
+			TEST_CHECK(MatchesReference(sorter, keys));
+		}
+	}
+}
+
+// 変化のないバイトは分配しないこと
+void TestPassCount() {
+	RadixSort sorter;
+
+	// 全て同じキーなら元の順のまま
+	std::vector<uint64_t> keys(100, 0xabcdef);
+	sorter.Sort(keys.data(), 100);
+	TEST_CHECK(sorter.GetPassCount() == 0);
+	TEST_CHECK(MatchesReference(sorter, keys));
+
+	// スプライトのレイヤーのように上位16bitだけが違えば2回
+	for (uint32_t i = 0; i < keys.size(); i++) {
+		keys[i] = uint64_t((i * 7919) % 1000 + 0x8000 - 500) << 48;
+	}
+	sorter.Sort(keys.data(), 100);
+	TEST_CHECK(sorter.GetPassCount() == 2);
+	TEST_CHECK(MatchesReference(sorter, keys));
+
+	// 1バイトだけなら1回
+	for (uint32_t i = 0; i < keys.size(); i++) {
+		keys[i] = uint64_t(99 - i) << 40;
+	}
+	sorter.Sort(keys.data(), 100);
+	TEST_CHECK(sorter.GetPassCount() == 1);
+	TEST_CHECK(sorter.GetOrder()[0] == 99 && sorter.GetOrder()[99] == 0);
+}
+
+} // namespace
+
+int main() {
+	TestMatchesStableSort();
+	TestPassCount();
+
+	return Test::Finish("RadixSortTest");
+}
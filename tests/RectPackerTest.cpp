@@ -0,0 +1,204 @@
+﻿#include "RectPacker.h"
+#include "TestUtility.h"
+
+namespace {
+
+// 面積の合計
+uint64_t GetTotalArea(const std::vector<RectPacker::Size>& sizes) {
+	uint64_t area = 0;
+	for (const RectPacker::Size& size : sizes) {
+		area += uint64_t(size.width) * size.height;
+	}
+	return area;
+}
+
+// 全て領域内に元の大きさで置かれ、互いに重ならないこと
+bool IsValidLayout(
+  const std::vector<RectPacker::Size>& sizes, const std::vector<RectPacker::Rect>& rects,
+  RectPacker::Size area) {
+	if (rects.size() != sizes.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < rects.size(); i++) {
+		const RectPacker::Rect& a = rects[i];
+		if (a.width != sizes[i].width || a.height != sizes[i].height) {
+			return false;
+		}
+		if (a.x + a.width > area.width || a.y + a.height > area.height) {
+			return false;
+		}
+		for (size_t j = i + 1; j < rects.size(); j++) {
+			const RectPacker::Rect& b = rects[j];
+			bool overlap = a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height &&
+			               b.y < a.y + a.height;
+			if (overlap && a.width > 0 && a.height > 0 && b.width > 0 && b.height > 0) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// ランダムな大きさ
+std::vector<RectPacker::Size>
+  MakeSizes(uint32_t seed, uint32_t count, uint32_t minSize, uint32_t maxSize) {
+	Test::Random random(seed);
+	std::vector<RectPacker::Size> sizes(count);
+	for (RectPacker::Size& size : sizes) {
+		size.width = minSize + random.Next(maxSize - minSize + 1);
+		size.height = minSize + random.Next(maxSize - minSize + 1);
+	}
+	return sizes;
+}
+
+// 面積と最大の辺から見て最も小さい2のべき乗の領域
+RectPacker::Size GetLowerBound(const std::vector<RectPacker::Size>& sizes) {
+	RectPacker::Size bound = {1, 1};
+	for (const RectPacker::Size& size : sizes) {
+		while (bound.width < size.width) {
+			bound.width *= 2;
+		}
+		while (bound.height < size.height) {
+			bound.height *= 2;
+		}
+	}
+	while (uint64_t(bound.width) * bound.height < GetTotalArea(sizes)) {
+		if (bound.width <= bound.height) {
+			bound.width *= 2;
+		} else {
+			bound.height *= 2;
+		}
+	}
+	return bound;
+}
+
+// 詰め込んで使用率を確認する
+// 使用率は置いた矩形の上端までの面積に対する割合（2のべき乗への切り上げ分を含まない）
+void CheckEfficiency(
+  const char* name, const std::vector<RectPacker::Size>& sizes, float minOccupancy,
+  bool expectLowerBound) {
+	std::vector<RectPacker::Rect> rects;
+	RectPacker::Size area;
+	if (!TEST_CHECK(RectPacker::PackMinimum(4096, sizes, rects, area))) {
+		return;
+	}
+	TEST_CHECK(IsValidLayout(sizes, rects, area));
+
+	uint32_t usedHeight = 0;
+	for (const RectPacker::Rect& rect : rects) {
+		usedHeight = (std::max)(usedHeight, rect.y + rect.height);
+	}
+	float occupancy = static_cast<float>(
+	  double(GetTotalArea(sizes)) / (double(area.width) * double(usedHeight)));
+	printf(
+	  "%-24s %4ux%-4u (used height %4u) occupancy %.3f\n", name, area.width, area.height,
+	  usedHeight, occupancy);
+	TEST_CHECK(occupancy >= minOccupancy);
+
+	// 面積から見て最小の大きさに収まっている
+	RectPacker::Size bound = GetLowerBound(sizes);
+	if (expectLowerBound) {
+		TEST_CHECK(area.width == bound.width && area.height == bound.height);
+	}
+
+	// 同じ入力なら同じ配置
+	std::vector<RectPacker::Rect> again;
+	TEST_CHECK(RectPacker::PackAll(area.width, area.height, sizes, again));
+	bool same = again.size() == rects.size();
+	for (size_t i = 0; same && i < rects.size(); i++) {
+		same = again[i].x == rects[i].x && again[i].y == rects[i].y;
+	}
+	TEST_CHECK(same);
+}
+
+// 同じ大きさの矩形は隙間なく敷き詰められること
+void TestGrid() {
+	RectPacker packer(64, 64);
+	RectPacker::Rect rect;
+	uint32_t count = 0;
+	while (packer.Insert(16, 16, rect)) {
+		TEST_CHECK(rect.x % 16 == 0 && rect.y % 16 == 0);
+		count++;
+	}
+	TEST_CHECK(count == 16);
+	TEST_CHECK(packer.GetOccupancy() == 1.0f);
+
+	// Resetで空に戻る
+	packer.Reset();
+	TEST_CHECK(packer.GetOccupancy() == 0.0f);
+	TEST_CHECK(packer.Insert(64, 64, rect));
+	TEST_CHECK(rect.x == 0 && rect.y == 0);
+	TEST_CHECK(!packer.Insert(1, 1, rect));
+}
+
+// 典型的な画像の組み合わせでの使用率
+void TestEfficiency() {
+	// 2のべき乗のアイコン
+	std::vector<RectPacker::Size> icons;
+	for (uint32_t i = 0; i < 64; i++) {
+		icons.push_back({32, 32});
+	}
+	for (uint32_t i = 0; i < 16; i++) {
+		icons.push_back({64, 64});
+	}
+	for (uint32_t i = 0; i < 4; i++) {
+		icons.push_back({128, 128});
+	}
+	CheckEfficiency("power of two icons", icons, 1.0f, true);
+
+	// ばらばらの大きさ（余白込みのUI画像を想定）
+	CheckEfficiency("random 8-64", MakeSizes(1, 300, 8, 64), 0.90f, true);
+	CheckEfficiency("random 2-256", MakeSizes(2, 200, 2, 256), 0.85f, true);
+	CheckEfficiency("many small 4-20", MakeSizes(3, 2000, 4, 20), 0.95f, true);
+
+	// 細長い画像が混ざる
+	std::vector<RectPacker::Size> mixed = MakeSizes(4, 200, 16, 48);
+	for (uint32_t i = 0; i < 10; i++) {
+		mixed.push_back({512, 18});
+		mixed.push_back({18, 300});
+	}
+	CheckEfficiency("mixed with strips", mixed, 0.85f, true);
+}
+
+// 収まらない入力は失敗すること
+void TestOverflow() {
+	std::vector<RectPacker::Rect> rects;
+	RectPacker::Size area;
+
+	// 1枚が大きすぎる
+	TEST_CHECK(!RectPacker::PackMinimum(256, {{257, 10}}, rects, area));
+	// 合計の面積が大きすぎる
+	std::vector<RectPacker::Size> sizes(5, RectPacker::Size{128, 128});
+	TEST_CHECK(!RectPacker::PackMinimum(256, sizes, rects, area));
+	sizes.pop_back();
+	TEST_CHECK(RectPacker::PackMinimum(256, sizes, rects, area));
+	TEST_CHECK(area.width == 256 && area.height == 256);
+
+	// 面積は足りても形が合わない
+	TEST_CHECK(!RectPacker::PackAll(100, 100, {{60, 60}, {60, 60}}, rects));
+}
+
+// 大きさ0の矩形や空の入力も扱えること
+void TestEmpty() {
+	std::vector<RectPacker::Rect> rects;
+	RectPacker::Size area;
+	TEST_CHECK(RectPacker::PackMinimum(256, {}, rects, area));
+	TEST_CHECK(rects.empty());
+	TEST_CHECK(area.width == 1 && area.height == 1);
+
+	std::vector<RectPacker::Size> sizes = {{0, 0}, {16, 0}, {8, 8}};
+	TEST_CHECK(RectPacker::PackMinimum(256, sizes, rects, area));
+	TEST_CHECK(IsValidLayout(sizes, rects, area));
+	TEST_CHECK(area.width == 16 && area.height == 8);
+}
+
+} // namespace
+
+int main() {
+	TestGrid();
+	TestEfficiency();
+	TestOverflow();
+	TestEmpty();
+
+	return Test::Finish("RectPackerTest");
+}
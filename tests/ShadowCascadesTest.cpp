@@ -0,0 +1,377 @@
+﻿#include "ShadowCascades.h"
+#include "TestUtility.h"
+#include <cfloat>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace {
+
+// 境界上の判定の丸め誤差を許す、半径に対する割合
+const float kRadiusTolerance = 1e-4f;
+
+// 視点と投影の設定
+struct Camera {
+	XMMATRIX matView;
+	float fovAngleY;
+	float aspectRatio;
+	float nearZ;
+	float farZ;
+};
+
+// ランダムな位置と向きのカメラ
+Camera MakeCamera(Test::Random& random) {
+	XMVECTOR eye = XMVectorSet(
+	  random.Range(-50.0f, 50.0f), random.Range(0.0f, 10.0f), random.Range(-50.0f, 50.0f), 1.0f);
+	XMVECTOR direction = XMVector3Normalize(XMVectorSet(
+	  random.Range(-1.0f, 1.0f), random.Range(-0.5f, 0.5f), random.Range(-1.0f, 1.0f), 0.0f));
+	Camera camera;
+	camera.matView = XMMatrixLookToLH(eye, direction, XMVectorSet(0, 1, 0, 0));
+	camera.fovAngleY = XMConvertToRadians(random.Range(40.0f, 90.0f));
+	camera.aspectRatio = random.Range(1.0f, 2.4f);
+	camera.nearZ = 0.1f;
+	camera.farZ = 1000.0f;
+	return camera;
+}
+
+// 斜めから差す光
+XMFLOAT3 MakeLightDirection(float x, float y, float z) {
+	XMFLOAT3 direction;
+	XMStoreFloat3(&direction, XMVector3Normalize(XMVectorSet(x, y, z, 0.0f)));
+	return direction;
+}
+
+// ワールド座標をカスケードのライト空間（boundsMin～boundsMaxの座標）へ
+XMFLOAT3 ToLightSpace(const ShadowCascades::Cascade& cascade, FXMVECTOR position) {
+	XMFLOAT3 clip;
+	XMStoreFloat3(&clip, XMVector3TransformCoord(position, cascade.matViewProjection));
+	return {
+	  cascade.boundsMin.x + (clip.x * 0.5f + 0.5f) * (cascade.boundsMax.x - cascade.boundsMin.x),
+	  cascade.boundsMin.y + (clip.y * 0.5f + 0.5f) * (cascade.boundsMax.y - cascade.boundsMin.y),
+	  cascade.boundsMin.z + clip.z * (cascade.boundsMax.z - cascade.boundsMin.z)};
+}
+
+// 区切りが手前から奥へ増え、両端が指定どおりであること
+void TestSplits() {
+	const float ranges[][2] = {{0.1f, 100.0f}, {0.5f, 1000.0f}, {1.0f, 2.0f}};
+	const float lambdas[] = {0.0f, 0.5f, 0.75f, 1.0f};
+	for (const float* range : ranges) {
+		for (float lambda : lambdas) {
+			float splits[ShadowCascades::kCascadeCount + 1];
+			ShadowCascades::ComputeSplits(range[0], range[1], lambda, splits);
+			TEST_CHECK(splits[0] == range[0]);
+			TEST_CHECK(splits[ShadowCascades::kCascadeCount] == range[1]);
+			for (uint32_t i = 0; i < ShadowCascades::kCascadeCount; i++) {
+				TEST_CHECK(splits[i] < splits[i + 1]);
+				float t = float(i) / ShadowCascades::kCascadeCount;
+				float uniform = range[0] + (range[1] - range[0]) * t;
+				float logarithmic = range[0] * std::pow(range[1] / range[0], t);
+				// 対数分割の割合が大きいほど手前に寄る
+				TEST_CHECK(splits[i] <= uniform * 1.0001f);
+				TEST_CHECK(splits[i] >= logarithmic * 0.9999f);
+				if (lambda == 0.0f) {
+					TEST_CHECK_NEAR(splits[i], uniform, uniform * 1e-5f);
+				}
+				if (lambda == 1.0f) {
+					TEST_CHECK_NEAR(splits[i], logarithmic, logarithmic * 1e-5f);
+				}
+			}
+		}
+	}
+
+	// カスケードは隙間なく並び、最大距離で打ち切られる
+	ShadowCascades cascades;
+	ShadowCascades::Desc desc;
+	desc.maxDistance = 80.0f;
+	cascades.Initialize(desc);
+	Test::Random random(1);
+	Camera camera = MakeCamera(random);
+	cascades.Build(
+	  camera.matView, camera.fovAngleY, camera.aspectRatio, camera.nearZ, camera.farZ,
+	  MakeLightDirection(0.3f, -1.0f, 0.2f));
+	TEST_CHECK(cascades.GetCascade(0).splitNear == camera.nearZ);
+	TEST_CHECK(cascades.GetCascade(ShadowCascades::kCascadeCount - 1).splitFar == 80.0f);
+	for (uint32_t i = 1; i < ShadowCascades::kCascadeCount; i++) {
+		TEST_CHECK(cascades.GetCascade(i).splitNear == cascades.GetCascade(i - 1).splitFar);
+	}
+}
+
+// 区切りの8つの角が球とその正射影の中に入り、カメラの向きによらず大きさが変わらないこと
+void TestEnclosesCorners(float fovAngleY, float aspectRatio) {
+	const XMFLOAT3 lightDirections[] = {
+	  MakeLightDirection(0.3f, -1.0f, 0.2f), MakeLightDirection(0.0f, -1.0f, 0.0f),
+	  MakeLightDirection(1.0f, -0.2f, 0.0f)};
+	for (const XMFLOAT3& lightDir : lightDirections) {
+		ShadowCascades cascades;
+		cascades.Initialize(ShadowCascades::Desc());
+		Test::Random random(2);
+		float extents[ShadowCascades::kCascadeCount] = {};
+		float texelSizes[ShadowCascades::kCascadeCount] = {};
+		bool enclosed = true;
+		bool stableSize = true;
+		for (int i = 0; i < 100; i++) {
+			// 視野角とアスペクト比は固定して、位置と向きだけを変える
+			Camera camera = MakeCamera(random);
+			camera.fovAngleY = fovAngleY;
+			camera.aspectRatio = aspectRatio;
+			cascades.Build(
+			  camera.matView, camera.fovAngleY, camera.aspectRatio, camera.nearZ, camera.farZ,
+			  lightDir);
+			XMMATRIX matInvView = XMMatrixInverse(nullptr, camera.matView);
+			float tanY = std::tan(camera.fovAngleY * 0.5f);
+			float tanX = tanY * camera.aspectRatio;
+
+			for (uint32_t c = 0; c < ShadowCascades::kCascadeCount; c++) {
+				const ShadowCascades::Cascade& cascade = cascades.GetCascade(c);
+				float extent = cascade.boundsMax.x - cascade.boundsMin.x;
+				if (i == 0) {
+					extents[c] = extent;
+					texelSizes[c] = cascade.texelSize;
+				}
+				// 半径は切り上げてあるのでテクセルの大きさは一致する（幅は丸め誤差で揺れる）
+				float extentY = cascade.boundsMax.y - cascade.boundsMin.y;
+				stableSize = stableSize && cascade.texelSize == texelSizes[c];
+				stableSize = stableSize && std::abs(extent - extents[c]) <= extents[c] * 1e-5f;
+				stableSize = stableSize && std::abs(extentY - extents[c]) <= extents[c] * 1e-5f;
+
+				// 球の中心は箱のxyの中央、光の来ない側の面から半径の位置（中心を揃えた分はずれる）
+				float radius = extent * 0.5f - cascade.texelSize;
+				XMFLOAT3 center = {
+				  (cascade.boundsMin.x + cascade.boundsMax.x) * 0.5f,
+				  (cascade.boundsMin.y + cascade.boundsMax.y) * 0.5f, cascade.boundsMax.z - radius};
+				float limit =
+				  radius * (1.0f + kRadiusTolerance) + std::sqrt(2.0f) * cascade.texelSize;
+
+				for (int corner = 0; corner < 8; corner++) {
+					float z = corner & 4 ? cascade.splitFar : cascade.splitNear;
+					float x = (corner & 1 ? 1.0f : -1.0f) * z * tanX;
+					float y = (corner & 2 ? 1.0f : -1.0f) * z * tanY;
+					XMVECTOR world =
+					  XMVector3TransformCoord(XMVectorSet(x, y, z, 1.0f), matInvView);
+					XMFLOAT3 light = ToLightSpace(cascade, world);
+					float dx = light.x - center.x;
+					float dy = light.y - center.y;
+					float dz = light.z - center.z;
+					enclosed = enclosed && std::sqrt(dx * dx + dy * dy + dz * dz) <= limit;
+
+					// シャドウマップの範囲に入る
+					XMFLOAT3 clip;
+					XMStoreFloat3(&clip, XMVector3TransformCoord(world, cascade.matViewProjection));
+					enclosed = enclosed && std::abs(clip.x) <= 1.0f && std::abs(clip.y) <= 1.0f;
+					enclosed = enclosed && 0.0f <= clip.z && clip.z <= 1.0f;
+				}
+			}
+		}
+		TEST_CHECK(enclosed);
+		TEST_CHECK(stableSize);
+	}
+}
+
+// テクセルより小さくカメラが動いても中心はテクセル単位でしか動かず、格子はワールドに固定されること
+void TestTexelSnapping() {
+	ShadowCascades cascades;
+	cascades.Initialize(ShadowCascades::Desc());
+	XMFLOAT3 lightDir = MakeLightDirection(0.3f, -1.0f, 0.2f);
+	XMVECTOR direction = XMVector3Normalize(XMVectorSet(0.6f, -0.2f, 1.0f, 0.0f));
+	XMVECTOR motion = XMVector3Normalize(XMVectorSet(1.0f, 0.3f, 0.5f, 0.0f));
+	const float kFovAngleY = XMConvertToRadians(60.0f);
+	const int kStepCount = 200;
+
+	// 最も細かいカスケードのテクセルの1/10ずつ動かす
+	cascades.Build(
+	  XMMatrixLookToLH(XMVectorSet(0, 5, 0, 1), direction, XMVectorSet(0, 1, 0, 0)), kFovAngleY,
+	  16.0f / 9.0f, 0.1f, 1000.0f, lightDir);
+	float step = cascades.GetCascade(0).texelSize * 0.1f;
+
+	float previousX[ShadowCascades::kCascadeCount] = {};
+	float previousY[ShadowCascades::kCascadeCount] = {};
+	float originFraction[ShadowCascades::kCascadeCount] = {};
+	uint32_t moveCounts[ShadowCascades::kCascadeCount] = {};
+	bool wholeTexels = true;
+	bool fixedGrid = true;
+	for (int i = 0; i < kStepCount; i++) {
+		XMVECTOR eye = XMVectorAdd(XMVectorSet(0, 5, 0, 1), XMVectorScale(motion, step * i));
+		cascades.Build(
+		  XMMatrixLookToLH(eye, direction, XMVectorSet(0, 1, 0, 0)), kFovAngleY, 16.0f / 9.0f,
+		  0.1f, 1000.0f, lightDir);
+
+		for (uint32_t c = 0; c < ShadowCascades::kCascadeCount; c++) {
+			const ShadowCascades::Cascade& cascade = cascades.GetCascade(c);
+			float centerX = (cascade.boundsMin.x + cascade.boundsMax.x) * 0.5f;
+			float centerY = (cascade.boundsMin.y + cascade.boundsMax.y) * 0.5f;
+
+			// ワールドの原点が乗るテクセル内の位置は変わらない
+			XMFLOAT3 clip;
+			XMStoreFloat3(
+			  &clip, XMVector3TransformCoord(XMVectorSet(0, 0, 0, 1), cascade.matViewProjection));
+			float texel = (clip.x * 0.5f + 0.5f) * ShadowCascades::Desc().resolution;
+			float fraction = texel - std::floor(texel);
+
+			if (i > 0) {
+				// 動いても1テクセル以内、かつテクセルの整数倍
+				float moveX = (centerX - previousX[c]) / cascade.texelSize;
+				float moveY = (centerY - previousY[c]) / cascade.texelSize;
+				wholeTexels = wholeTexels && std::abs(moveX - std::round(moveX)) < 1e-2f &&
+				              std::abs(moveY - std::round(moveY)) < 1e-2f;
+				wholeTexels = wholeTexels && std::abs(moveX) < 1.5f && std::abs(moveY) < 1.5f;
+				if (std::round(moveX) != 0.0f || std::round(moveY) != 0.0f) {
+					moveCounts[c]++;
+				}
+				float drift = std::abs(fraction - originFraction[c]);
+				fixedGrid = fixedGrid && (std::min)(drift, 1.0f - drift) < 2e-2f;
+			} else {
+				originFraction[c] = fraction;
+			}
+			previousX[c] = centerX;
+			previousY[c] = centerY;
+		}
+	}
+	TEST_CHECK(wholeTexels);
+	TEST_CHECK(fixedGrid);
+	// 最も細かいカスケードでも大半のフレームは動かず、奥ほど動かない
+	TEST_CHECK(0 < moveCounts[0] && moveCounts[0] < kStepCount / 4);
+	for (uint32_t c = 1; c < ShadowCascades::kCascadeCount; c++) {
+		TEST_CHECK(moveCounts[c] <= moveCounts[c - 1]);
+	}
+}
+
+// カスケードごとの判定が、ライト空間の箱と境界球の総当たりと一致すること
+void TestCullMatchesBruteForce() {
+	ShadowCascades cascades;
+	cascades.Initialize(ShadowCascades::Desc());
+	Test::Random random(3);
+	Camera camera = MakeCamera(random);
+	cascades.Build(
+	  camera.matView, camera.fovAngleY, camera.aspectRatio, camera.nearZ, camera.farZ,
+	  MakeLightDirection(0.3f, -1.0f, 0.2f));
+
+	const uint32_t counts[] = {0, 1, 3, 5, 1003};
+	for (uint32_t count : counts) {
+		std::vector<XMFLOAT4> spheres;
+		for (uint32_t i = 0; i < count; i++) {
+			spheres.push_back(
+			  {random.Range(-200.0f, 200.0f), random.Range(-20.0f, 40.0f),
+			   random.Range(-200.0f, 200.0f), random.Range(0.0f, 5.0f)});
+		}
+		std::vector<uint32_t> visible[ShadowCascades::kCascadeCount];
+		cascades.Cull(spheres.data(), count, visible);
+
+		for (uint32_t c = 0; c < ShadowCascades::kCascadeCount; c++) {
+			const ShadowCascades::Cascade& cascade = cascades.GetCascade(c);
+			const XMFLOAT3& minimum = cascade.boundsMin;
+			const XMFLOAT3& maximum = cascade.boundsMax;
+
+			// 番号順に並ぶので、先頭から照らし合わせる
+			size_t next = 0;
+			bool same = true;
+			for (uint32_t i = 0; i < count; i++) {
+				XMFLOAT3 light = ToLightSpace(cascade, XMLoadFloat4(&spheres[i]));
+				float dx = (std::max)((std::max)(minimum.x - light.x, light.x - maximum.x), 0.0f);
+				float dy = (std::max)((std::max)(minimum.y - light.y, light.y - maximum.y), 0.0f);
+				float dz = (std::max)((std::max)(minimum.z - light.z, light.z - maximum.z), 0.0f);
+				float distanceSq = dx * dx + dy * dy + dz * dz;
+				// 境界の付近は判定が分かれてもよい（ライト空間への変換の誤差）
+				float inner = spheres[i].w * (1.0f - kRadiusTolerance) - 1e-3f;
+				float outer = spheres[i].w * (1.0f + kRadiusTolerance) + 1e-3f;
+				bool listed = next < visible[c].size() && visible[c][next] == i;
+				if (listed) {
+					next++;
+				}
+				bool mustList = inner >= 0.0f && distanceSq <= inner * inner;
+				if (listed ? outer * outer < distanceSq : mustList) {
+					same = false;
+				}
+			}
+			// 埋めた要素は入らない
+			TEST_CHECK(same && next == visible[c].size());
+		}
+	}
+}
+
+// スポットライトの視錐台の判定が、角から作った平面による総当たりと矛盾しないこと
+void TestCullFrustum() {
+	XMFLOAT3 position = {0.0f, 5.0f, 0.0f};
+	XMFLOAT3 direction = MakeLightDirection(0.2f, -1.0f, 0.1f);
+	XMMATRIX matViewProjection =
+	  ShadowCascades::ComputeSpotViewProjection(position, direction, std::cos(0.6f), 30.0f);
+
+	// 視錐台の8つの角（クリップ座標の箱を戻す）
+	XMMATRIX matInverse = XMMatrixInverse(nullptr, matViewProjection);
+	XMVECTOR corners[8];
+	XMVECTOR middle = XMVectorZero();
+	for (int corner = 0; corner < 8; corner++) {
+		XMVECTOR clip = XMVectorSet(
+		  corner & 1 ? 1.0f : -1.0f, corner & 2 ? 1.0f : -1.0f, corner & 4 ? 1.0f : 0.0f, 1.0f);
+		corners[corner] = XMVector3TransformCoord(clip, matInverse);
+		middle = XMVectorAdd(middle, XMVectorScale(corners[corner], 1.0f / 8.0f));
+	}
+	// 6面（各面の3つの角から、内側が正になる向きで）
+	const int faces[6][3] = {{0, 2, 4}, {1, 3, 5}, {0, 1, 4}, {2, 3, 6}, {0, 1, 2}, {4, 5, 6}};
+	XMVECTOR normals[6];
+	float offsets[6];
+	for (int f = 0; f < 6; f++) {
+		XMVECTOR normal = XMVector3Normalize(XMVector3Cross(
+		  XMVectorSubtract(corners[faces[f][1]], corners[faces[f][0]]),
+		  XMVectorSubtract(corners[faces[f][2]], corners[faces[f][0]])));
+		float offset = -XMVectorGetX(XMVector3Dot(normal, corners[faces[f][0]]));
+		if (XMVectorGetX(XMVector3Dot(normal, middle)) + offset < 0.0f) {
+			normal = XMVectorNegate(normal);
+			offset = -offset;
+		}
+		normals[f] = normal;
+		offsets[f] = offset;
+	}
+
+	Test::Random random(4);
+	std::vector<XMFLOAT4> spheres;
+	for (int i = 0; i < 2003; i++) {
+		spheres.push_back(
+		  {random.Range(-30.0f, 30.0f), random.Range(-30.0f, 10.0f), random.Range(-30.0f, 30.0f),
+		   random.Range(0.0f, 2.0f)});
+	}
+	std::vector<uint32_t> visible;
+	ShadowCascades::CullFrustum(
+	  matViewProjection, spheres.data(), static_cast<uint32_t>(spheres.size()), visible);
+
+	size_t next = 0;
+	bool consistent = true;
+	uint32_t insideCount = 0;
+	for (uint32_t i = 0; i < spheres.size(); i++) {
+		XMVECTOR center = XMLoadFloat4(&spheres[i]);
+		float radius = spheres[i].w;
+		bool listed = next < visible.size() && visible[next] == i;
+		if (listed) {
+			next++;
+		}
+		float nearest = FLT_MAX;
+		for (int f = 0; f < 6; f++) {
+			float distance = XMVectorGetX(XMVector3Dot(normals[f], center)) + offsets[f];
+			nearest = (std::min)(nearest, distance);
+		}
+		// 中心が中にあれば必ず入り、どれかの面の外に半径より離れていれば入らない
+		if (nearest >= 1e-3f) {
+			consistent = consistent && listed;
+			insideCount++;
+		}
+		if (nearest < -radius - 1e-3f) {
+			consistent = consistent && !listed;
+		}
+	}
+	TEST_CHECK(consistent);
+	TEST_CHECK(next == visible.size());
+	TEST_CHECK(insideCount > 0);
+}
+
+} // namespace
+
+int main() {
+	TestSplits();
+	// 広い視野（球の中心が奥の断面）と狭い視野（手前と奥の角から等距離の点）
+	TestEnclosesCorners(XMConvertToRadians(60.0f), 16.0f / 9.0f);
+	TestEnclosesCorners(XMConvertToRadians(20.0f), 1.0f);
+	TestTexelSnapping();
+	TestCullMatchesBruteForce();
+	TestCullFrustum();
+
+	return Test::Finish("ShadowCascadesTest");
+}
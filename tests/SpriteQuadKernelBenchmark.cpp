@@ -0,0 +1,34 @@
+﻿#include "SpriteQuadKernel.h"
+#include "TestUtility.h"
+
+using namespace DirectX;
+
+// 10万枚のスプライトの頂点生成（4枚ずつのSIMD版と1枚ずつの基準）
+// DirectXMathがない環境ではスカラーの代替（tests/support）で動くので、速度差はWindowsで見る
+int main() {
+	const size_t kSpriteCount = 100000;
+
+	Test::Random random(1);
+	SpriteQuadKernel::SpriteArrays arrays;
+	for (size_t i = 0; i < kSpriteCount; i++) {
+		arrays.Add(
+		  {random.Range(0.0f, 1280.0f), random.Range(0.0f, 720.0f)},
+		  {random.Range(8.0f, 64.0f), random.Range(8.0f, 64.0f)}, random.Range(0.0f, XM_2PI),
+		  {0.5f, 0.5f}, {0.0f, 0.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f, 1.0f});
+	}
+	SpriteQuadKernel::Sprites sprites = arrays.GetSprites();
+	std::vector<SpriteQuadKernel::Vertex> vertices(kSpriteCount * 4);
+
+	double simd = Test::MeasureMilliseconds(
+	  10, [&]() { SpriteQuadKernel::Generate(sprites, kSpriteCount, vertices.data()); });
+	Test::KeepAlive(vertices[kSpriteCount * 2]);
+	Test::Report("Generate", simd, kSpriteCount);
+
+	double reference = Test::MeasureMilliseconds(
+	  10, [&]() { SpriteQuadKernel::GenerateReference(sprites, kSpriteCount, vertices.data()); });
+	Test::KeepAlive(vertices[kSpriteCount * 2]);
+	Test::Report("GenerateReference", reference, kSpriteCount);
+
+	printf("speedup %.2fx\n", reference / simd);
+	return Test::Finish("SpriteQuadKernelBenchmark");
+}
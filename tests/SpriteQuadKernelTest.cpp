@@ -0,0 +1,115 @@
+﻿#include "SpriteQuadKernel.h"
+#include "TestUtility.h"
+#include <cstring>
+
+using namespace DirectX;
+
+namespace {
+
+// 座標の許容誤差（ピクセル）。SIMD版のsin/cosは近似なので、基準とは完全には一致しない
+const float kPositionTolerance = 1e-3f;
+
+// ランダムなスプライト
+void AddRandomSprites(SpriteQuadKernel::SpriteArrays& arrays, uint32_t seed, size_t count) {
+	Test::Random random(seed);
+	for (size_t i = 0; i < count; i++) {
+		// 反転（負の大きさ）と1周を超える回転を含む
+		XMFLOAT2 position = {random.Range(-100.0f, 2000.0f), random.Range(-100.0f, 1200.0f)};
+		XMFLOAT2 size = {random.Range(-512.0f, 512.0f), random.Range(-512.0f, 512.0f)};
+		float rotation = random.Range(-4.0f * XM_PI, 4.0f * XM_PI);
+		XMFLOAT2 anchorPoint = {random.Range(0.0f, 1.0f), random.Range(0.0f, 1.0f)};
+		XMFLOAT4 uvRect = {
+		  random.Range(0.0f, 0.5f), random.Range(0.0f, 0.5f), random.Range(0.5f, 1.0f),
+		  random.Range(0.5f, 1.0f)};
+		XMFLOAT4 color = {
+		  random.Range(0.0f, 1.0f), random.Range(0.0f, 1.0f), random.Range(0.0f, 1.0f),
+		  random.Range(0.0f, 1.0f)};
+		arrays.Add(position, size, rotation, anchorPoint, uvRect, color);
+	}
+}
+
+// 4枚ずつの処理と端数の処理が、どの枚数でも1枚ずつの基準と一致すること
+void TestMatchesReference() {
+	const size_t counts[] = {0, 1, 2, 3, 4, 5, 7, 8, 9, 103, 1000};
+	for (size_t count : counts) {
+		SpriteQuadKernel::SpriteArrays arrays;
+		AddRandomSprites(arrays, static_cast<uint32_t>(count + 1), count);
+		SpriteQuadKernel::Sprites sprites = arrays.GetSprites();
+
+		// 範囲外に書き込まないことを末尾の番兵で確かめる
+		SpriteQuadKernel::Vertex sentinel;
+		std::memset(&sentinel, 0xcd, sizeof(sentinel));
+		std::vector<SpriteQuadKernel::Vertex> vertices(count * 4 + 1, sentinel);
+		std::vector<SpriteQuadKernel::Vertex> reference(count * 4);
+		SpriteQuadKernel::Generate(sprites, count, vertices.data());
+		SpriteQuadKernel::GenerateReference(sprites, count, reference.data());
+
+		float maxError = 0.0f;
+		bool sameAttributes = true;
+		for (size_t i = 0; i < count * 4; i++) {
+			const SpriteQuadKernel::Vertex& a = vertices[i];
+			const SpriteQuadKernel::Vertex& b = reference[i];
+			maxError = (std::max)(maxError, std::fabs(a.pos.x - b.pos.x));
+			maxError = (std::max)(maxError, std::fabs(a.pos.y - b.pos.y));
+			// UV、色、zはそのまま写すので一致する
+			sameAttributes = sameAttributes && a.pos.z == 0.0f && a.uv.x == b.uv.x &&
+			                 a.uv.y == b.uv.y && a.color.x == b.color.x && a.color.y == b.color.y &&
+			                 a.color.z == b.color.z && a.color.w == b.color.w;
+		}
+		TEST_CHECK(maxError <= kPositionTolerance);
+		TEST_CHECK(sameAttributes);
+		TEST_CHECK(std::memcmp(&vertices.back(), &sentinel, sizeof(sentinel)) == 0);
+	}
+}
+
+// 既知の配置（左下、左上、右下、右上の順）
+void TestKnownQuads() {
+	SpriteQuadKernel::SpriteArrays arrays;
+	// 回転なし、アンカーポイント(0.25, 0.5)
+	arrays.Add({100, 100}, {40, 20}, 0.0f, {0.25f, 0.5f}, {0, 0, 1, 1}, {1, 0, 0, 1});
+	// 左右反転
+	arrays.Add({100, 100}, {-40, 20}, 0.0f, {0.25f, 0.5f}, {0, 0, 1, 1}, {1, 1, 1, 1});
+	// 中心で90度回転
+	arrays.Add({0, 0}, {10, 20}, XM_PIDIV2, {0.5f, 0.5f}, {0.25f, 0.5f, 0.75f, 1}, {1, 1, 1, 1});
+	// 4枚そろえてSIMDの経路を通す
+	arrays.Add({5, 6}, {0, 0}, 1.0f, {0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0});
+
+	const float expected[3][4][4] = {
+	  // x, y, u, v
+	  {{90, 110, 0, 1}, {90, 90, 0, 0}, {130, 110, 1, 1}, {130, 90, 1, 0}},
+	  {{110, 110, 0, 1}, {110, 90, 0, 0}, {70, 110, 1, 1}, {70, 90, 1, 0}},
+	  {{-10, -5, 0.25f, 1}, {10, -5, 0.25f, 0.5f}, {-10, 5, 0.75f, 1}, {10, 5, 0.75f, 0.5f}},
+	};
+
+	SpriteQuadKernel::Vertex vertices[16];
+	SpriteQuadKernel::Vertex reference[16];
+	SpriteQuadKernel::Generate(arrays.GetSprites(), 4, vertices);
+	SpriteQuadKernel::GenerateReference(arrays.GetSprites(), 4, reference);
+	for (int sprite = 0; sprite < 3; sprite++) {
+		for (int corner = 0; corner < 4; corner++) {
+			const float* value = expected[sprite][corner];
+			for (const SpriteQuadKernel::Vertex* result : {vertices, reference}) {
+				const SpriteQuadKernel::Vertex& vertex = result[sprite * 4 + corner];
+				TEST_CHECK_NEAR(vertex.pos.x, value[0], kPositionTolerance);
+				TEST_CHECK_NEAR(vertex.pos.y, value[1], kPositionTolerance);
+				TEST_CHECK(vertex.uv.x == value[2] && vertex.uv.y == value[3]);
+			}
+		}
+	}
+	TEST_CHECK(vertices[0].color.x == 1.0f && vertices[0].color.y == 0.0f);
+
+	// 大きさ0は1点に潰れる
+	for (int corner = 0; corner < 4; corner++) {
+		TEST_CHECK_NEAR(vertices[12 + corner].pos.x, 5.0f, kPositionTolerance);
+		TEST_CHECK_NEAR(vertices[12 + corner].pos.y, 6.0f, kPositionTolerance);
+	}
+}
+
+} // namespace
+
+int main() {
+	TestMatchesReference();
+	TestKnownQuads();
+
+	return Test::Finish("SpriteQuadKernelTest");
+}
@@ -0,0 +1,218 @@
+﻿#include "SpriteQuadKernel.h"
+#include "TestUtility.h"
+#include <cmath>
+#include <vector>
+
+using namespace DirectX;
+
+namespace {
+
+// 画面全体のデバッグ文字（1280x720に9x18の文字を敷き詰める）
+const uint32_t kColumnCount = 1280 / 9;
+const uint32_t kRowCount = 720 / 18;
+const uint32_t kGlyphCount = kColumnCount * kRowCount;
+// フォント画像（14文字x7行）
+const float kFontWidth = 9.0f;
+const float kFontHeight = 18.0f;
+const float kTextureWidth = kFontWidth * 14;
+const float kTextureHeight = kFontHeight * 7;
+
+using Vertex = SpriteQuadKernel::Vertex;
+
+// 設定関数のたびに頂点を書き直すスプライト（以前のSpriteの頂点転送を写したもの）
+class EagerSprite {
+  public:
+	void SetPosition(const XMFLOAT2& position) {
+		position_ = position;
+		TransferVertices();
+	}
+
+	void SetSize(const XMFLOAT2& size) {
+		size_ = size;
+		TransferVertices();
+	}
+
+	void SetTextureRect(const XMFLOAT2& texBase, const XMFLOAT2& texSize) {
+		texBase_ = texBase;
+		texSize_ = texSize;
+		TransferVertices();
+	}
+
+	// 描画（ワールド行列と射影行列を合成して定数バッファへ書き込んでいた）
+	void Draw(const XMMATRIX& matProjection) {
+		float sin = std::sin(rotation_);
+		float cos = std::cos(rotation_);
+		XMMATRIX matWorld(
+		  XMVectorSet(cos, sin, 0.0f, 0.0f), XMVectorSet(-sin, cos, 0.0f, 0.0f),
+		  XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), XMVectorSet(position_.x, position_.y, 0.0f, 1.0f));
+		constants_.mat = XMMatrixMultiply(matWorld, matProjection);
+		constants_.color = {1, 1, 1, 1};
+	}
+
+	// 頂点はローカル座標（平行移動は定数バッファで行っていた）
+	const XMFLOAT2& GetPosition() const { return position_; }
+	const Vertex* GetVertices() const { return vertices_; }
+
+	// 書き込んだ頂点数
+	static uint64_t writeCount;
+
+  private:
+	void TransferVertices() {
+		float right = size_.x;
+		float bottom = size_.y;
+		float texLeft = texBase_.x / kTextureWidth;
+		float texRight = (texBase_.x + texSize_.x) / kTextureWidth;
+		float texTop = texBase_.y / kTextureHeight;
+		float texBottom = (texBase_.y + texSize_.y) / kTextureHeight;
+		vertices_[0] = {{0.0f, bottom, 0.0f}, {texLeft, texBottom}, {1, 1, 1, 1}};
+		vertices_[1] = {{0.0f, 0.0f, 0.0f}, {texLeft, texTop}, {1, 1, 1, 1}};
+		vertices_[2] = {{right, bottom, 0.0f}, {texRight, texBottom}, {1, 1, 1, 1}};
+		vertices_[3] = {{right, 0.0f, 0.0f}, {texRight, texTop}, {1, 1, 1, 1}};
+		writeCount += 4;
+	}
+
+	// 定数バッファ
+	struct Constants {
+		XMFLOAT4 color;
+		XMMATRIX mat;
+	};
+
+	float rotation_ = 0.0f;
+	XMFLOAT2 position_ = {0, 0};
+	XMFLOAT2 size_ = {0, 0};
+	XMFLOAT2 texBase_ = {0, 0};
+	XMFLOAT2 texSize_ = {0, 0};
+	Vertex vertices_[4];
+	Constants constants_;
+};
+
+uint64_t EagerSprite::writeCount = 0;
+
+// 設定関数は値を保持するだけで、描画時にまとめて頂点を作るスプライト（今のSprite）
+class LazySprite {
+  public:
+	void SetPosition(const XMFLOAT2& position) { position_ = position; }
+
+	void SetSize(const XMFLOAT2& size) { size_ = size; }
+
+	void SetTextureRect(const XMFLOAT2& texBase, const XMFLOAT2& texSize) {
+		if (
+		  texBase.x == texBase_.x && texBase.y == texBase_.y && texSize.x == texSize_.x &&
+		  texSize.y == texSize_.y) {
+			return;
+		}
+		texBase_ = texBase;
+		texSize_ = texSize;
+		isUvRectDirty_ = true;
+	}
+
+	void Draw(SpriteQuadKernel::SpriteArrays& batch) {
+		if (isUvRectDirty_) {
+			uvRect_ = {
+			  texBase_.x / kTextureWidth, texBase_.y / kTextureHeight,
+			  (texBase_.x + texSize_.x) / kTextureWidth,
+			  (texBase_.y + texSize_.y) / kTextureHeight};
+			isUvRectDirty_ = false;
+		}
+		batch.Add(position_, size_, 0.0f, {0.0f, 0.0f}, uvRect_, {1, 1, 1, 1});
+	}
+
+  private:
+	XMFLOAT2 position_ = {0, 0};
+	XMFLOAT2 size_ = {0, 0};
+	XMFLOAT2 texBase_ = {0, 0};
+	XMFLOAT2 texSize_ = {0, 0};
+	XMFLOAT4 uvRect_ = {0, 0, 1, 1};
+	bool isUvRectDirty_ = true;
+};
+
+// フレームごとに変わる文字（フォント画像内の位置）
+XMFLOAT2 GetGlyphBase(uint32_t glyph, uint32_t frame) {
+	uint32_t fontIndex = (glyph * 7 + frame) % 95;
+	return {float(fontIndex % 14) * kFontWidth, float(fontIndex / 14) * kFontHeight};
+}
+
+// 文字の位置
+XMFLOAT2 GetGlyphPosition(uint32_t glyph) {
+	return {float(glyph % kColumnCount) * kFontWidth, float(glyph / kColumnCount) * kFontHeight};
+}
+
+} // namespace
+
+// 画面全体のデバッグ文字を毎フレーム書き換える場合の、頂点の書き込み数と時間
+// 以前のDebugTextは文字ごとにSetPosition、SetTextureRect、SetSizeを呼び、
+// そのたびに頂点を書き直していた
+// DirectXMathがない環境ではスカラーの代替（tests/support）で動くので、速度差はWindowsで見る
+int main() {
+	std::vector<EagerSprite> eagerSprites(kGlyphCount);
+	std::vector<LazySprite> lazySprites(kGlyphCount);
+	SpriteQuadKernel::SpriteArrays batch;
+	std::vector<Vertex> vertices(kGlyphCount * 4);
+	const XMFLOAT2 size = {kFontWidth, kFontHeight};
+	const XMMATRIX matProjection =
+	  XMMatrixOrthographicOffCenterLH(0.0f, 1280.0f, 720.0f, 0.0f, 0.0f, 1.0f);
+	uint32_t frame = 0;
+
+	// 設定関数ごとに書き直す
+	auto eagerFrame = [&]() {
+		for (uint32_t i = 0; i < kGlyphCount; i++) {
+			eagerSprites[i].SetPosition(GetGlyphPosition(i));
+			eagerSprites[i].SetTextureRect(GetGlyphBase(i, frame), size);
+			eagerSprites[i].SetSize(size);
+			eagerSprites[i].Draw(matProjection);
+		}
+		frame++;
+	};
+	EagerSprite::writeCount = 0;
+	eagerFrame();
+	uint64_t eagerWrites = EagerSprite::writeCount;
+	double eager = Test::MeasureMilliseconds(20, eagerFrame);
+	Test::KeepAlive(eagerSprites[kGlyphCount / 2]);
+
+	// 描画時にまとめて作る
+	uint64_t lazyWrites = 0;
+	auto lazyFrame = [&]() {
+		batch.Clear();
+		for (uint32_t i = 0; i < kGlyphCount; i++) {
+			lazySprites[i].SetPosition(GetGlyphPosition(i));
+			lazySprites[i].SetTextureRect(GetGlyphBase(i, frame), size);
+			lazySprites[i].SetSize(size);
+			lazySprites[i].Draw(batch);
+		}
+		SpriteQuadKernel::Generate(batch.GetSprites(), batch.GetCount(), vertices.data());
+		lazyWrites = batch.GetCount() * 4;
+		frame++;
+	};
+	frame = 0;
+	lazyFrame();
+
+	// 同じフレームの頂点は一致する（以前の頂点はローカル座標なので位置を足して比べる）
+	frame = 0;
+	eagerFrame();
+	for (uint32_t i = 0; i < kGlyphCount; i++) {
+		const XMFLOAT2& position = eagerSprites[i].GetPosition();
+		const Vertex* expected = eagerSprites[i].GetVertices();
+		for (uint32_t v = 0; v < 4; v++) {
+			const Vertex& actual = vertices[size_t(i) * 4 + v];
+			TEST_CHECK_NEAR(actual.pos.x, expected[v].pos.x + position.x, 1e-3);
+			TEST_CHECK_NEAR(actual.pos.y, expected[v].pos.y + position.y, 1e-3);
+			TEST_CHECK_NEAR(actual.uv.x, expected[v].uv.x, 1e-6);
+			TEST_CHECK_NEAR(actual.uv.y, expected[v].uv.y, 1e-6);
+		}
+	}
+
+	double lazy = Test::MeasureMilliseconds(20, lazyFrame);
+	Test::KeepAlive(vertices[kGlyphCount * 2]);
+
+	// 頂点の書き込みは文字ごとに12から4へ
+	TEST_CHECK(eagerWrites == uint64_t(kGlyphCount) * 12);
+	TEST_CHECK(lazyWrites == uint64_t(kGlyphCount) * 4);
+
+	Test::Report("per-setter vertices + constants", eager, kGlyphCount);
+	Test::Report("lazy (SpriteQuadKernel at draw)", lazy, kGlyphCount);
+	printf(
+	  "vertex writes per frame: %llu -> %llu (%u glyphs)\n",
+	  static_cast<unsigned long long>(eagerWrites), static_cast<unsigned long long>(lazyWrites),
+	  kGlyphCount);
+	return Test::Finish("SpriteSetterBenchmark");
+}
@@ -0,0 +1,140 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/// <summary>
+/// テスト用の簡易チェックと計測
+/// 失敗しても止めずに数え、Test::Finishの戻り値をmainから返す
+/// </summary>
+namespace Test {
+
+/// <summary>
+/// 失敗数の取得
+/// </summary>
+/// <returns>失敗数</returns>
+inline int& FailureCount() {
+	static int count = 0;
+	return count;
+}
+
+/// <summary>
+/// 条件のチェック
+/// </summary>
+/// <param name="condition">条件</param>
+/// <param name="expression">条件式の文字列</param>
+/// <param name="file">ファイル名</param>
+/// <param name="line">行番号</param>
+/// <returns>条件</returns>
+inline bool Check(bool condition, const char* expression, const char* file, int line) {
+	if (!condition) {
+		// 同じ箇所で大量に失敗しても読めるように表示数を絞る
+		if (FailureCount() < 50) {
+			printf("%s(%d): check failed: %s\n", file, line, expression);
+		}
+		FailureCount()++;
+	}
+	return condition;
+}
+
+/// <summary>
+/// 結果の表示
+/// </summary>
+/// <param name="name">テスト名</param>
+/// <returns>mainの戻り値（失敗があれば1）</returns>
+inline int Finish(const char* name) {
+	if (FailureCount() == 0) {
+		printf("%s: passed\n", name);
+		return 0;
+	}
+	printf("%s: %d check(s) failed\n", name, FailureCount());
+	return 1;
+}
+
+/// <summary>
+/// 1回の処理時間を計る（繰り返しの最短をとる）
+/// </summary>
+/// <param name="repeat">繰り返し回数</param>
+/// <param name="func">計る処理</param>
+/// <returns>ミリ秒</returns>
+template<class Func> double MeasureMilliseconds(int repeat, Func func) {
+	double best = 1e30;
+	for (int i = 0; i < repeat; i++) {
+		auto start = std::chrono::steady_clock::now();
+		func();
+		std::chrono::duration<double, std::milli> elapsed =
+		  std::chrono::steady_clock::now() - start;
+		best = (std::min)(best, elapsed.count());
+	}
+	return best;
+}
+
+/// <summary>
+/// ベンチマーク結果の表示
+/// </summary>
+/// <param name="name">計った処理の名前</param>
+/// <param name="milliseconds">1回の処理時間</param>
+/// <param name="itemCount">1回で処理した要素数</param>
+inline void Report(const char* name, double milliseconds, uint64_t itemCount) {
+	printf(
+	  "%-40s %10.3f ms  %8.2f ns/item  (%llu items)\n", name, milliseconds,
+	  milliseconds * 1e6 / (std::max)(itemCount, uint64_t(1)),
+	  static_cast<unsigned long long>(itemCount));
+}
+
+/// <summary>
+/// 計算結果を捨てさせない（最適化で処理ごと消えないように）
+/// 値のアドレスを外へ出し、コンパイラにメモリを読まれたとみなさせる
+/// </summary>
+/// <param name="value">値</param>
+template<class T> void KeepAlive(const T& value) {
+#ifdef _MSC_VER
+	static const void* volatile sink;
+	sink = &value;
+	_ReadWriteBarrier();
+#else
+	asm volatile("" : : "r"(&value) : "memory");
+#endif
+}
+
+/// <summary>
+/// 再現できる擬似乱数（xorshift32）
+/// </summary>
+class Random {
+  public:
+	explicit Random(uint32_t seed) : state_(seed ? seed : 1u) {}
+
+	uint32_t Next() {
+		state_ ^= state_ << 13;
+		state_ ^= state_ >> 17;
+		state_ ^= state_ << 5;
+		return state_;
+	}
+
+	// [0, count)
+	uint32_t Next(uint32_t count) { return count ? Next() % count : 0; }
+
+	// [min, max)
+	float Range(float min, float max) {
+		return min + (max - min) * static_cast<float>(Next() >> 8) * (1.0f / 16777216.0f);
+	}
+
+  private:
+	uint32_t state_;
+};
+
+} // namespace Test
+
+// 条件のチェック
+#define TEST_CHECK(condition) Test::Check((condition), #condition, __FILE__, __LINE__)
+// 誤差内のチェック
+#define TEST_CHECK_NEAR(a, b, tolerance)                                                           \
+	Test::Check(                                                                                   \
+	  std::fabs(double(a) - double(b)) <= double(tolerance), #a " == " #b " (+-" #tolerance ")",  \
+	  __FILE__, __LINE__)
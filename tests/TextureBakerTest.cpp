@@ -0,0 +1,109 @@
+﻿#include "TestUtility.h"
+#include "TextureBaker.h"
+
+using namespace DirectX;
+
+namespace {
+
+// 画像の種類
+enum class Pattern {
+	kOpaque, // 不透明なグラデーション
+	kCutout, // 抜き（アルファが0か1、抜いた画素は黒）
+	kAlpha,  // アルファもグラデーション
+};
+
+// 合成画像を作ってミップマップを付ける（ベイクと同じフィルタ）
+ScratchImage CreateImage(uint32_t width, uint32_t height, Pattern pattern) {
+	ScratchImage image{};
+	HRESULT result = image.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, width, height, 1, 1);
+	TEST_CHECK(SUCCEEDED(result));
+
+	const Image* top = image.GetImage(0, 0, 0);
+	for (uint32_t y = 0; y < height; y++) {
+		uint8_t* row = top->pixels + y * top->rowPitch;
+		for (uint32_t x = 0; x < width; x++) {
+			uint8_t* pixel = row + x * 4;
+			pixel[0] = uint8_t(x * 255 / (std::max)(width - 1, 1u));
+			pixel[1] = uint8_t(y * 255 / (std::max)(height - 1, 1u));
+			pixel[2] = uint8_t((x + y) * 255 / (std::max)(width + height - 2, 1u));
+			pixel[3] = 255;
+			if (pattern == Pattern::kCutout && (x / 8 + y / 8) % 2 == 0) {
+				pixel[0] = pixel[1] = pixel[2] = pixel[3] = 0;
+			} else if (pattern == Pattern::kAlpha) {
+				pixel[3] = uint8_t(255 - pixel[0] / 2);
+			}
+		}
+	}
+
+	ScratchImage mipChain{};
+	result = GenerateMipMaps(
+	  image.GetImages(), image.GetImageCount(), image.GetMetadata(), TEX_FILTER_DEFAULT, 0,
+	  mipChain);
+	TEST_CHECK(SUCCEEDED(result));
+	return mipChain;
+}
+
+// 各形式で圧縮し、誤差が許容値に収まること（4の倍数でない大きさを含む）
+void TestRoundTrip() {
+	struct Case {
+		Pattern pattern;
+		TextureBaker::Format format;
+	};
+	const Case cases[] = {
+	  {Pattern::kOpaque, TextureBaker::Format::kBC1},
+	  {Pattern::kOpaque, TextureBaker::Format::kBC3},
+	  {Pattern::kOpaque, TextureBaker::Format::kBC7},
+	  {Pattern::kCutout, TextureBaker::Format::kBC1},
+	  {Pattern::kAlpha, TextureBaker::Format::kBC3},
+	  {Pattern::kAlpha, TextureBaker::Format::kBC7},
+	};
+	const uint32_t sizes[][2] = {{64, 64}, {128, 32}, {30, 18}, {5, 3}};
+
+	for (const auto& size : sizes) {
+		for (const Case& c : cases) {
+			ScratchImage source = CreateImage(size[0], size[1], c.pattern);
+			ScratchImage compressed{};
+			float mse = 1.0f;
+			HRESULT result = TextureBaker::Compress(source, c.format, compressed, mse);
+			TEST_CHECK(SUCCEEDED(result));
+			TEST_CHECK(compressed.GetMetadata().mipLevels == source.GetMetadata().mipLevels);
+			TEST_CHECK(mse <= TextureBaker::kMaxMeanSquaredError);
+		}
+	}
+}
+
+// 自動の形式は不透明ならBC1、アルファがあればBC7
+void TestAutoFormat() {
+	ScratchImage compressed{};
+	float mse = 1.0f;
+	ScratchImage opaque = CreateImage(32, 32, Pattern::kOpaque);
+	TEST_CHECK(SUCCEEDED(
+	  TextureBaker::Compress(opaque, TextureBaker::Format::kAuto, compressed, mse)));
+	TEST_CHECK(compressed.GetMetadata().format == DXGI_FORMAT_BC1_UNORM_SRGB);
+
+	ScratchImage alpha = CreateImage(32, 32, Pattern::kAlpha);
+	TEST_CHECK(SUCCEEDED(
+	  TextureBaker::Compress(alpha, TextureBaker::Format::kAuto, compressed, mse)));
+	TEST_CHECK(compressed.GetMetadata().format == DXGI_FORMAT_BC7_UNORM_SRGB);
+}
+
+// 別の画像と比べれば誤差は許容値を超える（計測が常に0を返さないこと）
+void TestMeasureErrorDetectsMismatch() {
+	ScratchImage opaque = CreateImage(32, 32, Pattern::kOpaque);
+	ScratchImage cutout = CreateImage(32, 32, Pattern::kCutout);
+	ScratchImage compressed{};
+	float mse = 0.0f;
+	TEST_CHECK(SUCCEEDED(
+	  TextureBaker::Compress(opaque, TextureBaker::Format::kBC7, compressed, mse)));
+	TEST_CHECK(SUCCEEDED(TextureBaker::MeasureError(cutout, compressed, mse)));
+	TEST_CHECK(mse > TextureBaker::kMaxMeanSquaredError);
+}
+
+} // namespace
+
+int main() {
+	TestRoundTrip();
+	TestAutoFormat();
+	TestMeasureErrorDetectsMismatch();
+	return Test::Finish("TextureBakerTest");
+}
@@ -0,0 +1,266 @@
+﻿#include "TestUtility.h"
+#include "TextureResidency.h"
+#include <vector>
+
+namespace {
+
+// 正方形のRGBA8テクスチャのミップごとのサイズ
+std::vector<uint64_t> MakeMipSizes(uint32_t size) {
+	std::vector<uint64_t> mipSizes;
+	for (;;) {
+		mipSizes.push_back(uint64_t(size) * size * 4);
+		if (size == 1) {
+			return mipSizes;
+		}
+		size /= 2;
+	}
+}
+
+// ミップから先の合計サイズ
+uint64_t GetSizeFrom(const std::vector<uint64_t>& mipSizes, uint32_t mip) {
+	uint64_t size = 0;
+	for (size_t i = mip; i < mipSizes.size(); i++) {
+		size += mipSizes[i];
+	}
+	return size;
+}
+
+// 変更を読み込み完了として反映する
+void Apply(TextureResidency& residency, const std::vector<TextureResidency::Change>& changes) {
+	for (const TextureResidency::Change& change : changes) {
+		residency.SetResidentMip(change.id, change.residentMip);
+	}
+}
+
+// 画面上の大きさからのミップの選択
+void TestComputeMip() {
+	TEST_CHECK(TextureResidency::ComputeMip(1024, 1024.0f, 11) == 0);
+	TEST_CHECK(TextureResidency::ComputeMip(1024, 2000.0f, 11) == 0);
+	TEST_CHECK(TextureResidency::ComputeMip(1024, 512.0f, 11) == 1);
+	TEST_CHECK(TextureResidency::ComputeMip(1024, 511.0f, 11) == 1);
+	TEST_CHECK(TextureResidency::ComputeMip(1024, 100.0f, 11) == 3);
+	// 見えていない、小さすぎるときは最も粗いミップ
+	TEST_CHECK(TextureResidency::ComputeMip(1024, 0.0f, 11) == 10);
+	TEST_CHECK(TextureResidency::ComputeMip(1024, -1.0f, 11) == 10);
+	TEST_CHECK(TextureResidency::ComputeMip(1024, 0.5f, 11) == 10);
+	TEST_CHECK(TextureResidency::ComputeMip(1024, 1.0f, 4) == 3);
+}
+
+// 予算内なら必要なミップまで読み込み、使われなくなっても粗くしないこと
+void TestWithinBudget() {
+	std::vector<uint64_t> mipSizes = MakeMipSizes(256);
+	TextureResidency residency;
+	std::vector<TextureResidency::Change> changes;
+	residency.Add(0, mipSizes, 8);
+	residency.Add(3, mipSizes, 8);
+
+	residency.Update(1, changes);
+	TEST_CHECK(changes.empty());
+
+	residency.Request(3, 4);
+	residency.Request(3, 2); // 同じフレームで最も詳細なもの
+	residency.Request(0, 5);
+	residency.Request(7, 0); // 登録していない番号は無視する
+	residency.Update(2, changes);
+	TEST_CHECK(changes.size() == 2);
+	TEST_CHECK(changes[0].id == 0 && changes[0].residentMip == 5);
+	TEST_CHECK(changes[1].id == 3 && changes[1].residentMip == 2);
+	Apply(residency, changes);
+	TEST_CHECK(residency.GetResidentSize() == GetSizeFrom(mipSizes, 5) + GetSizeFrom(mipSizes, 2));
+
+	// 要求がなくなっても予算内ならそのまま
+	residency.Update(3, changes);
+	TEST_CHECK(changes.empty());
+	// 最も粗いミップより先は要求できない
+	residency.Request(0, 20);
+	residency.Update(4, changes);
+	TEST_CHECK(changes.empty());
+}
+
+// 予算を超えたら長く使われていないものから最も粗いミップへ落とすこと
+void TestLeastRecentlyUsed() {
+	std::vector<uint64_t> mipSizes = MakeMipSizes(256);
+	uint64_t full = GetSizeFrom(mipSizes, 0);
+	uint64_t coarsest = mipSizes.back();
+	TextureResidency residency;
+	std::vector<TextureResidency::Change> changes;
+	for (uint32_t id = 0; id < 4; id++) {
+		residency.Add(id, mipSizes, 0);
+	}
+
+	// 使った順に 0, 1, 2, 3
+	for (uint32_t id = 0; id < 4; id++) {
+		residency.Request(id, 0);
+		residency.Update(id + 1, changes);
+		TEST_CHECK(changes.empty());
+	}
+
+	// 2枚と少しの予算なら、古い0と1を落とす
+	residency.SetBudget(full * 2 + coarsest * 2);
+	residency.Update(10, changes);
+	TEST_CHECK(changes.size() == 2);
+	TEST_CHECK(changes[0].id == 0 && changes[0].residentMip == 8);
+	TEST_CHECK(changes[1].id == 1 && changes[1].residentMip == 8);
+	Apply(residency, changes);
+	TEST_CHECK(residency.GetResidentSize() <= residency.GetBudget());
+
+	// 0を使うと、次に古い2が落ちる
+	residency.Request(0, 0);
+	residency.Update(11, changes);
+	TEST_CHECK(changes.size() == 2);
+	TEST_CHECK(changes[0].id == 0 && changes[0].residentMip == 0);
+	TEST_CHECK(changes[1].id == 2 && changes[1].residentMip == 8);
+	Apply(residency, changes);
+	TEST_CHECK(residency.GetResidentSize() <= residency.GetBudget());
+
+	// 同じフレームで使われたものは番号の小さい方から落とす
+	residency.Request(1, 0);
+	residency.Request(2, 0);
+	residency.Update(12, changes);
+	TEST_CHECK(changes.size() == 4);
+	TEST_CHECK(changes[0].id == 0 && changes[0].residentMip == 8);
+	TEST_CHECK(changes[1].id == 1 && changes[1].residentMip == 0);
+	TEST_CHECK(changes[2].id == 2 && changes[2].residentMip == 0);
+	TEST_CHECK(changes[3].id == 3 && changes[3].residentMip == 8);
+}
+
+// 必要以上に詳細なミップを先に削り、見えているものは必要な分だけ粗くすること
+void TestTrimBeforeVisible() {
+	std::vector<uint64_t> mipSizes = MakeMipSizes(256);
+	TextureResidency residency;
+	std::vector<TextureResidency::Change> changes;
+	residency.Add(0, mipSizes, 0);
+	residency.Add(1, mipSizes, 0);
+
+	// 同じフレームに使われ、0の方が先に落とす順だが、必要以上に詳細な1を先に削る
+	residency.Request(0, 0);
+	residency.Request(1, 2);
+	residency.SetBudget(GetSizeFrom(mipSizes, 0) + GetSizeFrom(mipSizes, 2));
+	residency.Update(1, changes);
+	TEST_CHECK(changes.size() == 1);
+	TEST_CHECK(changes[0].id == 1 && changes[0].residentMip == 2);
+	Apply(residency, changes);
+
+	// それでも足りなければ、見えているものを1段ずつ予算に収まるまで粗くする
+	residency.SetBudget(GetSizeFrom(mipSizes, 1) + GetSizeFrom(mipSizes, 2));
+	residency.Request(0, 0);
+	residency.Request(1, 2);
+	residency.Update(2, changes);
+	TEST_CHECK(changes.size() == 1);
+	TEST_CHECK(changes[0].id == 0 && changes[0].residentMip == 1);
+	Apply(residency, changes);
+	TEST_CHECK(residency.GetResidentSize() == residency.GetBudget());
+
+	// 使われていないものは見えているものより先に落とす
+	residency.Request(1, 2);
+	residency.Update(3, changes);
+	TEST_CHECK(changes.empty());
+	residency.SetBudget(GetSizeFrom(mipSizes, 2) + mipSizes.back());
+	residency.Request(1, 2);
+	residency.Update(4, changes);
+	TEST_CHECK(changes.size() == 1);
+	TEST_CHECK(changes[0].id == 0 && changes[0].residentMip == 8);
+}
+
+// 削除したテクスチャは数えず、番号を使い回せること
+void TestRemove() {
+	std::vector<uint64_t> mipSizes = MakeMipSizes(64);
+	TextureResidency residency;
+	std::vector<TextureResidency::Change> changes;
+	residency.Add(0, mipSizes, 0);
+	residency.Add(1, mipSizes, 0);
+	residency.Remove(0);
+	TEST_CHECK(residency.GetResidentSize() == GetSizeFrom(mipSizes, 0));
+
+	residency.SetBudget(GetSizeFrom(mipSizes, 0));
+	residency.Request(0, 0);
+	residency.Update(1, changes);
+	TEST_CHECK(changes.empty());
+
+	residency.Add(0, MakeMipSizes(16), 4);
+	TEST_CHECK(residency.GetResidentMip(0) == 4);
+	residency.Clear();
+	TEST_CHECK(residency.GetResidentSize() == 0);
+}
+
+// ランダムな要求と予算で、予算と要求を守ること
+void TestRandom() {
+	Test::Random random(1);
+	const uint32_t kTextureCount = 64;
+	std::vector<std::vector<uint64_t>> mipSizes(kTextureCount);
+	std::vector<uint64_t> lastUsed(kTextureCount, 0);
+	TextureResidency residency;
+	std::vector<TextureResidency::Change> changes;
+	for (uint32_t id = 0; id < kTextureCount; id++) {
+		mipSizes[id] = MakeMipSizes(1u << (2 + random.Next(9)));
+		residency.Add(id, mipSizes[id], static_cast<uint32_t>(mipSizes[id].size() - 1));
+	}
+
+	for (uint64_t frame = 1; frame <= 2000; frame++) {
+		if (frame % 100 == 1) {
+			residency.SetBudget(uint64_t(1024) * 1024 * (1 + random.Next(8)));
+		}
+
+		std::vector<uint32_t> requested(kTextureCount, UINT32_MAX);
+		std::vector<uint32_t> before(kTextureCount);
+		uint64_t requestedSize = 0;
+		for (uint32_t id = 0; id < kTextureCount; id++) {
+			before[id] = residency.GetResidentMip(id);
+			if (random.Next(4) == 0) {
+				uint32_t coarsest = static_cast<uint32_t>(mipSizes[id].size() - 1);
+				requested[id] = random.Next(coarsest + 1);
+				residency.Request(id, requested[id]);
+				lastUsed[id] = frame;
+			}
+		}
+		for (uint32_t id = 0; id < kTextureCount; id++) {
+			uint32_t mip = requested[id] != UINT32_MAX ? (std::min)(requested[id], before[id])
+			                                           : before[id];
+			requestedSize += GetSizeFrom(mipSizes[id], mip);
+		}
+
+		residency.Update(frame, changes);
+		Apply(residency, changes);
+
+		// 予算に収まるか、全て最も粗いミップまで落ちている
+		bool allCoarsest = true;
+		for (uint32_t id = 0; id < kTextureCount; id++) {
+			allCoarsest = allCoarsest && residency.GetResidentMip(id) == mipSizes[id].size() - 1;
+		}
+		TEST_CHECK(residency.GetResidentSize() <= residency.GetBudget() || allCoarsest);
+
+		// 予算内なら要求どおり（要求より粗くせず、不要に落とさない）
+		if (requestedSize <= residency.GetBudget()) {
+			for (uint32_t id = 0; id < kTextureCount; id++) {
+				uint32_t mip = residency.GetResidentMip(id);
+				TEST_CHECK(requested[id] == UINT32_MAX || mip <= requested[id]);
+				TEST_CHECK(mip <= before[id]);
+			}
+		}
+
+		// 粗くされたものより、後で使われたものが先に落ちることはない（見えていないもの同士）
+		for (uint32_t a = 0; a < kTextureCount; a++) {
+			if (requested[a] != UINT32_MAX || residency.GetResidentMip(a) <= before[a]) {
+				continue;
+			}
+			for (uint32_t b = 0; b < kTextureCount; b++) {
+				bool older = lastUsed[b] < lastUsed[a];
+				bool kept = residency.GetResidentMip(b) < mipSizes[b].size() - 1;
+				TEST_CHECK(!(requested[b] == UINT32_MAX && older && kept));
+			}
+		}
+	}
+}
+
+} // namespace
+
+int main() {
+	TestComputeMip();
+	TestWithinBudget();
+	TestLeastRecentlyUsed();
+	TestTrimBeforeVisible();
+	TestRemove();
+	TestRandom();
+
+	return Test::Finish("TextureResidencyTest");
+}
@@ -0,0 +1,240 @@
+﻿#include "TestUtility.h"
+#include "TlsfAllocator.h"
+#include <algorithm>
+
+namespace {
+
+const uint32_t kFree = UINT32_MAX;
+
+/// <summary>
+/// 確保した範囲を単位ごとの持ち主として記録する模擬メモリ
+/// 重なりの検出に使う
+/// </summary>
+class ShadowMemory {
+  public:
+	ShadowMemory(uint64_t capacity, uint64_t granularity)
+	    : granularity_(granularity), owners_(capacity / granularity, kFree) {}
+
+	// 範囲が空いているか
+	bool IsFree(uint64_t offset, uint64_t size) const {
+		for (uint64_t i = offset / granularity_; i < (offset + size) / granularity_; i++) {
+			if (owners_[i] != kFree) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// 範囲の持ち主を設定
+	void Fill(uint64_t offset, uint64_t size, uint32_t owner) {
+		std::fill(
+		  owners_.begin() + offset / granularity_, owners_.begin() + (offset + size) / granularity_,
+		  owner);
+	}
+
+	// 範囲が全て同じ持ち主か
+	bool IsOwnedBy(uint64_t offset, uint64_t size, uint32_t owner) const {
+		for (uint64_t i = offset / granularity_; i < (offset + size) / granularity_; i++) {
+			if (owners_[i] != owner) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// 最大の連続空き領域
+	uint64_t GetLargestFreeRun() const {
+		uint64_t largest = 0;
+		uint64_t run = 0;
+		for (uint32_t owner : owners_) {
+			run = owner == kFree ? run + 1 : 0;
+			largest = (std::max)(largest, run);
+		}
+		return largest * granularity_;
+	}
+
+  private:
+	uint64_t granularity_;
+	std::vector<uint32_t> owners_;
+};
+
+/// <summary>
+/// ランダムな確保・解放を繰り返し、模擬メモリと統計を突き合わせる
+/// </summary>
+class StressTest {
+  public:
+	StressTest(uint64_t capacity, uint64_t granularity, uint32_t seed)
+	    : capacity_(capacity), granularity_(granularity), allocator_(capacity, granularity),
+	      memory_(capacity, granularity), random_(seed) {}
+
+	void Run(uint32_t operationCount, uint32_t maxAlignmentShift, uint32_t maxSizeUnits) {
+		for (uint32_t i = 0; i < operationCount; i++) {
+			uint32_t operation = random_.Next(100);
+			if (operation < 55) {
+				uint64_t size = (1 + random_.Next(maxSizeUnits)) * granularity_ -
+				                random_.Next(static_cast<uint32_t>(granularity_));
+				uint64_t alignment = uint64_t(1) << random_.Next(maxAlignmentShift + 1);
+				Allocate(size, alignment);
+			} else {
+				FreeRandom();
+			}
+
+			if (i % 64 == 0) {
+				CheckConsistency();
+			}
+		}
+		CheckConsistency();
+
+		// 全て解放すると1つの空きブロックに戻る
+		while (!live_.empty()) {
+			FreeRandom();
+		}
+		TlsfAllocator::Stats stats = allocator_.GetStats();
+		TEST_CHECK(allocator_.IsEmpty());
+		TEST_CHECK(allocator_.Validate());
+		TEST_CHECK(stats.freeBlockCount == 1);
+		TEST_CHECK(stats.largestFreeBlock == capacity_);
+	}
+
+	uint32_t GetFailedAllocationCount() const { return failedCount_; }
+
+  private:
+	struct Live {
+		TlsfAllocator::Allocation allocation;
+		uint32_t owner;
+	};
+
+	void Allocate(uint64_t size, uint64_t alignment) {
+		TlsfAllocator::Allocation allocation = allocator_.Allocate(size, alignment);
+		if (!allocation.IsValid()) {
+			// 境界合わせで捨てる分を足しても収まる空きがなかったこと
+			uint64_t alignedSize = (size + granularity_ - 1) / granularity_ * granularity_;
+			uint64_t searchSize =
+			  alignedSize + ((std::max)(alignment, granularity_) - granularity_);
+			TEST_CHECK(memory_.GetLargestFreeRun() < searchSize);
+			failedCount_++;
+			return;
+		}
+
+		TEST_CHECK(allocation.size >= size);
+		TEST_CHECK(allocation.size % granularity_ == 0);
+		TEST_CHECK(allocation.offset % alignment == 0);
+		TEST_CHECK(allocation.offset + allocation.size <= capacity_);
+		// 使用中の範囲と重ならない
+		TEST_CHECK(memory_.IsFree(allocation.offset, allocation.size));
+
+		uint32_t owner = nextOwner_++;
+		memory_.Fill(allocation.offset, allocation.size, owner);
+		live_.push_back({allocation, owner});
+	}
+
+	void FreeRandom() {
+		if (live_.empty()) {
+			return;
+		}
+		size_t index = random_.Next(static_cast<uint32_t>(live_.size()));
+		Live& live = live_[index];
+		TEST_CHECK(memory_.IsOwnedBy(live.allocation.offset, live.allocation.size, live.owner));
+		memory_.Fill(live.allocation.offset, live.allocation.size, kFree);
+		allocator_.Free(live.allocation);
+		live_[index] = live_.back();
+		live_.pop_back();
+	}
+
+	void CheckConsistency() {
+		TEST_CHECK(allocator_.Validate());
+
+		uint64_t usedSize = 0;
+		for (const Live& live : live_) {
+			usedSize += live.allocation.size;
+		}
+		TlsfAllocator::Stats stats = allocator_.GetStats();
+		TEST_CHECK(stats.capacity == capacity_);
+		TEST_CHECK(stats.allocationCount == live_.size());
+		TEST_CHECK(stats.usedSize == usedSize);
+		TEST_CHECK(stats.usedSize + stats.freeSize == capacity_);
+		// 空きブロックは結合されているので、最大の空きは模擬メモリの最長の空きと一致する
+		TEST_CHECK(stats.largestFreeBlock == memory_.GetLargestFreeRun());
+		TEST_CHECK(allocator_.IsEmpty() == live_.empty());
+	}
+
+	uint64_t capacity_;
+	uint64_t granularity_;
+	TlsfAllocator allocator_;
+	ShadowMemory memory_;
+	Test::Random random_;
+	std::vector<Live> live_;
+	uint32_t nextOwner_ = 0;
+	uint32_t failedCount_ = 0;
+};
+
+// 空のアロケータの基本動作
+void TestBasic() {
+	TlsfAllocator allocator(1024 * 1024, 256);
+	TEST_CHECK(allocator.IsEmpty());
+	TEST_CHECK(allocator.Validate());
+
+	// 0バイトでも最小単位を確保する
+	TlsfAllocator::Allocation empty = allocator.Allocate(0, 1);
+	TEST_CHECK(empty.IsValid());
+	TEST_CHECK(empty.size == 256);
+
+	// 容量を超える確保は失敗する
+	TEST_CHECK(!allocator.Allocate(2 * 1024 * 1024, 256).IsValid());
+	// 容量ちょうどは残りがないので失敗し、解放後は成功する
+	TEST_CHECK(!allocator.Allocate(1024 * 1024, 256).IsValid());
+	allocator.Free(empty);
+	// 境界合わせの分も見込んで探すので、最小単位より大きいアライメントでは容量ちょうどは入らない
+	TEST_CHECK(!allocator.Allocate(1024 * 1024, 65536).IsValid());
+	TlsfAllocator::Allocation whole = allocator.Allocate(1024 * 1024, 256);
+	if (!TEST_CHECK(whole.IsValid())) {
+		return;
+	}
+	TEST_CHECK(whole.offset == 0);
+	TEST_CHECK(allocator.GetStats().freeSize == 0);
+	allocator.Free(whole);
+	TEST_CHECK(allocator.Validate());
+}
+
+// 大きなアライメントの確保で先頭の詰め物が空きとして残り、再利用されること
+void TestAlignmentPadding() {
+	TlsfAllocator allocator(1024 * 1024, 256);
+	TlsfAllocator::Allocation small = allocator.Allocate(256, 256);
+	TlsfAllocator::Allocation aligned = allocator.Allocate(65536, 65536);
+	TEST_CHECK(small.offset == 0);
+	TEST_CHECK(aligned.offset == 65536);
+	TEST_CHECK(allocator.Validate());
+
+	// 詰め物の隙間に小さい確保が入る（探すリストは切り上げるので隙間より小さめ）
+	TlsfAllocator::Allocation filler = allocator.Allocate(4096, 256);
+	TEST_CHECK(filler.offset == 256);
+	TEST_CHECK(allocator.Validate());
+}
+
+} // namespace
+
+int main() {
+	TestBasic();
+	TestAlignmentPadding();
+
+	// 小さい確保が中心（最小単位256、アライメント1～4KB）
+	{
+		StressTest test(4 * 1024 * 1024, 256, 1);
+		test.Run(40000, 12, 64);
+		printf("small: %u failed allocations\n", test.GetFailedAllocationCount());
+	}
+	// 大きな確保で埋まりやすい（テクスチャの64KB境界を含む）
+	{
+		StressTest test(16 * 1024 * 1024, 4096, 2);
+		test.Run(20000, 16, 512);
+		printf("large: %u failed allocations\n", test.GetFailedAllocationCount());
+		TEST_CHECK(test.GetFailedAllocationCount() > 0);
+	}
+	// 最小単位1で端数のあるサイズ
+	{
+		StressTest test(1 << 20, 1, 3);
+		test.Run(20000, 8, 3000);
+	}
+
+	return Test::Finish("TlsfAllocatorTest");
+}
@@ -0,0 +1,148 @@
+﻿// テスト用のSpriteBatch、TextureManager、SdfFont（fake/）と同じ場所に複製したものを読み込む
+#include "SdfFont.h"
+#include "TestUtility.h"
+#include "UiElement.h"
+
+using namespace DirectX;
+
+namespace {
+
+// 2,000要素のHUD（40枚のパネルに49個ずつ。8個に1個は文字列付き）
+const uint32_t kPanelCount = 40;
+const uint32_t kLeafCount = 49;
+const uint32_t kElementCount = 1 + kPanelCount * (1 + kLeafCount);
+
+// 要素の設定（保持型と、毎フレーム設定し直す方で同じものを使う）
+struct Item {
+	XMFLOAT2 position; // スクリーン座標
+	XMFLOAT2 size;
+	XMFLOAT4 color;
+	uint32_t textureHandle;
+	std::string text;
+};
+
+// HUDの要素（パネル、その子の順）
+std::vector<Item> CreateItems(uint32_t panelTexture, uint32_t iconTexture) {
+	std::vector<Item> items;
+	for (uint32_t p = 0; p < kPanelCount; p++) {
+		XMFLOAT2 panelPosition = {float(p % 8) * 160.0f, float(p / 8) * 144.0f};
+		items.push_back({panelPosition, {156.0f, 140.0f}, {1, 1, 1, 0.8f}, panelTexture, ""});
+		for (uint32_t i = 0; i < kLeafCount; i++) {
+			XMFLOAT2 position = {
+			  panelPosition.x + float(i % 7) * 22.0f, panelPosition.y + float(i / 7) * 20.0f};
+			std::string text = i % 8 == 0 ? "x" + std::to_string(i) : "";
+			items.push_back({position, {20.0f, 18.0f}, {1, 1, 1, 1}, iconTexture, text});
+		}
+	}
+	return items;
+}
+
+// 保持型のHUDを作る
+std::unique_ptr<UiElement>
+  CreateHud(const std::vector<Item>& items, SdfFont* font, std::vector<UiElement*>& elements) {
+	std::unique_ptr<UiElement> root(new UiElement());
+	elements.clear();
+	UiElement* panel = nullptr;
+	XMFLOAT2 panelPosition = {0, 0};
+	for (size_t i = 0; i < items.size(); i++) {
+		const Item& item = items[i];
+		UiElement* element = nullptr;
+		if (i % (kLeafCount + 1) == 0) {
+			panel = element = root->CreateChild();
+			panelPosition = item.position;
+			element->SetPosition(item.position);
+		} else {
+			element = panel->CreateChild();
+			element->SetPosition(
+			  {item.position.x - panelPosition.x, item.position.y - panelPosition.y});
+		}
+		elements.push_back(element);
+		element->SetSize(item.size);
+		element->SetColor(item.color);
+		element->SetImage(item.textureHandle);
+		if (!item.text.empty()) {
+			element->SetText(font, item.text, 12.0f);
+		}
+	}
+	return root;
+}
+
+} // namespace
+
+// 静的な2,000要素のHUDの描画（保持型と、毎フレーム全てのスプライトを設定し直す方）
+// 保持型は変更した要素だけ頂点を作り直し、毎フレームの手間は各要素の頂点をSpriteBatchへ写す分だけ
+int main() {
+	TextureManager* textureManager = TextureManager::GetInstance();
+	uint32_t panelTexture = textureManager->Add(256, 256);
+	uint32_t iconTexture = textureManager->Add(512, 512);
+	SdfFont font(textureManager->Add(512, 512));
+	std::vector<Item> items = CreateItems(panelTexture, iconTexture);
+	SpriteBatch* spriteBatch = SpriteBatch::GetInstance();
+
+	// 最初のフレーム（全要素の頂点を作る）
+	const int kRepeat = 20;
+	std::vector<std::unique_ptr<UiElement>> huds;
+	std::vector<UiElement*> elements;
+	std::vector<UiElement*> otherElements;
+	for (int i = 0; i < kRepeat; i++) {
+		huds.push_back(CreateHud(items, &font, i == 0 ? elements : otherElements));
+	}
+	size_t nextHud = 0;
+	double firstFrame = Test::MeasureMilliseconds(kRepeat, [&]() {
+		spriteBatch->Clear();
+		huds[nextHud++]->Draw();
+	});
+	TEST_CHECK(huds[0]->GetRebuildCount() == kElementCount);
+	size_t quadCount = spriteBatch->textureHandles.size();
+	huds.resize(1);
+	UiElement* hud = huds[0].get();
+
+	// 変更のないフレーム
+	double staticFrame = Test::MeasureMilliseconds(kRepeat, [&]() {
+		spriteBatch->Clear();
+		hud->Draw();
+	});
+	TEST_CHECK(hud->GetRebuildCount() == 0);
+	TEST_CHECK(spriteBatch->textureHandles.size() == quadCount);
+	Test::KeepAlive(spriteBatch->vertices[quadCount * 2]);
+
+	// 1つの葉の色の変更（真ん中のパネルの真ん中の葉）
+	UiElement* leaf = elements[(kPanelCount / 2) * (kLeafCount + 1) + 1 + kLeafCount / 2];
+	int frame = 0;
+	double leafChange = Test::MeasureMilliseconds(kRepeat, [&]() {
+		leaf->SetColor({1.0f, (frame++ % 2) ? 1.0f : 0.5f, 1.0f, 1.0f});
+		spriteBatch->Clear();
+		hud->Draw();
+	});
+	TEST_CHECK(hud->GetRebuildCount() == 1);
+	Test::KeepAlive(spriteBatch->vertices[quadCount * 2]);
+
+	// 毎フレーム全てのスプライトを設定し直す（文字列も並べ直す）
+	std::vector<SpriteBatch::Vertex> textVertices;
+	double immediate = Test::MeasureMilliseconds(kRepeat, [&]() {
+		spriteBatch->Clear();
+		for (const Item& item : items) {
+			spriteBatch->SetShader(SpriteBatch::Shader::kTexture);
+			spriteBatch->DrawSprite(
+			  item.textureHandle, item.position, item.size, 0.0f, {0.0f, 0.0f},
+			  {0.0f, 0.0f, 1.0f, 1.0f}, item.color);
+			if (!item.text.empty()) {
+				textVertices.clear();
+				font.Layout(item.text, item.position, 12.0f, 0.0f, item.color, &textVertices);
+				spriteBatch->SetShader(SpriteBatch::Shader::kDistanceField);
+				spriteBatch->DrawQuads(
+				  font.GetTextureHandle(), textVertices.data(), textVertices.size() / 4);
+			}
+		}
+		spriteBatch->FlushSprites();
+	});
+	TEST_CHECK(spriteBatch->textureHandles.size() == quadCount);
+	Test::KeepAlive(spriteBatch->vertices[quadCount * 2]);
+
+	Test::Report("retained: first frame", firstFrame, kElementCount);
+	Test::Report("retained: static frame", staticFrame, kElementCount);
+	Test::Report("retained: one leaf changed", leafChange, kElementCount);
+	Test::Report("immediate: re-set every sprite", immediate, kElementCount);
+	printf("%u elements, %zu quads\n", kElementCount, quadCount);
+	return Test::Finish("UiElementBenchmark");
+}
@@ -0,0 +1,261 @@
+﻿// テスト用のSpriteBatch、TextureManager、SdfFont（fake/）と同じ場所に複製したものを読み込む
+#include "SdfFont.h"
+#include "TestUtility.h"
+#include "UiElement.h"
+#include <cstring>
+
+using namespace DirectX;
+
+namespace {
+
+// 要素の設定（変更を続けた木と、毎回作り直した木に同じ設定をする）
+struct Node {
+	int parent;
+	XMFLOAT2 position;
+	XMFLOAT2 size;
+	XMFLOAT2 anchorPoint;
+	XMFLOAT4 color;
+	bool isVisible;
+	int image; // テクスチャの番号（負なら画像なし）
+	bool isAtlas;
+	std::string text;
+};
+
+// テスト用のテクスチャ
+struct Textures {
+	std::vector<uint32_t> handles;
+	uint32_t font;
+};
+
+// 画像の設定
+void ApplyImage(UiElement* element, const Node& node, const Textures& textures) {
+	if (node.image < 0) {
+		element->ClearImage();
+	} else if (node.isAtlas) {
+		TextureManager::AtlasRegion region;
+		region.textureHandle = textures.handles[node.image];
+		region.texBase = {16.0f, 8.0f};
+		region.texSize = {32.0f, 24.0f};
+		element->SetImage(region);
+	} else {
+		element->SetImage(textures.handles[node.image], {0.25f, 0.0f, 0.75f, 0.5f});
+	}
+}
+
+// 全ての設定
+void Apply(UiElement* element, const Node& node, const Textures& textures, SdfFont* font) {
+	element->SetPosition(node.position);
+	element->SetSize(node.size);
+	element->SetAnchorPoint(node.anchorPoint);
+	element->SetColor(node.color);
+	element->SetVisible(node.isVisible);
+	ApplyImage(element, node, textures);
+	element->SetText(node.text.empty() ? nullptr : font, node.text, 16.0f);
+}
+
+// 設定から木を作る（親は子より前に並んでいる）
+std::unique_ptr<UiElement> Build(
+  const std::vector<Node>& nodes, const Textures& textures, SdfFont* font,
+  std::vector<UiElement*>& elements) {
+	std::unique_ptr<UiElement> root(new UiElement());
+	elements.assign(1, root.get());
+	for (size_t i = 1; i < nodes.size(); i++) {
+		elements.push_back(elements[nodes[i].parent]->CreateChild());
+	}
+	for (size_t i = 0; i < nodes.size(); i++) {
+		Apply(elements[i], nodes[i], textures, font);
+	}
+	return root;
+}
+
+// ランダムな設定
+Node RandomNode(Test::Random& random, int parent) {
+	Node node;
+	node.parent = parent;
+	node.position = {random.Range(-50.0f, 200.0f), random.Range(-50.0f, 200.0f)};
+	node.size = {random.Range(1.0f, 64.0f), random.Range(1.0f, 64.0f)};
+	node.anchorPoint = {random.Range(0.0f, 1.0f), random.Range(0.0f, 1.0f)};
+	node.color = {random.Range(0.0f, 1.0f), random.Range(0.0f, 1.0f), 1.0f, 1.0f};
+	node.isVisible = random.Next(8) != 0;
+	node.image = random.Next(4) == 0 ? -1 : int(random.Next(3));
+	node.isAtlas = random.Next(2) == 0;
+	node.text = random.Next(4) == 0 ? std::string("HP ") + char('0' + random.Next(10)) : "";
+	return node;
+}
+
+// 描画して記録を取り出す
+SpriteBatch* DrawRoot(UiElement* root) {
+	SpriteBatch* spriteBatch = SpriteBatch::GetInstance();
+	spriteBatch->Clear();
+	root->Draw();
+	return spriteBatch;
+}
+
+// 変更を続けた木が、同じ設定で作り直した木と同じ頂点を追加すること
+// （画像、文字列、表示の切り替え、子の追加、親の移動、非同期読み込みの完了を含む）
+void TestMatchesFreshTree() {
+	TextureManager* textureManager = TextureManager::GetInstance();
+	Textures textures;
+	for (int i = 0; i < 3; i++) {
+		// 読み込み中の代わりのテクスチャは1x1
+		textures.handles.push_back(textureManager->Add(1, 1));
+	}
+	textures.font = textureManager->Add(512, 512);
+	SdfFont font(textures.font);
+
+	Test::Random random(7);
+	std::vector<Node> nodes;
+	for (int i = 0; i < 300; i++) {
+		nodes.push_back(RandomNode(random, i ? int(random.Next(uint32_t(nodes.size()))) : -1));
+		// 根に近い要素は表示しておく（多くの要素がその下にある）
+		nodes.back().isVisible |= i < 16;
+	}
+	std::vector<UiElement*> elements;
+	std::unique_ptr<UiElement> root = Build(nodes, textures, &font, elements);
+
+	for (int frame = 0; frame < 60; frame++) {
+		// いくつかの要素を変更
+		uint32_t changeCount = random.Next(6);
+		for (uint32_t c = 0; c < changeCount; c++) {
+			size_t index = 1 + random.Next(uint32_t(nodes.size() - 1));
+			Node& node = nodes[index];
+			UiElement* element = elements[index];
+			Node other = RandomNode(random, node.parent);
+			switch (random.Next(7)) {
+			case 0:
+				node.color = other.color;
+				element->SetColor(node.color);
+				break;
+			case 1:
+				node.position = other.position;
+				element->SetPosition(node.position);
+				break;
+			case 2:
+				node.size = other.size;
+				element->SetSize(node.size);
+				break;
+			case 3:
+				node.isVisible = !node.isVisible;
+				element->SetVisible(node.isVisible);
+				break;
+			case 4:
+				node.image = other.image;
+				node.isAtlas = other.isAtlas;
+				ApplyImage(element, node, textures);
+				break;
+			case 5:
+				node.text = other.text;
+				element->SetText(node.text.empty() ? nullptr : &font, node.text, 16.0f);
+				break;
+			default:
+				nodes.push_back(RandomNode(random, int(index)));
+				elements.push_back(element->CreateChild());
+				Apply(elements.back(), nodes.back(), textures, &font);
+				break;
+			}
+		}
+		// 読み込みの完了
+		if (frame == 20 || frame == 40) {
+			uint32_t handle = textures.handles[frame / 20 - 1];
+			textureManager->CompleteLoad(handle, 256, 128);
+		}
+
+		SpriteBatch* spriteBatch = DrawRoot(root.get());
+		std::vector<SpriteBatch::Vertex> vertices = spriteBatch->vertices;
+		std::vector<uint32_t> textureHandles = spriteBatch->textureHandles;
+		std::vector<SpriteBatch::Shader> shaders = spriteBatch->shaders;
+
+		std::vector<UiElement*> freshElements;
+		std::unique_ptr<UiElement> fresh = Build(nodes, textures, &font, freshElements);
+		DrawRoot(fresh.get());
+		TEST_CHECK(vertices.size() == spriteBatch->vertices.size());
+		TEST_CHECK(textureHandles == spriteBatch->textureHandles);
+		TEST_CHECK(shaders == spriteBatch->shaders);
+		if (vertices.size() == spriteBatch->vertices.size()) {
+			TEST_CHECK(
+			  memcmp(
+			    vertices.data(), spriteBatch->vertices.data(),
+			    vertices.size() * sizeof(SpriteBatch::Vertex)) == 0);
+		}
+	}
+}
+
+// 作り直すのは変更した要素と、動いた要素の子孫だけ
+void TestRebuildCount() {
+	uint32_t texture = TextureManager::GetInstance()->Add(64, 64);
+	UiElement root;
+	UiElement* panel = root.CreateChild();
+	std::vector<UiElement*> leaves;
+	for (int i = 0; i < 100; i++) {
+		UiElement* leaf = panel->CreateChild();
+		leaf->SetPosition({float(i) * 10.0f, 0.0f});
+		leaf->SetSize({8.0f, 8.0f});
+		leaf->SetImage(texture);
+		leaves.push_back(leaf);
+	}
+
+	DrawRoot(&root);
+	TEST_CHECK(root.GetRebuildCount() == 102);
+	SpriteBatch* spriteBatch = DrawRoot(&root);
+	TEST_CHECK(root.GetRebuildCount() == 0);
+	TEST_CHECK(spriteBatch->textureHandles.size() == 100);
+
+	// 1つの色の変更
+	leaves[50]->SetColor({1.0f, 0.0f, 0.0f, 1.0f});
+	spriteBatch = DrawRoot(&root);
+	TEST_CHECK(root.GetRebuildCount() == 1);
+	TEST_CHECK(spriteBatch->vertices[50 * 4].color.y == 0.0f);
+	TEST_CHECK(spriteBatch->vertices[49 * 4].color.y == 1.0f);
+
+	// 親の移動
+	panel->SetPosition({0.0f, 20.0f});
+	spriteBatch = DrawRoot(&root);
+	TEST_CHECK(root.GetRebuildCount() == 101);
+	TEST_CHECK(spriteBatch->vertices[1].pos.y == 20.0f);
+
+	// 非表示の部分木は追加しない
+	panel->SetVisible(false);
+	spriteBatch = DrawRoot(&root);
+	TEST_CHECK(spriteBatch->vertices.empty());
+	panel->SetVisible(true);
+	spriteBatch = DrawRoot(&root);
+	TEST_CHECK(root.GetRebuildCount() == 0);
+	TEST_CHECK(spriteBatch->textureHandles.size() == 100);
+}
+
+// アトラス内の画像は、読み込みが完了したら本来の大きさでUVを求め直す
+void TestAtlasImageAfterLoad() {
+	TextureManager* textureManager = TextureManager::GetInstance();
+	uint32_t texture = textureManager->Add(1, 1);
+	UiElement root;
+	TextureManager::AtlasRegion region;
+	region.textureHandle = texture;
+	region.texBase = {64.0f, 32.0f};
+	region.texSize = {64.0f, 32.0f};
+	root.SetSize({64.0f, 32.0f});
+	root.SetImage(region);
+
+	SpriteBatch* spriteBatch = DrawRoot(&root);
+	TEST_CHECK(spriteBatch->vertices[1].uv.x == 64.0f);
+
+	textureManager->CompleteLoad(texture, 256, 128);
+	spriteBatch = DrawRoot(&root);
+	TEST_CHECK(root.GetRebuildCount() == 1);
+	// 左上と右下
+	TEST_CHECK(spriteBatch->vertices[1].uv.x == 0.25f);
+	TEST_CHECK(spriteBatch->vertices[1].uv.y == 0.25f);
+	TEST_CHECK(spriteBatch->vertices[2].uv.x == 0.5f);
+	TEST_CHECK(spriteBatch->vertices[2].uv.y == 0.5f);
+
+	spriteBatch = DrawRoot(&root);
+	TEST_CHECK(root.GetRebuildCount() == 0);
+}
+
+} // namespace
+
+int main() {
+	TestMatchesFreshTree();
+	TestRebuildCount();
+	TestAtlasImageAfterLoad();
+	return Test::Finish("UiElementTest");
+}
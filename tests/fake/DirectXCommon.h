@@ -0,0 +1,53 @@
+﻿#pragma once
+
+#include "HeapPageSource.h"
+#include "LinearAllocator.h"
+#include "d3dx12.h"
+#include <cstdint>
+
+/// <summary>
+/// FrameConstantBuffer、FrameUploadBufferのテスト用のDirectXCommon
+/// フレーム番号とフレームごとの線形アロケータ、バッファを作るだけのデバイスを持つ
+/// </summary>
+class DirectXCommon {
+  public:
+	static const uint32_t kFrameCount = 2;
+
+	static DirectXCommon* GetInstance() {
+		static DirectXCommon instance;
+		return &instance;
+	}
+
+	uint64_t GetFrameNumber() const { return frameNumber_; }
+
+	UINT GetFrameIndex() const { return static_cast<UINT>(frameNumber_ % kFrameCount); }
+
+	ID3D12Device* GetDevice() { return &device_; }
+
+	LinearAllocator::Allocation
+	  AllocateUpload(size_t size, size_t alignment = LinearAllocator::kDefaultAlignment) {
+		allocationCount++;
+		lastAllocation = allocator_.Allocate(size, alignment);
+		return lastAllocation;
+	}
+
+	/// <summary>
+	/// 次のフレームへ（GPUが使い終わった扱いで領域を先頭から使い直す）
+	/// </summary>
+	void NextFrame() {
+		allocator_.Reset();
+		frameNumber_++;
+	}
+
+	// AllocateUploadの呼び出し回数と直前の確保
+	uint32_t allocationCount = 0;
+	LinearAllocator::Allocation lastAllocation;
+
+  private:
+	DirectXCommon() = default;
+
+	ID3D12Device device_;
+	HeapPageSource pageSource_;
+	LinearAllocator allocator_{&pageSource_, 64 * 1024};
+	uint64_t frameNumber_ = 0;
+};
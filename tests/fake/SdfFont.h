@@ -0,0 +1,39 @@
+﻿#pragma once
+
+#include "SpriteQuadKernel.h"
+#include <DirectXMath.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// UiElementのテスト用のSdfFont
+/// 1文字を幅が高さの半分の四角形として横に並べるだけ（折り返しなし）
+/// </summary>
+class SdfFont {
+  public:
+	explicit SdfFont(uint32_t textureHandle) : textureHandle_(textureHandle) {}
+
+	DirectX::XMFLOAT2 Layout(
+	  const std::string& text, const DirectX::XMFLOAT2& position, float fontSize, float maxWidth,
+	  const DirectX::XMFLOAT4& color, std::vector<SpriteQuadKernel::Vertex>* vertices) {
+		(void)maxWidth;
+		float width = fontSize * 0.5f;
+		for (size_t i = 0; i < text.size(); i++) {
+			float left = position.x + width * i;
+			float right = left + width;
+			float bottom = position.y + fontSize;
+			float u = static_cast<float>(static_cast<unsigned char>(text[i])) / 256.0f;
+			vertices->push_back({{left, bottom, 0.0f}, {u, 1.0f}, color});
+			vertices->push_back({{left, position.y, 0.0f}, {u, 0.0f}, color});
+			vertices->push_back({{right, bottom, 0.0f}, {u, 1.0f}, color});
+			vertices->push_back({{right, position.y, 0.0f}, {u, 0.0f}, color});
+		}
+		return {width * text.size(), fontSize};
+	}
+
+	uint32_t GetTextureHandle() const { return textureHandle_; }
+
+  private:
+	uint32_t textureHandle_;
+};
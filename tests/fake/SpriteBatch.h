@@ -0,0 +1,83 @@
+﻿#pragma once
+
+#include "SpriteQuadKernel.h"
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// UiElementのテスト用のSpriteBatch
+/// 追加された四角形の頂点、テクスチャ、シェーダを記録するだけで描画はしない
+/// </summary>
+class SpriteBatch {
+  public:
+	using Vertex = SpriteQuadKernel::Vertex;
+
+	enum class Shader {
+		kTexture,
+		kDistanceField,
+
+		kCountOfShader,
+	};
+
+	static SpriteBatch* GetInstance() {
+		static SpriteBatch instance;
+		return &instance;
+	}
+
+	void SetShader(Shader shader) { shader_ = shader; }
+
+	Shader GetShader() const { return shader_; }
+
+	void DrawQuads(uint32_t textureHandle, const Vertex* vertices, size_t quadCount) {
+		FlushSprites();
+		textureHandles.insert(textureHandles.end(), quadCount, textureHandle);
+		shaders.insert(shaders.end(), quadCount, shader_);
+		this->vertices.insert(this->vertices.end(), vertices, vertices + quadCount * 4);
+	}
+
+	void DrawSprite(
+	  uint32_t textureHandle, const DirectX::XMFLOAT2& position, const DirectX::XMFLOAT2& size,
+	  float rotation, const DirectX::XMFLOAT2& anchorPoint, const DirectX::XMFLOAT4& uvRect,
+	  const DirectX::XMFLOAT4& color) {
+		textureHandles.push_back(textureHandle);
+		shaders.push_back(shader_);
+		sprites_.Add(position, size, rotation, anchorPoint, uvRect, color);
+	}
+
+	/// <summary>
+	/// 追加済みのスプライトの頂点を生成（本物はEndと次の四角形の追加で行う）
+	/// </summary>
+	void FlushSprites() {
+		size_t count = sprites_.GetCount();
+		if (count == 0) {
+			return;
+		}
+		size_t first = vertices.size();
+		vertices.resize(first + count * 4);
+		SpriteQuadKernel::Generate(sprites_.GetSprites(), count, vertices.data() + first);
+		sprites_.Clear();
+	}
+
+	/// <summary>
+	/// 記録を捨てる（本物のBeginの代わり）
+	/// </summary>
+	void Clear() {
+		vertices.clear();
+		textureHandles.clear();
+		shaders.clear();
+		sprites_.Clear();
+		shader_ = Shader::kTexture;
+	}
+
+	// 追加された四角形の頂点（四角形ごとに4頂点）、テクスチャハンドル、シェーダ
+	std::vector<Vertex> vertices;
+	std::vector<uint32_t> textureHandles;
+	std::vector<Shader> shaders;
+
+  private:
+	SpriteBatch() = default;
+
+	Shader shader_ = Shader::kTexture;
+	SpriteQuadKernel::SpriteArrays sprites_;
+};
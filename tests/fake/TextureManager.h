@@ -0,0 +1,68 @@
+﻿#pragma once
+
+#include <DirectXMath.h>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+// D3D12の型の代わり
+struct D3D12_RESOURCE_DESC {
+	uint64_t Width;
+	uint32_t Height;
+};
+
+/// <summary>
+/// UiElementのテスト用のTextureManager
+/// テクスチャの大きさと読み込み世代だけを持つ
+/// </summary>
+class TextureManager {
+  public:
+	struct AtlasRegion {
+		uint32_t textureHandle = 0;
+		DirectX::XMFLOAT2 texBase = {0, 0};
+		DirectX::XMFLOAT2 texSize = {0, 0};
+	};
+
+	static TextureManager* GetInstance() {
+		static TextureManager instance;
+		return &instance;
+	}
+
+	/// <summary>
+	/// テクスチャの追加
+	/// </summary>
+	/// <returns>テクスチャハンドル</returns>
+	uint32_t Add(uint64_t width, uint32_t height) {
+		textures_.push_back({{width, height}, 0});
+		return static_cast<uint32_t>(textures_.size() - 1);
+	}
+
+	/// <summary>
+	/// 非同期読み込みの完了（代わりのテクスチャから本来の大きさへ）
+	/// </summary>
+	void CompleteLoad(uint32_t textureHandle, uint64_t width, uint32_t height) {
+		assert(textureHandle < textures_.size());
+		textures_[textureHandle].desc = {width, height};
+		textures_[textureHandle].generation++;
+	}
+
+	uint32_t GetLoadGeneration(uint32_t textureHandle) const {
+		assert(textureHandle < textures_.size());
+		return textures_[textureHandle].generation;
+	}
+
+	const D3D12_RESOURCE_DESC GetResoureDesc(uint32_t textureHandle) {
+		assert(textureHandle < textures_.size());
+		return textures_[textureHandle].desc;
+	}
+
+  private:
+	struct Texture {
+		D3D12_RESOURCE_DESC desc;
+		uint32_t generation;
+	};
+
+	TextureManager() = default;
+
+	std::vector<Texture> textures_;
+};
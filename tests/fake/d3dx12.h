@@ -0,0 +1,99 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// D3D12の型の代わり（テストするクラスが使う分だけ）
+typedef long HRESULT;
+typedef uint32_t UINT;
+typedef uint64_t D3D12_GPU_VIRTUAL_ADDRESS;
+
+#define SUCCEEDED(hr) ((hr) >= 0)
+#define IID_PPV_ARGS(pp) (pp)
+
+enum D3D12_HEAP_TYPE { D3D12_HEAP_TYPE_UPLOAD };
+enum D3D12_HEAP_FLAGS { D3D12_HEAP_FLAG_NONE };
+enum D3D12_RESOURCE_STATES { D3D12_RESOURCE_STATE_GENERIC_READ };
+
+struct CD3DX12_HEAP_PROPERTIES {
+	explicit CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE type) : Type(type) {}
+
+	D3D12_HEAP_TYPE Type;
+};
+
+struct CD3DX12_RESOURCE_DESC {
+	static CD3DX12_RESOURCE_DESC Buffer(uint64_t width) { return {width}; }
+
+	uint64_t Width;
+};
+
+namespace Microsoft {
+namespace WRL {
+
+// 所有するだけのComPtr
+template<class T> class ComPtr {
+  public:
+	T* operator->() const { return pointer_.get(); }
+	T* Get() const { return pointer_.get(); }
+	void Attach(T* pointer) { pointer_.reset(pointer); }
+
+  private:
+	std::shared_ptr<T> pointer_;
+};
+
+} // namespace WRL
+} // namespace Microsoft
+
+/// <summary>
+/// CPUのメモリを確保するだけのリソース
+/// </summary>
+class ID3D12Resource {
+  public:
+	ID3D12Resource(uint64_t size, D3D12_GPU_VIRTUAL_ADDRESS address)
+	    : memory_(size), address_(address) {}
+
+	HRESULT Map(UINT subresource, const void* readRange, void** data) {
+		(void)subresource;
+		(void)readRange;
+		*data = memory_.data();
+		return 0;
+	}
+
+	D3D12_GPU_VIRTUAL_ADDRESS GetGPUVirtualAddress() const { return address_; }
+
+	// テスト用: GPUアドレスに対応するCPU側のメモリ
+	uint8_t* GetMemory(D3D12_GPU_VIRTUAL_ADDRESS address) {
+		return memory_.data() + (address - address_);
+	}
+
+  private:
+	std::vector<uint8_t> memory_;
+	D3D12_GPU_VIRTUAL_ADDRESS address_;
+};
+
+/// <summary>
+/// アップロード用のバッファを作るだけのデバイス
+/// </summary>
+class ID3D12Device {
+  public:
+	HRESULT CreateCommittedResource(
+	  const CD3DX12_HEAP_PROPERTIES* heapProperties, D3D12_HEAP_FLAGS heapFlags,
+	  const CD3DX12_RESOURCE_DESC* desc, D3D12_RESOURCE_STATES initialState,
+	  const void* optimizedClearValue, Microsoft::WRL::ComPtr<ID3D12Resource>* resource) {
+		(void)heapProperties;
+		(void)heapFlags;
+		(void)initialState;
+		(void)optimizedClearValue;
+		resource->Attach(new ID3D12Resource(desc->Width, nextAddress_));
+		lastResource = resource->Get();
+		nextAddress_ += (desc->Width + 0xffff) & ~uint64_t(0xffff);
+		return 0;
+	}
+
+	// 直前に作ったリソース
+	ID3D12Resource* lastResource = nullptr;
+
+  private:
+	D3D12_GPU_VIRTUAL_ADDRESS nextAddress_ = 0x10000;
+};
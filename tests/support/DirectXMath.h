@@ -0,0 +1,462 @@
+﻿#pragma once
+
+// DirectXMathが見つからない環境（Windows SDKのない環境）でテストを動かすための代替
+// エンジンのデバイスに依存しないクラスが使う部分だけを、_XM_NO_INTRINSICS_と同じ意味で
+// スカラー実装する（行ベクトル、左手系）。本物が見つかればCMakeはこのディレクトリを使わない
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace DirectX {
+
+constexpr float XM_PI = 3.141592654f;
+constexpr float XM_2PI = 6.283185307f;
+constexpr float XM_PIDIV2 = 1.570796327f;
+constexpr float XM_PIDIV4 = 0.785398163f;
+
+// ベクトル（4要素。比較の結果などはビット列として扱う）
+struct XMVECTOR {
+	union {
+		float vector4_f32[4];
+		uint32_t vector4_u32[4];
+	};
+};
+
+typedef const XMVECTOR& FXMVECTOR;
+typedef const XMVECTOR& GXMVECTOR;
+typedef const XMVECTOR& HXMVECTOR;
+typedef const XMVECTOR& CXMVECTOR;
+
+// 行列（行ベクトル4本）
+struct XMMATRIX {
+	XMVECTOR r[4];
+
+	XMMATRIX() = default;
+	XMMATRIX(FXMVECTOR r0, FXMVECTOR r1, FXMVECTOR r2, CXMVECTOR r3) : r{r0, r1, r2, r3} {}
+};
+
+typedef const XMMATRIX& FXMMATRIX;
+typedef const XMMATRIX& CXMMATRIX;
+
+struct XMFLOAT2 {
+	float x;
+	float y;
+
+	XMFLOAT2() = default;
+	constexpr XMFLOAT2(float x, float y) : x(x), y(y) {}
+};
+
+struct XMFLOAT3 {
+	float x;
+	float y;
+	float z;
+
+	XMFLOAT3() = default;
+	constexpr XMFLOAT3(float x, float y, float z) : x(x), y(y), z(z) {}
+};
+
+struct XMFLOAT4 {
+	float x;
+	float y;
+	float z;
+	float w;
+
+	XMFLOAT4() = default;
+	constexpr XMFLOAT4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+};
+
+struct XMFLOAT4X4 {
+	union {
+		struct {
+			float _11, _12, _13, _14;
+			float _21, _22, _23, _24;
+			float _31, _32, _33, _34;
+			float _41, _42, _43, _44;
+		};
+		float m[4][4];
+	};
+};
+
+// 定数
+struct XMVECTORF32 {
+	union {
+		float f[4];
+		XMVECTOR v;
+	};
+	operator XMVECTOR() const { return v; }
+};
+
+struct XMVECTORU32 {
+	union {
+		uint32_t u[4];
+		XMVECTOR v;
+	};
+	operator XMVECTOR() const { return v; }
+};
+
+const XMVECTORF32 g_XMZero = {{{0.0f, 0.0f, 0.0f, 0.0f}}};
+const XMVECTORF32 g_XMOne = {{{1.0f, 1.0f, 1.0f, 1.0f}}};
+const XMVECTORU32 g_XMSelect1100 = {{{0xFFFFFFFFu, 0xFFFFFFFFu, 0, 0}}};
+const XMVECTORU32 g_XMSelect1110 = {{{0xFFFFFFFFu, 0xFFFFFFFFu, 0xFFFFFFFFu, 0}}};
+
+constexpr float XMConvertToRadians(float degrees) { return degrees * (XM_PI / 180.0f); }
+
+// 生成、読み書き
+
+inline XMVECTOR XMVectorSet(float x, float y, float z, float w) {
+	XMVECTOR result;
+	result.vector4_f32[0] = x;
+	result.vector4_f32[1] = y;
+	result.vector4_f32[2] = z;
+	result.vector4_f32[3] = w;
+	return result;
+}
+
+inline XMVECTOR XMVectorReplicate(float value) { return XMVectorSet(value, value, value, value); }
+
+inline XMVECTOR XMVectorZero() { return XMVectorReplicate(0.0f); }
+
+inline XMVECTOR XMVectorSplatOne() { return XMVectorReplicate(1.0f); }
+
+inline XMVECTOR XMVectorTrueInt() {
+	XMVECTOR result;
+	for (int i = 0; i < 4; i++) {
+		result.vector4_u32[i] = 0xFFFFFFFFu;
+	}
+	return result;
+}
+
+inline float XMVectorGetX(FXMVECTOR v) { return v.vector4_f32[0]; }
+inline float XMVectorGetY(FXMVECTOR v) { return v.vector4_f32[1]; }
+inline float XMVectorGetZ(FXMVECTOR v) { return v.vector4_f32[2]; }
+inline float XMVectorGetW(FXMVECTOR v) { return v.vector4_f32[3]; }
+
+inline XMVECTOR XMLoadFloat3(const XMFLOAT3* source) {
+	return XMVectorSet(source->x, source->y, source->z, 0.0f);
+}
+
+inline XMVECTOR XMLoadFloat4(const XMFLOAT4* source) {
+	return XMVectorSet(source->x, source->y, source->z, source->w);
+}
+
+inline void XMStoreFloat2(XMFLOAT2* destination, FXMVECTOR v) {
+	destination->x = v.vector4_f32[0];
+	destination->y = v.vector4_f32[1];
+}
+
+inline void XMStoreFloat3(XMFLOAT3* destination, FXMVECTOR v) {
+	destination->x = v.vector4_f32[0];
+	destination->y = v.vector4_f32[1];
+	destination->z = v.vector4_f32[2];
+}
+
+inline void XMStoreFloat4(XMFLOAT4* destination, FXMVECTOR v) {
+	destination->x = v.vector4_f32[0];
+	destination->y = v.vector4_f32[1];
+	destination->z = v.vector4_f32[2];
+	destination->w = v.vector4_f32[3];
+}
+
+inline void XMStoreInt4(uint32_t* destination, FXMVECTOR v) {
+	std::memcpy(destination, v.vector4_u32, sizeof(v.vector4_u32));
+}
+
+inline void XMStoreFloat4x4(XMFLOAT4X4* destination, FXMMATRIX m) {
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			destination->m[i][j] = m.r[i].vector4_f32[j];
+		}
+	}
+}
+
+// 要素ごとの演算
+
+namespace Internal {
+
+// 要素ごとに関数を適用する
+template<class Func> XMVECTOR Componentwise(FXMVECTOR a, FXMVECTOR b, Func func) {
+	XMVECTOR result;
+	for (int i = 0; i < 4; i++) {
+		result.vector4_f32[i] = func(a.vector4_f32[i], b.vector4_f32[i]);
+	}
+	return result;
+}
+
+// 要素ごとに比較してビット列のマスクにする
+template<class Func> XMVECTOR CompareComponentwise(FXMVECTOR a, FXMVECTOR b, Func func) {
+	XMVECTOR result;
+	for (int i = 0; i < 4; i++) {
+		result.vector4_u32[i] = func(a.vector4_f32[i], b.vector4_f32[i]) ? 0xFFFFFFFFu : 0u;
+	}
+	return result;
+}
+
+// xyzの内積
+inline float Dot3(FXMVECTOR a, FXMVECTOR b) {
+	return a.vector4_f32[0] * b.vector4_f32[0] + a.vector4_f32[1] * b.vector4_f32[1] +
+	       a.vector4_f32[2] * b.vector4_f32[2];
+}
+
+} // namespace Internal
+
+inline XMVECTOR XMVectorAdd(FXMVECTOR a, FXMVECTOR b) {
+	return Internal::Componentwise(a, b, [](float x, float y) { return x + y; });
+}
+
+inline XMVECTOR XMVectorSubtract(FXMVECTOR a, FXMVECTOR b) {
+	return Internal::Componentwise(a, b, [](float x, float y) { return x - y; });
+}
+
+inline XMVECTOR XMVectorMultiply(FXMVECTOR a, FXMVECTOR b) {
+	return Internal::Componentwise(a, b, [](float x, float y) { return x * y; });
+}
+
+inline XMVECTOR XMVectorDivide(FXMVECTOR a, FXMVECTOR b) {
+	return Internal::Componentwise(a, b, [](float x, float y) { return x / y; });
+}
+
+inline XMVECTOR XMVectorMax(FXMVECTOR a, FXMVECTOR b) {
+	return Internal::Componentwise(a, b, [](float x, float y) { return x > y ? x : y; });
+}
+
+inline XMVECTOR XMVectorMin(FXMVECTOR a, FXMVECTOR b) {
+	return Internal::Componentwise(a, b, [](float x, float y) { return x < y ? x : y; });
+}
+
+inline XMVECTOR XMVectorMultiplyAdd(FXMVECTOR a, FXMVECTOR b, FXMVECTOR c) {
+	return XMVectorAdd(XMVectorMultiply(a, b), c);
+}
+
+inline XMVECTOR XMVectorScale(FXMVECTOR v, float scale) {
+	return XMVectorMultiply(v, XMVectorReplicate(scale));
+}
+
+inline XMVECTOR XMVectorNegate(FXMVECTOR v) { return XMVectorSubtract(XMVectorZero(), v); }
+
+inline XMVECTOR XMVectorLerp(FXMVECTOR v0, FXMVECTOR v1, float t) {
+	return XMVectorAdd(v0, XMVectorScale(XMVectorSubtract(v1, v0), t));
+}
+
+inline XMVECTOR XMVectorSaturate(FXMVECTOR v) {
+	return XMVectorMin(XMVectorMax(v, XMVectorZero()), XMVectorSplatOne());
+}
+
+inline XMVECTOR XMVectorSqrt(FXMVECTOR v) {
+	return Internal::Componentwise(v, v, [](float x, float) { return std::sqrt(x); });
+}
+
+inline void XMVectorSinCos(XMVECTOR* sin, XMVECTOR* cos, FXMVECTOR v) {
+	*sin = Internal::Componentwise(v, v, [](float x, float) { return std::sin(x); });
+	*cos = Internal::Componentwise(v, v, [](float x, float) { return std::cos(x); });
+}
+
+// 比較、選択
+
+inline XMVECTOR XMVectorLess(FXMVECTOR a, FXMVECTOR b) {
+	return Internal::CompareComponentwise(a, b, [](float x, float y) { return x < y; });
+}
+
+inline XMVECTOR XMVectorLessOrEqual(FXMVECTOR a, FXMVECTOR b) {
+	return Internal::CompareComponentwise(a, b, [](float x, float y) { return x <= y; });
+}
+
+inline XMVECTOR XMVectorGreaterOrEqual(FXMVECTOR a, FXMVECTOR b) {
+	return Internal::CompareComponentwise(a, b, [](float x, float y) { return x >= y; });
+}
+
+inline bool XMVector4LessOrEqual(FXMVECTOR a, FXMVECTOR b) {
+	for (int i = 0; i < 4; i++) {
+		if (!(a.vector4_f32[i] <= b.vector4_f32[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+inline XMVECTOR XMVectorAndInt(FXMVECTOR a, FXMVECTOR b) {
+	XMVECTOR result;
+	for (int i = 0; i < 4; i++) {
+		result.vector4_u32[i] = a.vector4_u32[i] & b.vector4_u32[i];
+	}
+	return result;
+}
+
+// controlのビットが立っている所はb、それ以外はa
+inline XMVECTOR XMVectorSelect(FXMVECTOR a, FXMVECTOR b, FXMVECTOR control) {
+	XMVECTOR result;
+	for (int i = 0; i < 4; i++) {
+		result.vector4_u32[i] = (a.vector4_u32[i] & ~control.vector4_u32[i]) |
+		                        (b.vector4_u32[i] & control.vector4_u32[i]);
+	}
+	return result;
+}
+
+template<uint32_t X, uint32_t Y, uint32_t Z, uint32_t W> XMVECTOR XMVectorSwizzle(FXMVECTOR v) {
+	static_assert(X < 4 && Y < 4 && Z < 4 && W < 4, "swizzle index out of range");
+	return XMVectorSet(v.vector4_f32[X], v.vector4_f32[Y], v.vector4_f32[Z], v.vector4_f32[W]);
+}
+
+// 3要素、平面
+
+inline XMVECTOR XMVector3Dot(FXMVECTOR a, FXMVECTOR b) {
+	return XMVectorReplicate(Internal::Dot3(a, b));
+}
+
+inline XMVECTOR XMVector3Length(FXMVECTOR v) {
+	return XMVectorReplicate(std::sqrt(Internal::Dot3(v, v)));
+}
+
+inline XMVECTOR XMVector3Cross(FXMVECTOR a, FXMVECTOR b) {
+	const float* x = a.vector4_f32;
+	const float* y = b.vector4_f32;
+	return XMVectorSet(
+	  x[1] * y[2] - x[2] * y[1], x[2] * y[0] - x[0] * y[2], x[0] * y[1] - x[1] * y[0], 0.0f);
+}
+
+// 長さ0ならそのまま0を返す（wも同じ倍率）
+inline XMVECTOR XMVector3Normalize(FXMVECTOR v) {
+	float length = std::sqrt(Internal::Dot3(v, v));
+	return XMVectorScale(v, length > 0.0f ? 1.0f / length : 0.0f);
+}
+
+// 法線(xyz)の長さで割る
+inline XMVECTOR XMPlaneNormalize(FXMVECTOR plane) {
+	float length = std::sqrt(Internal::Dot3(plane, plane));
+	return XMVectorScale(plane, length > 0.0f ? 1.0f / length : 0.0f);
+}
+
+inline XMVECTOR XMVector4Transform(FXMVECTOR v, FXMMATRIX m) {
+	XMVECTOR result = XMVectorZero();
+	for (int i = 0; i < 4; i++) {
+		result = XMVectorMultiplyAdd(XMVectorReplicate(v.vector4_f32[i]), m.r[i], result);
+	}
+	return result;
+}
+
+// w=1として変換し、wで割る
+inline XMVECTOR XMVector3TransformCoord(FXMVECTOR v, FXMMATRIX m) {
+	XMVECTOR result = XMVector4Transform(XMVectorSelect(XMVectorSplatOne(), v, g_XMSelect1110), m);
+	return XMVectorDivide(result, XMVectorReplicate(result.vector4_f32[3]));
+}
+
+// 行列
+
+inline XMMATRIX XMMatrixIdentity() {
+	return XMMATRIX(
+	  XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f),
+	  XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f));
+}
+
+inline XMMATRIX XMMatrixTranspose(FXMMATRIX m) {
+	XMMATRIX result;
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			result.r[i].vector4_f32[j] = m.r[j].vector4_f32[i];
+		}
+	}
+	return result;
+}
+
+inline XMMATRIX XMMatrixMultiply(FXMMATRIX a, CXMMATRIX b) {
+	XMMATRIX result;
+	for (int i = 0; i < 4; i++) {
+		result.r[i] = XMVector4Transform(a.r[i], b);
+	}
+	return result;
+}
+
+inline XMMATRIX operator*(FXMMATRIX a, CXMMATRIX b) { return XMMatrixMultiply(a, b); }
+
+// 掃き出し法（特異行列なら無限大やNaNを含む）
+inline XMMATRIX XMMatrixInverse(XMVECTOR* determinant, FXMMATRIX m) {
+	double a[4][8];
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			a[i][j] = m.r[i].vector4_f32[j];
+			a[i][j + 4] = i == j ? 1.0 : 0.0;
+		}
+	}
+
+	double det = 1.0;
+	for (int column = 0; column < 4; column++) {
+		int pivot = column;
+		for (int i = column + 1; i < 4; i++) {
+			if (std::fabs(a[i][column]) > std::fabs(a[pivot][column])) {
+				pivot = i;
+			}
+		}
+		if (pivot != column) {
+			for (int j = 0; j < 8; j++) {
+				double temp = a[column][j];
+				a[column][j] = a[pivot][j];
+				a[pivot][j] = temp;
+			}
+			det = -det;
+		}
+
+		double diagonal = a[column][column];
+		det *= diagonal;
+		for (int j = 0; j < 8; j++) {
+			a[column][j] /= diagonal;
+		}
+		for (int i = 0; i < 4; i++) {
+			if (i == column) {
+				continue;
+			}
+			double factor = a[i][column];
+			for (int j = 0; j < 8; j++) {
+				a[i][j] -= factor * a[column][j];
+			}
+		}
+	}
+
+	if (determinant) {
+		*determinant = XMVectorReplicate(static_cast<float>(det));
+	}
+	XMMATRIX result;
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			result.r[i].vector4_f32[j] = static_cast<float>(a[i][j + 4]);
+		}
+	}
+	return result;
+}
+
+inline XMMATRIX XMMatrixLookToLH(FXMVECTOR eyePosition, FXMVECTOR eyeDirection, FXMVECTOR up) {
+	XMVECTOR axisZ = XMVector3Normalize(eyeDirection);
+	XMVECTOR axisX = XMVector3Normalize(XMVector3Cross(up, axisZ));
+	XMVECTOR axisY = XMVector3Cross(axisZ, axisX);
+
+	// 各軸と、その軸への視点の位置の射影（符号反転）を並べてから転置する
+	XMVECTOR dotX = XMVectorReplicate(-Internal::Dot3(axisX, eyePosition));
+	XMVECTOR dotY = XMVectorReplicate(-Internal::Dot3(axisY, eyePosition));
+	XMVECTOR dotZ = XMVectorReplicate(-Internal::Dot3(axisZ, eyePosition));
+	XMMATRIX result(
+	  XMVectorSelect(dotX, axisX, g_XMSelect1110), XMVectorSelect(dotY, axisY, g_XMSelect1110),
+	  XMVectorSelect(dotZ, axisZ, g_XMSelect1110), XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f));
+	return XMMatrixTranspose(result);
+}
+
+inline XMMATRIX
+  XMMatrixPerspectiveFovLH(float fovAngleY, float aspectRatio, float nearZ, float farZ) {
+	float height = std::cos(0.5f * fovAngleY) / std::sin(0.5f * fovAngleY);
+	float width = height / aspectRatio;
+	float range = farZ / (farZ - nearZ);
+	return XMMATRIX(
+	  XMVectorSet(width, 0.0f, 0.0f, 0.0f), XMVectorSet(0.0f, height, 0.0f, 0.0f),
+	  XMVectorSet(0.0f, 0.0f, range, 1.0f), XMVectorSet(0.0f, 0.0f, -range * nearZ, 0.0f));
+}
+
+inline XMMATRIX XMMatrixOrthographicOffCenterLH(
+  float left, float right, float bottom, float top, float nearZ, float farZ) {
+	float width = 1.0f / (right - left);
+	float height = 1.0f / (top - bottom);
+	float range = 1.0f / (farZ - nearZ);
+	return XMMATRIX(
+	  XMVectorSet(width + width, 0.0f, 0.0f, 0.0f), XMVectorSet(0.0f, height + height, 0.0f, 0.0f),
+	  XMVectorSet(0.0f, 0.0f, range, 0.0f),
+	  XMVectorSet(-(left + right) * width, -(top + bottom) * height, -range * nearZ, 1.0f));
+}
+
+} // namespace DirectX